@@ -1,5 +1,6 @@
 """MariaDB Storage module."""
 
+from collections import Counter
 from collections.abc import Sequence
 from uuid import UUID, uuid4
 
@@ -12,15 +13,24 @@ from spider_py.storage.storage import Storage, StorageError
 
 InsertJob = """
 INSERT INTO
-  `jobs` (`id`, `client_id`)
+  `jobs` (`id`, `client_id`, `remaining_tasks`)
 VALUES
-  (?, ?)"""
+  (?, ?, ?)"""
 
 InsertTask = """
 INSERT INTO
-  `tasks` (`id`, `job_id`, `func_name`, `language`, `state`, `timeout`, `max_retry`)
+  `tasks` (
+    `id`,
+    `job_id`,
+    `func_name`,
+    `language`,
+    `state`,
+    `timeout`,
+    `max_retry`,
+    `remaining_inputs`
+  )
 VALUES
-  (?, ?, ?, ?, ?, ?, ?)"""
+  (?, ?, ?, ?, ?, ?, ?, ?)"""
 
 InsertTaskInputOutput = """
 INSERT INTO
@@ -40,6 +50,12 @@ INSERT INTO
 VALUES
   (?, ?, ?, ?)"""
 
+InsertTaskInputValueData = """
+INSERT INTO
+  `task_inputs` (`task_id`, `position`, `type`, `value_data_id`)
+VALUES
+  (?, ?, ?, ?)"""
+
 InsertTaskOutput = """
 INSERT INTO
   `task_outputs` (`task_id`, `position`, `type`)
@@ -87,7 +103,8 @@ GetTaskOutputs = """
 SELECT
   `type`,
   `value`,
-  `data_id`
+  `data_id`,
+  `value_data_id`
 FROM
   `task_outputs`
 WHERE
@@ -97,7 +114,13 @@ ORDER BY
 
 InsertData = """
 INSERT INTO
-  `data` (`id`, `value`, `hard_locality`)
+  `data` (`id`, `value`, `hard_locality`, `size`, `num_chunks`)
+VALUES
+  (?, ?, ?, ?, ?)"""
+
+InsertDataChunk = """
+INSERT INTO
+  `data_chunks` (`id`, `chunk_index`, `value`)
 VALUES
   (?, ?, ?)"""
 
@@ -122,12 +145,23 @@ VALUES
 GetData = """
 SELECT
   `value`,
-  `hard_locality`
+  `hard_locality`,
+  `num_chunks`
 FROM
   `data`
 WHERE
   `id` = ?"""
 
+GetDataChunks = """
+SELECT
+  `value`
+FROM
+  `data_chunks`
+WHERE
+  `id` = ?
+ORDER BY
+  `chunk_index`"""
+
 GetDataLocality = """
 SELECT
   `address`
@@ -142,6 +176,10 @@ INSERT INTO
 VALUES
   (?)"""
 
+# Values larger than the `value` column of the `data` table are stored in `data_chunks`.
+MaxInlineDataSize = 999
+DataChunkSize = 1024 * 1024
+
 _StrToJobStatusMap = {
     "running": core.JobStatus.Running,
     "success": core.JobStatus.Succeeded,
@@ -193,7 +231,13 @@ class MariaDBStorage(Storage):
 
             with self._conn.cursor() as cursor:
                 # Insert jobs table
-                cursor.executemany(InsertJob, [(job.job_id.bytes, driver_id.bytes) for job in jobs])
+                cursor.executemany(
+                    InsertJob,
+                    [
+                        (job.job_id.bytes, driver_id.bytes, len(task_graph.tasks))
+                        for job, task_graph in zip(jobs, task_graphs, strict=True)
+                    ],
+                )
                 # Insert tasks table
                 cursor.executemany(
                     InsertTask,
@@ -236,10 +280,23 @@ class MariaDBStorage(Storage):
                         input_data_params,
                     )
 
-                # Insert task input values table
-                input_value_params = self._gen_task_input_value_insertion_params(
+                # Insert task input values table. Values too large for the `value` column are stored
+                # as data referenced by the task.
+                input_value_params = []
+                all_input_value_params = self._gen_task_input_value_insertion_params(
                     task_ids, task_graphs
                 )
+                for task_id, position, input_type, value in all_input_value_params:
+                    if len(value) <= MaxInlineDataSize:
+                        input_value_params.append((task_id, position, input_type, value))
+                        continue
+                    value_data_id = uuid4()
+                    self._insert_data(cursor, value_data_id, value, hard_locality=False)
+                    cursor.execute(InsertDataRefTask, (value_data_id.bytes, task_id))
+                    cursor.execute(
+                        InsertTaskInputValueData,
+                        (task_id, position, input_type, value_data_id.bytes),
+                    )
                 if input_value_params:
                     cursor.executemany(
                         InsertTaskInputValue,
@@ -291,7 +348,10 @@ class MariaDBStorage(Storage):
                 results = []
                 for task_id in task_ids:
                     cursor.execute(GetTaskOutputs, (task_id,))
-                    for output_type, value, data_id in cursor.fetchall():
+                    for output_type, inline_value, data_id, value_data_id in cursor.fetchall():
+                        value = inline_value
+                        if value is None and value_data_id is not None:
+                            value = self._get_data(cursor, core.DataId(bytes=value_data_id)).value
                         if value is not None:
                             results.append(
                                 core.TaskOutput(
@@ -360,10 +420,7 @@ class MariaDBStorage(Storage):
         """
         try:
             with self._conn.cursor() as cursor:
-                cursor.execute(
-                    InsertData,
-                    (data.id.bytes, data.value, data.hard_locality),
-                )
+                self._insert_data(cursor, data.id, data.value, data.hard_locality)
                 if data.localities:
                     cursor.executemany(
                         InsertDataLocality,
@@ -383,7 +440,7 @@ class MariaDBStorage(Storage):
         jobs: Sequence[core.Job],
         task_ids: Sequence[Sequence[UUID]],
         task_graphs: Sequence[core.TaskGraph],
-    ) -> list[tuple[bytes, bytes, str, str, str, float, int]]:
+    ) -> list[tuple[bytes, bytes, str, str, str, float, int, int]]:
         """
         Generates parameters for inserting tasks into the database.
         :param jobs: The jobs.
@@ -397,6 +454,7 @@ class MariaDBStorage(Storage):
             - Task state.
             - Task timeout.
             - Task max retry.
+            - Number of inputs referencing the output of another task.
         :raises ValueError: If the lengths of `jobs` and `task_graphs` do not match.
         """
         task_insert_params = []
@@ -404,6 +462,9 @@ class MariaDBStorage(Storage):
             msg = "The lengths of `jobs` and `task_graphs` must match."
             raise ValueError(msg)
         for graph_index, (job, task_graph) in enumerate(zip(jobs, task_graphs, strict=True)):
+            num_output_refs = Counter(
+                ref.input_task_index for ref in task_graph.task_input_output_refs
+            )
             for task_index, task in enumerate(task_graph.tasks):
                 task_insert_params.append(
                     (
@@ -414,6 +475,7 @@ class MariaDBStorage(Storage):
                         str(task.state),
                         task.timeout,
                         task.max_retries,
+                        num_output_refs[task_index],
                     )
                 )
         return task_insert_params
@@ -643,6 +705,32 @@ class MariaDBStorage(Storage):
         cursor.fetchall()
         return _StrToJobStatusMap[status_str]
 
+    @staticmethod
+    def _insert_data(
+        cursor: mariadb.Cursor, data_id: UUID, value: bytes, hard_locality: bool
+    ) -> None:
+        """
+        Inserts a data row using the `cursor`, storing a value larger than the `value` column in
+        chunks.
+        This method does not commit or rollback the transaction.
+        :param cursor:
+        :param data_id:
+        :param value:
+        :param hard_locality:
+        """
+        chunks = []
+        if len(value) > MaxInlineDataSize:
+            chunks = [
+                value[offset : offset + DataChunkSize]
+                for offset in range(0, len(value), DataChunkSize)
+            ]
+        cursor.execute(
+            InsertData,
+            (data_id.bytes, b"" if chunks else value, hard_locality, len(value), len(chunks)),
+        )
+        for chunk_index, chunk in enumerate(chunks):
+            cursor.execute(InsertDataChunk, (data_id.bytes, chunk_index, chunk))
+
     @staticmethod
     def _get_data(cursor: mariadb.Cursor, data_id: core.DataId) -> core.Data:
         """
@@ -658,7 +746,10 @@ class MariaDBStorage(Storage):
         if row is None:
             msg = f"No data found with id {data_id}."
             raise StorageError(msg)
-        value, hard_locality = row
+        value, hard_locality, num_chunks = row
+        if num_chunks > 0:
+            cursor.execute(GetDataChunks, (data_id.bytes,))
+            value = b"".join(chunk for (chunk,) in cursor.fetchall())
         data = core.Data(id=data_id, value=value, hard_locality=hard_locality)
         cursor.execute(GetDataLocality, (data_id.bytes,))
         for (address,) in cursor.fetchall():
@@ -1,6 +1,7 @@
 #ifndef SPIDER_CLIENT_DATA_HPP
 #define SPIDER_CLIENT_DATA_HPP
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -51,7 +52,14 @@ public:
      */
     auto get() -> T {
         std::string const& value = m_impl->get_value();
-        return msgpack::unpack(value.data(), value.size()).get().as<T>();
+        // Reference strings and binaries in the value instead of copying them into the zone
+        msgpack::object_handle const handle = msgpack::unpack(
+                value.data(),
+                value.size(),
+                [](msgpack::type::object_type /*type*/, std::size_t /*length*/, void* /*data*/)
+                        -> bool { return true; }
+        );
+        return handle.get().as<T>();
     }
 
     /**
@@ -114,9 +122,10 @@ public:
          * @throw spider::ConnectionException
          */
         auto build(T const& t) -> Data {
-            msgpack::sbuffer buffer;
-            msgpack::pack(buffer, t);
-            auto data = std::make_unique<core::Data>(std::string{buffer.data(), buffer.size()});
+            std::string value;
+            StringStream stream{&value};
+            msgpack::pack(stream, t);
+            auto data = std::make_unique<core::Data>(std::move(value));
             data->set_locality(m_nodes);
             data->set_hard_locality(m_hard_locality);
             std::shared_ptr<core::StorageConnection> conn = m_connection;
@@ -147,6 +156,16 @@ public:
         }
 
     private:
+        /**
+         * A msgpack stream that packs directly into a string, so that a large value is not copied
+         * out of an intermediate buffer.
+         */
+        struct StringStream {
+            std::string* str;
+
+            auto write(char const* buf, std::size_t const len) -> void { str->append(buf, len); }
+        };
+
         Builder(core::Context context,
                 std::shared_ptr<core::DataStorage> data_store,
                 std::shared_ptr<core::StorageFactory> storage_factory)
@@ -18,12 +18,12 @@
 #include <spider/core/Error.hpp>
 #include <spider/core/KeyValueData.hpp>
 #include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
-#include <spider/storage/mysql/MySqlStorageFactory.hpp>
 #include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageFactory.hpp>
 
 namespace spider {
 Driver::Driver(std::string const& storage_url)
-        : m_storage_factory{std::make_shared<core::MySqlStorageFactory>(storage_url)} {
+        : m_storage_factory{core::create_storage_factory(storage_url)} {
     boost::uuids::random_generator gen;
     m_id = gen();
 
@@ -74,7 +74,7 @@ Driver::Driver(std::string const& storage_url)
 
 Driver::Driver(std::string const& storage_url, boost::uuids::uuid const id)
         : m_id{id},
-          m_storage_factory{std::make_shared<core::MySqlStorageFactory>(storage_url)} {
+          m_storage_factory{core::create_storage_factory(storage_url)} {
     m_metadata_storage = m_storage_factory->provide_metadata_storage();
     m_data_storage = m_storage_factory->provide_data_storage();
 
@@ -1,6 +1,7 @@
 #ifndef SPIDER_CLIENT_DRIVER_HPP
 #define SPIDER_CLIENT_DRIVER_HPP
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -21,6 +22,7 @@
 #include <spider/client/task.hpp>
 #include <spider/core/DriverCleaner.hpp>
 #include <spider/core/Error.hpp>
+#include <spider/core/JobMetadata.hpp>
 #include <spider/core/TaskGraphImpl.hpp>
 #include <spider/io/Serializer.hpp>
 #include <spider/storage/JobSubmissionBatch.hpp>
@@ -184,6 +186,28 @@ public:
     template <TaskIo ReturnType, TaskIo... Params, TaskIo... Inputs>
     auto start(TaskFunction<ReturnType, Params...> const& task, Inputs&&... inputs)
             -> Job<ReturnType> {
+        return start(core::cDefaultJobPriority, task, std::forward<Inputs>(inputs)...);
+    }
+
+    /**
+     * Starts running a task with the given inputs on Spider with the given priority.
+     *
+     * @tparam ReturnType
+     * @tparam Params
+     * @tparam Inputs
+     * @param priority Priority of the job. Priority-aware scheduling policies run jobs with a
+     * higher priority first.
+     * @param task
+     * @param inputs
+     * @return A job representing the running task.
+     * @throw spider::ConnectionException
+     */
+    template <TaskIo ReturnType, TaskIo... Params, TaskIo... Inputs>
+    auto start(
+            std::int32_t const priority,
+            TaskFunction<ReturnType, Params...> const& task,
+            Inputs&&... inputs
+    ) -> Job<ReturnType> {
         // Check input type
         static_assert(
                 sizeof...(Inputs) == sizeof...(Params),
@@ -213,13 +237,20 @@ public:
         graph.add_input_task(new_task.get_id());
         graph.add_output_task(new_task.get_id());
         if (nullptr != m_batch) {
-            core::StorageErr const err
-                    = m_metadata_storage->add_job_batch(*m_conn, *m_batch, job_id, m_id, graph);
+            core::StorageErr const err = m_metadata_storage->add_job_batch(
+                    *m_conn,
+                    *m_batch,
+                    job_id,
+                    m_id,
+                    graph,
+                    priority
+            );
             if (!err.success()) {
                 throw ConnectionException(fmt::format("Failed to start job: {}", err.description));
             }
         } else {
-            core::StorageErr const err = m_metadata_storage->add_job(*m_conn, job_id, m_id, graph);
+            core::StorageErr const err
+                    = m_metadata_storage->add_job(*m_conn, job_id, m_id, graph, priority);
             if (!err.success()) {
                 throw ConnectionException(fmt::format("Failed to start job: {}", err.description));
             }
@@ -249,6 +280,28 @@ public:
     template <TaskIo ReturnType, TaskIo... Params, TaskIo... Inputs>
     auto start(TaskGraph<ReturnType, Params...> const& graph, Inputs&&... inputs)
             -> Job<ReturnType> {
+        return start(core::cDefaultJobPriority, graph, std::forward<Inputs>(inputs)...);
+    }
+
+    /**
+     * Starts running a task graph with the given inputs on Spider with the given priority.
+     *
+     * @tparam ReturnType
+     * @tparam Params
+     * @tparam Inputs
+     * @param priority Priority of the job. Priority-aware scheduling policies run jobs with a
+     * higher priority first.
+     * @param graph
+     * @param inputs
+     * @return A job representing the running task graph.
+     * @throw spider::ConnectionException
+     */
+    template <TaskIo ReturnType, TaskIo... Params, TaskIo... Inputs>
+    auto start(
+            std::int32_t const priority,
+            TaskGraph<ReturnType, Params...> const& graph,
+            Inputs&&... inputs
+    ) -> Job<ReturnType> {
         // Check input type
         static_assert(
                 sizeof...(Inputs) == sizeof...(Params),
@@ -276,14 +329,20 @@ public:
                     *m_batch,
                     job_id,
                     m_id,
-                    graph.m_impl->get_graph()
+                    graph.m_impl->get_graph(),
+                    priority
             );
             if (!err.success()) {
                 throw ConnectionException(fmt::format("Failed to start job: {}", err.description));
             }
         } else {
-            core::StorageErr const err
-                    = m_metadata_storage->add_job(*m_conn, job_id, m_id, graph.m_impl->get_graph());
+            core::StorageErr const err = m_metadata_storage->add_job(
+                    *m_conn,
+                    job_id,
+                    m_id,
+                    graph.m_impl->get_graph(),
+                    priority
+            );
             if (!err.success()) {
                 throw ConnectionException(fmt::format("Failed to start job: {}", err.description));
             }
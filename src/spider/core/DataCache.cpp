@@ -0,0 +1,64 @@
+#include "DataCache.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Data.hpp>
+#include <spider/utils/env.hpp>
+
+namespace spider::core {
+namespace {
+/**
+ * @return The capacity set in the environment, or 0 if it is not set or invalid.
+ */
+auto get_env_capacity() -> std::size_t {
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    char const* value = std::getenv(std::string{spider::utils::cDataCacheSizeEnv}.c_str());
+    if (nullptr == value) {
+        return 0;
+    }
+    try {
+        return std::stoull(value);
+    } catch (std::exception const&) {
+        return 0;
+    }
+}
+}  // namespace
+
+auto DataCache::get_instance() -> DataCache& {
+    // Explicitly use new because the cache may be used by tasks until the process exits
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    static auto* instance = [] {
+        auto* cache = new DataCache();
+        cache->set_capacity(get_env_capacity());
+        return cache;
+    }();
+    return *instance;
+}
+
+auto DataCache::get(boost::uuids::uuid const id) -> std::optional<Data> {
+    std::lock_guard const lock{m_mutex};
+    return m_cache.get(id);
+}
+
+auto DataCache::put(Data const& data) -> void {
+    std::lock_guard const lock{m_mutex};
+    m_cache.put(data.get_id(), data);
+}
+
+auto DataCache::set_capacity(std::size_t const capacity) -> void {
+    std::lock_guard const lock{m_mutex};
+    m_cache.set_size(capacity);
+}
+
+auto DataCache::get_size() -> std::size_t {
+    std::lock_guard const lock{m_mutex};
+    return m_cache.get_weight();
+}
+}  // namespace spider::core
@@ -0,0 +1,66 @@
+#ifndef SPIDER_CORE_DATACACHE_HPP
+#define SPIDER_CORE_DATACACHE_HPP
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Data.hpp>
+#include <spider/utils/LruCache.hpp>
+
+namespace spider::core {
+/**
+ * Process-wide cache of the data read as task arguments, bounded by the total size of the data
+ * values. A data value never changes once created, so tasks running in the same process can reuse
+ * a cached value instead of reading it from the storage again. The initial capacity is read from
+ * the `SPIDER_DATA_CACHE_SIZE` environment variable, and the cache is disabled if it is not set.
+ */
+class DataCache {
+public:
+    // Delete copy & move constructors and assignment operators
+    DataCache(DataCache const&) = delete;
+    auto operator=(DataCache const&) -> DataCache& = delete;
+    DataCache(DataCache&&) = delete;
+    auto operator=(DataCache&&) -> DataCache& = delete;
+
+    static auto get_instance() -> DataCache&;
+
+    /**
+     * @param id
+     * @return The cached data, or std::nullopt if the data is not cached.
+     */
+    auto get(boost::uuids::uuid id) -> std::optional<Data>;
+
+    auto put(Data const& data) -> void;
+
+    /**
+     * Sets the maximum total size of the cached data in bytes. 0 disables the cache.
+     *
+     * @param capacity
+     */
+    auto set_capacity(std::size_t capacity) -> void;
+
+    /**
+     * @return The total size of the cached data in bytes.
+     */
+    auto get_size() -> std::size_t;
+
+private:
+    // Counts the entry itself too, so that empty values are not free to cache
+    struct DataWeigher {
+        auto operator()(Data const& data) const -> std::size_t {
+            return sizeof(Data) + data.get_value().size();
+        }
+    };
+
+    DataCache() = default;
+    ~DataCache() = default;
+
+    std::mutex m_mutex;
+    LruCache<boost::uuids::uuid, Data, DataWeigher> m_cache{0};
+};
+}  // namespace spider::core
+
+#endif
@@ -7,6 +7,12 @@
 #include <boost/uuid/uuid.hpp>
 
 namespace spider::core {
+/**
+ * Priority of jobs started without an explicit priority. Jobs with a higher priority are scheduled
+ * first by priority-aware scheduling policies.
+ */
+constexpr std::int32_t cDefaultJobPriority = 0;
+
 class JobMetadata {
 public:
     JobMetadata() = default;
@@ -14,11 +20,13 @@ public:
     JobMetadata(
             boost::uuids::uuid id,
             boost::uuids::uuid client_id,
-            std::chrono::system_clock::time_point creation_time
+            std::chrono::system_clock::time_point creation_time,
+            std::int32_t priority = cDefaultJobPriority
     )
             : m_id{id},
               m_client_id{client_id},
-              m_creation_time{creation_time} {}
+              m_creation_time{creation_time},
+              m_priority{priority} {}
 
     [[nodiscard]] auto get_id() const -> boost::uuids::uuid { return m_id; }
 
@@ -28,10 +36,13 @@ public:
         return m_creation_time;
     }
 
+    [[nodiscard]] auto get_priority() const -> std::int32_t { return m_priority; }
+
 private:
     boost::uuids::uuid m_id;
     boost::uuids::uuid m_client_id;
     std::chrono::system_clock::time_point m_creation_time;
+    std::int32_t m_priority = cDefaultJobPriority;
 };
 
 enum class JobStatus : std::uint8_t {
@@ -14,6 +14,7 @@
 #include <boost/uuid/uuid.hpp>
 
 #include <spider/core/Data.hpp>
+#include <spider/core/JobMetadata.hpp>
 #include <spider/io/MsgPack.hpp>
 
 namespace spider::core {
@@ -143,6 +144,8 @@ public:
         return m_job_creation_time;
     }
 
+    [[nodiscard]] auto get_job_priority() const -> std::int32_t { return m_job_priority; }
+
     [[nodiscard]] auto get_hard_localities() const -> std::vector<std::string> const& {
         return m_hard_localities;
     }
@@ -158,6 +161,10 @@ public:
         m_job_creation_time = job_creation_time;
     }
 
+    auto set_job_priority(std::int32_t const job_priority) -> void {
+        m_job_priority = job_priority;
+    }
+
     auto add_hard_locality(std::string const& locality) -> void {
         m_hard_localities.push_back(locality);
     }
@@ -172,6 +179,7 @@ private:
     boost::uuids::uuid m_job_id;
     boost::uuids::uuid m_client_id;
     std::chrono::system_clock::time_point m_job_creation_time;
+    std::int32_t m_job_priority = cDefaultJobPriority;
     std::vector<std::string> m_hard_localities;
     std::vector<std::string> m_soft_localities;
 };
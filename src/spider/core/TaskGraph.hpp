@@ -9,6 +9,7 @@
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid.hpp>
 
@@ -87,6 +88,54 @@ public:
         return parents;
     }
 
+    /**
+     * Orders the tasks so that every task comes after its parents, starting from the input tasks.
+     * The children of each task are indexed once, so ordering takes time linear in the size of the
+     * graph, unlike walking the graph with `get_child_tasks` and `get_parent_tasks`. Tasks that
+     * cannot be reached from the input tasks are left out.
+     *
+     * @return The tasks in graph order on success.
+     * @return std::nullopt if an input task or a child task is not in the graph.
+     */
+    [[nodiscard]] auto get_tasks_in_graph_order() const
+            -> std::optional<std::vector<Task const*>> {
+        absl::flat_hash_map<boost::uuids::uuid, std::vector<boost::uuids::uuid>> children;
+        absl::flat_hash_map<boost::uuids::uuid, std::size_t> num_remaining_parents;
+        for (auto const& [parent_id, child_id] : m_dependencies) {
+            children[parent_id].push_back(child_id);
+            ++num_remaining_parents[child_id];
+        }
+
+        absl::flat_hash_set<boost::uuids::uuid> visited;
+        std::vector<boost::uuids::uuid> stack;
+        for (boost::uuids::uuid const task_id : m_input_tasks) {
+            if (visited.insert(task_id).second) {
+                stack.push_back(task_id);
+            }
+        }
+        std::vector<Task const*> tasks;
+        tasks.reserve(m_tasks.size());
+        while (false == stack.empty()) {
+            boost::uuids::uuid const task_id = stack.back();
+            stack.pop_back();
+            auto const task_it = m_tasks.find(task_id);
+            if (m_tasks.end() == task_it) {
+                return std::nullopt;
+            }
+            tasks.push_back(&task_it->second);
+            auto const children_it = children.find(task_id);
+            if (children.end() == children_it) {
+                continue;
+            }
+            for (boost::uuids::uuid const child_id : children_it->second) {
+                if (0 == --num_remaining_parents[child_id] && visited.insert(child_id).second) {
+                    stack.push_back(child_id);
+                }
+            }
+        }
+        return tasks;
+    }
+
     // NOLINTBEGIN(misc-include-cleaner)
     [[nodiscard]] auto get_tasks() const
             -> absl::flat_hash_map<boost::uuids::uuid, Task, std::hash<boost::uuids::uuid>> const& {
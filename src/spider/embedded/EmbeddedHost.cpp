@@ -0,0 +1,370 @@
+#include "EmbeddedHost.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <spdlog/spdlog.h>
+
+#include <spider/core/Driver.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
+#include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
+#include <spider/scheduler/FifoPolicy.hpp>
+#include <spider/scheduler/SchedulerMessage.hpp>
+#include <spider/scheduler/SchedulerServer.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+#include <spider/storage/StorageFactory.hpp>
+#include <spider/utils/StopFlag.hpp>
+#include <spider/worker/InProcessExecutor.hpp>
+#include <spider/worker/ResultSubmitter.hpp>
+#include <spider/worker/task_result.hpp>
+#include <spider/worker/TaskFetcher.hpp>
+#include <spider/worker/TaskPipeline.hpp>
+#include <spider/worker/WorkerClient.hpp>
+
+namespace spider::embedded {
+namespace {
+constexpr char const* cLoopbackAddr = "127.0.0.1";
+
+constexpr std::size_t cNumServerThreads = 1;
+constexpr std::size_t cNumServerStorageConnections = 2;
+
+constexpr int cRetryCount = 5;
+// Number of maintenance rounds, one per second, between storage cleanups
+constexpr int cCleanupInterval = 1000;
+// Jobs whose submission made no progress for this many milliseconds are left by crashed submitters
+constexpr double cSubmittingJobTimeout = 3'600'000;
+// Workers update their heartbeat every second, so this allows for 5 missed updates
+constexpr std::int64_t cWorkerHeartbeatTimeout = 5000;
+
+constexpr std::size_t cNumBlockingCallsPerSlot = 2;
+constexpr std::chrono::milliseconds cResultFlushInterval{5};
+constexpr std::size_t cResultBatchSize = 64;
+
+// The result of a task run by a slot, to be submitted
+struct SlotTaskResult {
+    core::TaskInstance instance;
+    core::Task task;
+    worker::TaskResult result;
+};
+
+/**
+ * Runs tasks one at a time in a task slot of the embedded worker, on the in-process executor.
+ *
+ * @param context The event loop.
+ * @param blocking_pool Thread pool for blocking calls, with `cNumBlockingCallsPerSlot` threads per
+ * slot.
+ * @param fetcher Fetcher sharing the scheduler session between slots.
+ * @param conn_pool Pool of storage connections shared by the slots.
+ * @param submitter Submitter batching the outputs of the slots.
+ * @param metadata_store
+ * @param executor Executor running the tasks.
+ */
+auto slot_loop(
+        boost::asio::io_context& context,
+        boost::asio::thread_pool& blocking_pool,
+        worker::TaskFetcher& fetcher,
+        core::StorageConnectionPool& conn_pool,
+        worker::ResultSubmitter& submitter,
+        std::shared_ptr<core::MetadataStorage> const& metadata_store,
+        worker::InProcessExecutor& executor
+) -> boost::asio::awaitable<void> {
+    auto const run_task = [&](scheduler::ScheduledTask scheduled_task)
+            -> boost::asio::awaitable<std::optional<SlotTaskResult>> {
+        core::TaskInstance const instance = scheduled_task.get_instance();
+        core::Task task = scheduled_task.get_task();
+        if (core::TaskLanguage::Cpp != task.get_language()) {
+            spdlog::error(
+                    "Task `{}` is not a C++ task and cannot run in an embedded host.",
+                    task.get_function_name()
+            );
+            worker::fail_task(
+                    conn_pool,
+                    metadata_store,
+                    instance,
+                    "Only C++ tasks run in an embedded host."
+            );
+            fetcher.add_failed_task(task.get_id());
+            co_return std::nullopt;
+        }
+
+        msgpack::sbuffer const response = co_await executor.run(
+                task.get_function_name(),
+                task.get_id(),
+                scheduled_task.get_arg_buffers()
+        );
+        worker::TaskResult result = worker::collect_in_process_result(task, response);
+        co_return SlotTaskResult{instance, std::move(task), std::move(result)};
+    };
+
+    co_await worker::run_task_pipeline<scheduler::ScheduledTask, SlotTaskResult>(
+            context,
+            blocking_pool,
+            [&fetcher] { return fetcher.fetch(); },
+            [] { return core::StopFlag::is_stop_requested(); },
+            run_task,
+            [&conn_pool, &submitter, &metadata_store, &fetcher](SlotTaskResult task_result) {
+                bool const success = worker::submit_task_result(
+                        conn_pool,
+                        submitter,
+                        metadata_store,
+                        task_result.instance,
+                        task_result.task,
+                        task_result.result
+                );
+                if (false == success) {
+                    fetcher.add_failed_task(task_result.task.get_id());
+                }
+                return success;
+            }
+    );
+}
+}  // namespace
+
+EmbeddedHost::EmbeddedHost(
+        std::shared_ptr<core::StorageFactory> storage_factory,
+        std::shared_ptr<core::MetadataStorage> metadata_store,
+        std::shared_ptr<core::DataStorage> data_store,
+        core::Scheduler scheduler,
+        core::Driver worker,
+        std::size_t const num_slots
+)
+        : m_storage_factory{std::move(storage_factory)},
+          m_metadata_store{std::move(metadata_store)},
+          m_data_store{std::move(data_store)},
+          m_scheduler{std::move(scheduler)},
+          m_worker{worker},
+          m_num_slots{num_slots},
+          m_server_conn_pool{std::make_shared<core::StorageConnectionPool>(
+                  m_storage_factory,
+                  cNumServerStorageConnections
+          )} {
+    m_server = std::make_unique<scheduler::SchedulerServer>(
+            static_cast<unsigned short>(m_scheduler.get_port()),
+            std::make_shared<scheduler::FifoPolicy>(
+                    m_scheduler.get_id(),
+                    m_metadata_store,
+                    m_data_store,
+                    m_server_conn_pool
+            ),
+            m_metadata_store,
+            m_data_store,
+            m_server_conn_pool,
+            cNumServerThreads
+    );
+    m_in_process_executor = std::make_unique<worker::InProcessExecutor>(
+            m_storage_factory,
+            m_metadata_store,
+            m_data_store,
+            m_num_slots,
+            std::vector<std::string>{}
+    );
+    m_client = std::make_unique<worker::WorkerClient>(
+            m_worker.get_id(),
+            cLoopbackAddr,
+            m_data_store,
+            m_metadata_store,
+            m_storage_factory
+    );
+    m_maintenance_thread = std::thread{[this] { maintenance_loop(); }};
+    m_task_thread = std::thread{[this] { task_loop(); }};
+}
+
+EmbeddedHost::~EmbeddedHost() {
+    stop();
+}
+
+auto EmbeddedHost::start(
+        std::string const& storage_url,
+        unsigned short const port,
+        std::size_t const num_slots
+) -> std::variant<std::unique_ptr<EmbeddedHost>, core::StorageErr> {
+    if (0 == num_slots) {
+        return core::StorageErr{core::StorageErrType::OtherErr, "num_slots must be positive"};
+    }
+
+    std::shared_ptr<core::StorageFactory> storage_factory
+            = core::create_storage_factory(storage_url);
+    std::shared_ptr<core::MetadataStorage> metadata_store
+            = storage_factory->provide_metadata_storage();
+    std::shared_ptr<core::DataStorage> data_store = storage_factory->provide_data_storage();
+
+    std::variant<std::unique_ptr<core::StorageConnection>, core::StorageErr> conn_result
+            = storage_factory->provide_storage_connection();
+    if (std::holds_alternative<core::StorageErr>(conn_result)) {
+        return std::get<core::StorageErr>(conn_result);
+    }
+    auto const conn = std::move(std::get<std::unique_ptr<core::StorageConnection>>(conn_result));
+
+    core::StorageErr err = metadata_store->initialize(*conn);
+    if (!err.success()) {
+        return err;
+    }
+    err = data_store->initialize(*conn);
+    if (!err.success()) {
+        return err;
+    }
+
+    boost::uuids::random_generator gen;
+    core::Scheduler scheduler{gen(), cLoopbackAddr, port};
+    err = metadata_store->add_scheduler(*conn, scheduler);
+    if (!err.success()) {
+        return err;
+    }
+    core::Driver const worker{gen()};
+    err = metadata_store->add_driver(*conn, worker);
+    if (!err.success()) {
+        metadata_store->remove_driver(*conn, scheduler.get_id());
+        return err;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    return std::unique_ptr<EmbeddedHost>{new EmbeddedHost{
+            std::move(storage_factory),
+            std::move(metadata_store),
+            std::move(data_store),
+            std::move(scheduler),
+            worker,
+            num_slots
+    }};
+}
+
+auto EmbeddedHost::stop() -> void {
+    if (m_stopped) {
+        return;
+    }
+    m_stopped = true;
+
+    core::StopFlag::request_stop();
+    // The worker stops first, since its slots wait for the scheduler to answer their requests
+    m_task_thread.join();
+    m_maintenance_thread.join();
+    m_server->stop();
+    // Closes the listening socket, so that the port can be reused
+    m_server = nullptr;
+
+    std::variant<std::unique_ptr<core::StorageConnection>, core::StorageErr> conn_result
+            = m_storage_factory->provide_storage_connection();
+    if (std::holds_alternative<core::StorageErr>(conn_result)) {
+        spdlog::error(
+                "Failed to connect to storage: {}",
+                std::get<core::StorageErr>(conn_result).description
+        );
+    } else {
+        auto const& conn = std::get<std::unique_ptr<core::StorageConnection>>(conn_result);
+        m_metadata_store->remove_driver(*conn, m_worker.get_id());
+        m_metadata_store->remove_driver(*conn, m_scheduler.get_id());
+    }
+
+    core::StopFlag::reset();
+}
+
+auto EmbeddedHost::maintenance_loop() -> void {
+    int fail_count = 0;
+    int num_rounds = 0;
+    while (!core::StopFlag::is_stop_requested()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::variant<std::unique_ptr<core::StorageConnection>, core::StorageErr> conn_result
+                = m_storage_factory->provide_storage_connection();
+        if (std::holds_alternative<core::StorageErr>(conn_result)) {
+            spdlog::error(
+                    "Failed to connect to storage: {}",
+                    std::get<core::StorageErr>(conn_result).description
+            );
+            fail_count++;
+            if (fail_count >= cRetryCount - 1) {
+                core::StopFlag::request_stop();
+                break;
+            }
+            continue;
+        }
+        auto const conn
+                = std::move(std::get<std::unique_ptr<core::StorageConnection>>(conn_result));
+
+        core::StorageErr err = m_metadata_store->update_heartbeat(*conn, m_scheduler.get_id());
+        if (err.success()) {
+            err = m_metadata_store->update_heartbeat(*conn, m_worker.get_id());
+        }
+        if (!err.success()) {
+            spdlog::error("Failed to update heartbeat: {}", err.description);
+            fail_count++;
+        } else {
+            fail_count = 0;
+        }
+        if (fail_count >= cRetryCount - 1) {
+            core::StopFlag::request_stop();
+            break;
+        }
+
+        std::vector<boost::uuids::uuid> task_ids;
+        err = m_metadata_store->recover_dead_worker_tasks(
+                *conn,
+                static_cast<double>(cWorkerHeartbeatTimeout),
+                &task_ids
+        );
+        if (!err.success()) {
+            spdlog::error("Failed to recover tasks of dead workers: {}", err.description);
+        } else if (!task_ids.empty()) {
+            spdlog::warn("Rescheduled {} tasks of dead workers", task_ids.size());
+            m_server->notify_tasks_ready();
+        }
+
+        if (++num_rounds < cCleanupInterval) {
+            continue;
+        }
+        num_rounds = 0;
+        spdlog::debug("Starting cleanup");
+        err = m_metadata_store->remove_stale_submitting_jobs(*conn, cSubmittingJobTimeout);
+        if (!err.success()) {
+            spdlog::error("Failed to remove stale submitting jobs: {}", err.description);
+        }
+        m_data_store->remove_dangling_data(*conn);
+        spdlog::debug("Finished cleanup");
+    }
+}
+
+// NOLINTBEGIN(clang-analyzer-unix.BlockInCriticalSection)
+auto EmbeddedHost::task_loop() -> void {
+    boost::asio::io_context context;
+    boost::asio::thread_pool blocking_pool{m_num_slots * cNumBlockingCallsPerSlot};
+    // One more connection for the result submitter
+    core::StorageConnectionPool conn_pool{m_storage_factory, m_num_slots + 1};
+    worker::ResultSubmitter
+            submitter{m_metadata_store, conn_pool, cResultFlushInterval, cResultBatchSize};
+    worker::TaskFetcher fetcher{*m_client};
+    for (std::size_t slot = 0; slot < m_num_slots; ++slot) {
+        boost::asio::co_spawn(
+                context,
+                slot_loop(
+                        context,
+                        blocking_pool,
+                        fetcher,
+                        conn_pool,
+                        submitter,
+                        m_metadata_store,
+                        *m_in_process_executor
+                ),
+                boost::asio::detached
+        );
+    }
+    // Returns once every slot stops
+    context.run();
+    blocking_pool.join();
+}
+
+// NOLINTEND(clang-analyzer-unix.BlockInCriticalSection)
+}  // namespace spider::embedded
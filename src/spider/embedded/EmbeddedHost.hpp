@@ -0,0 +1,106 @@
+#ifndef SPIDER_EMBEDDED_EMBEDDEDHOST_HPP
+#define SPIDER_EMBEDDED_EMBEDDEDHOST_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <variant>
+
+#include <spider/core/Driver.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/scheduler/SchedulerServer.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+#include <spider/storage/StorageFactory.hpp>
+#include <spider/worker/InProcessExecutor.hpp>
+#include <spider/worker/WorkerClient.hpp>
+
+namespace spider::embedded {
+/**
+ * Runs a scheduler and a worker inside the calling process, so that a driver can run jobs without
+ * starting any other spider process. This is the way to use `memory://` storage, which other
+ * processes cannot reach.
+ *
+ * The worker runs the C++ tasks registered in the process on an in-process executor, and fails
+ * tasks of other languages. It fetches tasks from the scheduler over a loopback connection, the
+ * same way as a worker process.
+ *
+ * The host stops with the process-wide `StopFlag`, so only one host can run in a process at a time,
+ * and not alongside the main loop of a scheduler or worker binary.
+ */
+class EmbeddedHost {
+public:
+    // Delete copy & move constructors and assignment operators
+    EmbeddedHost(EmbeddedHost const&) = delete;
+    auto operator=(EmbeddedHost const&) -> EmbeddedHost& = delete;
+    EmbeddedHost(EmbeddedHost&&) = delete;
+    auto operator=(EmbeddedHost&&) -> EmbeddedHost& = delete;
+
+    /**
+     * Stops the host if it is still running.
+     */
+    ~EmbeddedHost();
+
+    /**
+     * Initializes the storage, registers the scheduler and the worker, and starts them.
+     *
+     * @param storage_url
+     * @param port Port the scheduler listens on for the worker.
+     * @param num_slots Number of tasks the worker runs at once. Must be positive.
+     * @return The running host on success.
+     * @return The storage error if the storage cannot be initialized or the scheduler or worker
+     * cannot be registered.
+     */
+    static auto start(std::string const& storage_url, unsigned short port, std::size_t num_slots)
+            -> std::variant<std::unique_ptr<EmbeddedHost>, core::StorageErr>;
+
+    /**
+     * Stops the worker once its running tasks return, then stops the scheduler and unregisters
+     * both. Tasks fetched but not started are rescheduled by the next scheduler once the worker is
+     * found dead.
+     */
+    auto stop() -> void;
+
+private:
+    EmbeddedHost(
+            std::shared_ptr<core::StorageFactory> storage_factory,
+            std::shared_ptr<core::MetadataStorage> metadata_store,
+            std::shared_ptr<core::DataStorage> data_store,
+            core::Scheduler scheduler,
+            core::Driver worker,
+            std::size_t num_slots
+    );
+
+    /**
+     * Updates the heartbeats of the scheduler and the worker, reschedules the tasks of dead workers
+     * connected to the scheduler, and periodically cleans up the storage. Returns once a stop is
+     * requested.
+     */
+    auto maintenance_loop() -> void;
+
+    /**
+     * Runs the task slots of the worker. Returns once a stop is requested and every slot stops.
+     */
+    auto task_loop() -> void;
+
+    std::shared_ptr<core::StorageFactory> m_storage_factory;
+    std::shared_ptr<core::MetadataStorage> m_metadata_store;
+    std::shared_ptr<core::DataStorage> m_data_store;
+    core::Scheduler m_scheduler;
+    core::Driver m_worker;
+    std::size_t m_num_slots;
+
+    std::shared_ptr<core::StorageConnectionPool> m_server_conn_pool;
+    std::unique_ptr<scheduler::SchedulerServer> m_server;
+    std::unique_ptr<worker::InProcessExecutor> m_in_process_executor;
+    std::unique_ptr<worker::WorkerClient> m_client;
+
+    std::thread m_maintenance_thread;
+    std::thread m_task_thread;
+    bool m_stopped = false;
+};
+}  // namespace spider::embedded
+
+#endif
@@ -26,6 +26,8 @@
 #include <boost/asio/detached.hpp>
 #include <boost/asio/impl/co_spawn.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <boost/asio/use_future.hpp>
 #include <boost/asio/executor_work_guard.hpp>
@@ -0,0 +1,100 @@
+#include "FairSharePolicy.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Task.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::scheduler {
+FairSharePolicy::FairSharePolicy(
+        boost::uuids::uuid const scheduler_id,
+        std::shared_ptr<core::MetadataStorage> const& metadata_store,
+        std::shared_ptr<core::DataStorage> const& data_store,
+        std::shared_ptr<core::StorageConnectionPool> const& conn_pool,
+        absl::flat_hash_map<boost::uuids::uuid, double> client_weights
+)
+        : m_data_store{data_store},
+          m_fetcher{scheduler_id, metadata_store, conn_pool},
+          m_client_weights{std::move(client_weights)} {}
+
+auto FairSharePolicy::schedule_fetched(
+        boost::uuids::uuid const /*worker_id*/,
+        std::string const& worker_addr
+) -> std::optional<core::ScheduleTaskMetadata> {
+    std::lock_guard const lock{m_mutex};
+    return pop_next_task(worker_addr);
+}
+
+auto FairSharePolicy::pop_next_task(std::string const& worker_addr)
+        -> std::optional<core::ScheduleTaskMetadata> {
+    for (auto it = m_active_clients.begin(); it != m_active_clients.end(); ++it) {
+        auto const [virtual_time, client_id] = *it;
+        ClientQueue& client = m_clients.at(client_id);
+        std::optional<core::ScheduleTaskMetadata> task = client.tasks.pop(worker_addr);
+        if (false == task.has_value()) {
+            continue;
+        }
+        --m_num_tasks;
+        m_virtual_time = virtual_time;
+        m_active_clients.erase(it);
+        client.virtual_time = virtual_time + 1.0 / client.weight;
+        if (false == client.tasks.empty()) {
+            m_active_clients.emplace(client.virtual_time, client_id);
+        }
+        return task;
+    }
+    return std::nullopt;
+}
+
+auto FairSharePolicy::fetch_tasks() -> bool {
+    std::vector<core::ScheduleTaskMetadata> tasks;
+    m_fetcher.fetch_per_client(&tasks);
+
+    std::lock_guard const lock{m_mutex};
+    return push_tasks(std::move(tasks));
+}
+
+auto FairSharePolicy::requeue_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> void {
+    std::lock_guard const lock{m_mutex};
+    push_tasks(std::move(tasks));
+}
+
+auto FairSharePolicy::push_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> bool {
+    std::size_t const num_tasks = m_num_tasks;
+    for (core::ScheduleTaskMetadata& task : tasks) {
+        boost::uuids::uuid const client_id = task.get_client_id();
+        auto const [it, inserted] = m_clients.try_emplace(client_id);
+        ClientQueue& client = it->second;
+        if (inserted) {
+            auto const weight_it = m_client_weights.find(client_id);
+            if (m_client_weights.end() != weight_it) {
+                client.weight = weight_it->second;
+            }
+        }
+        bool const was_active = false == client.tasks.empty();
+        std::size_t const num_client_tasks = client.tasks.size();
+        client.tasks.push(std::move(task));
+        if (client.tasks.size() == num_client_tasks) {
+            continue;
+        }
+        ++m_num_tasks;
+        if (false == was_active) {
+            client.virtual_time = std::max(client.virtual_time, m_virtual_time);
+            m_active_clients.emplace(client.virtual_time, client_id);
+        }
+    }
+    return m_num_tasks != num_tasks;
+}
+}  // namespace spider::scheduler
@@ -0,0 +1,97 @@
+#ifndef SPIDER_SCHEDULER_FAIRSHAREPOLICY_HPP
+#define SPIDER_SCHEDULER_FAIRSHAREPOLICY_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Task.hpp>
+#include <spider/scheduler/ReadyQueue.hpp>
+#include <spider/scheduler/ReadyTaskFetcher.hpp>
+#include <spider/scheduler/SchedulerPolicy.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::scheduler {
+/**
+ * A weighted fair queueing policy across clients.
+ *
+ * Each client has a virtual time that advances by `1 / weight` for every task dispatched to it.
+ * The next task comes from the client with the smallest virtual time that has a task the worker
+ * can run; within a client, tasks are dispatched in job creation order. A client that becomes
+ * active again starts from the current virtual time, so idle clients do not bank credit.
+ *
+ * Ready tasks are fetched a page per client, so a client with more queued tasks than fit in a page
+ * does not starve the others.
+ *
+ * Active clients are kept ordered by virtual time, so a dispatch costs O(log clients) unless hard
+ * localities rule out the tasks of the first clients in order.
+ */
+class FairSharePolicy final : public SchedulerPolicy {
+public:
+    static constexpr double cDefaultWeight = 1.0;
+
+    /**
+     * @param scheduler_id
+     * @param metadata_store
+     * @param data_store
+     * @param conn_pool Pool of the connections used to fetch ready tasks.
+     * @param client_weights Weights of clients. Clients not in the map get `cDefaultWeight`. All
+     * weights must be positive.
+     */
+    FairSharePolicy(
+            boost::uuids::uuid scheduler_id,
+            std::shared_ptr<core::MetadataStorage> const& metadata_store,
+            std::shared_ptr<core::DataStorage> const& data_store,
+            std::shared_ptr<core::StorageConnectionPool> const& conn_pool,
+            absl::flat_hash_map<boost::uuids::uuid, double> client_weights = {}
+    );
+
+    auto schedule_fetched(boost::uuids::uuid worker_id, std::string const& worker_addr)
+            -> std::optional<core::ScheduleTaskMetadata> override;
+
+    auto fetch_tasks() -> bool override;
+
+    auto requeue_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> void override;
+
+private:
+    struct ClientQueue {
+        ReadyQueue tasks;
+        double virtual_time = 0;
+        double weight = cDefaultWeight;
+    };
+
+    auto pop_next_task(std::string const& worker_addr)
+            -> std::optional<core::ScheduleTaskMetadata>;
+
+    /**
+     * Adds tasks to the fetched tasks. Must be called with `m_mutex` held.
+     *
+     * @param tasks
+     * @return Whether any task the policy did not have yet is added.
+     */
+    auto push_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> bool;
+
+    std::shared_ptr<core::DataStorage> m_data_store;
+    ReadyTaskFetcher m_fetcher;
+    std::mutex m_mutex;
+
+    absl::flat_hash_map<boost::uuids::uuid, double> m_client_weights;
+    absl::flat_hash_map<boost::uuids::uuid, ClientQueue> m_clients;
+    // Clients with queued tasks, ordered by virtual time
+    std::set<std::pair<double, boost::uuids::uuid>> m_active_clients;
+    double m_virtual_time = 0;
+    std::size_t m_num_tasks = 0;
+};
+}  // namespace spider::scheduler
+
+#endif  // SPIDER_SCHEDULER_FAIRSHAREPOLICY_HPP
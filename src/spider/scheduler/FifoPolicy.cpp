@@ -1,11 +1,11 @@
 #include "FifoPolicy.hpp"
 
-#include <algorithm>
 #include <cstddef>
-#include <iterator>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/uuid/uuid.hpp>
@@ -13,67 +13,49 @@
 #include <spider/core/Task.hpp>
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
-#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 
 namespace spider::scheduler {
 FifoPolicy::FifoPolicy(
         boost::uuids::uuid const scheduler_id,
         std::shared_ptr<core::MetadataStorage> const& metadata_store,
         std::shared_ptr<core::DataStorage> const& data_store,
-        std::shared_ptr<core::StorageConnection> const& conn
+        std::shared_ptr<core::StorageConnectionPool> const& conn_pool
 )
-        : m_scheduler_id{scheduler_id},
-          m_metadata_store{metadata_store},
-          m_data_store{data_store},
-          m_conn{conn} {}
-
-auto
-FifoPolicy::schedule_next(boost::uuids::uuid const /*worker_id*/, std::string const& worker_addr)
-        -> std::optional<boost::uuids::uuid> {
-    std::optional<boost::uuids::uuid> const next_task = pop_next_task(worker_addr);
-    if (next_task.has_value()) {
-        return next_task;
-    }
-    size_t const num_tasks = m_tasks.size();
-    fetch_tasks();
-    if (m_tasks.size() == num_tasks) {
-        return std::nullopt;
-    }
+        : m_data_store{data_store},
+          m_fetcher{scheduler_id, metadata_store, conn_pool} {}
+
+auto FifoPolicy::schedule_fetched(
+        boost::uuids::uuid const /*worker_id*/,
+        std::string const& worker_addr
+) -> std::optional<core::ScheduleTaskMetadata> {
+    std::lock_guard const lock{m_mutex};
     return pop_next_task(worker_addr);
 }
 
 auto FifoPolicy::pop_next_task(std::string const& worker_addr)
-        -> std::optional<boost::uuids::uuid> {
-    auto const reverse_begin = std::reverse_iterator(m_tasks.end());
-    auto const reverse_end = std::reverse_iterator(m_tasks.begin());
-    auto const it
-            = std::find_if(reverse_begin, reverse_end, [&](core::ScheduleTaskMetadata const& task) {
-                  std::vector<std::string> const& hard_localities = task.get_hard_localities();
-                  if (hard_localities.empty()) {
-                      return true;
-                  }
-                  // If the worker address is in the hard localities, then the task can be
-                  // scheduled.
-                  return std::ranges::find(hard_localities, worker_addr) != hard_localities.end();
-              });
-    if (it == reverse_end) {
-        return std::nullopt;
-    }
-    boost::uuids::uuid const task_id = it->get_id();
-    m_tasks.erase(std::next(it).base());
-    return task_id;
+        -> std::optional<core::ScheduleTaskMetadata> {
+    return m_tasks.pop(worker_addr);
 }
 
-auto FifoPolicy::fetch_tasks() -> void {
-    m_metadata_store->get_ready_tasks(*m_conn, m_scheduler_id, &m_tasks);
-    m_metadata_store->get_task_timeout(*m_conn, &m_tasks);
+auto FifoPolicy::fetch_tasks() -> bool {
+    std::vector<core::ScheduleTaskMetadata> tasks;
+    m_fetcher.fetch(&tasks);
 
-    // Sort tasks based on job creation time in descending order.
-    std::ranges::sort(
-            m_tasks,
-            [&](core::ScheduleTaskMetadata const& a, core::ScheduleTaskMetadata const& b) {
-                return a.get_job_creation_time() > b.get_job_creation_time();
-            }
-    );
+    std::lock_guard const lock{m_mutex};
+    return push_tasks(std::move(tasks));
+}
+
+auto FifoPolicy::requeue_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> void {
+    std::lock_guard const lock{m_mutex};
+    push_tasks(std::move(tasks));
+}
+
+auto FifoPolicy::push_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> bool {
+    std::size_t const num_tasks = m_tasks.size();
+    for (core::ScheduleTaskMetadata& task : tasks) {
+        m_tasks.push(std::move(task));
+    }
+    return m_tasks.size() != num_tasks;
 }
 }  // namespace spider::scheduler
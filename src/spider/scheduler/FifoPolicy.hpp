@@ -2,6 +2,7 @@
 #define SPIDER_SCHEDULER_FIFOPOLICY_HPP
 
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -9,10 +10,12 @@
 #include <boost/uuid/uuid.hpp>
 
 #include <spider/core/Task.hpp>
+#include <spider/scheduler/ReadyQueue.hpp>
+#include <spider/scheduler/ReadyTaskFetcher.hpp>
 #include <spider/scheduler/SchedulerPolicy.hpp>
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
-#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 
 namespace spider::scheduler {
 class FifoPolicy final : public SchedulerPolicy {
@@ -21,24 +24,33 @@ public:
             boost::uuids::uuid scheduler_id,
             std::shared_ptr<core::MetadataStorage> const& metadata_store,
             std::shared_ptr<core::DataStorage> const& data_store,
-            std::shared_ptr<core::StorageConnection> const& conn
+            std::shared_ptr<core::StorageConnectionPool> const& conn_pool
     );
 
-    auto schedule_next(boost::uuids::uuid worker_id, std::string const& worker_addr)
-            -> std::optional<boost::uuids::uuid> override;
+    auto schedule_fetched(boost::uuids::uuid worker_id, std::string const& worker_addr)
+            -> std::optional<core::ScheduleTaskMetadata> override;
 
-private:
-    auto fetch_tasks() -> void;
+    auto fetch_tasks() -> bool override;
+
+    auto requeue_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> void override;
 
-    auto pop_next_task(std::string const& worker_addr) -> std::optional<boost::uuids::uuid>;
+private:
+    auto pop_next_task(std::string const& worker_addr)
+            -> std::optional<core::ScheduleTaskMetadata>;
 
-    boost::uuids::uuid m_scheduler_id;
+    /**
+     * Adds tasks to the fetched tasks. Must be called with `m_mutex` held.
+     *
+     * @param tasks
+     * @return Whether any task the policy did not have yet is added.
+     */
+    auto push_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> bool;
 
-    std::shared_ptr<core::MetadataStorage> m_metadata_store;
     std::shared_ptr<core::DataStorage> m_data_store;
-    std::shared_ptr<core::StorageConnection> m_conn;
+    ReadyTaskFetcher m_fetcher;
+    std::mutex m_mutex;
 
-    std::vector<core::ScheduleTaskMetadata> m_tasks;
+    ReadyQueue m_tasks;
 };
 }  // namespace spider::scheduler
 
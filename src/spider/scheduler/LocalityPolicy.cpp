@@ -0,0 +1,79 @@
+#include "LocalityPolicy.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Task.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::scheduler {
+LocalityPolicy::LocalityPolicy(
+        boost::uuids::uuid const scheduler_id,
+        std::shared_ptr<core::MetadataStorage> const& metadata_store,
+        std::shared_ptr<core::DataStorage> const& data_store,
+        std::shared_ptr<core::StorageConnectionPool> const& conn_pool,
+        std::size_t const max_skips
+)
+        : m_data_store{data_store},
+          m_fetcher{scheduler_id, metadata_store, conn_pool},
+          m_max_skips{max_skips} {}
+
+auto LocalityPolicy::schedule_fetched(
+        boost::uuids::uuid const /*worker_id*/,
+        std::string const& worker_addr
+) -> std::optional<core::ScheduleTaskMetadata> {
+    std::lock_guard const lock{m_mutex};
+    return pop_next_task(worker_addr);
+}
+
+auto LocalityPolicy::pop_next_task(std::string const& worker_addr)
+        -> std::optional<core::ScheduleTaskMetadata> {
+    core::ScheduleTaskMetadata const* head = m_tasks.front(worker_addr);
+    if (nullptr == head) {
+        return std::nullopt;
+    }
+    boost::uuids::uuid task_id = head->get_id();
+
+    core::ScheduleTaskMetadata const* local_task = m_tasks.front_soft_local(worker_addr);
+    if (nullptr != local_task && local_task->get_id() != task_id) {
+        std::size_t& skip_count = m_skip_counts[task_id];
+        if (skip_count < m_max_skips) {
+            ++skip_count;
+            task_id = local_task->get_id();
+        }
+    }
+
+    m_skip_counts.erase(task_id);
+    return m_tasks.erase(task_id);
+}
+
+auto LocalityPolicy::fetch_tasks() -> bool {
+    std::vector<core::ScheduleTaskMetadata> tasks;
+    m_fetcher.fetch(&tasks);
+
+    std::lock_guard const lock{m_mutex};
+    return push_tasks(std::move(tasks));
+}
+
+auto LocalityPolicy::requeue_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> void {
+    std::lock_guard const lock{m_mutex};
+    push_tasks(std::move(tasks));
+}
+
+auto LocalityPolicy::push_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> bool {
+    std::size_t const num_tasks = m_tasks.size();
+    for (core::ScheduleTaskMetadata& task : tasks) {
+        m_tasks.push(std::move(task));
+    }
+    return m_tasks.size() != num_tasks;
+}
+}  // namespace spider::scheduler
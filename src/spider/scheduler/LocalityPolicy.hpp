@@ -0,0 +1,73 @@
+#ifndef SPIDER_SCHEDULER_LOCALITYPOLICY_HPP
+#define SPIDER_SCHEDULER_LOCALITYPOLICY_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Task.hpp>
+#include <spider/scheduler/ReadyQueue.hpp>
+#include <spider/scheduler/ReadyTaskFetcher.hpp>
+#include <spider/scheduler/SchedulerPolicy.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::scheduler {
+/**
+ * A FIFO policy that prefers tasks whose soft localities match the requesting worker.
+ *
+ * A worker is handed the earliest task that lists its address as a soft locality, even if an
+ * earlier task is waiting. Each time the earliest task is passed over this way it is charged one
+ * skip; once it has been skipped `max_skips` times, it is handed to the next worker that can run
+ * it, so no task waits for more than `max_skips` schedule calls.
+ */
+class LocalityPolicy final : public SchedulerPolicy {
+public:
+    static constexpr std::size_t cDefaultMaxSkips = 16;
+
+    LocalityPolicy(
+            boost::uuids::uuid scheduler_id,
+            std::shared_ptr<core::MetadataStorage> const& metadata_store,
+            std::shared_ptr<core::DataStorage> const& data_store,
+            std::shared_ptr<core::StorageConnectionPool> const& conn_pool,
+            std::size_t max_skips = cDefaultMaxSkips
+    );
+
+    auto schedule_fetched(boost::uuids::uuid worker_id, std::string const& worker_addr)
+            -> std::optional<core::ScheduleTaskMetadata> override;
+
+    auto fetch_tasks() -> bool override;
+
+    auto requeue_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> void override;
+
+private:
+    auto pop_next_task(std::string const& worker_addr)
+            -> std::optional<core::ScheduleTaskMetadata>;
+
+    /**
+     * Adds tasks to the fetched tasks. Must be called with `m_mutex` held.
+     *
+     * @param tasks
+     * @return Whether any task the policy did not have yet is added.
+     */
+    auto push_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> bool;
+
+    std::shared_ptr<core::DataStorage> m_data_store;
+    ReadyTaskFetcher m_fetcher;
+    std::mutex m_mutex;
+
+    std::size_t m_max_skips;
+
+    ReadyQueue m_tasks;
+    absl::flat_hash_map<boost::uuids::uuid, std::size_t> m_skip_counts;
+};
+}  // namespace spider::scheduler
+
+#endif  // SPIDER_SCHEDULER_LOCALITYPOLICY_HPP
@@ -0,0 +1,64 @@
+#include "PriorityPolicy.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Task.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::scheduler {
+PriorityPolicy::PriorityPolicy(
+        boost::uuids::uuid const scheduler_id,
+        std::shared_ptr<core::MetadataStorage> const& metadata_store,
+        std::shared_ptr<core::DataStorage> const& data_store,
+        std::shared_ptr<core::StorageConnectionPool> const& conn_pool,
+        std::chrono::system_clock::duration const priority_aging
+)
+        : m_data_store{data_store},
+          m_fetcher{scheduler_id, metadata_store, conn_pool},
+          m_tasks{priority_aging} {}
+
+auto PriorityPolicy::schedule_fetched(
+        boost::uuids::uuid const /*worker_id*/,
+        std::string const& worker_addr
+) -> std::optional<core::ScheduleTaskMetadata> {
+    std::lock_guard const lock{m_mutex};
+    return pop_next_task(worker_addr);
+}
+
+auto PriorityPolicy::pop_next_task(std::string const& worker_addr)
+        -> std::optional<core::ScheduleTaskMetadata> {
+    return m_tasks.pop(worker_addr);
+}
+
+auto PriorityPolicy::fetch_tasks() -> bool {
+    std::vector<core::ScheduleTaskMetadata> tasks;
+    m_fetcher.fetch(&tasks);
+
+    std::lock_guard const lock{m_mutex};
+    return push_tasks(std::move(tasks));
+}
+
+auto PriorityPolicy::requeue_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> void {
+    std::lock_guard const lock{m_mutex};
+    push_tasks(std::move(tasks));
+}
+
+auto PriorityPolicy::push_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> bool {
+    std::size_t const num_tasks = m_tasks.size();
+    for (core::ScheduleTaskMetadata& task : tasks) {
+        m_tasks.push(std::move(task));
+    }
+    return m_tasks.size() != num_tasks;
+}
+}  // namespace spider::scheduler
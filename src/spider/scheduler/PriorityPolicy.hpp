@@ -0,0 +1,69 @@
+#ifndef SPIDER_SCHEDULER_PRIORITYPOLICY_HPP
+#define SPIDER_SCHEDULER_PRIORITYPOLICY_HPP
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Task.hpp>
+#include <spider/scheduler/ReadyQueue.hpp>
+#include <spider/scheduler/ReadyTaskFetcher.hpp>
+#include <spider/scheduler/SchedulerPolicy.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::scheduler {
+/**
+ * A policy that dispatches tasks of high-priority jobs first.
+ *
+ * Lower priorities age: each level of job priority is worth `priority_aging` of waiting time, so a
+ * task of a lower-priority job runs before a task of a higher-priority job created more than
+ * `priority_aging` per priority level later. Within the same priority, tasks run in job creation
+ * order.
+ */
+class PriorityPolicy final : public SchedulerPolicy {
+public:
+    static constexpr std::chrono::seconds cDefaultPriorityAging{60};
+
+    PriorityPolicy(
+            boost::uuids::uuid scheduler_id,
+            std::shared_ptr<core::MetadataStorage> const& metadata_store,
+            std::shared_ptr<core::DataStorage> const& data_store,
+            std::shared_ptr<core::StorageConnectionPool> const& conn_pool,
+            std::chrono::system_clock::duration priority_aging = cDefaultPriorityAging
+    );
+
+    auto schedule_fetched(boost::uuids::uuid worker_id, std::string const& worker_addr)
+            -> std::optional<core::ScheduleTaskMetadata> override;
+
+    auto fetch_tasks() -> bool override;
+
+    auto requeue_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> void override;
+
+private:
+    auto pop_next_task(std::string const& worker_addr)
+            -> std::optional<core::ScheduleTaskMetadata>;
+
+    /**
+     * Adds tasks to the fetched tasks. Must be called with `m_mutex` held.
+     *
+     * @param tasks
+     * @return Whether any task the policy did not have yet is added.
+     */
+    auto push_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> bool;
+
+    std::shared_ptr<core::DataStorage> m_data_store;
+    ReadyTaskFetcher m_fetcher;
+    std::mutex m_mutex;
+
+    ReadyQueue m_tasks;
+};
+}  // namespace spider::scheduler
+
+#endif  // SPIDER_SCHEDULER_PRIORITYPOLICY_HPP
@@ -0,0 +1,173 @@
+#include "ReadyQueue.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Task.hpp>
+
+namespace spider::scheduler {
+namespace {
+// Heaps are only compacted once they hold at least this many stale entries
+constexpr std::size_t cMinCompactEntries = 1024;
+
+/**
+ * @param task
+ * @return The number of heap entries `ReadyQueue::push` adds for the task.
+ */
+auto count_entries(core::ScheduleTaskMetadata const& task) -> std::size_t {
+    std::vector<std::string> const& hard_localities = task.get_hard_localities();
+    if (hard_localities.empty()) {
+        return 1 + task.get_soft_localities().size();
+    }
+    std::size_t num_entries = hard_localities.size();
+    for (std::string const& locality : task.get_soft_localities()) {
+        if (std::ranges::find(hard_localities, locality) != hard_localities.end()) {
+            ++num_entries;
+        }
+    }
+    return num_entries;
+}
+}  // namespace
+
+auto ReadyQueue::push(core::ScheduleTaskMetadata task) -> void {
+    boost::uuids::uuid const task_id = task.get_id();
+    auto const [it, inserted] = m_tasks.try_emplace(task_id, std::move(task));
+    if (false == inserted) {
+        return;
+    }
+    Entry const entry{
+            it->second.get_job_creation_time() - it->second.get_job_priority() * m_priority_aging,
+            m_next_sequence++,
+            task_id
+    };
+    std::vector<std::string> const& hard_localities = it->second.get_hard_localities();
+    if (hard_localities.empty()) {
+        m_unconstrained.push(entry);
+    }
+    for (std::string const& locality : hard_localities) {
+        m_locality_index[locality].push(entry);
+    }
+    for (std::string const& locality : it->second.get_soft_localities()) {
+        // Skip soft localities the task is not allowed to run on
+        if (false == hard_localities.empty()
+            && std::ranges::find(hard_localities, locality) == hard_localities.end())
+        {
+            continue;
+        }
+        m_soft_locality_index[locality].push(entry);
+    }
+    std::size_t const num_entries = count_entries(it->second);
+    m_num_entries += num_entries;
+    m_num_live_entries += num_entries;
+}
+
+auto ReadyQueue::pop(std::string const& worker_addr) -> std::optional<core::ScheduleTaskMetadata> {
+    Heap* heap = select_heap(worker_addr);
+    if (nullptr == heap) {
+        return std::nullopt;
+    }
+    boost::uuids::uuid const task_id = heap->top().task_id;
+    heap->pop();
+    --m_num_entries;
+    return erase(task_id);
+}
+
+auto ReadyQueue::front(std::string const& worker_addr) -> core::ScheduleTaskMetadata const* {
+    Heap const* heap = select_heap(worker_addr);
+    if (nullptr == heap) {
+        return nullptr;
+    }
+    return &m_tasks.find(heap->top().task_id)->second;
+}
+
+auto ReadyQueue::front_soft_local(std::string const& worker_addr)
+        -> core::ScheduleTaskMetadata const* {
+    auto const it = m_soft_locality_index.find(worker_addr);
+    if (m_soft_locality_index.end() == it) {
+        return nullptr;
+    }
+    drop_stale_entries(it->second);
+    if (it->second.empty()) {
+        m_soft_locality_index.erase(it);
+        return nullptr;
+    }
+    return &m_tasks.find(it->second.top().task_id)->second;
+}
+
+auto ReadyQueue::erase(boost::uuids::uuid const task_id)
+        -> std::optional<core::ScheduleTaskMetadata> {
+    auto const it = m_tasks.find(task_id);
+    if (m_tasks.end() == it) {
+        return std::nullopt;
+    }
+    core::ScheduleTaskMetadata task = std::move(it->second);
+    m_tasks.erase(it);
+    m_num_live_entries -= count_entries(task);
+    std::size_t const num_stale_entries = m_num_entries - m_num_live_entries;
+    if (num_stale_entries >= cMinCompactEntries && num_stale_entries > m_num_live_entries) {
+        compact();
+    }
+    return task;
+}
+
+auto ReadyQueue::drop_stale_entries(Heap& heap) -> void {
+    while (false == heap.empty() && false == m_tasks.contains(heap.top().task_id)) {
+        heap.pop();
+        --m_num_entries;
+    }
+}
+
+auto ReadyQueue::compact() -> void {
+    auto const compact_heap = [&](Heap& heap) {
+        std::vector<Entry> entries;
+        entries.reserve(heap.size());
+        while (false == heap.empty()) {
+            if (m_tasks.contains(heap.top().task_id)) {
+                entries.push_back(heap.top());
+            }
+            heap.pop();
+        }
+        heap = Heap{std::greater<>{}, std::move(entries)};
+    };
+    auto const compact_index = [&](absl::flat_hash_map<std::string, Heap>& index) {
+        for (auto& [locality, heap] : index) {
+            compact_heap(heap);
+        }
+        absl::erase_if(index, [](auto const& item) { return item.second.empty(); });
+    };
+    compact_heap(m_unconstrained);
+    compact_index(m_locality_index);
+    compact_index(m_soft_locality_index);
+    m_num_entries = m_num_live_entries;
+}
+
+auto ReadyQueue::select_heap(std::string const& worker_addr) -> Heap* {
+    drop_stale_entries(m_unconstrained);
+    Heap* locality_heap = nullptr;
+    auto const locality_it = m_locality_index.find(worker_addr);
+    if (m_locality_index.end() != locality_it) {
+        drop_stale_entries(locality_it->second);
+        if (locality_it->second.empty()) {
+            m_locality_index.erase(locality_it);
+        } else {
+            locality_heap = &locality_it->second;
+        }
+    }
+
+    if (m_unconstrained.empty()) {
+        return locality_heap;
+    }
+    if (nullptr != locality_heap && m_unconstrained.top() > locality_heap->top()) {
+        return locality_heap;
+    }
+    return &m_unconstrained;
+}
+}  // namespace spider::scheduler
@@ -0,0 +1,149 @@
+#ifndef SPIDER_SCHEDULER_READYQUEUE_HPP
+#define SPIDER_SCHEDULER_READYQUEUE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Task.hpp>
+
+namespace spider::scheduler {
+/**
+ * An in-memory queue of ready tasks ordered by job creation time.
+ *
+ * If a priority aging interval is set, each level of job priority moves a task ahead by that
+ * interval, i.e. tasks are ordered by `job_creation_time - job_priority * priority_aging`. A
+ * high-priority task therefore runs first, but a lower-priority task that has waited long enough
+ * overtakes it. Since every waiting task ages at the same rate, this order never changes while the
+ * tasks wait.
+ *
+ * Tasks without hard locality are kept in one min-heap. Tasks with hard locality are kept in one
+ * min-heap per address in their hard locality list, so a worker only looks at the tasks it is
+ * allowed to run. Popping compares the heads of the two heaps relevant to the worker, which makes
+ * both push and pop O(log n).
+ *
+ * Tasks are also indexed by soft locality, so a policy can look up the earliest task that prefers a
+ * given worker without scanning the queue.
+ *
+ * A task with several localities is referenced from several heaps. Entries of tasks that have
+ * already been removed are dropped lazily when they reach the head of a heap. Entries that never
+ * reach a head, e.g. those of addresses no worker pops from, are dropped by compacting all heaps
+ * once they outnumber the entries of queued tasks, which keeps the memory bounded by the size of
+ * the queue at an amortized O(log n) cost per entry.
+ */
+class ReadyQueue {
+public:
+    ReadyQueue() = default;
+
+    /**
+     * @param priority_aging How far ahead of its job creation time a task is ordered per level of
+     * job priority. Zero ignores job priorities.
+     */
+    explicit ReadyQueue(std::chrono::system_clock::duration const priority_aging)
+            : m_priority_aging{priority_aging} {}
+
+    /**
+     * Adds a task to the queue. Tasks already in the queue are ignored.
+     *
+     * @param task
+     */
+    auto push(core::ScheduleTaskMetadata task) -> void;
+
+    /**
+     * Removes and returns the first task in order that can run on a worker at `worker_addr`. Ties
+     * are broken by insertion order.
+     *
+     * @param worker_addr
+     * @return The popped task.
+     * @return std::nullopt if no task in the queue can run on the worker.
+     */
+    auto pop(std::string const& worker_addr) -> std::optional<core::ScheduleTaskMetadata>;
+
+    /**
+     * @param worker_addr
+     * @return The task `pop` would return for `worker_addr`, without removing it.
+     * @return nullptr if no task in the queue can run on the worker.
+     */
+    auto front(std::string const& worker_addr) -> core::ScheduleTaskMetadata const*;
+
+    /**
+     * @param worker_addr
+     * @return The first task in order that has `worker_addr` as a soft locality and can run on the
+     * worker, without removing it.
+     * @return nullptr if no such task is in the queue.
+     */
+    auto front_soft_local(std::string const& worker_addr) -> core::ScheduleTaskMetadata const*;
+
+    /**
+     * Removes a task from the queue.
+     *
+     * @param task_id
+     * @return The removed task.
+     * @return std::nullopt if the task is not in the queue.
+     */
+    auto erase(boost::uuids::uuid task_id) -> std::optional<core::ScheduleTaskMetadata>;
+
+    [[nodiscard]] auto size() const -> std::size_t { return m_tasks.size(); }
+
+    [[nodiscard]] auto empty() const -> bool { return m_tasks.empty(); }
+
+    /**
+     * @return The number of entries in all heaps, including the entries of removed tasks.
+     */
+    [[nodiscard]] auto get_num_entries() const -> std::size_t { return m_num_entries; }
+
+private:
+    struct Entry {
+        std::chrono::system_clock::time_point order_time;
+        std::uint64_t sequence;
+        boost::uuids::uuid task_id;
+
+        auto operator>(Entry const& other) const -> bool {
+            if (order_time != other.order_time) {
+                return order_time > other.order_time;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    using Heap = std::priority_queue<Entry, std::vector<Entry>, std::greater<>>;
+
+    /**
+     * Pops entries of tasks that are no longer in the queue from the head of the heap.
+     *
+     * @param heap
+     */
+    auto drop_stale_entries(Heap& heap) -> void;
+
+    /**
+     * Removes the entries of removed tasks from all heaps.
+     */
+    auto compact() -> void;
+
+    /**
+     * @param worker_addr
+     * @return The heap whose head is the earliest task that can run on `worker_addr`.
+     * @return nullptr if no task in the queue can run on the worker.
+     */
+    auto select_heap(std::string const& worker_addr) -> Heap*;
+
+    Heap m_unconstrained;
+    absl::flat_hash_map<std::string, Heap> m_locality_index;
+    absl::flat_hash_map<std::string, Heap> m_soft_locality_index;
+    absl::flat_hash_map<boost::uuids::uuid, core::ScheduleTaskMetadata> m_tasks;
+    std::uint64_t m_next_sequence = 0;
+    std::size_t m_num_entries = 0;
+    std::size_t m_num_live_entries = 0;
+    std::chrono::system_clock::duration m_priority_aging{0};
+};
+}  // namespace spider::scheduler
+
+#endif  // SPIDER_SCHEDULER_READYQUEUE_HPP
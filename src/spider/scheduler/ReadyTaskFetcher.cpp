@@ -0,0 +1,131 @@
+#include "ReadyTaskFetcher.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <boost/uuid/uuid.hpp>
+#include <spdlog/spdlog.h>
+
+#include <spider/core/Error.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/scheduler/SchedulerPolicy.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::scheduler {
+ReadyTaskFetcher::ReadyTaskFetcher(
+        boost::uuids::uuid const scheduler_id,
+        std::shared_ptr<core::MetadataStorage> const& metadata_store,
+        std::shared_ptr<core::StorageConnectionPool> const& conn_pool
+)
+        : m_scheduler_id{scheduler_id},
+          m_metadata_store{metadata_store},
+          m_conn_pool{conn_pool} {}
+
+auto ReadyTaskFetcher::fetch(std::vector<core::ScheduleTaskMetadata>* tasks) -> void {
+    std::lock_guard const lock{m_mutex};
+    std::variant<core::StorageConnectionPool::Lease, core::StorageErr> conn_result
+            = m_conn_pool->acquire();
+    if (std::holds_alternative<core::StorageErr>(conn_result)) {
+        spdlog::error(
+                "Failed to connect to storage: {}",
+                std::get<core::StorageErr>(conn_result).description
+        );
+        return;
+    }
+    core::StorageConnectionPool::Lease const& conn
+            = std::get<core::StorageConnectionPool::Lease>(conn_result);
+
+    fetch_page(*conn, std::nullopt, SchedulerPolicy::cMaxFetchTasks, &m_cursor, tasks);
+    m_metadata_store->get_task_timeout(*conn, tasks);
+}
+
+auto ReadyTaskFetcher::fetch_per_client(std::vector<core::ScheduleTaskMetadata>* tasks) -> void {
+    std::lock_guard const lock{m_mutex};
+    std::variant<core::StorageConnectionPool::Lease, core::StorageErr> conn_result
+            = m_conn_pool->acquire();
+    if (std::holds_alternative<core::StorageErr>(conn_result)) {
+        spdlog::error(
+                "Failed to connect to storage: {}",
+                std::get<core::StorageErr>(conn_result).description
+        );
+        return;
+    }
+    core::StorageConnectionPool::Lease const& conn
+            = std::get<core::StorageConnectionPool::Lease>(conn_result);
+
+    std::vector<boost::uuids::uuid> client_ids;
+    core::StorageErr const err = m_metadata_store->get_ready_clients(*conn, &client_ids);
+    if (false == err.success()) {
+        spdlog::error("Failed to get clients with ready tasks: {}", err.description);
+        return;
+    }
+
+    // Forget the cursors of clients without ready tasks
+    absl::flat_hash_map<boost::uuids::uuid, boost::uuids::uuid> client_cursors;
+    std::size_t const num_clients = std::max<std::size_t>(client_ids.size(), 1);
+    std::size_t const max_num_client_tasks
+            = std::max<std::size_t>(SchedulerPolicy::cMaxFetchTasks / num_clients, 1);
+    for (boost::uuids::uuid const& client_id : client_ids) {
+        std::optional<boost::uuids::uuid> cursor;
+        if (auto const it = m_client_cursors.find(client_id); m_client_cursors.end() != it) {
+            cursor = it->second;
+        }
+        fetch_page(*conn, client_id, max_num_client_tasks, &cursor, tasks);
+        if (cursor.has_value()) {
+            client_cursors.emplace(client_id, cursor.value());
+        }
+    }
+    m_client_cursors = std::move(client_cursors);
+    m_metadata_store->get_task_timeout(*conn, tasks);
+}
+
+auto ReadyTaskFetcher::fetch_page(
+        core::StorageConnection& conn,
+        std::optional<boost::uuids::uuid> const& client_id,
+        std::size_t const max_num_tasks,
+        std::optional<boost::uuids::uuid>* cursor,
+        std::vector<core::ScheduleTaskMetadata>* tasks
+) -> void {
+    std::vector<core::ScheduleTaskMetadata> ready_tasks;
+    m_metadata_store->get_ready_tasks(
+            conn,
+            m_scheduler_id,
+            client_id,
+            *cursor,
+            max_num_tasks,
+            &ready_tasks
+    );
+    if (ready_tasks.empty() && cursor->has_value()) {
+        // The previous page was the last one, or the cursor task is removed
+        m_metadata_store->get_ready_tasks(
+                conn,
+                m_scheduler_id,
+                client_id,
+                std::nullopt,
+                max_num_tasks,
+                &ready_tasks
+        );
+    }
+    if (ready_tasks.size() < max_num_tasks) {
+        *cursor = std::nullopt;
+    } else {
+        *cursor = ready_tasks.back().get_id();
+    }
+
+    tasks->insert(
+            tasks->end(),
+            std::make_move_iterator(ready_tasks.begin()),
+            std::make_move_iterator(ready_tasks.end())
+    );
+}
+}  // namespace spider::scheduler
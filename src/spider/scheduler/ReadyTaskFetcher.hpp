@@ -0,0 +1,95 @@
+#ifndef SPIDER_SCHEDULER_READYTASKFETCHER_HPP
+#define SPIDER_SCHEDULER_READYTASKFETCHER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Task.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::scheduler {
+/**
+ * Fetches ready tasks from the storage for a scheduling policy, one page of at most
+ * `SchedulerPolicy::cMaxFetchTasks` tasks at a time.
+ *
+ * Consecutive fetches page through the ready tasks in priority order with a keyset cursor on the
+ * last fetched task, so tasks beyond the first page are fetched even while the tasks of the first
+ * page cannot be scheduled, e.g. because no worker matches their hard locality. After the last
+ * page, fetching starts over from the highest priority task.
+ *
+ * Policies that share the workers across clients fetch a page per client instead, so that a client
+ * with many queued tasks cannot fill every page and hide the tasks of other clients.
+ *
+ * Each fetch checks a connection out of the pool, so policies can fetch without holding the lock
+ * that guards their ready queue.
+ */
+class ReadyTaskFetcher {
+public:
+    ReadyTaskFetcher(
+            boost::uuids::uuid scheduler_id,
+            std::shared_ptr<core::MetadataStorage> const& metadata_store,
+            std::shared_ptr<core::StorageConnectionPool> const& conn_pool
+    );
+
+    /**
+     * Fetches the next page of ready tasks, together with the tasks whose instances all timed out.
+     * Concurrent fetches are serialized.
+     *
+     * @param tasks Output vector the fetched tasks are appended to. Left untouched if no storage
+     * connection is available.
+     */
+    auto fetch(std::vector<core::ScheduleTaskMetadata>* tasks) -> void;
+
+    /**
+     * Fetches the next page of ready tasks of every client with ready tasks, together with the
+     * tasks whose instances all timed out. The `SchedulerPolicy::cMaxFetchTasks` tasks of a fetch
+     * are split evenly across the clients, with at least one task per client. Each client is paged
+     * through with its own cursor. Concurrent fetches are serialized.
+     *
+     * @param tasks Output vector the fetched tasks are appended to. Left untouched if no storage
+     * connection is available.
+     */
+    auto fetch_per_client(std::vector<core::ScheduleTaskMetadata>* tasks) -> void;
+
+private:
+    /**
+     * Fetches the page of ready tasks after a cursor, starting over from the first page if there
+     * is no task after the cursor, and moves the cursor to the end of the fetched page.
+     *
+     * @param conn
+     * @param client_id The client whose tasks are fetched. std::nullopt to fetch tasks of all
+     * clients.
+     * @param max_num_tasks
+     * @param cursor
+     * @param tasks Output vector the fetched tasks are appended to.
+     */
+    auto fetch_page(
+            core::StorageConnection& conn,
+            std::optional<boost::uuids::uuid> const& client_id,
+            std::size_t max_num_tasks,
+            std::optional<boost::uuids::uuid>* cursor,
+            std::vector<core::ScheduleTaskMetadata>* tasks
+    ) -> void;
+
+    boost::uuids::uuid m_scheduler_id;
+
+    std::shared_ptr<core::MetadataStorage> m_metadata_store;
+    std::shared_ptr<core::StorageConnectionPool> m_conn_pool;
+
+    std::mutex m_mutex;
+    // Last task of the previous page. std::nullopt if the next fetch starts from the first page.
+    std::optional<boost::uuids::uuid> m_cursor;
+    // Last task of the previous page of each client, for fetches per client
+    absl::flat_hash_map<boost::uuids::uuid, boost::uuids::uuid> m_client_cursors;
+};
+}  // namespace spider::scheduler
+
+#endif  // SPIDER_SCHEDULER_READYTASKFETCHER_HPP
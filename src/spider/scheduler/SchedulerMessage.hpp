@@ -1,12 +1,15 @@
 #ifndef SPIDER_SCHEDULER_SCHEDULERMESSAGE_HPP
 #define SPIDER_SCHEDULER_SCHEDULERMESSAGE_HPP
 
+#include <cstddef>
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/uuid/uuid.hpp>
 
+#include <spider/core/Task.hpp>
 #include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
 #include <spider/io/Serializer.hpp>  // IWYU pragma: keep
 
@@ -31,6 +34,24 @@ public:
               m_worker_addr{std::move(addr)},
               m_task_id{task_id} {}
 
+    /**
+     * @param worker_id
+     * @param addr
+     * @param task_id The id of the previously failed task, if any.
+     * @param num_tasks The maximum number of tasks to assign in one response. The scheduler may
+     * assign fewer tasks, as it caps the number of tasks per response.
+     */
+    ScheduleTaskRequest(
+            boost::uuids::uuid const worker_id,
+            std::string addr,
+            std::optional<boost::uuids::uuid> const& task_id,
+            std::size_t const num_tasks
+    )
+            : m_worker_id{worker_id},
+              m_worker_addr{std::move(addr)},
+              m_task_id{task_id},
+              m_num_tasks{num_tasks} {}
+
     [[nodiscard]] auto has_task_id() const -> bool { return m_task_id.has_value(); }
 
     // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
@@ -40,33 +61,125 @@ public:
 
     [[nodiscard]] auto get_worker_addr() const -> std::string const& { return m_worker_addr; }
 
-    MSGPACK_DEFINE_ARRAY(m_worker_id, m_worker_addr, m_task_id);
+    [[nodiscard]] auto get_num_tasks() const -> std::size_t { return m_num_tasks; }
+
+    MSGPACK_DEFINE_ARRAY(m_worker_id, m_worker_addr, m_task_id, m_num_tasks);
 
 private:
     boost::uuids::uuid m_worker_id;
     std::string m_worker_addr;
     // Optional task id if the task fails
     std::optional<boost::uuids::uuid> m_task_id = std::nullopt;
+    std::size_t m_num_tasks = 1;
+};
+
+/**
+ * A task assigned to a worker. The scheduler has already created the task instance, so the worker
+ * can run the task without querying the storage.
+ */
+class ScheduledTask {
+public:
+    /**
+     * Default constructor for msgpack. Do __not__ use it directly.
+     */
+    ScheduledTask() = default;
+
+    /**
+     * @param instance The created task instance.
+     * @param task The task with its inputs and outputs.
+     * @param arg_buffers The serialized arguments of the task.
+     */
+    ScheduledTask(
+            core::TaskInstance const& instance,
+            core::Task const& task,
+            std::vector<msgpack::sbuffer> const& arg_buffers
+    )
+            : m_task_id{instance.task_id},
+              m_instance_id{instance.id},
+              m_function_name{task.get_function_name()},
+              m_language{task.get_language()} {
+        m_args.reserve(arg_buffers.size());
+        for (msgpack::sbuffer const& buffer : arg_buffers) {
+            m_args.emplace_back(buffer.data(), buffer.size());
+        }
+        m_output_types.reserve(task.get_num_outputs());
+        for (core::TaskOutput const& output : task.get_outputs()) {
+            m_output_types.push_back(output.get_type());
+        }
+    }
+
+    [[nodiscard]] auto get_task_id() const -> boost::uuids::uuid { return m_task_id; }
+
+    [[nodiscard]] auto get_instance() const -> core::TaskInstance {
+        return core::TaskInstance{m_instance_id, m_task_id};
+    }
+
+    [[nodiscard]] auto get_function_name() const -> std::string const& { return m_function_name; }
+
+    [[nodiscard]] auto get_language() const -> core::TaskLanguage { return m_language; }
+
+    /**
+     * @return A vector of buffers containing the serialized arguments of the task.
+     */
+    [[nodiscard]] auto get_arg_buffers() const -> std::vector<msgpack::sbuffer> {
+        std::vector<msgpack::sbuffer> arg_buffers(m_args.size());
+        for (std::size_t i = 0; i < m_args.size(); ++i) {
+            arg_buffers[i].write(m_args[i].data(), m_args[i].size());
+        }
+        return arg_buffers;
+    }
+
+    /**
+     * @return The running task with its outputs, which is enough to parse and submit the results.
+     */
+    [[nodiscard]] auto get_task() const -> core::Task {
+        core::Task task{m_task_id, m_function_name, m_language, core::TaskState::Running, 0};
+        for (std::string const& type : m_output_types) {
+            task.add_output(core::TaskOutput{type});
+        }
+        return task;
+    }
+
+    MSGPACK_DEFINE_ARRAY(
+            m_task_id,
+            m_instance_id,
+            m_function_name,
+            m_language,
+            m_args,
+            m_output_types
+    );
+
+private:
+    boost::uuids::uuid m_task_id;
+    boost::uuids::uuid m_instance_id;
+    std::string m_function_name;
+    core::TaskLanguage m_language = core::TaskLanguage::Cpp;
+    std::vector<std::string> m_args;
+    std::vector<std::string> m_output_types;
 };
 
 class ScheduleTaskResponse {
 public:
     ScheduleTaskResponse() = default;
 
-    explicit ScheduleTaskResponse(boost::uuids::uuid const task_id) : m_task_id{task_id} {}
+    explicit ScheduleTaskResponse(std::vector<ScheduledTask> tasks) : m_tasks{std::move(tasks)} {}
 
-    [[nodiscard]] auto has_task_id() const -> bool { return m_task_id.has_value(); }
+    [[nodiscard]] auto has_task_id() const -> bool { return false == m_tasks.empty(); }
 
-    [[nodiscard]] auto get_task_id() const -> boost::uuids::uuid const& {
-        // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
-        return m_task_id.value();
+    [[nodiscard]] auto get_task_id() const -> boost::uuids::uuid {
+        return m_tasks.front().get_task_id();
     }
 
-    MSGPACK_DEFINE_ARRAY(m_task_id);
+    [[nodiscard]] auto get_tasks() const -> std::vector<ScheduledTask> const& { return m_tasks; }
+
+    MSGPACK_DEFINE_ARRAY(m_tasks);
 
 private:
-    std::optional<boost::uuids::uuid> m_task_id = std::nullopt;
+    std::vector<ScheduledTask> m_tasks;
 };
 }  // namespace spider::scheduler
 
+// MSGPACK_ADD_ENUM must be called in global namespace
+MSGPACK_ADD_ENUM(spider::core::TaskLanguage);
+
 #endif  // SPIDER_SCHEDULER_SCHEDULERMESSAGE_HPP
@@ -1,14 +1,22 @@
 #ifndef SPIDER_SCHEDULER_SCHEDULERPOLICY_HPP
 #define SPIDER_SCHEDULER_SCHEDULERPOLICY_HPP
 
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <boost/uuid/uuid.hpp>
 
+#include <spider/core/Task.hpp>
+
 namespace spider::scheduler {
 class SchedulerPolicy {
 public:
+    // Maximum number of ready tasks a policy fetches from the storage at once
+    static constexpr std::size_t cMaxFetchTasks = 1000;
+
     SchedulerPolicy() = default;
     SchedulerPolicy(SchedulerPolicy const&) = default;
     auto operator=(SchedulerPolicy const&) -> SchedulerPolicy& = default;
@@ -16,9 +24,120 @@ public:
     auto operator=(SchedulerPolicy&&) -> SchedulerPolicy& = default;
     virtual ~SchedulerPolicy() = default;
 
-    virtual auto schedule_next(boost::uuids::uuid worker_id, std::string const& worker_addr)
-            -> std::optional<boost::uuids::uuid>
+    /**
+     * Schedules the next task for the worker among the tasks the policy has already fetched,
+     * without accessing the storage. The scheduler server calls this concurrently from several
+     * threads, so implementations must be thread-safe.
+     *
+     * @param worker_id
+     * @param worker_addr
+     * @return The scheduled task. std::nullopt if no fetched task can run on the worker.
+     */
+    virtual auto schedule_fetched(boost::uuids::uuid worker_id, std::string const& worker_addr)
+            -> std::optional<core::ScheduleTaskMetadata>
             = 0;
+
+    /**
+     * Fetches ready tasks from the storage. Implementations must be thread-safe.
+     *
+     * @return Whether any task the policy did not have yet is fetched.
+     */
+    virtual auto fetch_tasks() -> bool = 0;
+
+    /**
+     * Adds scheduled tasks back to the fetched tasks, e.g. because their task instances cannot be
+     * created. Fetching does not return them soon, as it pages past them. Implementations must be
+     * thread-safe.
+     *
+     * @param tasks
+     */
+    virtual auto requeue_tasks(std::vector<core::ScheduleTaskMetadata> tasks) -> void = 0;
+
+    /**
+     * Schedules the next task for the worker, fetching ready tasks from the storage if none of the
+     * fetched tasks can run on the worker.
+     *
+     * @param worker_id
+     * @param worker_addr
+     * @return The id of the scheduled task. std::nullopt if no task is available.
+     */
+    auto schedule_next(boost::uuids::uuid const worker_id, std::string const& worker_addr)
+            -> std::optional<boost::uuids::uuid> {
+        std::optional<core::ScheduleTaskMetadata> task = schedule_fetched(worker_id, worker_addr);
+        if (false == task.has_value() && fetch_tasks()) {
+            task = schedule_fetched(worker_id, worker_addr);
+        }
+        if (false == task.has_value()) {
+            return std::nullopt;
+        }
+        return task->get_id();
+    }
+
+    /**
+     * Schedules up to `max_num_tasks` of the already fetched tasks for the worker.
+     *
+     * @param worker_id
+     * @param worker_addr
+     * @param max_num_tasks
+     * @return The scheduled tasks. Empty if no fetched task can run on the worker.
+     */
+    auto schedule_fetched_batch(
+            boost::uuids::uuid const worker_id,
+            std::string const& worker_addr,
+            std::size_t const max_num_tasks
+    ) -> std::vector<core::ScheduleTaskMetadata> {
+        std::vector<core::ScheduleTaskMetadata> tasks;
+        add_fetched_tasks(worker_id, worker_addr, max_num_tasks, &tasks);
+        return tasks;
+    }
+
+    /**
+     * Schedules up to `max_num_tasks` tasks for the worker. Ready tasks are fetched from the
+     * storage at most once, if the already fetched tasks are not enough.
+     *
+     * @param worker_id
+     * @param worker_addr
+     * @param max_num_tasks
+     * @return The scheduled tasks. Empty if no task is available.
+     */
+    auto schedule_next_batch(
+            boost::uuids::uuid const worker_id,
+            std::string const& worker_addr,
+            std::size_t const max_num_tasks
+    ) -> std::vector<core::ScheduleTaskMetadata> {
+        std::vector<core::ScheduleTaskMetadata> tasks;
+        add_fetched_tasks(worker_id, worker_addr, max_num_tasks, &tasks);
+        if (tasks.size() < max_num_tasks && fetch_tasks()) {
+            add_fetched_tasks(worker_id, worker_addr, max_num_tasks, &tasks);
+        }
+        return tasks;
+    }
+
+private:
+    /**
+     * Appends already fetched tasks scheduled for the worker to `tasks` until it holds
+     * `max_num_tasks` tasks or no fetched task can run on the worker.
+     *
+     * @param worker_id
+     * @param worker_addr
+     * @param max_num_tasks
+     * @param tasks
+     */
+    auto add_fetched_tasks(
+            boost::uuids::uuid const worker_id,
+            std::string const& worker_addr,
+            std::size_t const max_num_tasks,
+            std::vector<core::ScheduleTaskMetadata>* tasks
+    ) -> void {
+        while (tasks->size() < max_num_tasks) {
+            std::optional<core::ScheduleTaskMetadata> task
+                    = schedule_fetched(worker_id, worker_addr);
+            if (false == task.has_value()) {
+                return;
+            }
+            tasks->push_back(std::move(task.value()));
+        }
+    }
 };
 }  // namespace spider::scheduler
 
@@ -1,17 +1,25 @@
 #include "SchedulerServer.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <utility>
+#include <variant>
+#include <vector>
 
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <spdlog/spdlog.h>
 
 #include <spider/core/Error.hpp>
+#include <spider/core/Task.hpp>
 #include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
 #include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
 #include <spider/io/msgpack_message.hpp>
@@ -20,63 +28,106 @@
 #include <spider/scheduler/SchedulerPolicy.hpp>
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
-#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 #include <spider/utils/StopFlag.hpp>
 
 namespace spider::scheduler {
+namespace {
+/**
+ * Interval between two attempts of the dispatcher to assign tasks to pending requests, unless it is
+ * notified earlier. Tasks are also made ready by other processes, e.g. by workers submitting
+ * results, so the dispatcher still polls the storage while requests are waiting.
+ */
+constexpr std::chrono::milliseconds cDispatchInterval{50};
+
+/**
+ * Maximum time a request waits for a task before the server answers with an empty response. This
+ * bounds how long a worker blocks on a session so that it can still react to stop requests.
+ */
+constexpr std::chrono::milliseconds cLongPollTimeout{1000};
+
+/**
+ * Maximum number of tasks assigned to one request, so that a single worker cannot lease the whole
+ * ready queue.
+ */
+constexpr std::size_t cMaxTasksPerRequest = 64;
+}  // namespace
+
 SchedulerServer::SchedulerServer(
         unsigned short const port,
         std::shared_ptr<SchedulerPolicy> policy,
         std::shared_ptr<core::MetadataStorage> metadata_store,
         std::shared_ptr<core::DataStorage> data_store,
-        std::shared_ptr<core::StorageConnection> conn
+        std::shared_ptr<core::StorageConnectionPool> conn_pool,
+        std::size_t const num_threads
 )
         : m_port{port},
           m_policy{std::move(policy)},
           m_metadata_store{std::move(metadata_store)},
           m_data_store{std::move(data_store)},
-          m_conn{std::move(conn)} {
+          m_conn_pool{std::move(conn_pool)},
+          m_storage_pool{std::max<std::size_t>(m_conn_pool->get_max_size(), 1)},
+          m_context{static_cast<int>(std::max<std::size_t>(num_threads, 1))},
+          m_num_threads{std::max<std::size_t>(num_threads, 1)},
+          m_dispatch_strand{boost::asio::make_strand(m_context)},
+          m_dispatch_timer{m_dispatch_strand} {
     boost::asio::co_spawn(m_context, receive_message(), boost::asio::detached);
+    boost::asio::co_spawn(m_dispatch_strand, dispatch_loop(), boost::asio::detached);
     std::lock_guard const lock{m_mutex};
-    m_thread = std::make_unique<std::thread>([&] { m_context.run(); });
+    start_threads();
 }
 
 auto SchedulerServer::pause() -> void {
     std::lock_guard const lock{m_mutex};
-    if (m_thread == nullptr) {
-        return;
-    }
-    m_context.stop();
-    m_thread->join();
-    m_thread = nullptr;
+    stop_threads();
 }
 
 auto SchedulerServer::resume() -> void {
     std::lock_guard const lock{m_mutex};
-    if (m_thread != nullptr) {
+    if (false == m_threads.empty()) {
         return;
     }
-    m_thread = std::make_unique<std::thread>([&] {
-        m_context.restart();
-        m_context.run();
-    });
+    m_context.restart();
+    start_threads();
 }
 
 auto SchedulerServer::stop() -> void {
     std::lock_guard const lock{m_mutex};
-    if (m_thread == nullptr) {
+    stop_threads();
+    // Storage calls in progress finish, and their results are dropped with the stopped context
+    m_storage_pool.stop();
+    m_storage_pool.join();
+}
+
+auto SchedulerServer::notify_tasks_ready() -> void {
+    m_dispatch_requested = true;
+    boost::asio::post(m_dispatch_strand, [this] { m_dispatch_timer.cancel(); });
+}
+
+auto SchedulerServer::start_threads() -> void {
+    m_threads.reserve(m_num_threads);
+    for (std::size_t i = 0; i < m_num_threads; ++i) {
+        m_threads.emplace_back([&] { m_context.run(); });
+    }
+}
+
+auto SchedulerServer::stop_threads() -> void {
+    if (m_threads.empty()) {
         return;
     }
     m_context.stop();
-    m_thread->join();
-    m_thread = nullptr;
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
 }
 
 auto SchedulerServer::receive_message() -> boost::asio::awaitable<void> {
     try {
         boost::asio::ip::tcp::acceptor acceptor{m_context, {boost::asio::ip::tcp::v4(), m_port}};
         while (true) {
-            boost::asio::ip::tcp::socket socket{m_context};
+            // Each session runs on its own strand so that sessions are served in parallel
+            boost::asio::ip::tcp::socket socket{boost::asio::make_strand(m_context)};
             auto const& [ec] = co_await acceptor.async_accept(
                     socket,
                     boost::asio::as_tuple(boost::asio::use_awaitable)
@@ -85,8 +136,9 @@ auto SchedulerServer::receive_message() -> boost::asio::awaitable<void> {
                 spdlog::error("Cannot accept connection {}: {}", ec.value(), ec.what());
                 continue;
             }
+            boost::asio::any_io_executor const executor = socket.get_executor();
             boost::asio::co_spawn(
-                    m_context,
+                    executor,
                     process_message(std::move(socket)),
                     boost::asio::detached
             );
@@ -114,50 +166,83 @@ auto deserialize_message(msgpack::sbuffer const& buffer) -> std::optional<Schedu
 
 auto SchedulerServer::process_message(boost::asio::ip::tcp::socket socket)
         -> boost::asio::awaitable<void> {
-    // NOLINTBEGIN(clang-analyzer-core.CallAndMessage)
-    std::optional<msgpack::sbuffer> const& optional_message_buffer
-            = co_await core::receive_message_async(socket);
-    // NOLINTEND(clang-analyzer-core.CallAndMessage)
+    while (true) {
+        // NOLINTBEGIN(clang-analyzer-core.CallAndMessage)
+        std::optional<msgpack::sbuffer> const& optional_message_buffer
+                = co_await core::receive_message_async(socket);
+        // NOLINTEND(clang-analyzer-core.CallAndMessage)
 
-    if (false == optional_message_buffer.has_value()) {
-        spdlog::error("Cannot receive message from worker");
-        co_return;
-    }
-    msgpack::sbuffer const& message_buffer = optional_message_buffer.value();
-    std::optional<ScheduleTaskRequest> const& optional_request
-            = deserialize_message(message_buffer);
-    if (false == optional_request.has_value()) {
-        spdlog::error("Cannot parse message into schedule task request");
-        co_return;
+        // Worker closes the session
+        if (false == optional_message_buffer.has_value()) {
+            co_return;
+        }
+        msgpack::sbuffer const& message_buffer = optional_message_buffer.value();
+        std::optional<ScheduleTaskRequest> const& optional_request
+                = deserialize_message(message_buffer);
+        if (false == optional_request.has_value()) {
+            spdlog::error("Cannot parse message into schedule task request");
+            co_return;
+        }
+        if (false == co_await process_request(socket, optional_request.value())) {
+            co_return;
+        }
     }
-    ScheduleTaskRequest const& request = optional_request.value();
+}
 
+auto SchedulerServer::process_request(
+        boost::asio::ip::tcp::socket& socket,
+        ScheduleTaskRequest const& request
+) -> boost::asio::awaitable<bool> {
     // Reset the whole job if the task fails
     if (request.has_task_id()) {
-        boost::uuids::uuid job_id;
-        core::StorageErr err
-                = m_metadata_store->get_task_job_id(*m_conn, request.get_task_id(), &job_id);
-        // It is possible the job is deleted, so we don't need to reset it
-        if (!err.success()) {
-            spdlog::error(
-                    "Cannot get job id for task {}",
-                    boost::uuids::to_string(request.get_task_id())
-            );
-        } else {
-            err = m_metadata_store->reset_job(*m_conn, job_id);
-            if (!err.success()) {
-                spdlog::error("Cannot reset job {}", boost::uuids::to_string(job_id));
-                co_return;
-            }
+        boost::uuids::uuid const task_id = request.get_task_id();
+        bool const job_reset
+                = co_await run_on_storage_pool([&] { return reset_failed_job(task_id); });
+        if (false == job_reset) {
+            co_return false;
         }
+        notify_tasks_ready();
     }
 
-    std::optional<boost::uuids::uuid> const task_id
-            = m_policy->schedule_next(request.get_worker_id(), request.get_worker_addr());
-    ScheduleTaskResponse response{};
-    if (task_id.has_value()) {
-        response = ScheduleTaskResponse{task_id.value()};
+    std::size_t const num_tasks
+            = std::clamp<std::size_t>(request.get_num_tasks(), 1, cMaxTasksPerRequest);
+    std::vector<ScheduledTask> tasks = co_await run_on_storage_pool([&] {
+        return assign_tasks(request.get_worker_id(), request.get_worker_addr(), num_tasks, true);
+    });
+    if (false == tasks.empty()) {
+        // The fetch for this request may have brought tasks for waiting requests as well
+        notify_tasks_ready();
+    } else {
+        // Park the request until the dispatcher assigns tasks or the long poll times out
+        auto const pending = std::make_shared<PendingRequest>(
+                socket.get_executor(),
+                request.get_worker_id(),
+                request.get_worker_addr(),
+                num_tasks
+        );
+        pending->timer.expires_after(cLongPollTimeout);
+        {
+            std::lock_guard const lock{m_pending_mutex};
+            m_pending_requests.push_back(pending);
+        }
+        while (true) {
+            co_await pending->timer.async_wait(boost::asio::as_tuple(boost::asio::use_awaitable));
+            std::lock_guard const lock{m_pending_mutex};
+            if (PendingRequest::State::Waiting == pending->state) {
+                pending->state = PendingRequest::State::Completed;
+                m_pending_requests.remove(pending);
+            }
+            if (PendingRequest::State::Completed == pending->state) {
+                tasks = std::move(pending->tasks);
+                break;
+            }
+            // The dispatcher is assigning tasks to the request and completes it once it is done
+            pending->timed_out = true;
+            pending->timer.expires_at(boost::asio::steady_timer::time_point::max());
+        }
     }
+
+    ScheduleTaskResponse const response{std::move(tasks)};
     msgpack::sbuffer response_buffer;
     msgpack::pack(response_buffer, response);
 
@@ -168,7 +253,209 @@ auto SchedulerServer::process_message(boost::asio::ip::tcp::socket socket)
                 boost::uuids::to_string(request.get_worker_id()),
                 request.get_worker_addr()
         );
+        // Undelivered tasks are never run, so schedule them again
+        if (false == response.get_tasks().empty()) {
+            co_await run_on_storage_pool([&] { release_tasks(response.get_tasks()); });
+            notify_tasks_ready();
+        }
+    }
+    co_return success;
+}
+
+auto SchedulerServer::dispatch_loop() -> boost::asio::awaitable<void> {
+    while (true) {
+        if (false == m_dispatch_requested.exchange(false)) {
+            m_dispatch_timer.expires_after(cDispatchInterval);
+            auto const& [ec] = co_await m_dispatch_timer.async_wait(
+                    boost::asio::as_tuple(boost::asio::use_awaitable)
+            );
+            // The timer is cancelled when the dispatcher is notified
+            if (ec && boost::asio::error::operation_aborted != ec) {
+                co_return;
+            }
+            m_dispatch_requested = false;
+        }
+        bool has_pending_requests = false;
+        {
+            std::lock_guard const lock{m_pending_mutex};
+            has_pending_requests = false == m_pending_requests.empty();
+        }
+        if (has_pending_requests) {
+            co_await run_on_storage_pool([this] { dispatch_pending_requests(); });
+        }
+    }
+}
+
+auto SchedulerServer::dispatch_pending_requests() -> void {
+    // Schedule on a snapshot so that sessions can park requests while the policy hits the storage
+    std::vector<std::shared_ptr<PendingRequest>> pending_requests;
+    {
+        std::lock_guard const lock{m_pending_mutex};
+        pending_requests.assign(m_pending_requests.cbegin(), m_pending_requests.cend());
+    }
+
+    // The ready tasks fetched from the storage do not depend on the worker, so serve the requests
+    // from the tasks the policy already has and fetch at most once per round
+    std::vector<std::shared_ptr<PendingRequest>> unserved_requests;
+    for (std::shared_ptr<PendingRequest> const& pending : pending_requests) {
+        if (false == dispatch_fetched_tasks(pending)) {
+            unserved_requests.push_back(pending);
+        }
+    }
+    if (unserved_requests.empty() || false == m_policy->fetch_tasks()) {
+        return;
+    }
+    for (std::shared_ptr<PendingRequest> const& pending : unserved_requests) {
+        dispatch_fetched_tasks(pending);
+    }
+}
+
+auto SchedulerServer::dispatch_fetched_tasks(std::shared_ptr<PendingRequest> const& pending)
+        -> bool {
+    {
+        std::lock_guard const lock{m_pending_mutex};
+        // The long poll timed out since the snapshot was taken
+        if (PendingRequest::State::Waiting != pending->state) {
+            return true;
+        }
+        pending->state = PendingRequest::State::Dispatching;
+        m_pending_requests.remove(pending);
+    }
+
+    std::vector<ScheduledTask> tasks
+            = assign_tasks(pending->worker_id, pending->worker_addr, pending->num_tasks, false);
+    {
+        std::lock_guard const lock{m_pending_mutex};
+        if (tasks.empty() && false == pending->timed_out) {
+            pending->state = PendingRequest::State::Waiting;
+            m_pending_requests.push_back(pending);
+            return false;
+        }
+        pending->state = PendingRequest::State::Completed;
+        pending->tasks = std::move(tasks);
+    }
+    boost::asio::post(pending->timer.get_executor(), [pending] { pending->timer.cancel(); });
+    return true;
+}
+
+auto SchedulerServer::assign_tasks(
+        boost::uuids::uuid const worker_id,
+        std::string const& worker_addr,
+        std::size_t const num_tasks,
+        bool const fetch
+) -> std::vector<ScheduledTask> {
+    std::vector<core::ScheduleTaskMetadata> schedule_tasks
+            = fetch ? m_policy->schedule_next_batch(worker_id, worker_addr, num_tasks)
+                    : m_policy->schedule_fetched_batch(worker_id, worker_addr, num_tasks);
+    if (schedule_tasks.empty()) {
+        return {};
+    }
+
+    // The tasks are still ready if no instance is created. Put them back into the policy, as
+    // fetching pages past them.
+    std::variant<core::StorageConnectionPool::Lease, core::StorageErr> conn_result
+            = m_conn_pool->acquire();
+    if (std::holds_alternative<core::StorageErr>(conn_result)) {
+        spdlog::error(
+                "Failed to connect to storage: {}",
+                std::get<core::StorageErr>(conn_result).description
+        );
+        m_policy->requeue_tasks(std::move(schedule_tasks));
+        return {};
+    }
+    core::StorageConnectionPool::Lease const& conn
+            = std::get<core::StorageConnectionPool::Lease>(conn_result);
+
+    std::vector<core::TaskInstance> instances;
+    instances.reserve(schedule_tasks.size());
+    for (core::ScheduleTaskMetadata const& task : schedule_tasks) {
+        instances.emplace_back(task.get_id());
+    }
+    std::vector<core::TaskInstance> created_instances;
+    std::vector<core::Task> tasks;
+    core::StorageErr const err = m_metadata_store->start_task_instances(
+            *conn,
+            worker_id,
+            instances,
+            &created_instances,
+            &tasks
+    );
+    if (!err.success()) {
+        spdlog::error("Failed to create task instances: {}", err.description);
+        m_policy->requeue_tasks(std::move(schedule_tasks));
+        return {};
+    }
+
+    std::vector<ScheduledTask> scheduled_tasks;
+    scheduled_tasks.reserve(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        std::optional<std::vector<msgpack::sbuffer>> const optional_arg_buffers
+                = tasks[i].get_arg_buffers();
+        if (false == optional_arg_buffers.has_value()) {
+            spdlog::error("Failed to fetch arguments of task {}", tasks[i].get_function_name());
+            m_metadata_store->task_fail(
+                    *conn,
+                    created_instances[i],
+                    "Failed to fetch task arguments"
+            );
+            continue;
+        }
+        scheduled_tasks.emplace_back(created_instances[i], tasks[i], optional_arg_buffers.value());
+    }
+    return scheduled_tasks;
+}
+
+auto SchedulerServer::release_tasks(std::vector<ScheduledTask> const& tasks) -> void {
+    std::variant<core::StorageConnectionPool::Lease, core::StorageErr> conn_result
+            = m_conn_pool->acquire();
+    if (std::holds_alternative<core::StorageErr>(conn_result)) {
+        spdlog::error(
+                "Failed to connect to storage: {}",
+                std::get<core::StorageErr>(conn_result).description
+        );
+        return;
+    }
+    core::StorageConnectionPool::Lease const& conn
+            = std::get<core::StorageConnectionPool::Lease>(conn_result);
+
+    std::vector<core::TaskInstance> instances;
+    instances.reserve(tasks.size());
+    for (ScheduledTask const& task : tasks) {
+        instances.push_back(task.get_instance());
+    }
+    std::vector<boost::uuids::uuid> task_ids;
+    core::StorageErr const err
+            = m_metadata_store->remove_task_instances(*conn, instances, &task_ids);
+    if (!err.success()) {
+        spdlog::error("Failed to remove undelivered task instances: {}", err.description);
+    }
+}
+
+auto SchedulerServer::reset_failed_job(boost::uuids::uuid const task_id) -> bool {
+    std::variant<core::StorageConnectionPool::Lease, core::StorageErr> conn_result
+            = m_conn_pool->acquire();
+    if (std::holds_alternative<core::StorageErr>(conn_result)) {
+        spdlog::error(
+                "Failed to connect to storage: {}",
+                std::get<core::StorageErr>(conn_result).description
+        );
+        return false;
+    }
+    core::StorageConnectionPool::Lease const& conn
+            = std::get<core::StorageConnectionPool::Lease>(conn_result);
+
+    boost::uuids::uuid job_id;
+    core::StorageErr err = m_metadata_store->get_task_job_id(*conn, task_id, &job_id);
+    // It is possible the job is deleted, so we don't need to reset it
+    if (!err.success()) {
+        spdlog::error("Cannot get job id for task {}", boost::uuids::to_string(task_id));
+        return true;
+    }
+    err = m_metadata_store->reset_job(*conn, job_id);
+    if (!err.success()) {
+        spdlog::error("Cannot reset job {}", boost::uuids::to_string(job_id));
+        return false;
     }
-    co_return;
+    return true;
 }
 }  // namespace spider::scheduler
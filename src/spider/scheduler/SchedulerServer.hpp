@@ -1,15 +1,26 @@
 #ifndef SPIDER_SCHEDULER_SCHEDULERSERVER_HPP
 #define SPIDER_SCHEDULER_SCHEDULERSERVER_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
 
 #include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
+#include <spider/scheduler/SchedulerMessage.hpp>
 #include <spider/scheduler/SchedulerPolicy.hpp>
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
-#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 
 namespace spider::scheduler {
 class SchedulerServer {
@@ -21,12 +32,22 @@ public:
     auto operator=(SchedulerServer&&) noexcept -> SchedulerServer& = delete;
     ~SchedulerServer() = default;
 
+    /**
+     * @param port
+     * @param policy
+     * @param metadata_store
+     * @param data_store
+     * @param conn_pool Pool of storage connections used by the server. Storage calls run on a
+     * separate thread pool with one thread per connection of the pool.
+     * @param num_threads Number of threads serving worker sessions.
+     */
     SchedulerServer(
             unsigned short port,
             std::shared_ptr<SchedulerPolicy> policy,
             std::shared_ptr<core::MetadataStorage> metadata_store,
             std::shared_ptr<core::DataStorage> data_store,
-            std::shared_ptr<core::StorageConnection> conn
+            std::shared_ptr<core::StorageConnectionPool> conn_pool,
+            std::size_t num_threads
     );
 
     auto pause() -> void;
@@ -34,21 +55,173 @@ public:
 
     auto stop() -> void;
 
+    /**
+     * Wakes the dispatcher so that waiting requests are served without waiting for its next
+     * round. Call it when tasks are made ready.
+     */
+    auto notify_tasks_ready() -> void;
+
 private:
+    /**
+     * A schedule request that is waiting for a task to become available. The session coroutine
+     * waits on `timer` and the dispatcher cancels it once the request is completed. The dispatcher
+     * claims a request before it assigns tasks to it, so that tasks are never assigned to a request
+     * that has already been answered. `state`, `timed_out` and `tasks` are guarded by
+     * `m_pending_mutex`, and `timer` is only accessed on the session's strand.
+     */
+    struct PendingRequest {
+        PendingRequest(
+                boost::asio::any_io_executor const& executor,
+                boost::uuids::uuid const worker_id,
+                std::string worker_addr,
+                std::size_t const num_tasks
+        )
+                : worker_id{worker_id},
+                  worker_addr{std::move(worker_addr)},
+                  num_tasks{num_tasks},
+                  timer{executor} {}
+
+        enum class State : std::uint8_t {
+            // In `m_pending_requests`, waiting for the dispatcher
+            Waiting,
+            // Claimed by the dispatcher, which is assigning tasks to it
+            Dispatching,
+            // Answered with `tasks`, possibly empty
+            Completed,
+        };
+
+        boost::uuids::uuid worker_id;
+        std::string worker_addr;
+        std::size_t num_tasks;
+        State state = State::Waiting;
+        // Whether the long poll timed out while the request was claimed by the dispatcher
+        bool timed_out = false;
+        std::vector<ScheduledTask> tasks;
+        boost::asio::steady_timer timer;
+    };
+
+    /**
+     * Runs a blocking function on the storage thread pool so that it never stalls the sessions
+     * served by the io threads.
+     *
+     * @param function
+     * @return The result of `function`, delivered on the executor of the calling coroutine.
+     */
+    template <typename Function>
+    auto run_on_storage_pool(Function function)
+            -> boost::asio::awaitable<std::invoke_result_t<Function>> {
+        co_return co_await boost::asio::co_spawn(
+                m_storage_pool,
+                [function = std::move(function)]() mutable
+                        -> boost::asio::awaitable<std::invoke_result_t<Function>> {
+                    co_return function();
+                },
+                boost::asio::use_awaitable
+        );
+    }
+
+    auto start_threads() -> void;
+
+    auto stop_threads() -> void;
+
     auto receive_message() -> boost::asio::awaitable<void>;
 
+    /**
+     * Serves a worker session. A session is a long-lived connection on which the worker sends a
+     * sequence of schedule requests. Each request is answered either immediately, or as soon as
+     * the dispatcher finds a task for it, or with an empty response after the long poll timeout.
+     *
+     * @param socket
+     */
     auto process_message(boost::asio::ip::tcp::socket socket) -> boost::asio::awaitable<void>;
 
+    /**
+     * Handles one schedule request of a session.
+     *
+     * @param socket
+     * @param request
+     * @return Whether the response is sent successfully.
+     */
+    auto process_request(boost::asio::ip::tcp::socket& socket, ScheduleTaskRequest const& request)
+            -> boost::asio::awaitable<bool>;
+
+    /**
+     * Tries to assign tasks to pending requests whenever it is notified, and periodically while
+     * requests are pending, and pushes the assignments to the waiting sessions.
+     */
+    auto dispatch_loop() -> boost::asio::awaitable<void>;
+
+    /**
+     * Assigns tasks to pending requests, fetching ready tasks from the storage at most once.
+     */
+    auto dispatch_pending_requests() -> void;
+
+    /**
+     * Assigns tasks the policy has already fetched to a pending request. The request is claimed
+     * first, and is completed if any task is assigned or its long poll timed out in the meantime,
+     * and put back to wait otherwise.
+     *
+     * @param pending
+     * @return Whether the request is completed or no longer waiting.
+     */
+    auto dispatch_fetched_tasks(std::shared_ptr<PendingRequest> const& pending) -> bool;
+
+    /**
+     * Schedules up to `num_tasks` tasks for the worker and creates their task instances, so that
+     * the worker can run them without touching the storage. Tasks whose instance cannot be created,
+     * e.g. because another scheduler already started them, are dropped.
+     *
+     * @param worker_id
+     * @param worker_addr
+     * @param num_tasks
+     * @param fetch Whether to fetch ready tasks from the storage if the tasks the policy already
+     * has are not enough.
+     * @return The started tasks. Empty if no task is available.
+     */
+    auto assign_tasks(
+            boost::uuids::uuid worker_id,
+            std::string const& worker_addr,
+            std::size_t num_tasks,
+            bool fetch
+    ) -> std::vector<ScheduledTask>;
+
+    /**
+     * Removes the instances of tasks that are not delivered to their worker, so that the tasks are
+     * scheduled again.
+     *
+     * @param tasks
+     */
+    auto release_tasks(std::vector<ScheduledTask> const& tasks) -> void;
+
+    /**
+     * Resets the job of a failed task.
+     *
+     * @param task_id
+     * @return Whether the job is reset or no longer exists.
+     */
+    auto reset_failed_job(boost::uuids::uuid task_id) -> bool;
+
     unsigned short m_port;
     std::shared_ptr<SchedulerPolicy> m_policy;
     std::shared_ptr<core::MetadataStorage> m_metadata_store;
     std::shared_ptr<core::DataStorage> m_data_store;
-    std::shared_ptr<core::StorageConnection> m_conn;
+    std::shared_ptr<core::StorageConnectionPool> m_conn_pool;
 
+    // Declared before `m_context` so that it outlives the handlers queued in `m_context`
+    boost::asio::thread_pool m_storage_pool;
     boost::asio::io_context m_context;
+    std::size_t m_num_threads;
+
+    // The dispatcher runs on its own strand, which also guards `m_dispatch_timer`
+    boost::asio::strand<boost::asio::io_context::executor_type> m_dispatch_strand;
+    boost::asio::steady_timer m_dispatch_timer;
+    std::atomic<bool> m_dispatch_requested = false;
+
+    std::mutex m_pending_mutex;
+    std::list<std::shared_ptr<PendingRequest>> m_pending_requests;
 
     std::mutex m_mutex;
-    std::unique_ptr<std::thread> m_thread;
+    std::vector<std::thread> m_threads;
 };
 }  // namespace spider::scheduler
 
@@ -1,14 +1,23 @@
+#include <algorithm>
 #include <cerrno>
 #include <chrono>
+#include <cmath>
 #include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <system_error>
 #include <thread>
 #include <utility>
 #include <variant>
+#include <vector>
 
+#include <absl/container/flat_hash_map.h>
 #include <boost/any/bad_any_cast.hpp>
 #include <boost/program_options/errors.hpp>
 #include <boost/program_options/options_description.hpp>
@@ -16,6 +25,7 @@
 #include <boost/program_options/value_semantic.hpp>
 #include <boost/program_options/variables_map.hpp>
 #include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/string_generator.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <spdlog/common.h>
 #include <spdlog/spdlog.h>
@@ -23,13 +33,16 @@
 #include <spider/core/Driver.hpp>
 #include <spider/core/Error.hpp>
 #include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
+#include <spider/scheduler/FairSharePolicy.hpp>
 #include <spider/scheduler/FifoPolicy.hpp>
+#include <spider/scheduler/LocalityPolicy.hpp>
+#include <spider/scheduler/PriorityPolicy.hpp>
 #include <spider/scheduler/SchedulerPolicy.hpp>
 #include <spider/scheduler/SchedulerServer.hpp>
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
-#include <spider/storage/mysql/MySqlStorageFactory.hpp>
 #include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 #include <spider/storage/StorageFactory.hpp>
 #include <spider/utils/env.hpp>
 #include <spider/utils/logging.hpp>
@@ -42,8 +55,19 @@ constexpr int cSchedulerAddrErr = 4;
 constexpr int cStorageErr = 5;
 
 constexpr int cCleanupInterval = 1000;
+// Jobs whose submission made no progress for this many milliseconds are left by crashed submitters
+constexpr double cSubmittingJobTimeout = 3'600'000;
 constexpr int cRetryCount = 5;
 
+constexpr std::size_t cDefaultStorageConnections = 8;
+// Workers update their heartbeat every second and exit after missing 5 updates
+constexpr std::int64_t cDefaultWorkerHeartbeatTimeout = 5000;
+
+constexpr std::string_view cFifoPolicyName = "fifo";
+constexpr std::string_view cLocalityPolicyName = "locality";
+constexpr std::string_view cFairSharePolicyName = "fair_share";
+constexpr std::string_view cPriorityPolicyName = "priority";
+
 namespace {
 /*
  * Signal handler for SIGTERM. Sets the stop flag to request a stop.
@@ -73,6 +97,52 @@ auto parse_args(int const argc, char** argv) -> boost::program_options::variable
             boost::program_options::value<std::string>(),
             "storage server url"
     );
+    desc.add_options()(
+            "threads",
+            boost::program_options::value<std::size_t>()->default_value(
+                    std::max<std::size_t>(std::thread::hardware_concurrency(), 1)
+            ),
+            "number of threads serving worker sessions"
+    );
+    desc.add_options()(
+            "storage_connections",
+            boost::program_options::value<std::size_t>()->default_value(cDefaultStorageConnections),
+            "number of storage connections, and of threads running storage calls, of the server"
+    );
+    desc.add_options()(
+            "worker_heartbeat_timeout_ms",
+            boost::program_options::value<std::int64_t>()->default_value(
+                    cDefaultWorkerHeartbeatTimeout
+            ),
+            "time in milliseconds without heartbeat after which a worker's tasks are rescheduled"
+    );
+    desc.add_options()(
+            "policy",
+            boost::program_options::value<std::string>()->default_value(std::string{cFifoPolicyName}),
+            "scheduling policy: fifo, locality, fair_share or priority"
+    );
+    desc.add_options()(
+            "locality_max_skips",
+            boost::program_options::value<std::size_t>()->default_value(
+                    spider::scheduler::LocalityPolicy::cDefaultMaxSkips
+            ),
+            "times the earliest task may be skipped for a soft locality match under the locality "
+            "policy"
+    );
+    desc.add_options()(
+            "priority_aging_ms",
+            boost::program_options::value<std::int64_t>()->default_value(
+                    std::chrono::milliseconds{
+                            spider::scheduler::PriorityPolicy::cDefaultPriorityAging
+                    }.count()
+            ),
+            "waiting time in milliseconds worth one level of job priority under the priority policy"
+    );
+    desc.add_options()(
+            "client_weight",
+            boost::program_options::value<std::vector<std::string>>()->composing(),
+            "client weight under the fair_share policy, as <client id>=<weight>; may be repeated"
+    );
 
     boost::program_options::variables_map variables;
     boost::program_options::store(
@@ -84,6 +154,45 @@ auto parse_args(int const argc, char** argv) -> boost::program_options::variable
     return variables;
 }
 
+/**
+ * Parses client weights given as `<client id>=<weight>`.
+ *
+ * @param specs
+ * @return The weights keyed by client id.
+ * @return std::nullopt if any of the specs is malformed or has a non-positive weight.
+ */
+auto parse_client_weights(std::vector<std::string> const& specs)
+        -> std::optional<absl::flat_hash_map<boost::uuids::uuid, double>> {
+    absl::flat_hash_map<boost::uuids::uuid, double> weights;
+    boost::uuids::string_generator gen;
+    for (std::string const& spec : specs) {
+        size_t const pos = spec.find('=');
+        if (std::string::npos == pos) {
+            spdlog::error("Invalid client weight: {}", spec);
+            return std::nullopt;
+        }
+        try {
+            boost::uuids::uuid const client_id = gen(spec.substr(0, pos));
+            std::string const weight_str = spec.substr(pos + 1);
+            size_t num_parsed = 0;
+            double const weight = std::stod(weight_str, &num_parsed);
+            if (num_parsed != weight_str.size()) {
+                spdlog::error("Invalid client weight: {}", spec);
+                return std::nullopt;
+            }
+            if (false == std::isfinite(weight) || weight <= 0) {
+                spdlog::error("Client weight must be positive and finite: {}", spec);
+                return std::nullopt;
+            }
+            weights[client_id] = weight;
+        } catch (std::exception& e) {
+            spdlog::error("Invalid client weight {}: {}", spec, e.what());
+            return std::nullopt;
+        }
+    }
+    return weights;
+}
+
 auto heartbeat_loop(
         std::shared_ptr<spider::core::StorageFactory> const& storage_factory,
         std::shared_ptr<spider::core::MetadataStorage> const& metadata_store,
@@ -124,6 +233,7 @@ auto heartbeat_loop(
 
 auto cleanup_loop(
         std::shared_ptr<spider::core::StorageFactory> const& storage_factory,
+        std::shared_ptr<spider::core::MetadataStorage> const& metadata_store,
         std::shared_ptr<spider::core::DataStorage> const& data_store
 ) -> void {
     while (!spider::core::StopFlag::is_stop_requested()) {
@@ -142,11 +252,63 @@ auto cleanup_loop(
                 std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result)
         );
 
+        spider::core::StorageErr const err
+                = metadata_store->remove_stale_submitting_jobs(*conn, cSubmittingJobTimeout);
+        if (!err.success()) {
+            spdlog::error("Failed to remove stale submitting jobs: {}", err.description);
+        }
         data_store->remove_dangling_data(*conn);
         spdlog::debug("Finished cleanup");
     }
 }
 
+/**
+ * Periodically reschedules the running tasks of workers that stopped updating their heartbeat, so
+ * that they do not wait for their instances to time out.
+ *
+ * @param storage_factory
+ * @param metadata_store
+ * @param server The server to notify of the rescheduled tasks.
+ * @param worker_heartbeat_timeout
+ */
+auto liveness_loop(
+        std::shared_ptr<spider::core::StorageFactory> const& storage_factory,
+        std::shared_ptr<spider::core::MetadataStorage> const& metadata_store,
+        spider::scheduler::SchedulerServer& server,
+        std::chrono::milliseconds const worker_heartbeat_timeout
+) -> void {
+    while (!spider::core::StopFlag::is_stop_requested()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+                conn_result = storage_factory->provide_storage_connection();
+        if (std::holds_alternative<spider::core::StorageErr>(conn_result)) {
+            spdlog::error(
+                    "Failed to connect to storage: {}",
+                    std::get<spider::core::StorageErr>(conn_result).description
+            );
+            continue;
+        }
+        auto conn = std::move(
+                std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result)
+        );
+
+        std::vector<boost::uuids::uuid> task_ids;
+        spider::core::StorageErr const err = metadata_store->recover_dead_worker_tasks(
+                *conn,
+                static_cast<double>(worker_heartbeat_timeout.count()),
+                &task_ids
+        );
+        if (!err.success()) {
+            spdlog::error("Failed to recover tasks of dead workers: {}", err.description);
+            continue;
+        }
+        if (!task_ids.empty()) {
+            spdlog::warn("Rescheduled {} tasks of dead workers", task_ids.size());
+            server.notify_tasks_ready();
+        }
+    }
+}
+
 constexpr int cSignalExitBase = 128;
 }  // namespace
 
@@ -159,6 +321,13 @@ auto main(int argc, char** argv) -> int {
     unsigned short port = 0;
     std::string scheduler_addr;
     std::string storage_url;
+    std::size_t num_threads = 0;
+    std::size_t num_storage_connections = 0;
+    std::string policy_name;
+    std::size_t locality_max_skips = 0;
+    std::chrono::milliseconds priority_aging{0};
+    std::chrono::milliseconds worker_heartbeat_timeout{0};
+    absl::flat_hash_map<boost::uuids::uuid, double> client_weights;
     try {
         if (!args.contains("port")) {
             spdlog::error("port is required");
@@ -188,6 +357,51 @@ auto main(int argc, char** argv) -> int {
             );
             return cCmdArgParseErr;
         }
+
+        if (spider::core::is_process_local_storage_url(storage_url)) {
+            spdlog::error(
+                    "Storage URL {} is only reachable from a single process and cannot be shared "
+                    "with other spider processes.",
+                    storage_url
+            );
+            return cCmdArgParseErr;
+        }
+
+        num_threads = args["threads"].as<std::size_t>();
+        num_storage_connections = args["storage_connections"].as<std::size_t>();
+        if (0 == num_threads || 0 == num_storage_connections) {
+            spdlog::error("threads and storage_connections must be positive");
+            return cCmdArgParseErr;
+        }
+        worker_heartbeat_timeout = std::chrono::milliseconds{
+                args["worker_heartbeat_timeout_ms"].as<std::int64_t>()
+        };
+        if (worker_heartbeat_timeout.count() <= 0) {
+            spdlog::error("worker_heartbeat_timeout_ms must be positive");
+            return cCmdArgParseErr;
+        }
+
+        policy_name = args["policy"].as<std::string>();
+        if (cFifoPolicyName != policy_name && cLocalityPolicyName != policy_name
+            && cFairSharePolicyName != policy_name && cPriorityPolicyName != policy_name)
+        {
+            spdlog::error("Unknown scheduling policy: {}", policy_name);
+            return cCmdArgParseErr;
+        }
+        locality_max_skips = args["locality_max_skips"].as<std::size_t>();
+        priority_aging = std::chrono::milliseconds{args["priority_aging_ms"].as<std::int64_t>()};
+        if (priority_aging.count() < 0) {
+            spdlog::error("priority_aging_ms must not be negative");
+            return cCmdArgParseErr;
+        }
+        if (args.contains("client_weight")) {
+            std::optional<absl::flat_hash_map<boost::uuids::uuid, double>> optional_weights
+                    = parse_client_weights(args["client_weight"].as<std::vector<std::string>>());
+            if (false == optional_weights.has_value()) {
+                return cCmdArgParseErr;
+            }
+            client_weights = std::move(optional_weights.value());
+        }
     } catch (boost::bad_any_cast& e) {
         return cCmdArgParseErr;
     } catch (boost::program_options::error& e) {
@@ -208,7 +422,7 @@ auto main(int argc, char** argv) -> int {
 
     // Create storages
     std::shared_ptr<spider::core::StorageFactory> const storage_factory
-            = std::make_unique<spider::core::MySqlStorageFactory>(storage_url);
+            = spider::core::create_storage_factory(storage_url);
     std::shared_ptr<spider::core::MetadataStorage> const metadata_store
             = storage_factory->provide_metadata_storage();
     std::shared_ptr<spider::core::DataStorage> const data_store
@@ -249,15 +463,53 @@ auto main(int argc, char** argv) -> int {
         return cStorageErr;
     }
 
-    // Start scheduler server
-    std::shared_ptr<spider::scheduler::SchedulerPolicy> const policy
-            = std::make_shared<spider::scheduler::FifoPolicy>(
-                    scheduler_id,
-                    metadata_store,
-                    data_store,
-                    conn
+    // Start scheduler server. The policy fetches ready tasks through the server's connection pool.
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(
+                    storage_factory,
+                    num_storage_connections
             );
-    spider::scheduler::SchedulerServer server{port, policy, metadata_store, data_store, conn};
+    std::shared_ptr<spider::scheduler::SchedulerPolicy> policy;
+    if (cLocalityPolicyName == policy_name) {
+        policy = std::make_shared<spider::scheduler::LocalityPolicy>(
+                scheduler_id,
+                metadata_store,
+                data_store,
+                conn_pool,
+                locality_max_skips
+        );
+    } else if (cPriorityPolicyName == policy_name) {
+        policy = std::make_shared<spider::scheduler::PriorityPolicy>(
+                scheduler_id,
+                metadata_store,
+                data_store,
+                conn_pool,
+                priority_aging
+        );
+    } else if (cFairSharePolicyName == policy_name) {
+        policy = std::make_shared<spider::scheduler::FairSharePolicy>(
+                scheduler_id,
+                metadata_store,
+                data_store,
+                conn_pool,
+                std::move(client_weights)
+        );
+    } else {
+        policy = std::make_shared<spider::scheduler::FifoPolicy>(
+                scheduler_id,
+                metadata_store,
+                data_store,
+                conn_pool
+        );
+    }
+    spider::scheduler::SchedulerServer server{
+            port,
+            policy,
+            metadata_store,
+            data_store,
+            conn_pool,
+            num_threads
+    };
 
     try {
         // Start a thread that periodically updates the scheduler's heartbeat
@@ -269,10 +521,25 @@ auto main(int argc, char** argv) -> int {
         };
 
         // Start a thread that periodically starts cleanup
-        std::thread cleanup_thread{cleanup_loop, std::cref(storage_factory), std::cref(data_store)};
+        std::thread cleanup_thread{
+                cleanup_loop,
+                std::cref(storage_factory),
+                std::cref(metadata_store),
+                std::cref(data_store)
+        };
+
+        // Start a thread that periodically reschedules tasks of dead workers
+        std::thread liveness_thread{
+                liveness_loop,
+                std::cref(storage_factory),
+                std::cref(metadata_store),
+                std::ref(server),
+                worker_heartbeat_timeout
+        };
 
         heartbeat_thread.join();
         cleanup_thread.join();
+        liveness_thread.join();
         server.stop();
     } catch (std::system_error& e) {
         spdlog::error("Failed to join thread: {}", e.what());
@@ -1,6 +1,10 @@
 #ifndef SPIDER_STORAGE_METADATASTORAGE_HPP
 #define SPIDER_STORAGE_METADATASTORAGE_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -36,18 +40,36 @@ public:
             -> StorageErr
             = 0;
 
+    auto
+    add_job(StorageConnection& conn,
+            boost::uuids::uuid const job_id,
+            boost::uuids::uuid const client_id,
+            TaskGraph const& task_graph) -> StorageErr {
+        return add_job(conn, job_id, client_id, task_graph, cDefaultJobPriority);
+    }
     virtual auto
     add_job(StorageConnection& conn,
             boost::uuids::uuid job_id,
             boost::uuids::uuid client_id,
-            TaskGraph const& task_graph) -> StorageErr
+            TaskGraph const& task_graph,
+            std::int32_t priority) -> StorageErr
             = 0;
+    auto add_job_batch(
+            StorageConnection& conn,
+            JobSubmissionBatch& batch,
+            boost::uuids::uuid const job_id,
+            boost::uuids::uuid const client_id,
+            TaskGraph const& task_graph
+    ) -> StorageErr {
+        return add_job_batch(conn, batch, job_id, client_id, task_graph, cDefaultJobPriority);
+    }
     virtual auto add_job_batch(
             StorageConnection& conn,
             JobSubmissionBatch& batch,
             boost::uuids::uuid job_id,
             boost::uuids::uuid client_id,
-            TaskGraph const& task_graph
+            TaskGraph const& task_graph,
+            std::int32_t priority
     ) -> StorageErr
             = 0;
     virtual auto get_job_metadata(StorageConnection& conn, boost::uuids::uuid id, JobMetadata* job)
@@ -84,12 +106,56 @@ public:
     get_task_job_id(StorageConnection& conn, boost::uuids::uuid id, boost::uuids::uuid* job_id)
             -> StorageErr
             = 0;
+    auto get_ready_tasks(
+            StorageConnection& conn,
+            boost::uuids::uuid const scheduler_id,
+            std::vector<ScheduleTaskMetadata>* tasks
+    ) -> StorageErr {
+        return get_ready_tasks(conn, scheduler_id, std::numeric_limits<std::size_t>::max(), tasks);
+    }
+    auto get_ready_tasks(
+            StorageConnection& conn,
+            boost::uuids::uuid const scheduler_id,
+            std::size_t const max_num_tasks,
+            std::vector<ScheduleTaskMetadata>* tasks
+    ) -> StorageErr {
+        return get_ready_tasks(conn, scheduler_id, std::nullopt, max_num_tasks, tasks);
+    }
+    auto get_ready_tasks(
+            StorageConnection& conn,
+            boost::uuids::uuid const scheduler_id,
+            std::optional<boost::uuids::uuid> const& after_task_id,
+            std::size_t const max_num_tasks,
+            std::vector<ScheduleTaskMetadata>* tasks
+    ) -> StorageErr {
+        return get_ready_tasks(
+                conn,
+                scheduler_id,
+                std::nullopt,
+                after_task_id,
+                max_num_tasks,
+                tasks
+        );
+    }
+    // Leases and returns at most `max_num_tasks` ready tasks, highest job priority first, then
+    // earliest job creation time, then task id. If `client_id` is set, only tasks of that client's
+    // jobs are returned. If `after_task_id` is set, only tasks ordered after that task are
+    // returned, so passing the last task of a page fetches the next page. Nothing is returned if
+    // that task no longer exists. Tasks leased by any scheduler are skipped until their lease
+    // expires.
     virtual auto get_ready_tasks(
             StorageConnection& conn,
             boost::uuids::uuid scheduler_id,
+            std::optional<boost::uuids::uuid> const& client_id,
+            std::optional<boost::uuids::uuid> const& after_task_id,
+            std::size_t max_num_tasks,
             std::vector<ScheduleTaskMetadata>* tasks
     ) -> StorageErr
             = 0;
+    // Returns the clients with ready tasks of running jobs, in no particular order.
+    virtual auto get_ready_clients(StorageConnection& conn, std::vector<boost::uuids::uuid>* ids)
+            -> StorageErr
+            = 0;
     virtual auto set_task_state(StorageConnection& conn, boost::uuids::uuid id, TaskState state)
             -> StorageErr
             = 0;
@@ -101,12 +167,39 @@ public:
     virtual auto create_task_instance(StorageConnection& conn, TaskInstance const& instance)
             -> StorageErr
             = 0;
+    // Same as `create_task_instance` for a batch of instances in a single transaction. Instances
+    // whose task is no longer ready are skipped. `created` holds the instances actually created.
+    virtual auto create_task_instances(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<TaskInstance>* created
+    ) -> StorageErr
+            = 0;
+    // Same as `create_task_instances` for instances run by `worker_id`, and also fetches the task
+    // of each created instance with its inputs and outputs in the same transaction. `tasks` holds
+    // one task per created instance.
+    virtual auto start_task_instances(
+            StorageConnection& conn,
+            boost::uuids::uuid worker_id,
+            std::vector<TaskInstance> const& instances,
+            std::vector<TaskInstance>* created,
+            std::vector<Task>* tasks
+    ) -> StorageErr
+            = 0;
     virtual auto task_finish(
             StorageConnection& conn,
             TaskInstance const& instance,
             std::vector<TaskOutput> const& outputs
     ) -> StorageErr
             = 0;
+    // Same as `task_finish` for many task instances in a single transaction. `outputs` holds the
+    // outputs of each instance in the same order.
+    virtual auto task_finish_batch(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<std::vector<TaskOutput>> const& outputs
+    ) -> StorageErr
+            = 0;
     virtual auto
     task_fail(StorageConnection& conn, TaskInstance const& instance, std::string const& error)
             -> StorageErr
@@ -128,6 +221,30 @@ public:
     heartbeat_timeout(StorageConnection& conn, double timeout, std::vector<boost::uuids::uuid>* ids)
             -> StorageErr
             = 0;
+    // Removes the task instances of workers whose heartbeat is older than `timeout` milliseconds or
+    // who are removed, and sets their running tasks without any other instance back to ready in a
+    // single transaction. `task_ids` holds the tasks made ready.
+    virtual auto recover_dead_worker_tasks(
+            StorageConnection& conn,
+            double timeout,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> StorageErr
+            = 0;
+    // Removes task instances that never ran, e.g. because they are not delivered to their worker,
+    // and sets their running tasks without any other instance back to ready in a single
+    // transaction. `task_ids` holds the tasks made ready.
+    virtual auto remove_task_instances(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> StorageErr
+            = 0;
+    // Removes jobs still being submitted whose last chunk was committed more than `timeout`
+    // milliseconds ago, which are left partly inserted by submitters that crashed between chunk
+    // commits.
+    virtual auto remove_stale_submitting_jobs(StorageConnection& conn, double timeout)
+            -> StorageErr
+            = 0;
 
     virtual auto
     get_scheduler_addr(StorageConnection& conn, boost::uuids::uuid id, std::string* addr, int* port)
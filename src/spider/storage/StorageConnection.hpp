@@ -10,6 +10,11 @@ public:
     StorageConnection(StorageConnection&&) = default;
     auto operator=(StorageConnection&&) -> StorageConnection& = default;
     virtual ~StorageConnection() = default;
+
+    /**
+     * @return Whether the connection is still usable, e.g. has not been closed by the server.
+     */
+    [[nodiscard]] virtual auto is_valid() -> bool { return true; }
 };
 }  // namespace spider::core
 
@@ -0,0 +1,156 @@
+#include "StorageConnectionPool.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <variant>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageFactory.hpp>
+
+namespace spider::core {
+StorageConnectionPool::Lease::Lease(Lease&& other) noexcept
+        : m_pool{other.m_pool},
+          m_conn{std::move(other.m_conn)} {}
+
+auto StorageConnectionPool::Lease::operator=(Lease&& other) noexcept -> Lease& {
+    if (this == &other) {
+        return *this;
+    }
+    release();
+    m_pool = other.m_pool;
+    m_conn = std::move(other.m_conn);
+    return *this;
+}
+
+StorageConnectionPool::Lease::~Lease() {
+    release();
+}
+
+auto StorageConnectionPool::Lease::discard() -> void {
+    if (nullptr != m_conn) {
+        m_pool->discard(std::move(m_conn));
+    }
+}
+
+auto StorageConnectionPool::Lease::release() -> void {
+    if (nullptr != m_conn) {
+        m_pool->release(std::move(m_conn));
+    }
+}
+
+StorageConnectionPool::StorageConnectionPool(
+        std::shared_ptr<StorageFactory> const& storage_factory,
+        std::size_t const max_size,
+        std::chrono::milliseconds const max_idle_time
+)
+        : StorageConnectionPool{
+                  [storage_factory] { return storage_factory->create_storage_connection(); },
+                  max_size,
+                  max_idle_time
+          } {}
+
+StorageConnectionPool::StorageConnectionPool(
+        ConnectionCreator create_connection,
+        std::size_t const max_size,
+        std::chrono::milliseconds const max_idle_time
+)
+        : m_create_connection{std::move(create_connection)},
+          m_max_size{max_size},
+          m_max_idle_time{max_idle_time} {}
+
+auto StorageConnectionPool::acquire() -> std::variant<Lease, StorageErr> {
+    while (true) {
+        IdleConnection idle;
+        std::deque<IdleConnection> evicted;
+        std::chrono::steady_clock::time_point const now = std::chrono::steady_clock::now();
+        {
+            std::unique_lock lock{m_mutex};
+            m_cv.wait(lock, [&] {
+                return false == m_idle_connections.empty() || m_num_connections < m_max_size;
+            });
+            evicted = evict_idle_connections(now);
+            if (false == m_idle_connections.empty()) {
+                idle = std::move(m_idle_connections.back());
+                m_idle_connections.pop_back();
+            } else {
+                // Reserve the slot so that the connection can be created without holding the lock
+                ++m_num_connections;
+            }
+        }
+        if (false == evicted.empty()) {
+            // Closed connections free slots for other waiters
+            m_cv.notify_all();
+        }
+        evicted.clear();
+
+        if (nullptr != idle.conn) {
+            // A connection that was idle for a while may have been closed by the server
+            if (now - idle.idle_since < cDefaultValidationInterval || idle.conn->is_valid()) {
+                return Lease{*this, std::move(idle.conn)};
+            }
+            discard(std::move(idle.conn));
+            continue;
+        }
+
+        std::variant<std::unique_ptr<StorageConnection>, StorageErr> conn_result
+                = m_create_connection();
+        if (std::holds_alternative<StorageErr>(conn_result)) {
+            {
+                std::lock_guard const lock{m_mutex};
+                --m_num_connections;
+            }
+            m_cv.notify_one();
+            return std::get<StorageErr>(conn_result);
+        }
+        return Lease{*this, std::move(std::get<std::unique_ptr<StorageConnection>>(conn_result))};
+    }
+}
+
+auto StorageConnectionPool::get_num_connections() -> std::size_t {
+    std::lock_guard const lock{m_mutex};
+    return m_num_connections;
+}
+
+auto StorageConnectionPool::get_num_idle_connections() -> std::size_t {
+    std::lock_guard const lock{m_mutex};
+    return m_idle_connections.size();
+}
+
+auto StorageConnectionPool::release(std::unique_ptr<StorageConnection> conn) -> void {
+    std::deque<IdleConnection> evicted;
+    {
+        std::lock_guard const lock{m_mutex};
+        std::chrono::steady_clock::time_point const now = std::chrono::steady_clock::now();
+        evicted = evict_idle_connections(now);
+        m_idle_connections.push_back({std::move(conn), now});
+    }
+    m_cv.notify_all();
+}
+
+auto StorageConnectionPool::discard(std::unique_ptr<StorageConnection> conn) -> void {
+    conn.reset();
+    {
+        std::lock_guard const lock{m_mutex};
+        --m_num_connections;
+    }
+    m_cv.notify_one();
+}
+
+auto StorageConnectionPool::evict_idle_connections(std::chrono::steady_clock::time_point const now)
+        -> std::deque<IdleConnection> {
+    std::deque<IdleConnection> evicted;
+    while (false == m_idle_connections.empty()
+           && now - m_idle_connections.front().idle_since > m_max_idle_time)
+    {
+        evicted.push_back(std::move(m_idle_connections.front()));
+        m_idle_connections.pop_front();
+        --m_num_connections;
+    }
+    return evicted;
+}
+}  // namespace spider::core
@@ -0,0 +1,158 @@
+#ifndef SPIDER_STORAGE_STORAGECONNECTIONPOOL_HPP
+#define SPIDER_STORAGE_STORAGECONNECTIONPOOL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <variant>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageFactory.hpp>
+
+namespace spider::core {
+/**
+ * A thread-safe pool of at most `max_size` storage connections. Connections are created on demand
+ * and reused once released. Connections idle for longer than the max idle time are closed, and a
+ * connection idle for longer than the validation interval is checked before it is reused.
+ */
+class StorageConnectionPool {
+public:
+    using ConnectionCreator
+            = std::function<std::variant<std::unique_ptr<StorageConnection>, StorageErr>()>;
+
+    static constexpr std::chrono::milliseconds cDefaultMaxIdleTime{std::chrono::minutes{5}};
+    static constexpr std::chrono::milliseconds cDefaultValidationInterval{std::chrono::seconds{5}};
+
+    /**
+     * RAII handle of a connection checked out from the pool. The connection is returned to the
+     * pool when the lease is destroyed.
+     */
+    class Lease {
+    public:
+        Lease(StorageConnectionPool& pool, std::unique_ptr<StorageConnection> conn)
+                : m_pool{&pool},
+                  m_conn{std::move(conn)} {}
+
+        // Delete copy constructor and copy assignment operator
+        Lease(Lease const&) = delete;
+        auto operator=(Lease const&) -> Lease& = delete;
+
+        Lease(Lease&& other) noexcept;
+        auto operator=(Lease&& other) noexcept -> Lease&;
+
+        ~Lease();
+
+        auto operator*() const -> StorageConnection& { return *m_conn; }
+
+        auto operator->() const -> StorageConnection* { return m_conn.get(); }
+
+        /**
+         * @return Whether the lease still holds a connection, i.e. is not moved from or discarded.
+         */
+        explicit operator bool() const { return nullptr != m_conn; }
+
+        /**
+         * Closes the connection instead of returning it to the pool, e.g. if it is broken.
+         */
+        auto discard() -> void;
+
+    private:
+        auto release() -> void;
+
+        StorageConnectionPool* m_pool;
+        std::unique_ptr<StorageConnection> m_conn;
+    };
+
+    /**
+     * Creates a pool of connections opened by `StorageFactory::create_storage_connection`.
+     *
+     * @param storage_factory
+     * @param max_size
+     * @param max_idle_time
+     */
+    StorageConnectionPool(
+            std::shared_ptr<StorageFactory> const& storage_factory,
+            std::size_t max_size,
+            std::chrono::milliseconds max_idle_time = cDefaultMaxIdleTime
+    );
+
+    /**
+     * @param create_connection Opens a new connection.
+     * @param max_size
+     * @param max_idle_time
+     */
+    StorageConnectionPool(
+            ConnectionCreator create_connection,
+            std::size_t max_size,
+            std::chrono::milliseconds max_idle_time = cDefaultMaxIdleTime
+    );
+
+    // Delete copy & move constructor and assignment operator
+    StorageConnectionPool(StorageConnectionPool const&) = delete;
+    auto operator=(StorageConnectionPool const&) -> StorageConnectionPool& = delete;
+    StorageConnectionPool(StorageConnectionPool&&) = delete;
+    auto operator=(StorageConnectionPool&&) -> StorageConnectionPool& = delete;
+    ~StorageConnectionPool() = default;
+
+    /**
+     * Checks out a connection. Reuses the most recently released idle connection if there is one,
+     * otherwise creates a new one if the pool is not full, otherwise blocks until another lease is
+     * released.
+     *
+     * @return A lease of the connection on success.
+     * @return The error from the connection creator if the connection cannot be created.
+     */
+    auto acquire() -> std::variant<Lease, StorageErr>;
+
+    [[nodiscard]] auto get_max_size() const -> std::size_t { return m_max_size; }
+
+    /**
+     * @return The number of open connections, including the leased ones.
+     */
+    [[nodiscard]] auto get_num_connections() -> std::size_t;
+
+    /**
+     * @return The number of idle connections.
+     */
+    [[nodiscard]] auto get_num_idle_connections() -> std::size_t;
+
+private:
+    struct IdleConnection {
+        std::unique_ptr<StorageConnection> conn;
+        std::chrono::steady_clock::time_point idle_since;
+    };
+
+    auto release(std::unique_ptr<StorageConnection> conn) -> void;
+
+    auto discard(std::unique_ptr<StorageConnection> conn) -> void;
+
+    /**
+     * Removes the connections idle for longer than the max idle time. Must be called with the lock
+     * held.
+     *
+     * @param now
+     * @return The removed connections, to be closed without holding the lock.
+     */
+    auto evict_idle_connections(std::chrono::steady_clock::time_point now)
+            -> std::deque<IdleConnection>;
+
+    ConnectionCreator m_create_connection;
+    std::size_t m_max_size;
+    std::chrono::milliseconds m_max_idle_time;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    // Ordered by release time, the most recently released connection at the back
+    std::deque<IdleConnection> m_idle_connections;
+    // Number of connections created by the pool, including the leased ones
+    std::size_t m_num_connections = 0;
+};
+}  // namespace spider::core
+
+#endif
@@ -0,0 +1,24 @@
+#include "StorageFactory.hpp"
+
+#include <memory>
+#include <string>
+
+#include <spider/storage/durable/DurableStorageFactory.hpp>
+#include <spider/storage/memory/MemoryStorageFactory.hpp>
+#include <spider/storage/mysql/MySqlStorageFactory.hpp>
+
+namespace spider::core {
+auto create_storage_factory(std::string const& url) -> std::shared_ptr<StorageFactory> {
+    if (url.starts_with(MemoryStorageFactory::cUrlScheme)) {
+        return std::make_shared<MemoryStorageFactory>(url);
+    }
+    if (url.starts_with(DurableStorageFactory::cUrlScheme)) {
+        return std::make_shared<DurableStorageFactory>(url);
+    }
+    return std::make_shared<MySqlStorageFactory>(url);
+}
+
+auto is_process_local_storage_url(std::string const& url) -> bool {
+    return url.starts_with(MemoryStorageFactory::cUrlScheme);
+}
+}  // namespace spider::core
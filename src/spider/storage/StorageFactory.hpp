@@ -2,6 +2,7 @@
 #define SPIDER_STORAGE_STORAGEFACTORY_HPP
 
 #include <memory>
+#include <string>
 #include <variant>
 
 #include <spider/core/Error.hpp>
@@ -15,9 +16,19 @@ class StorageFactory {
 public:
     virtual auto provide_data_storage() -> std::unique_ptr<DataStorage> = 0;
     virtual auto provide_metadata_storage() -> std::unique_ptr<MetadataStorage> = 0;
+    /**
+     * Checks out a connection. Implementations may reuse a pooled connection, which is returned to
+     * the pool when the connection is destroyed.
+     */
     virtual auto provide_storage_connection()
             -> std::variant<std::unique_ptr<StorageConnection>, StorageErr>
             = 0;
+    /**
+     * Opens a new connection that is not pooled, e.g. for a pool managed by the caller.
+     */
+    virtual auto create_storage_connection()
+            -> std::variant<std::unique_ptr<StorageConnection>, StorageErr>
+            = 0;
     virtual auto provide_job_submission_batch(StorageConnection&)
             -> std::unique_ptr<JobSubmissionBatch>
             = 0;
@@ -29,6 +40,24 @@ public:
     auto operator=(StorageFactory&&) -> StorageFactory& = default;
     virtual ~StorageFactory() = default;
 };
+
+/**
+ * Creates the storage factory of a storage URL. URLs starting with `memory://` select the in-memory
+ * storage, and URLs starting with `file://` the storage persisted in a local directory. Other URLs
+ * are treated as MySQL JDBC URLs.
+ *
+ * @param url
+ * @return The storage factory.
+ */
+auto create_storage_factory(std::string const& url) -> std::shared_ptr<StorageFactory>;
+
+/**
+ * @param url
+ * @return Whether the storage of the URL is only reachable from the process that opens it, i.e. the
+ * in-memory storage. Such storages cannot be shared by the scheduler, worker and task executor
+ * processes, so these reject them.
+ */
+auto is_process_local_storage_url(std::string const& url) -> bool;
 }  // namespace spider::core
 
 #endif
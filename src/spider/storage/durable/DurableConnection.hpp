@@ -0,0 +1,49 @@
+#ifndef SPIDER_STORAGE_DURABLECONNECTION_HPP
+#define SPIDER_STORAGE_DURABLECONNECTION_HPP
+
+#include <memory>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/durable/DurableStore.hpp>
+#include <spider/storage/memory/MemoryConnection.hpp>
+
+namespace spider::core {
+// Connection to a durable store. Changes are durable once an operation returns, so there is
+// nothing to commit or roll back.
+class DurableConnection : public MemoryConnection {
+public:
+    explicit DurableConnection(std::shared_ptr<DurableStore> store)
+            : MemoryConnection{store->get_store()},
+              m_durable_store{std::move(store)} {}
+
+    // Delete copy constructor and copy assignment operator
+    DurableConnection(DurableConnection const&) = delete;
+    auto operator=(DurableConnection const&) -> DurableConnection& = delete;
+    // Default move constructor and move assignment operator
+    DurableConnection(DurableConnection&&) = default;
+    auto operator=(DurableConnection&&) -> DurableConnection& = default;
+
+    ~DurableConnection() override = default;
+
+    [[nodiscard]] auto get_durable_store() const -> DurableStore& { return *m_durable_store; }
+
+    /**
+     * Replays the changes other processes made to the store. If they cannot be replayed, the
+     * operation goes on with the store as it is, and the next change fails with the error.
+     */
+    auto refresh() -> void override {
+        StorageErr const err = m_durable_store->refresh();
+        if (false == err.success()) {
+            spdlog::error("Cannot refresh durable store: {}", err.description);
+        }
+    }
+
+private:
+    std::shared_ptr<DurableStore> m_durable_store;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_DURABLECONNECTION_HPP
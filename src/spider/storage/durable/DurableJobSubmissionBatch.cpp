@@ -0,0 +1,13 @@
+#include "DurableJobSubmissionBatch.hpp"
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/durable/DurableStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+auto DurableJobSubmissionBatch::submit_batch(StorageConnection& conn) -> StorageErr {
+    StorageErr err = DurableMetadataStorage::commit_jobs(conn, m_jobs);
+    m_jobs.clear();
+    return err;
+}
+}  // namespace spider::core
@@ -0,0 +1,30 @@
+#ifndef SPIDER_STORAGE_DURABLEJOBSUBMISSIONBATCH_HPP
+#define SPIDER_STORAGE_DURABLEJOBSUBMISSIONBATCH_HPP
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/memory/MemoryJobSubmissionBatch.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+// Forward declaration for friend class
+class DurableStorageFactory;
+
+// Stages jobs and inserts them all at once with a single log record.
+class DurableJobSubmissionBatch : public MemoryJobSubmissionBatch {
+public:
+    DurableJobSubmissionBatch(DurableJobSubmissionBatch const&) = delete;
+    auto operator=(DurableJobSubmissionBatch const&) -> DurableJobSubmissionBatch& = delete;
+    DurableJobSubmissionBatch(DurableJobSubmissionBatch&&) = default;
+    auto operator=(DurableJobSubmissionBatch&&) -> DurableJobSubmissionBatch& = default;
+    ~DurableJobSubmissionBatch() override = default;
+
+    auto submit_batch(StorageConnection& conn) -> StorageErr override;
+
+private:
+    DurableJobSubmissionBatch() = default;
+
+    friend class DurableStorageFactory;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_DURABLEJOBSUBMISSIONBATCH_HPP
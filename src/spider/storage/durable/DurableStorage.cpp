@@ -0,0 +1,794 @@
+#include "DurableStorage.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+#include <fmt/format.h>
+
+#include <spider/core/Data.hpp>
+#include <spider/core/Driver.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/core/KeyValueData.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/core/TaskGraph.hpp>
+#include <spider/storage/durable/DurableConnection.hpp>
+#include <spider/storage/durable/DurableStore.hpp>
+#include <spider/storage/durable/StoreCodec.hpp>
+#include <spider/storage/memory/MemoryConnection.hpp>
+#include <spider/storage/memory/MemoryStorage.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+namespace {
+constexpr std::size_t cUuidSize = 16;
+
+// Type of a log record. Values are stored in the log, so they must not change.
+enum class LogOp : std::uint8_t {
+    AddDriver = 1,
+    AddScheduler = 2,
+    RemoveDriver = 3,
+    AddJobs = 4,
+    RemoveJob = 5,
+    ResetJob = 6,
+    SetTaskState = 7,
+    SetTaskRunning = 8,
+    AddTaskInstance = 9,
+    CreateTaskInstances = 10,
+    TaskFinish = 11,
+    TaskFail = 12,
+    RecoverTaskInstances = 13,
+    AddDriverData = 14,
+    AddTaskData = 15,
+    SetDataLocality = 16,
+    RemoveData = 17,
+    AddTaskReference = 18,
+    RemoveTaskReference = 19,
+    AddDriverReference = 20,
+    RemoveDriverReference = 21,
+    RemoveDanglingData = 22,
+    AddClientKvData = 23,
+    AddTaskKvData = 24,
+    UpdateHeartbeat = 25,
+};
+
+auto get_durable_store(StorageConnection& conn) -> DurableStore& {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    return static_cast<DurableConnection&>(conn).get_durable_store();
+}
+
+auto get_memory_store(StorageConnection& conn) -> MemoryStore& {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    return static_cast<MemoryConnection&>(conn).get_store();
+}
+
+auto write_op(BinaryWriter& record, LogOp const op) -> void {
+    record.write_u8(static_cast<std::uint8_t>(op));
+}
+
+auto write_instance(BinaryWriter& record, TaskInstance const& instance) -> void {
+    record.write_uuid(instance.id);
+    record.write_uuid(instance.task_id);
+}
+
+auto read_instance(BinaryReader& reader) -> TaskInstance {
+    boost::uuids::uuid const id = reader.read_uuid();
+    return TaskInstance{id, reader.read_uuid()};
+}
+
+/**
+ * Writes the record of task instances created for their tasks.
+ *
+ * @param record
+ * @param worker_id The worker running the instances, if known.
+ * @param instances
+ * @param begin The position of the first created instance in `instances`.
+ */
+auto write_create_instances(
+        BinaryWriter& record,
+        std::optional<boost::uuids::uuid> const& worker_id,
+        std::vector<TaskInstance> const& instances,
+        std::size_t const begin
+) -> void {
+    write_op(record, LogOp::CreateTaskInstances);
+    record.write_optional_uuid(worker_id);
+    record.write_u64(instances.size() - begin);
+    for (std::size_t i = begin; i < instances.size(); ++i) {
+        write_instance(record, instances[i]);
+    }
+}
+
+/**
+ * Writes the record of removed task instances whose tasks are made ready again. Nothing is written
+ * if there is no instance.
+ *
+ * @param record
+ * @param instance_ids
+ */
+auto write_recover_instances(
+        BinaryWriter& record,
+        std::vector<boost::uuids::uuid> const& instance_ids
+) -> void {
+    if (instance_ids.empty()) {
+        return;
+    }
+    write_op(record, LogOp::RecoverTaskInstances);
+    record.write_u64(instance_ids.size());
+    for (boost::uuids::uuid const& instance_id : instance_ids) {
+        record.write_uuid(instance_id);
+    }
+}
+
+auto write_task_finish(
+        BinaryWriter& record,
+        TaskInstance const& instance,
+        std::vector<TaskOutput> const& outputs
+) -> void {
+    write_instance(record, instance);
+    record.write_u64(outputs.size());
+    for (TaskOutput const& output : outputs) {
+        write_task_output(record, output);
+    }
+}
+
+auto write_data_reference(
+        BinaryWriter& record,
+        LogOp const op,
+        boost::uuids::uuid const data_id,
+        boost::uuids::uuid const owner_id
+) -> void {
+    write_op(record, op);
+    record.write_uuid(data_id);
+    record.write_uuid(owner_id);
+}
+
+auto write_kv_data(BinaryWriter& record, LogOp const op, KeyValueData const& data) -> void {
+    write_op(record, op);
+    record.write_uuid(data.get_id());
+    record.write_string(data.get_key());
+    record.write_string(data.get_value());
+}
+
+auto read_kv_data(BinaryReader& reader) -> KeyValueData {
+    boost::uuids::uuid const id = reader.read_uuid();
+    std::string key = reader.read_string();
+    return KeyValueData{std::move(key), reader.read_string(), id};
+}
+}  // namespace
+
+auto DurableMetadataStorage::add_driver(StorageConnection& conn, Driver const& driver)
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::AddDriver);
+        record.write_uuid(driver.get_id());
+        return MemoryMetadataStorage::add_driver(conn, driver);
+    });
+}
+
+auto DurableMetadataStorage::add_scheduler(StorageConnection& conn, Scheduler const& scheduler)
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::AddScheduler);
+        record.write_uuid(scheduler.get_id());
+        record.write_string(scheduler.get_addr());
+        record.write_i32(scheduler.get_port());
+        return MemoryMetadataStorage::add_scheduler(conn, scheduler);
+    });
+}
+
+auto DurableMetadataStorage::remove_driver(StorageConnection& conn, boost::uuids::uuid id) noexcept
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::RemoveDriver);
+        record.write_uuid(id);
+        return MemoryMetadataStorage::remove_driver(conn, id);
+    });
+}
+
+auto DurableMetadataStorage::commit_jobs(
+        StorageConnection& conn,
+        std::vector<MemoryStore::StagedJob>& jobs
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        // Jobs are moved into the store, so they are written first
+        write_op(record, LogOp::AddJobs);
+        record.write_u64(jobs.size());
+        for (MemoryStore::StagedJob const& job : jobs) {
+            write_staged_job(record, job);
+        }
+        return insert_jobs(get_memory_store(conn), jobs);
+    });
+}
+
+auto DurableMetadataStorage::add_job(
+        StorageConnection& conn,
+        boost::uuids::uuid job_id,
+        boost::uuids::uuid client_id,
+        TaskGraph const& task_graph,
+        std::int32_t priority
+) -> StorageErr {
+    std::variant<MemoryStore::StagedJob, StorageErr> staged
+            = stage_job(job_id, client_id, task_graph, priority);
+    if (std::holds_alternative<StorageErr>(staged)) {
+        return std::get<StorageErr>(staged);
+    }
+    std::vector<MemoryStore::StagedJob> jobs;
+    jobs.push_back(std::move(std::get<MemoryStore::StagedJob>(staged)));
+    return commit_jobs(conn, jobs);
+}
+
+auto DurableMetadataStorage::remove_job(StorageConnection& conn, boost::uuids::uuid id) noexcept
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::RemoveJob);
+        record.write_uuid(id);
+        return MemoryMetadataStorage::remove_job(conn, id);
+    });
+}
+
+auto DurableMetadataStorage::reset_job(StorageConnection& conn, boost::uuids::uuid id)
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::ResetJob);
+        record.write_uuid(id);
+        return MemoryMetadataStorage::reset_job(conn, id);
+    });
+}
+
+auto DurableMetadataStorage::set_task_state(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        TaskState state
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::SetTaskState);
+        record.write_uuid(id);
+        record.write_u8(static_cast<std::uint8_t>(state));
+        return MemoryMetadataStorage::set_task_state(conn, id, state);
+    });
+}
+
+auto DurableMetadataStorage::set_task_running(StorageConnection& conn, boost::uuids::uuid id)
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::SetTaskRunning);
+        record.write_uuid(id);
+        return MemoryMetadataStorage::set_task_running(conn, id);
+    });
+}
+
+auto DurableMetadataStorage::add_task_instance(
+        StorageConnection& conn,
+        TaskInstance const& instance
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::AddTaskInstance);
+        write_instance(record, instance);
+        return MemoryMetadataStorage::add_task_instance(conn, instance);
+    });
+}
+
+auto DurableMetadataStorage::create_task_instance(
+        StorageConnection& conn,
+        TaskInstance const& instance
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_create_instances(record, std::nullopt, {instance}, 0);
+        return MemoryMetadataStorage::create_task_instance(conn, instance);
+    });
+}
+
+auto DurableMetadataStorage::create_task_instances(
+        StorageConnection& conn,
+        std::vector<TaskInstance> const& instances,
+        std::vector<TaskInstance>* created
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        // Only the instances created are logged
+        std::size_t const num_created = created->size();
+        StorageErr err = MemoryMetadataStorage::create_task_instances(conn, instances, created);
+        if (err.success() && created->size() > num_created) {
+            write_create_instances(record, std::nullopt, *created, num_created);
+        }
+        return err;
+    });
+}
+
+auto DurableMetadataStorage::start_task_instances(
+        StorageConnection& conn,
+        boost::uuids::uuid worker_id,
+        std::vector<TaskInstance> const& instances,
+        std::vector<TaskInstance>* created,
+        std::vector<Task>* tasks
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        std::size_t const num_created = created->size();
+        StorageErr err = MemoryMetadataStorage::start_task_instances(
+                conn,
+                worker_id,
+                instances,
+                created,
+                tasks
+        );
+        if (err.success() && created->size() > num_created) {
+            write_create_instances(record, worker_id, *created, num_created);
+        }
+        return err;
+    });
+}
+
+auto DurableMetadataStorage::task_finish(
+        StorageConnection& conn,
+        TaskInstance const& instance,
+        std::vector<TaskOutput> const& outputs
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::TaskFinish);
+        record.write_u64(1);
+        write_task_finish(record, instance, outputs);
+        return MemoryMetadataStorage::task_finish(conn, instance, outputs);
+    });
+}
+
+auto DurableMetadataStorage::task_finish_batch(
+        StorageConnection& conn,
+        std::vector<TaskInstance> const& instances,
+        std::vector<std::vector<TaskOutput>> const& outputs
+) -> StorageErr {
+    if (instances.size() != outputs.size() || instances.empty()) {
+        return MemoryMetadataStorage::task_finish_batch(conn, instances, outputs);
+    }
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::TaskFinish);
+        record.write_u64(instances.size());
+        for (std::size_t i = 0; i < instances.size(); ++i) {
+            write_task_finish(record, instances[i], outputs[i]);
+        }
+        return MemoryMetadataStorage::task_finish_batch(conn, instances, outputs);
+    });
+}
+
+auto DurableMetadataStorage::task_fail(
+        StorageConnection& conn,
+        TaskInstance const& instance,
+        std::string const& error
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::TaskFail);
+        write_instance(record, instance);
+        return MemoryMetadataStorage::task_fail(conn, instance, error);
+    });
+}
+
+auto DurableMetadataStorage::update_heartbeat(StorageConnection& conn, boost::uuids::uuid id)
+        -> StorageErr {
+    // Logged so that the scheduler sees the heartbeats of workers in other processes
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::UpdateHeartbeat);
+        record.write_uuid(id);
+        return MemoryMetadataStorage::update_heartbeat(conn, id);
+    });
+}
+
+auto DurableMetadataStorage::recover_dead_worker_tasks(
+        StorageConnection& conn,
+        double timeout,
+        std::vector<boost::uuids::uuid>* task_ids
+) -> StorageErr {
+    MemoryStore& store = get_memory_store(conn);
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        // Heartbeats are replayed with the time they are read, so the recovered instances are
+        // logged instead of the timeout
+        std::unique_lock const lock{store.metadata_mutex};
+        std::vector<boost::uuids::uuid> const instance_ids
+                = find_dead_worker_instances(store, timeout);
+        recover_task_instances(store, instance_ids, task_ids);
+        write_recover_instances(record, instance_ids);
+        return StorageErr{};
+    });
+}
+
+auto DurableMetadataStorage::remove_task_instances(
+        StorageConnection& conn,
+        std::vector<TaskInstance> const& instances,
+        std::vector<boost::uuids::uuid>* task_ids
+) -> StorageErr {
+    MemoryStore& store = get_memory_store(conn);
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        std::vector<boost::uuids::uuid> instance_ids;
+        instance_ids.reserve(instances.size());
+        for (TaskInstance const& instance : instances) {
+            instance_ids.push_back(instance.id);
+        }
+        std::unique_lock const lock{store.metadata_mutex};
+        recover_task_instances(store, instance_ids, task_ids);
+        write_recover_instances(record, instance_ids);
+        return StorageErr{};
+    });
+}
+
+auto DurableDataStorage::add_driver_data(
+        StorageConnection& conn,
+        boost::uuids::uuid driver_id,
+        Data const& data
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::AddDriverData);
+        record.write_uuid(driver_id);
+        write_data(record, data);
+        return MemoryDataStorage::add_driver_data(conn, driver_id, data);
+    });
+}
+
+auto DurableDataStorage::add_task_data(
+        StorageConnection& conn,
+        boost::uuids::uuid task_id,
+        Data const& data
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::AddTaskData);
+        record.write_uuid(task_id);
+        write_data(record, data);
+        return MemoryDataStorage::add_task_data(conn, task_id, data);
+    });
+}
+
+auto DurableDataStorage::get_driver_data(
+        StorageConnection& conn,
+        boost::uuids::uuid driver_id,
+        boost::uuids::uuid data_id,
+        Data* data
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_data_reference(record, LogOp::AddDriverReference, data_id, driver_id);
+        return MemoryDataStorage::get_driver_data(conn, driver_id, data_id, data);
+    });
+}
+
+auto DurableDataStorage::get_task_data(
+        StorageConnection& conn,
+        boost::uuids::uuid task_id,
+        boost::uuids::uuid data_id,
+        Data* data
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_data_reference(record, LogOp::AddTaskReference, data_id, task_id);
+        return MemoryDataStorage::get_task_data(conn, task_id, data_id, data);
+    });
+}
+
+auto DurableDataStorage::set_data_locality(StorageConnection& conn, Data const& data)
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::SetDataLocality);
+        record.write_uuid(data.get_id());
+        record.write_bool(data.is_hard_locality());
+        record.write_u64(data.get_locality().size());
+        for (std::string const& locality : data.get_locality()) {
+            record.write_string(locality);
+        }
+        return MemoryDataStorage::set_data_locality(conn, data);
+    });
+}
+
+auto DurableDataStorage::remove_data(StorageConnection& conn, boost::uuids::uuid id)
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::RemoveData);
+        record.write_uuid(id);
+        return MemoryDataStorage::remove_data(conn, id);
+    });
+}
+
+auto DurableDataStorage::add_task_reference(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        boost::uuids::uuid task_id
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_data_reference(record, LogOp::AddTaskReference, id, task_id);
+        return MemoryDataStorage::add_task_reference(conn, id, task_id);
+    });
+}
+
+auto DurableDataStorage::remove_task_reference(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        boost::uuids::uuid task_id
+) noexcept -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_data_reference(record, LogOp::RemoveTaskReference, id, task_id);
+        return MemoryDataStorage::remove_task_reference(conn, id, task_id);
+    });
+}
+
+auto DurableDataStorage::add_driver_reference(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        boost::uuids::uuid driver_id
+) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_data_reference(record, LogOp::AddDriverReference, id, driver_id);
+        return MemoryDataStorage::add_driver_reference(conn, id, driver_id);
+    });
+}
+
+auto DurableDataStorage::remove_driver_reference(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        boost::uuids::uuid driver_id
+) noexcept -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_data_reference(record, LogOp::RemoveDriverReference, id, driver_id);
+        return MemoryDataStorage::remove_driver_reference(conn, id, driver_id);
+    });
+}
+
+auto DurableDataStorage::remove_dangling_data(StorageConnection& conn) -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_op(record, LogOp::RemoveDanglingData);
+        return MemoryDataStorage::remove_dangling_data(conn);
+    });
+}
+
+auto DurableDataStorage::add_client_kv_data(StorageConnection& conn, KeyValueData const& data)
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_kv_data(record, LogOp::AddClientKvData, data);
+        return MemoryDataStorage::add_client_kv_data(conn, data);
+    });
+}
+
+auto DurableDataStorage::add_task_kv_data(StorageConnection& conn, KeyValueData const& data)
+        -> StorageErr {
+    return get_durable_store(conn).commit([&](BinaryWriter& record) {
+        write_kv_data(record, LogOp::AddTaskKvData, data);
+        return MemoryDataStorage::add_task_kv_data(conn, data);
+    });
+}
+
+// NOLINTBEGIN(readability-function-cognitive-complexity)
+auto replay_log_record(StorageConnection& conn, std::string_view const record) -> StorageErr {
+    DurableMetadataStorage metadata_storage;
+    DurableDataStorage data_storage;
+    MemoryStore& store = get_memory_store(conn);
+    BinaryReader reader{record};
+    auto const op = static_cast<LogOp>(reader.read_u8());
+
+    // Reads the arguments of the change, then applies it if the whole record is read
+    auto const apply = [&](auto&& change) -> StorageErr {
+        if (reader.failed() || false == reader.at_end()) {
+            return StorageErr{StorageErrType::OtherErr, "corrupt log record"};
+        }
+        StorageErr err = change();
+        if (false == err.success()) {
+            return StorageErr{
+                    StorageErrType::OtherErr,
+                    fmt::format("cannot replay log record: {}", err.description)
+            };
+        }
+        return err;
+    };
+
+    switch (op) {
+        case LogOp::AddDriver: {
+            Driver const driver{reader.read_uuid()};
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::add_driver(conn, driver);
+            });
+        }
+        case LogOp::AddScheduler: {
+            boost::uuids::uuid const id = reader.read_uuid();
+            std::string addr = reader.read_string();
+            Scheduler const scheduler{id, std::move(addr), reader.read_i32()};
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::add_scheduler(conn, scheduler);
+            });
+        }
+        case LogOp::RemoveDriver: {
+            boost::uuids::uuid const id = reader.read_uuid();
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::remove_driver(conn, id);
+            });
+        }
+        case LogOp::AddJobs: {
+            std::vector<MemoryStore::StagedJob> jobs(reader.read_size(cUuidSize));
+            for (MemoryStore::StagedJob& job : jobs) {
+                job = read_staged_job(reader);
+            }
+            return apply([&] { return DurableMetadataStorage::insert_jobs(store, jobs); });
+        }
+        case LogOp::RemoveJob: {
+            boost::uuids::uuid const id = reader.read_uuid();
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::remove_job(conn, id);
+            });
+        }
+        case LogOp::ResetJob: {
+            boost::uuids::uuid const id = reader.read_uuid();
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::reset_job(conn, id);
+            });
+        }
+        case LogOp::SetTaskState: {
+            boost::uuids::uuid const id = reader.read_uuid();
+            auto const state = static_cast<TaskState>(reader.read_u8());
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::set_task_state(conn, id, state);
+            });
+        }
+        case LogOp::SetTaskRunning: {
+            boost::uuids::uuid const id = reader.read_uuid();
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::set_task_running(conn, id);
+            });
+        }
+        case LogOp::AddTaskInstance: {
+            TaskInstance const instance = read_instance(reader);
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::add_task_instance(conn, instance);
+            });
+        }
+        case LogOp::CreateTaskInstances: {
+            std::optional<boost::uuids::uuid> const worker_id = reader.read_optional_uuid();
+            std::size_t const num_instances = reader.read_size(2 * cUuidSize);
+            std::vector<TaskInstance> instances;
+            for (std::size_t i = 0; i < num_instances; ++i) {
+                instances.push_back(read_instance(reader));
+            }
+            return apply([&] {
+                std::unique_lock const lock{store.metadata_mutex};
+                for (TaskInstance const& instance : instances) {
+                    StorageErr err = DurableMetadataStorage::create_task_instance_impl(
+                            store,
+                            instance,
+                            worker_id
+                    );
+                    if (false == err.success()) {
+                        return err;
+                    }
+                }
+                return StorageErr{};
+            });
+        }
+        case LogOp::TaskFinish: {
+            std::size_t const num_instances = reader.read_size(2 * cUuidSize);
+            std::vector<TaskInstance> instances;
+            std::vector<std::vector<TaskOutput>> outputs(num_instances);
+            for (std::vector<TaskOutput>& instance_outputs : outputs) {
+                instances.push_back(read_instance(reader));
+                std::size_t const num_outputs = reader.read_size(1);
+                for (std::size_t i = 0; i < num_outputs; ++i) {
+                    instance_outputs.push_back(read_task_output(reader));
+                }
+            }
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::task_finish_batch(
+                        conn,
+                        instances,
+                        outputs
+                );
+            });
+        }
+        case LogOp::TaskFail: {
+            TaskInstance const instance = read_instance(reader);
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::task_fail(conn, instance, "");
+            });
+        }
+        case LogOp::RecoverTaskInstances: {
+            std::vector<boost::uuids::uuid> instance_ids(reader.read_size(cUuidSize));
+            for (boost::uuids::uuid& instance_id : instance_ids) {
+                instance_id = reader.read_uuid();
+            }
+            return apply([&] {
+                std::unique_lock const lock{store.metadata_mutex};
+                std::vector<boost::uuids::uuid> task_ids;
+                DurableMetadataStorage::recover_task_instances(store, instance_ids, &task_ids);
+                return StorageErr{};
+            });
+        }
+        case LogOp::AddDriverData: {
+            boost::uuids::uuid const driver_id = reader.read_uuid();
+            Data const data = read_data(reader);
+            return apply([&] {
+                return data_storage.MemoryDataStorage::add_driver_data(conn, driver_id, data);
+            });
+        }
+        case LogOp::AddTaskData: {
+            boost::uuids::uuid const task_id = reader.read_uuid();
+            Data const data = read_data(reader);
+            return apply([&] {
+                return data_storage.MemoryDataStorage::add_task_data(conn, task_id, data);
+            });
+        }
+        case LogOp::SetDataLocality: {
+            Data data{reader.read_uuid(), ""};
+            data.set_hard_locality(reader.read_bool());
+            std::vector<std::string> locality(reader.read_size(sizeof(std::uint64_t)));
+            for (std::string& address : locality) {
+                address = reader.read_string();
+            }
+            data.set_locality(locality);
+            return apply([&] {
+                return data_storage.MemoryDataStorage::set_data_locality(conn, data);
+            });
+        }
+        case LogOp::RemoveData: {
+            boost::uuids::uuid const id = reader.read_uuid();
+            return apply([&] { return data_storage.MemoryDataStorage::remove_data(conn, id); });
+        }
+        case LogOp::AddTaskReference:
+        case LogOp::RemoveTaskReference:
+        case LogOp::AddDriverReference:
+        case LogOp::RemoveDriverReference: {
+            boost::uuids::uuid const id = reader.read_uuid();
+            boost::uuids::uuid const owner_id = reader.read_uuid();
+            return apply([&] {
+                switch (op) {
+                    case LogOp::AddTaskReference:
+                        return data_storage.MemoryDataStorage::add_task_reference(
+                                conn,
+                                id,
+                                owner_id
+                        );
+                    case LogOp::RemoveTaskReference:
+                        return data_storage.MemoryDataStorage::remove_task_reference(
+                                conn,
+                                id,
+                                owner_id
+                        );
+                    case LogOp::AddDriverReference:
+                        return data_storage.MemoryDataStorage::add_driver_reference(
+                                conn,
+                                id,
+                                owner_id
+                        );
+                    default:
+                        return data_storage.MemoryDataStorage::remove_driver_reference(
+                                conn,
+                                id,
+                                owner_id
+                        );
+                }
+            });
+        }
+        case LogOp::RemoveDanglingData:
+            return apply([&] {
+                return data_storage.MemoryDataStorage::remove_dangling_data(conn);
+            });
+        case LogOp::AddClientKvData: {
+            KeyValueData const data = read_kv_data(reader);
+            return apply([&] {
+                return data_storage.MemoryDataStorage::add_client_kv_data(conn, data);
+            });
+        }
+        case LogOp::AddTaskKvData: {
+            KeyValueData const data = read_kv_data(reader);
+            return apply([&] {
+                return data_storage.MemoryDataStorage::add_task_kv_data(conn, data);
+            });
+        }
+        case LogOp::UpdateHeartbeat: {
+            boost::uuids::uuid const id = reader.read_uuid();
+            return apply([&] {
+                return metadata_storage.MemoryMetadataStorage::update_heartbeat(conn, id);
+            });
+        }
+    }
+    return StorageErr{
+            StorageErrType::OtherErr,
+            fmt::format("unknown log record type {}", static_cast<int>(op))
+    };
+}
+
+// NOLINTEND(readability-function-cognitive-complexity)
+}  // namespace spider::core
@@ -0,0 +1,180 @@
+#ifndef SPIDER_STORAGE_DURABLESTORAGE_HPP
+#define SPIDER_STORAGE_DURABLESTORAGE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Data.hpp>
+#include <spider/core/Driver.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/core/KeyValueData.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/core/TaskGraph.hpp>
+#include <spider/storage/memory/MemoryStorage.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+// Forward declaration for friend class
+class DurableStorageFactory;
+class DurableJobSubmissionBatch;
+
+/**
+ * Replays a record of the write-ahead log of a durable store on the in-memory store of a
+ * connection.
+ *
+ * @param conn A connection to the in-memory store being recovered.
+ * @param record
+ * @return StorageErr::Success if the record is replayed.
+ * @return StorageErrType::OtherErr if the record is corrupt or its change cannot be applied again.
+ */
+auto replay_log_record(StorageConnection& conn, std::string_view record) -> StorageErr;
+
+// Metadata storage of a `DurableStore`. Operations behave as in `MemoryMetadataStorage`, and
+// changes are logged before the operation returns.
+class DurableMetadataStorage : public MemoryMetadataStorage {
+public:
+    DurableMetadataStorage(DurableMetadataStorage const&) = default;
+    DurableMetadataStorage(DurableMetadataStorage&&) = default;
+    auto operator=(DurableMetadataStorage const&) -> DurableMetadataStorage& = default;
+    auto operator=(DurableMetadataStorage&&) -> DurableMetadataStorage& = default;
+    ~DurableMetadataStorage() override = default;
+    auto add_driver(StorageConnection& conn, Driver const& driver) -> StorageErr override;
+    auto add_scheduler(StorageConnection& conn, Scheduler const& scheduler) -> StorageErr override;
+    auto remove_driver(StorageConnection& conn, boost::uuids::uuid id) noexcept
+            -> StorageErr override;
+    using MemoryMetadataStorage::add_job;
+    auto add_job(
+            StorageConnection& conn,
+            boost::uuids::uuid job_id,
+            boost::uuids::uuid client_id,
+            TaskGraph const& task_graph,
+            std::int32_t priority
+    ) -> StorageErr override;
+    auto remove_job(StorageConnection& conn, boost::uuids::uuid id) noexcept -> StorageErr override;
+    auto reset_job(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr override;
+    auto set_task_state(StorageConnection& conn, boost::uuids::uuid id, TaskState state)
+            -> StorageErr override;
+    auto set_task_running(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr override;
+    auto add_task_instance(StorageConnection& conn, TaskInstance const& instance)
+            -> StorageErr override;
+    auto create_task_instance(StorageConnection& conn, TaskInstance const& instance)
+            -> StorageErr override;
+    auto create_task_instances(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<TaskInstance>* created
+    ) -> StorageErr override;
+    auto start_task_instances(
+            StorageConnection& conn,
+            boost::uuids::uuid worker_id,
+            std::vector<TaskInstance> const& instances,
+            std::vector<TaskInstance>* created,
+            std::vector<Task>* tasks
+    ) -> StorageErr override;
+    auto task_finish(
+            StorageConnection& conn,
+            TaskInstance const& instance,
+            std::vector<TaskOutput> const& outputs
+    ) -> StorageErr override;
+    auto task_finish_batch(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<std::vector<TaskOutput>> const& outputs
+    ) -> StorageErr override;
+    auto task_fail(StorageConnection& conn, TaskInstance const& instance, std::string const& error)
+            -> StorageErr override;
+    auto update_heartbeat(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr override;
+    auto recover_dead_worker_tasks(
+            StorageConnection& conn,
+            double timeout,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> StorageErr override;
+    auto remove_task_instances(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> StorageErr override;
+
+private:
+    DurableMetadataStorage() = default;
+
+    /**
+     * Inserts staged jobs, either all of them or none, and logs them.
+     *
+     * @param conn
+     * @param jobs
+     * @return StorageErr::Success if all jobs are inserted. Error types otherwise.
+     */
+    static auto commit_jobs(StorageConnection& conn, std::vector<MemoryStore::StagedJob>& jobs)
+            -> StorageErr;
+
+    friend class DurableStorageFactory;
+    friend class DurableJobSubmissionBatch;
+    friend auto replay_log_record(StorageConnection& conn, std::string_view record) -> StorageErr;
+};
+
+// Data storage of a `DurableStore`. Operations behave as in `MemoryDataStorage`, and changes are
+// logged before the operation returns. Reading the data of a driver or task adds a reference, so
+// it is logged as well.
+class DurableDataStorage : public MemoryDataStorage {
+public:
+    DurableDataStorage(DurableDataStorage const&) = default;
+    DurableDataStorage(DurableDataStorage&&) = default;
+    auto operator=(DurableDataStorage const&) -> DurableDataStorage& = default;
+    auto operator=(DurableDataStorage&&) -> DurableDataStorage& = default;
+    ~DurableDataStorage() override = default;
+    auto add_driver_data(StorageConnection& conn, boost::uuids::uuid driver_id, Data const& data)
+            -> StorageErr override;
+    auto add_task_data(StorageConnection& conn, boost::uuids::uuid task_id, Data const& data)
+            -> StorageErr override;
+    auto get_driver_data(
+            StorageConnection& conn,
+            boost::uuids::uuid driver_id,
+            boost::uuids::uuid data_id,
+            Data* data
+    ) -> StorageErr override;
+    auto get_task_data(
+            StorageConnection& conn,
+            boost::uuids::uuid task_id,
+            boost::uuids::uuid data_id,
+            Data* data
+    ) -> StorageErr override;
+    auto set_data_locality(StorageConnection& conn, Data const& data) -> StorageErr override;
+    auto remove_data(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr override;
+    auto
+    add_task_reference(StorageConnection& conn, boost::uuids::uuid id, boost::uuids::uuid task_id)
+            -> StorageErr override;
+    auto remove_task_reference(
+            StorageConnection& conn,
+            boost::uuids::uuid id,
+            boost::uuids::uuid task_id
+    ) noexcept -> StorageErr override;
+    auto add_driver_reference(
+            StorageConnection& conn,
+            boost::uuids::uuid id,
+            boost::uuids::uuid driver_id
+    ) -> StorageErr override;
+    auto remove_driver_reference(
+            StorageConnection& conn,
+            boost::uuids::uuid id,
+            boost::uuids::uuid driver_id
+    ) noexcept -> StorageErr override;
+    auto remove_dangling_data(StorageConnection& conn) -> StorageErr override;
+    auto add_client_kv_data(StorageConnection& conn, KeyValueData const& data)
+            -> StorageErr override;
+    auto add_task_kv_data(StorageConnection& conn, KeyValueData const& data) -> StorageErr override;
+
+private:
+    DurableDataStorage() = default;
+
+    friend class DurableStorageFactory;
+    friend auto replay_log_record(StorageConnection& conn, std::string_view record) -> StorageErr;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_DURABLESTORAGE_HPP
@@ -0,0 +1,54 @@
+#include "DurableStorageFactory.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <variant>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/durable/DurableConnection.hpp>
+#include <spider/storage/durable/DurableJobSubmissionBatch.hpp>
+#include <spider/storage/durable/DurableStorage.hpp>
+#include <spider/storage/durable/DurableStore.hpp>
+#include <spider/storage/JobSubmissionBatch.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+DurableStorageFactory::DurableStorageFactory(std::string const& url)
+        : m_directory{url.starts_with(cUrlScheme) ? url.substr(cUrlScheme.size()) : url} {}
+
+auto DurableStorageFactory::provide_data_storage() -> std::unique_ptr<DataStorage> {
+    return std::unique_ptr<DataStorage>(new DurableDataStorage());
+}
+
+auto DurableStorageFactory::provide_metadata_storage() -> std::unique_ptr<MetadataStorage> {
+    return std::unique_ptr<MetadataStorage>(new DurableMetadataStorage());
+}
+
+auto DurableStorageFactory::provide_storage_connection()
+        -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> {
+    return create_storage_connection();
+}
+
+auto DurableStorageFactory::create_storage_connection()
+        -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> {
+    std::lock_guard const lock{m_mutex};
+    if (nullptr == m_store) {
+        std::variant<std::shared_ptr<DurableStore>, StorageErr> result
+                = DurableStore::open(m_directory);
+        if (std::holds_alternative<StorageErr>(result)) {
+            return std::get<StorageErr>(result);
+        }
+        m_store = std::move(std::get<std::shared_ptr<DurableStore>>(result));
+    }
+    return std::unique_ptr<StorageConnection>(new DurableConnection{m_store});
+}
+
+auto DurableStorageFactory::provide_job_submission_batch(StorageConnection& /*conn*/)
+        -> std::unique_ptr<JobSubmissionBatch> {
+    return std::unique_ptr<JobSubmissionBatch>(new DurableJobSubmissionBatch());
+}
+}  // namespace spider::core
@@ -0,0 +1,57 @@
+#ifndef SPIDER_STORAGE_DURABLESTORAGEFACTORY_HPP
+#define SPIDER_STORAGE_DURABLESTORAGEFACTORY_HPP
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/durable/DurableStore.hpp>
+#include <spider/storage/JobSubmissionBatch.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageFactory.hpp>
+
+namespace spider::core {
+/**
+ * Factory of storages persisted in a local directory, for deployments on one machine without a
+ * database server. The storage is kept in memory like the `memory://` storage and survives restarts
+ * through a write-ahead log and snapshots in the directory. The scheduler, workers, task executors
+ * and clients on the machine share the storage by opening the same directory, each keeping a copy
+ * in memory that follows the log.
+ *
+ * Heartbeat and task instance start times are not persisted, so a process opening the directory
+ * treats the drivers and task instances it recovers as timed out, until the drivers send another
+ * heartbeat.
+ */
+class DurableStorageFactory : public StorageFactory {
+public:
+    static constexpr std::string_view cUrlScheme = "file://";
+
+    /**
+     * @param url `file://` followed by the path of the directory.
+     */
+    explicit DurableStorageFactory(std::string const& url);
+
+    auto provide_data_storage() -> std::unique_ptr<DataStorage> override;
+    auto provide_metadata_storage() -> std::unique_ptr<MetadataStorage> override;
+    auto provide_storage_connection()
+            -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> override;
+    auto create_storage_connection()
+            -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> override;
+    auto provide_job_submission_batch(StorageConnection&)
+            -> std::unique_ptr<JobSubmissionBatch> override;
+
+private:
+    std::string m_directory;
+
+    // The store is opened by the first connection, so that errors are returned to the caller
+    std::mutex m_mutex;
+    std::shared_ptr<DurableStore> m_store;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_DURABLESTORAGEFACTORY_HPP
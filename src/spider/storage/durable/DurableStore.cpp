@@ -0,0 +1,295 @@
+#include "DurableStore.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <variant>
+
+#include <absl/container/flat_hash_map.h>
+#include <boost/crc.hpp>
+#include <fmt/format.h>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/durable/DurableStorage.hpp>
+#include <spider/storage/durable/StoreCodec.hpp>
+#include <spider/storage/durable/WriteAheadLog.hpp>
+#include <spider/storage/memory/MemoryConnection.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+
+namespace spider::core {
+namespace {
+constexpr std::string_view cLockFileName = "LOCK";
+constexpr std::string_view cLogFileName = "wal";
+constexpr std::string_view cSnapshotFileName = "snapshot";
+constexpr std::string_view cSnapshotTempFileName = "snapshot.tmp";
+// "SPIDERSS" in little endian
+constexpr std::uint64_t cSnapshotMagic = 0x5353'5245'4449'5053ULL;
+constexpr std::uint32_t cSnapshotVersion = 1;
+
+auto io_error(std::string_view const action, std::filesystem::path const& path) -> StorageErr {
+    return StorageErr{
+            StorageErrType::ConnectionErr,
+            fmt::format("cannot {} {}: {}", action, path.string(), std::strerror(errno))
+    };
+}
+
+auto get_checksum(std::string_view const bytes) -> std::uint32_t {
+    boost::crc_32_type crc;
+    crc.process_bytes(bytes.data(), bytes.size());
+    return crc.checksum();
+}
+
+/**
+ * Replaces a file with new contents, so that after a crash the file has either its old or its new
+ * contents.
+ *
+ * @param path
+ * @param temp_path A file in the same directory to write the contents to before renaming it.
+ * @param contents
+ * @return StorageErr::Success if the file is replaced.
+ * @return StorageErrType::ConnectionErr if the file cannot be written.
+ */
+auto replace_file(
+        std::filesystem::path const& path,
+        std::filesystem::path const& temp_path,
+        std::string_view const contents
+) -> StorageErr {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    int const fd = ::open(
+            temp_path.c_str(),
+            O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+            S_IRUSR | S_IWUSR
+    );
+    if (fd < 0) {
+        return io_error("open", temp_path);
+    }
+    std::size_t written = 0;
+    while (written < contents.size()) {
+        ssize_t const result = ::write(fd, contents.data() + written, contents.size() - written);
+        if (result < 0 && EINTR != errno) {
+            StorageErr err = io_error("write", temp_path);
+            ::close(fd);
+            return err;
+        }
+        written += result < 0 ? 0 : static_cast<std::size_t>(result);
+    }
+    if (0 != ::fdatasync(fd)) {
+        StorageErr err = io_error("flush", temp_path);
+        ::close(fd);
+        return err;
+    }
+    ::close(fd);
+    if (0 != ::rename(temp_path.c_str(), path.c_str())) {
+        return io_error("rename", temp_path);
+    }
+
+    // Flush the directory so the rename survives a crash
+    std::filesystem::path const directory = path.parent_path();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    int const dir_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0) {
+        return io_error("open", directory);
+    }
+    int const result = ::fsync(dir_fd);
+    ::close(dir_fd);
+    if (0 != result) {
+        return io_error("flush", directory);
+    }
+    return StorageErr{};
+}
+}  // namespace
+
+DurableStore::DirectoryLock::DirectoryLock(DurableStore& store) : m_store{store} {
+    while (0 != ::flock(m_store.m_lock_fd, LOCK_EX)) {
+        if (EINTR != errno) {
+            m_err = io_error("lock", m_store.m_directory);
+            return;
+        }
+    }
+    m_store.m_locking_thread = std::this_thread::get_id();
+}
+
+DurableStore::DirectoryLock::~DirectoryLock() {
+    if (false == m_err.success()) {
+        return;
+    }
+    m_store.m_locking_thread = std::thread::id{};
+    ::flock(m_store.m_lock_fd, LOCK_UN);
+}
+
+DurableStore::DurableStore(std::filesystem::path directory, int const lock_fd)
+        : m_directory{std::move(directory)},
+          m_lock_fd{lock_fd},
+          m_store{std::make_shared<MemoryStore>()} {}
+
+DurableStore::~DurableStore() {
+    ::close(m_lock_fd);
+}
+
+auto DurableStore::open(std::string const& directory)
+        -> std::variant<std::shared_ptr<DurableStore>, StorageErr> {
+    static std::mutex registry_mutex;
+    static absl::flat_hash_map<std::string, std::weak_ptr<DurableStore>> registry;
+
+    std::error_code error_code;
+    std::filesystem::create_directories(directory, error_code);
+    std::filesystem::path const path = std::filesystem::canonical(directory, error_code);
+    if (error_code) {
+        return StorageErr{
+                StorageErrType::ConnectionErr,
+                fmt::format("cannot use directory {}: {}", directory, error_code.message())
+        };
+    }
+
+    std::lock_guard const lock{registry_mutex};
+    std::weak_ptr<DurableStore>& registered = registry[path.string()];
+    if (std::shared_ptr<DurableStore> store = registered.lock(); nullptr != store) {
+        return store;
+    }
+
+    std::filesystem::path const lock_path = path / cLockFileName;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    int const lock_fd
+            = ::open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (lock_fd < 0) {
+        return io_error("open", lock_path);
+    }
+
+    std::shared_ptr<DurableStore> const store{new DurableStore{path, lock_fd}};
+    StorageErr err = store->recover();
+    if (false == err.success()) {
+        return err;
+    }
+    registered = store;
+    return store;
+}
+
+auto DurableStore::recover() -> StorageErr {
+    std::lock_guard const lock{m_commit_mutex};
+    DirectoryLock const directory_lock{*this};
+    if (false == directory_lock.get_error().success()) {
+        return directory_lock.get_error();
+    }
+
+    std::filesystem::path const snapshot_path = m_directory / cSnapshotFileName;
+    std::uint64_t snapshot_lsn = 0;
+    std::error_code error_code;
+    if (std::filesystem::exists(snapshot_path, error_code)) {
+        std::ifstream file{snapshot_path, std::ios::binary};
+        std::string const contents{std::istreambuf_iterator<char>{file}, {}};
+        if (false == file.is_open() || file.bad()) {
+            return io_error("read", snapshot_path);
+        }
+        // The checksum of the rest of the snapshot is at the end
+        std::string_view const snapshot{contents};
+        std::size_t const body_size
+                = snapshot.size() - std::min(snapshot.size(), sizeof(std::uint32_t));
+        BinaryReader reader{snapshot.substr(0, body_size)};
+        bool valid = BinaryReader{snapshot.substr(body_size)}.read_u32()
+                             == get_checksum(snapshot.substr(0, body_size))
+                     && cSnapshotMagic == reader.read_u64()
+                     && cSnapshotVersion == reader.read_u32();
+        snapshot_lsn = reader.read_u64();
+        valid = valid && read_store(reader, *m_store) && reader.at_end();
+        if (false == valid) {
+            return StorageErr{
+                    StorageErrType::OtherErr,
+                    fmt::format("corrupt snapshot {}", snapshot_path.string())
+            };
+        }
+    }
+
+    std::variant<std::unique_ptr<WriteAheadLog>, StorageErr> log_result
+            = WriteAheadLog::open(m_directory / cLogFileName, snapshot_lsn);
+    if (std::holds_alternative<StorageErr>(log_result)) {
+        return std::get<StorageErr>(log_result);
+    }
+    m_log = std::move(std::get<std::unique_ptr<WriteAheadLog>>(log_result));
+
+    // Replay the changes after the snapshot. Drivers and task instances restored from the log get
+    // the epoch as their heartbeat and start time, as they may not be alive anymore.
+    m_store->replaying = true;
+    StorageErr err = catch_up_locked();
+    m_store->replaying = false;
+    return err;
+}
+
+auto DurableStore::catch_up_locked() -> StorageErr {
+    StorageErr err = m_log->get_error();
+    if (false == err.success()) {
+        return err;
+    }
+    MemoryConnection conn{m_store};
+    return m_log->read([&](std::uint64_t /*lsn*/, std::string_view const record) -> StorageErr {
+        return replay_log_record(conn, record);
+    });
+}
+
+auto DurableStore::refresh() -> StorageErr {
+    if (std::this_thread::get_id() == m_locking_thread.load()) {
+        return StorageErr{};
+    }
+    std::lock_guard const lock{m_commit_mutex};
+    if (false == m_log->has_unread_records()) {
+        return StorageErr{};
+    }
+    DirectoryLock const directory_lock{*this};
+    if (false == directory_lock.get_error().success()) {
+        return directory_lock.get_error();
+    }
+    return catch_up_locked();
+}
+
+auto DurableStore::snapshot() -> StorageErr {
+    std::lock_guard const lock{m_commit_mutex};
+    DirectoryLock const directory_lock{*this};
+    StorageErr err = directory_lock.get_error();
+    if (err.success()) {
+        err = catch_up_locked();
+    }
+    if (false == err.success()) {
+        return err;
+    }
+    return snapshot_locked();
+}
+
+auto DurableStore::snapshot_locked() -> StorageErr {
+    BinaryWriter writer;
+    writer.write_u64(cSnapshotMagic);
+    writer.write_u32(cSnapshotVersion);
+    writer.write_u64(m_log->get_last_lsn());
+    {
+        std::shared_lock const lock{m_store->metadata_mutex};
+        write_store(writer, *m_store);
+    }
+    writer.write_u32(get_checksum(writer.get_buffer()));
+
+    StorageErr err = replace_file(
+            m_directory / cSnapshotFileName,
+            m_directory / cSnapshotTempFileName,
+            writer.get_buffer()
+    );
+    if (false == err.success()) {
+        return err;
+    }
+    return m_log->replace();
+}
+}  // namespace spider::core
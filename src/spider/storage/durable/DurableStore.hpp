@@ -0,0 +1,198 @@
+#ifndef SPIDER_STORAGE_DURABLESTORE_HPP
+#define SPIDER_STORAGE_DURABLESTORE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/durable/StoreCodec.hpp>
+#include <spider/storage/durable/WriteAheadLog.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+
+namespace spider::core {
+/**
+ * A `MemoryStore` persisted in a directory, shared by all connections to the same `file://` URL in
+ * a process, and by all processes opening the same directory.
+ *
+ * Every change is applied to the in-memory store, then described by a record appended to a
+ * write-ahead log, and the change is acknowledged once its record is flushed to disk. Changes are
+ * serialized by a commit lock within a process and by a lock on the directory across processes, so
+ * the log follows the order they are applied in, while the flushes are batched across concurrent
+ * commits. Before a change, and before an operation reads the store, the records that other
+ * processes appended since are replayed on the in-memory store, so each process sees the changes of
+ * the others. Once the log grows past `cSnapshotLogSize`, the whole store is written to a snapshot
+ * and the log is replaced by an empty one. Opening a directory loads the snapshot and replays the
+ * log after it.
+ *
+ * Scheduler leases are kept by each process, so only one scheduler should use a directory.
+ */
+class DurableStore {
+public:
+    static constexpr std::size_t cSnapshotLogSize = 64ULL * 1024 * 1024;
+
+    // Delete copy and move constructors and assignment operators
+    DurableStore(DurableStore const&) = delete;
+    auto operator=(DurableStore const&) -> DurableStore& = delete;
+    DurableStore(DurableStore&&) = delete;
+    auto operator=(DurableStore&&) -> DurableStore& = delete;
+
+    ~DurableStore();
+
+    /**
+     * Opens the store of a directory, creating the directory if it does not exist. The store is
+     * recovered from the directory on first use in the process, and closed once no connection
+     * uses it anymore.
+     *
+     * @param directory
+     * @return The store on success.
+     * @return StorageErrType::ConnectionErr if the directory cannot be used or locked.
+     * @return StorageErrType::OtherErr if the snapshot is corrupt or the log cannot be replayed.
+     */
+    static auto open(std::string const& directory)
+            -> std::variant<std::shared_ptr<DurableStore>, StorageErr>;
+
+    [[nodiscard]] auto get_store() const -> std::shared_ptr<MemoryStore> const& { return m_store; }
+
+    /**
+     * Applies a change and makes it durable. `apply` is called with the commit lock and the
+     * directory lock held, once the changes of other processes are replayed. It changes the
+     * in-memory store and, if the change succeeds, writes a record to replay it. The change is
+     * logged only if it succeeds and the record is not empty.
+     *
+     * @param apply Called as `apply(record)` and returns a `StorageErr`.
+     * @return The error of `apply` if the change fails or once its record is flushed.
+     * @return StorageErrType::ConnectionErr if the log cannot be read or written.
+     * @return StorageErrType::OtherErr if the changes of other processes cannot be replayed.
+     */
+    template <class Apply>
+    auto commit(Apply&& apply) -> StorageErr;
+
+    /**
+     * Replays the changes other processes made since the last commit or refresh. Does nothing when
+     * called while applying a change, as the store is already up to date then.
+     *
+     * @return StorageErr::Success if the store is up to date.
+     * @return StorageErrType::ConnectionErr if the directory cannot be locked or the log read.
+     * @return StorageErrType::OtherErr if the changes of other processes cannot be replayed.
+     */
+    auto refresh() -> StorageErr;
+
+    /**
+     * Writes a snapshot of the store and replaces the log with an empty one.
+     *
+     * @return StorageErr::Success if the snapshot is written.
+     * @return StorageErrType::ConnectionErr if the snapshot or the log cannot be written.
+     */
+    auto snapshot() -> StorageErr;
+
+    /**
+     * @return The number of flushes of the log so far.
+     */
+    [[nodiscard]] auto get_num_log_syncs() const -> std::size_t {
+        return m_log->get_num_syncs();
+    }
+
+private:
+    // Holds the lock of the directory, which serializes the use of the log across processes
+    class DirectoryLock {
+    public:
+        /**
+         * Blocks until the directory is locked. Must be called with the commit lock held.
+         *
+         * @param store
+         */
+        explicit DirectoryLock(DurableStore& store);
+
+        // Delete copy and move constructors and assignment operators
+        DirectoryLock(DirectoryLock const&) = delete;
+        auto operator=(DirectoryLock const&) -> DirectoryLock& = delete;
+        DirectoryLock(DirectoryLock&&) = delete;
+        auto operator=(DirectoryLock&&) -> DirectoryLock& = delete;
+
+        ~DirectoryLock();
+
+        /**
+         * @return StorageErr::Success if the directory is locked.
+         * @return StorageErrType::ConnectionErr otherwise.
+         */
+        [[nodiscard]] auto get_error() const -> StorageErr const& { return m_err; }
+
+    private:
+        DurableStore& m_store;
+        StorageErr m_err;
+    };
+
+    DurableStore(std::filesystem::path directory, int lock_fd);
+
+    /**
+     * Loads the snapshot, replays the log after it and opens the log for appending.
+     *
+     * @return StorageErr::Success if the store is recovered. Error types otherwise.
+     */
+    auto recover() -> StorageErr;
+
+    /**
+     * Replays the records other processes appended to the log. Must be called with the directory
+     * lock held.
+     *
+     * @return StorageErr::Success if the store is up to date. Error types otherwise.
+     */
+    auto catch_up_locked() -> StorageErr;
+
+    /**
+     * Writes a snapshot and replaces the log. Must be called with the directory lock held and the
+     * store up to date.
+     *
+     * @return StorageErr::Success if the snapshot is written. Error types otherwise.
+     */
+    auto snapshot_locked() -> StorageErr;
+
+    std::filesystem::path m_directory;
+    int m_lock_fd;
+    std::shared_ptr<MemoryStore> m_store;
+    std::unique_ptr<WriteAheadLog> m_log;
+
+    std::mutex m_commit_mutex;
+    // Thread holding the directory lock, if any
+    std::atomic<std::thread::id> m_locking_thread;
+};
+
+template <class Apply>
+auto DurableStore::commit(Apply&& apply) -> StorageErr {
+    StorageErr err;
+    std::uint64_t lsn = 0;
+    {
+        std::lock_guard const lock{m_commit_mutex};
+        DirectoryLock const directory_lock{*this};
+        StorageErr log_err = directory_lock.get_error();
+        if (log_err.success()) {
+            log_err = catch_up_locked();
+        }
+        if (false == log_err.success()) {
+            return log_err;
+        }
+        BinaryWriter record;
+        err = std::forward<Apply>(apply)(record);
+        if (false == err.success() || record.empty()) {
+            return err;
+        }
+        lsn = m_log->append(record.get_buffer());
+        if (m_log->get_size() >= cSnapshotLogSize) {
+            log_err = snapshot_locked();
+            return log_err.success() ? err : log_err;
+        }
+    }
+    StorageErr sync_err = m_log->sync(lsn);
+    return sync_err.success() ? err : sync_err;
+}
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_DURABLESTORE_HPP
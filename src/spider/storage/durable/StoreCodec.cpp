@@ -0,0 +1,578 @@
+#include "StoreCodec.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Data.hpp>
+#include <spider/core/JobMetadata.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+
+namespace spider::core {
+namespace {
+constexpr std::size_t cUuidSize = 16;
+constexpr unsigned cBitsPerByte = 8;
+
+template <class Int>
+auto write_int(std::string& buffer, Int const value) -> void {
+    for (std::size_t i = 0; i < sizeof(Int); ++i) {
+        buffer.push_back(static_cast<char>(static_cast<std::uint8_t>(value >> (i * cBitsPerByte))));
+    }
+}
+
+template <class Int>
+auto read_int(std::string_view const bytes) -> Int {
+    Int value = 0;
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        value |= static_cast<Int>(static_cast<std::uint8_t>(bytes[i])) << (i * cBitsPerByte);
+    }
+    return value;
+}
+
+auto write_uuids(BinaryWriter& writer, std::vector<boost::uuids::uuid> const& ids) -> void {
+    writer.write_u64(ids.size());
+    for (boost::uuids::uuid const& id : ids) {
+        writer.write_uuid(id);
+    }
+}
+
+auto read_uuids(BinaryReader& reader) -> std::vector<boost::uuids::uuid> {
+    std::vector<boost::uuids::uuid> ids(reader.read_size(cUuidSize));
+    for (boost::uuids::uuid& id : ids) {
+        id = reader.read_uuid();
+    }
+    return ids;
+}
+
+auto write_uuid_set(BinaryWriter& writer, absl::flat_hash_set<boost::uuids::uuid> const& ids)
+        -> void {
+    writer.write_u64(ids.size());
+    for (boost::uuids::uuid const& id : ids) {
+        writer.write_uuid(id);
+    }
+}
+
+auto read_uuid_set(BinaryReader& reader) -> absl::flat_hash_set<boost::uuids::uuid> {
+    std::size_t const size = reader.read_size(cUuidSize);
+    absl::flat_hash_set<boost::uuids::uuid> ids;
+    ids.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        ids.insert(reader.read_uuid());
+    }
+    return ids;
+}
+
+auto write_optional_string(BinaryWriter& writer, std::optional<std::string> const& value) -> void {
+    writer.write_bool(value.has_value());
+    if (value.has_value()) {
+        writer.write_string(value.value());
+    }
+}
+
+auto read_optional_string(BinaryReader& reader) -> std::optional<std::string> {
+    if (false == reader.read_bool()) {
+        return std::nullopt;
+    }
+    return reader.read_string();
+}
+
+auto write_job_entry(BinaryWriter& writer, MemoryStore::JobEntry const& job) -> void {
+    writer.write_uuid(job.client_id);
+    writer.write_u64(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    job.creation_time.time_since_epoch()
+            )
+                    .count()
+    ));
+    writer.write_i32(job.priority);
+    writer.write_u8(static_cast<std::uint8_t>(job.state));
+    writer.write_u32(job.remaining_tasks);
+    write_uuids(writer, job.task_ids);
+    writer.write_u64(job.dependencies.size());
+    for (auto const& [parent_id, child_id] : job.dependencies) {
+        writer.write_uuid(parent_id);
+        writer.write_uuid(child_id);
+    }
+    write_uuids(writer, job.input_tasks);
+    write_uuids(writer, job.output_tasks);
+}
+
+auto read_job_entry(BinaryReader& reader) -> MemoryStore::JobEntry {
+    MemoryStore::JobEntry job;
+    job.client_id = reader.read_uuid();
+    job.creation_time = std::chrono::system_clock::time_point{
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds{static_cast<std::int64_t>(reader.read_u64())}
+            )
+    };
+    job.priority = reader.read_i32();
+    job.state = static_cast<JobStatus>(reader.read_u8());
+    job.remaining_tasks = reader.read_u32();
+    job.task_ids = read_uuids(reader);
+    job.dependencies.resize(reader.read_size(2 * cUuidSize));
+    for (auto& [parent_id, child_id] : job.dependencies) {
+        parent_id = reader.read_uuid();
+        child_id = reader.read_uuid();
+    }
+    job.input_tasks = read_uuids(reader);
+    job.output_tasks = read_uuids(reader);
+    return job;
+}
+
+auto write_task_entry(BinaryWriter& writer, MemoryStore::TaskEntry const& task) -> void {
+    writer.write_uuid(task.job_id);
+    writer.write_string(task.function_name);
+    writer.write_u8(static_cast<std::uint8_t>(task.language));
+    writer.write_u8(static_cast<std::uint8_t>(task.state));
+    writer.write_float(task.timeout);
+    writer.write_u32(task.max_retries);
+    writer.write_u32(task.retry);
+    writer.write_optional_uuid(task.instance_id);
+    writer.write_u32(task.remaining_inputs);
+    writer.write_u64(task.inputs.size());
+    for (TaskInput const& input : task.inputs) {
+        write_task_input(writer, input);
+    }
+    writer.write_u64(task.outputs.size());
+    for (TaskOutput const& output : task.outputs) {
+        write_task_output(writer, output);
+    }
+    write_uuids(writer, task.parents);
+    write_uuids(writer, task.children);
+    writer.write_u64(task.consumers.size());
+    for (auto const& [consumer_id, position] : task.consumers) {
+        writer.write_uuid(consumer_id);
+        writer.write_u64(position);
+    }
+    write_uuids(writer, task.instance_ids);
+}
+
+auto read_task_entry(BinaryReader& reader) -> MemoryStore::TaskEntry {
+    MemoryStore::TaskEntry task;
+    task.job_id = reader.read_uuid();
+    task.function_name = reader.read_string();
+    task.language = static_cast<TaskLanguage>(reader.read_u8());
+    task.state = static_cast<TaskState>(reader.read_u8());
+    task.timeout = reader.read_float();
+    task.max_retries = reader.read_u32();
+    task.retry = reader.read_u32();
+    task.instance_id = reader.read_optional_uuid();
+    task.remaining_inputs = reader.read_u32();
+    std::size_t const num_inputs = reader.read_size(1);
+    for (std::size_t i = 0; i < num_inputs; ++i) {
+        task.inputs.push_back(read_task_input(reader));
+    }
+    std::size_t const num_outputs = reader.read_size(1);
+    for (std::size_t i = 0; i < num_outputs; ++i) {
+        task.outputs.push_back(read_task_output(reader));
+    }
+    task.parents = read_uuids(reader);
+    task.children = read_uuids(reader);
+    task.consumers.resize(reader.read_size(cUuidSize + sizeof(std::uint64_t)));
+    for (auto& [consumer_id, position] : task.consumers) {
+        consumer_id = reader.read_uuid();
+        position = reader.read_u64();
+    }
+    task.instance_ids = read_uuids(reader);
+    return task;
+}
+
+/**
+ * Writes the entries of the maps of a striped map, each preceded by `true`, then `false`.
+ *
+ * @param writer
+ * @param map
+ * @param write_entry Writes an entry of a stripe.
+ */
+template <class Map, class WriteEntry>
+auto write_striped_map(BinaryWriter& writer, Map& map, WriteEntry write_entry) -> void {
+    map.write_all([&](auto const& stripe) {
+        for (auto const& entry : stripe) {
+            writer.write_bool(true);
+            write_entry(entry);
+        }
+    });
+    writer.write_bool(false);
+}
+
+auto write_kv_map(
+        BinaryWriter& writer,
+        StripedHashMap<boost::uuids::uuid, absl::flat_hash_map<std::string, std::string>>& map
+) -> void {
+    write_striped_map(writer, map, [&](auto const& entry) {
+        writer.write_uuid(entry.first);
+        writer.write_u64(entry.second.size());
+        for (auto const& [key, value] : entry.second) {
+            writer.write_string(key);
+            writer.write_string(value);
+        }
+    });
+}
+
+auto read_kv_map(
+        BinaryReader& reader,
+        StripedHashMap<boost::uuids::uuid, absl::flat_hash_map<std::string, std::string>>& map
+) -> void {
+    while (reader.read_bool()) {
+        boost::uuids::uuid const id = reader.read_uuid();
+        std::size_t const size = reader.read_size(2 * sizeof(std::uint64_t));
+        absl::flat_hash_map<std::string, std::string> values;
+        for (std::size_t i = 0; i < size; ++i) {
+            std::string key = reader.read_string();
+            values.insert_or_assign(std::move(key), reader.read_string());
+        }
+        map.write(id, [&](auto& stripe) { stripe.insert_or_assign(id, std::move(values)); });
+    }
+}
+
+/**
+ * Adds `data_id` to the references of `owner_id` in a reverse index of data references.
+ */
+auto add_reverse_reference(
+        StripedHashMap<boost::uuids::uuid, absl::flat_hash_set<boost::uuids::uuid>>& refs_map,
+        boost::uuids::uuid const owner_id,
+        boost::uuids::uuid const data_id
+) -> void {
+    refs_map.write(owner_id, [&](auto& owner_map) { owner_map[owner_id].insert(data_id); });
+}
+}  // namespace
+
+auto BinaryWriter::write_u8(std::uint8_t const value) -> void {
+    m_buffer.push_back(static_cast<char>(value));
+}
+
+auto BinaryWriter::write_u32(std::uint32_t const value) -> void {
+    write_int(m_buffer, value);
+}
+
+auto BinaryWriter::write_u64(std::uint64_t const value) -> void {
+    write_int(m_buffer, value);
+}
+
+auto BinaryWriter::write_i32(std::int32_t const value) -> void {
+    write_int(m_buffer, static_cast<std::uint32_t>(value));
+}
+
+auto BinaryWriter::write_float(float const value) -> void {
+    write_int(m_buffer, std::bit_cast<std::uint32_t>(value));
+}
+
+auto BinaryWriter::write_bool(bool const value) -> void {
+    write_u8(value ? 1 : 0);
+}
+
+auto BinaryWriter::write_uuid(boost::uuids::uuid const& value) -> void {
+    m_buffer.append(value.begin(), value.end());
+}
+
+auto BinaryWriter::write_string(std::string_view const value) -> void {
+    write_u64(value.size());
+    m_buffer.append(value);
+}
+
+auto BinaryWriter::write_optional_uuid(std::optional<boost::uuids::uuid> const& value) -> void {
+    write_bool(value.has_value());
+    if (value.has_value()) {
+        write_uuid(value.value());
+    }
+}
+
+auto BinaryReader::take(std::size_t const size) -> std::string_view {
+    if (m_failed || size > m_buffer.size() - m_pos) {
+        m_failed = true;
+        return {};
+    }
+    std::string_view const bytes = m_buffer.substr(m_pos, size);
+    m_pos += size;
+    return bytes;
+}
+
+auto BinaryReader::read_u8() -> std::uint8_t {
+    return read_int<std::uint8_t>(take(sizeof(std::uint8_t)));
+}
+
+auto BinaryReader::read_u32() -> std::uint32_t {
+    return read_int<std::uint32_t>(take(sizeof(std::uint32_t)));
+}
+
+auto BinaryReader::read_u64() -> std::uint64_t {
+    return read_int<std::uint64_t>(take(sizeof(std::uint64_t)));
+}
+
+auto BinaryReader::read_i32() -> std::int32_t {
+    return static_cast<std::int32_t>(read_u32());
+}
+
+auto BinaryReader::read_float() -> float {
+    return std::bit_cast<float>(read_u32());
+}
+
+auto BinaryReader::read_bool() -> bool {
+    return 0 != read_u8();
+}
+
+auto BinaryReader::read_uuid() -> boost::uuids::uuid {
+    boost::uuids::uuid value{};
+    std::string_view const bytes = take(cUuidSize);
+    std::ranges::copy(bytes, value.begin());
+    return value;
+}
+
+auto BinaryReader::read_string() -> std::string {
+    return std::string{take(read_size(1))};
+}
+
+auto BinaryReader::read_optional_uuid() -> std::optional<boost::uuids::uuid> {
+    if (false == read_bool()) {
+        return std::nullopt;
+    }
+    return read_uuid();
+}
+
+auto BinaryReader::read_size(std::size_t const min_element_size) -> std::size_t {
+    std::uint64_t const size = read_u64();
+    if (m_failed || size > (m_buffer.size() - m_pos) / std::max<std::size_t>(min_element_size, 1))
+    {
+        m_failed = true;
+        return 0;
+    }
+    return static_cast<std::size_t>(size);
+}
+
+auto write_task_input(BinaryWriter& writer, TaskInput const& input) -> void {
+    writer.write_string(input.get_type());
+    std::optional<std::tuple<boost::uuids::uuid, std::uint8_t>> const task_output
+            = input.get_task_output();
+    writer.write_bool(task_output.has_value());
+    if (task_output.has_value()) {
+        writer.write_uuid(std::get<0>(task_output.value()));
+        writer.write_u8(std::get<1>(task_output.value()));
+    }
+    write_optional_string(writer, input.get_value());
+    writer.write_optional_uuid(input.get_data_id());
+}
+
+auto read_task_input(BinaryReader& reader) -> TaskInput {
+    TaskInput input{reader.read_string()};
+    if (reader.read_bool()) {
+        boost::uuids::uuid const task_id = reader.read_uuid();
+        input.set_output(task_id, reader.read_u8());
+    }
+    std::optional<std::string> const value = read_optional_string(reader);
+    if (value.has_value()) {
+        input.set_value(value.value());
+    }
+    std::optional<boost::uuids::uuid> const data_id = reader.read_optional_uuid();
+    if (data_id.has_value()) {
+        input.set_data_id(data_id.value());
+    }
+    return input;
+}
+
+auto write_task_output(BinaryWriter& writer, TaskOutput const& output) -> void {
+    writer.write_string(output.get_type());
+    write_optional_string(writer, output.get_value());
+    writer.write_optional_uuid(output.get_data_id());
+}
+
+auto read_task_output(BinaryReader& reader) -> TaskOutput {
+    TaskOutput output{reader.read_string()};
+    std::optional<std::string> const value = read_optional_string(reader);
+    if (value.has_value()) {
+        output.set_value(value.value());
+    }
+    std::optional<boost::uuids::uuid> const data_id = reader.read_optional_uuid();
+    if (data_id.has_value()) {
+        output.set_data_id(data_id.value());
+    }
+    return output;
+}
+
+auto write_data(BinaryWriter& writer, Data const& data) -> void {
+    writer.write_uuid(data.get_id());
+    writer.write_string(data.get_value());
+    writer.write_bool(data.is_hard_locality());
+    writer.write_u64(data.get_locality().size());
+    for (std::string const& locality : data.get_locality()) {
+        writer.write_string(locality);
+    }
+}
+
+auto read_data(BinaryReader& reader) -> Data {
+    boost::uuids::uuid const id = reader.read_uuid();
+    Data data{id, reader.read_string()};
+    data.set_hard_locality(reader.read_bool());
+    std::vector<std::string> locality(reader.read_size(sizeof(std::uint64_t)));
+    for (std::string& address : locality) {
+        address = reader.read_string();
+    }
+    if (false == locality.empty()) {
+        data.set_locality(locality);
+    }
+    return data;
+}
+
+auto write_staged_job(BinaryWriter& writer, MemoryStore::StagedJob const& job) -> void {
+    writer.write_uuid(job.id);
+    write_job_entry(writer, job.job);
+    writer.write_u64(job.tasks.size());
+    for (auto const& [task_id, task] : job.tasks) {
+        writer.write_uuid(task_id);
+        write_task_entry(writer, task);
+    }
+}
+
+auto read_staged_job(BinaryReader& reader) -> MemoryStore::StagedJob {
+    MemoryStore::StagedJob job;
+    job.id = reader.read_uuid();
+    job.job = read_job_entry(reader);
+    std::size_t const num_tasks = reader.read_size(cUuidSize);
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        boost::uuids::uuid const task_id = reader.read_uuid();
+        job.tasks.emplace_back(task_id, read_task_entry(reader));
+    }
+    return job;
+}
+
+auto write_store(BinaryWriter& writer, MemoryStore& store) -> void {
+    writer.write_u64(store.drivers.size());
+    for (auto const& [id, heartbeat] : store.drivers) {
+        writer.write_uuid(id);
+    }
+    writer.write_u64(store.schedulers.size());
+    for (auto const& [id, scheduler] : store.schedulers) {
+        writer.write_uuid(id);
+        writer.write_string(scheduler.addr);
+        writer.write_i32(scheduler.port);
+    }
+    writer.write_u64(store.jobs.size());
+    for (auto const& [id, job] : store.jobs) {
+        writer.write_uuid(id);
+        write_job_entry(writer, job);
+    }
+    writer.write_u64(store.tasks.size());
+    for (auto const& [id, task] : store.tasks) {
+        writer.write_uuid(id);
+        write_task_entry(writer, task);
+    }
+    writer.write_u64(store.instances.size());
+    for (auto const& [id, instance] : store.instances) {
+        writer.write_uuid(id);
+        writer.write_uuid(instance.task_id);
+        writer.write_optional_uuid(instance.worker_id);
+    }
+
+    write_striped_map(writer, store.data, [&](auto const& entry) {
+        MemoryStore::DataEntry const& data = entry.second;
+        writer.write_uuid(entry.first);
+        writer.write_string(data.value);
+        writer.write_bool(data.hard_locality);
+        writer.write_u64(data.locality.size());
+        for (std::string const& locality : data.locality) {
+            writer.write_string(locality);
+        }
+        write_uuid_set(writer, data.driver_refs);
+        write_uuid_set(writer, data.task_refs);
+    });
+    write_kv_map(writer, store.client_kv_data);
+    write_kv_map(writer, store.task_kv_data);
+}
+
+// NOLINTBEGIN(readability-function-cognitive-complexity)
+auto read_store(BinaryReader& reader, MemoryStore& store) -> bool {
+    std::size_t const num_drivers = reader.read_size(cUuidSize);
+    for (std::size_t i = 0; i < num_drivers; ++i) {
+        store.drivers.insert_or_assign(reader.read_uuid(), MemoryStore::Clock::time_point{});
+    }
+    std::size_t const num_schedulers = reader.read_size(cUuidSize);
+    for (std::size_t i = 0; i < num_schedulers; ++i) {
+        boost::uuids::uuid const id = reader.read_uuid();
+        MemoryStore::SchedulerEntry scheduler;
+        scheduler.addr = reader.read_string();
+        scheduler.port = reader.read_i32();
+        store.schedulers.insert_or_assign(id, std::move(scheduler));
+    }
+    std::size_t const num_jobs = reader.read_size(cUuidSize);
+    for (std::size_t i = 0; i < num_jobs; ++i) {
+        boost::uuids::uuid const id = reader.read_uuid();
+        MemoryStore::JobEntry job = read_job_entry(reader);
+        store.client_jobs[job.client_id].insert(id);
+        store.jobs.insert_or_assign(id, std::move(job));
+    }
+    std::size_t const num_tasks = reader.read_size(cUuidSize);
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        boost::uuids::uuid const id = reader.read_uuid();
+        store.tasks.insert_or_assign(id, read_task_entry(reader));
+    }
+    std::size_t const num_instances = reader.read_size(2 * cUuidSize);
+    for (std::size_t i = 0; i < num_instances; ++i) {
+        boost::uuids::uuid const id = reader.read_uuid();
+        MemoryStore::InstanceEntry instance;
+        instance.task_id = reader.read_uuid();
+        instance.worker_id = reader.read_optional_uuid();
+        store.instances.insert_or_assign(id, instance);
+    }
+
+    while (reader.read_bool()) {
+        boost::uuids::uuid const id = reader.read_uuid();
+        MemoryStore::DataEntry data;
+        data.value = reader.read_string();
+        data.hard_locality = reader.read_bool();
+        data.locality.resize(reader.read_size(sizeof(std::uint64_t)));
+        for (std::string& locality : data.locality) {
+            locality = reader.read_string();
+        }
+        data.driver_refs = read_uuid_set(reader);
+        data.task_refs = read_uuid_set(reader);
+        for (boost::uuids::uuid const& driver_id : data.driver_refs) {
+            add_reverse_reference(store.driver_data_refs, driver_id, id);
+        }
+        for (boost::uuids::uuid const& task_id : data.task_refs) {
+            add_reverse_reference(store.task_data_refs, task_id, id);
+        }
+        store.data.write(id, [&](auto& data_map) {
+            data_map.insert_or_assign(id, std::move(data));
+        });
+    }
+    read_kv_map(reader, store.client_kv_data);
+    read_kv_map(reader, store.task_kv_data);
+    if (reader.failed()) {
+        return false;
+    }
+
+    // Rebuild the ready index, checking that every task refers to a job of the state
+    for (auto const& [id, task] : store.tasks) {
+        auto const job_it = store.jobs.find(task.job_id);
+        if (job_it == store.jobs.end()) {
+            return false;
+        }
+        if (TaskState::Ready == task.state) {
+            MemoryStore::ReadyTaskKey const key{
+                    job_it->second.priority,
+                    job_it->second.creation_time,
+                    id
+            };
+            store.ready_tasks.insert(key);
+            store.client_ready_tasks[job_it->second.client_id].insert(key);
+        }
+    }
+    return std::ranges::all_of(store.instances, [&](auto const& entry) {
+        return store.tasks.contains(entry.second.task_id);
+    });
+}
+
+// NOLINTEND(readability-function-cognitive-complexity)
+}  // namespace spider::core
@@ -0,0 +1,118 @@
+#ifndef SPIDER_STORAGE_STORECODEC_HPP
+#define SPIDER_STORAGE_STORECODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Data.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+
+namespace spider::core {
+/**
+ * Appends values to a byte buffer in a fixed little-endian layout, for the log records and
+ * snapshots of the durable storage.
+ */
+class BinaryWriter {
+public:
+    auto write_u8(std::uint8_t value) -> void;
+    auto write_u32(std::uint32_t value) -> void;
+    auto write_u64(std::uint64_t value) -> void;
+    auto write_i32(std::int32_t value) -> void;
+    auto write_float(float value) -> void;
+    auto write_bool(bool value) -> void;
+    auto write_uuid(boost::uuids::uuid const& value) -> void;
+    // Writes the size followed by the bytes
+    auto write_string(std::string_view value) -> void;
+    auto write_optional_uuid(std::optional<boost::uuids::uuid> const& value) -> void;
+
+    [[nodiscard]] auto empty() const -> bool { return m_buffer.empty(); }
+
+    [[nodiscard]] auto get_buffer() const -> std::string const& { return m_buffer; }
+
+private:
+    std::string m_buffer;
+};
+
+/**
+ * Reads values written by `BinaryWriter`. Once a read runs past the end of the buffer, the reader
+ * fails and all further reads return zero values, so a caller can decode a whole record and check
+ * `failed` once.
+ */
+class BinaryReader {
+public:
+    explicit BinaryReader(std::string_view buffer) : m_buffer{buffer} {}
+
+    auto read_u8() -> std::uint8_t;
+    auto read_u32() -> std::uint32_t;
+    auto read_u64() -> std::uint64_t;
+    auto read_i32() -> std::int32_t;
+    auto read_float() -> float;
+    auto read_bool() -> bool;
+    auto read_uuid() -> boost::uuids::uuid;
+    auto read_string() -> std::string;
+    auto read_optional_uuid() -> std::optional<boost::uuids::uuid>;
+
+    /**
+     * Reads the number of elements of a sequence. Fails if the rest of the buffer is too short to
+     * hold that many elements of at least `min_element_size` bytes, so a corrupt size does not
+     * make the caller allocate a huge sequence.
+     *
+     * @param min_element_size
+     * @return The number of elements.
+     */
+    auto read_size(std::size_t min_element_size) -> std::size_t;
+
+    [[nodiscard]] auto failed() const -> bool { return m_failed; }
+
+    [[nodiscard]] auto at_end() const -> bool { return m_pos == m_buffer.size(); }
+
+private:
+    /**
+     * @param size
+     * @return The next `size` bytes, or an empty view after failing if there are not enough bytes.
+     */
+    auto take(std::size_t size) -> std::string_view;
+
+    std::string_view m_buffer;
+    std::size_t m_pos = 0;
+    bool m_failed = false;
+};
+
+auto write_task_input(BinaryWriter& writer, TaskInput const& input) -> void;
+auto read_task_input(BinaryReader& reader) -> TaskInput;
+auto write_task_output(BinaryWriter& writer, TaskOutput const& output) -> void;
+auto read_task_output(BinaryReader& reader) -> TaskOutput;
+auto write_data(BinaryWriter& writer, Data const& data) -> void;
+auto read_data(BinaryReader& reader) -> Data;
+auto write_staged_job(BinaryWriter& writer, MemoryStore::StagedJob const& job) -> void;
+auto read_staged_job(BinaryReader& reader) -> MemoryStore::StagedJob;
+
+/**
+ * Writes the durable state of a store: drivers, schedulers, jobs, tasks, task instances, data and
+ * key-value data. Heartbeats, instance start times and scheduler leases are not written. Must be
+ * called with the metadata lock held and no concurrent change to the data maps.
+ *
+ * @param writer
+ * @param store
+ */
+auto write_store(BinaryWriter& writer, MemoryStore& store) -> void;
+
+/**
+ * Reads a state written by `write_store` into an empty store, rebuilding the indexes. Drivers get
+ * the epoch as their last heartbeat and task instances the epoch as their start time, since the
+ * drivers and task instances may not be alive anymore.
+ *
+ * @param reader
+ * @param store
+ * @return Whether the state is read. The store must be discarded otherwise.
+ */
+auto read_store(BinaryReader& reader, MemoryStore& store) -> bool;
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_STORECODEC_HPP
@@ -0,0 +1,337 @@
+#include "WriteAheadLog.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#include <boost/crc.hpp>
+#include <fmt/format.h>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/durable/StoreCodec.hpp>
+
+namespace spider::core {
+namespace {
+// Payload size, CRC-32 and sequence number
+constexpr std::size_t cRecordHeaderSize = 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+constexpr std::size_t cReadBufferSize = 64ULL * 1024;
+constexpr std::string_view cTempFileSuffix = ".tmp";
+
+auto get_checksum(std::uint64_t const lsn, std::string_view const payload) -> std::uint32_t {
+    BinaryWriter lsn_writer;
+    lsn_writer.write_u64(lsn);
+    boost::crc_32_type crc;
+    crc.process_bytes(lsn_writer.get_buffer().data(), lsn_writer.get_buffer().size());
+    crc.process_bytes(payload.data(), payload.size());
+    return crc.checksum();
+}
+
+auto io_error(std::string_view const action, std::filesystem::path const& path) -> StorageErr {
+    return StorageErr{
+            StorageErrType::ConnectionErr,
+            fmt::format("cannot {} {}: {}", action, path.string(), std::strerror(errno))
+    };
+}
+
+/**
+ * Reads a file from an offset to its end.
+ *
+ * @param fd
+ * @param offset
+ * @param contents Returns the bytes read.
+ * @return Whether the file is read.
+ */
+auto read_from(int const fd, std::size_t const offset, std::string* contents) -> bool {
+    std::array<char, cReadBufferSize> buffer{};
+    while (true) {
+        ssize_t const result = ::pread(
+                fd,
+                buffer.data(),
+                buffer.size(),
+                static_cast<off_t>(offset + contents->size())
+        );
+        if (result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        if (0 == result) {
+            return true;
+        }
+        contents->append(buffer.data(), static_cast<std::size_t>(result));
+    }
+}
+
+auto write_all(int const fd, std::string_view const bytes) -> bool {
+    std::size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t const result = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+/**
+ * Opens a log file for reading and appending.
+ *
+ * @param path
+ * @param fd Returns the file descriptor.
+ * @param inode Returns the inode of the file.
+ * @return StorageErr::Success if the file is opened.
+ * @return StorageErrType::ConnectionErr if the file cannot be opened.
+ */
+auto open_file(std::filesystem::path const& path, int* fd, ino_t* inode) -> StorageErr {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    *fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (*fd < 0) {
+        return io_error("open", path);
+    }
+    struct stat file_stat{};
+    if (0 != ::fstat(*fd, &file_stat)) {
+        StorageErr err = io_error("stat", path);
+        ::close(*fd);
+        return err;
+    }
+    *inode = file_stat.st_ino;
+    return StorageErr{};
+}
+}  // namespace
+
+WriteAheadLog::WriteAheadLog(
+        std::filesystem::path path,
+        int const fd,
+        ino_t const inode,
+        std::uint64_t const last_lsn
+)
+        : m_path{std::move(path)},
+          m_inode{inode},
+          m_fd{fd},
+          m_last_lsn{last_lsn},
+          m_synced_lsn{last_lsn} {}
+
+WriteAheadLog::~WriteAheadLog() {
+    ::close(m_fd);
+}
+
+auto WriteAheadLog::open(std::filesystem::path const& path, std::uint64_t const last_lsn)
+        -> std::variant<std::unique_ptr<WriteAheadLog>, StorageErr> {
+    int fd = -1;
+    ino_t inode = 0;
+    StorageErr err = open_file(path, &fd, &inode);
+    if (false == err.success()) {
+        return err;
+    }
+    return std::unique_ptr<WriteAheadLog>(new WriteAheadLog(path, fd, inode, last_lsn));
+}
+
+auto WriteAheadLog::read(std::function<StorageErr(std::uint64_t, std::string_view)> const& apply)
+        -> StorageErr {
+    while (true) {
+        std::string contents;
+        if (false == read_from(m_fd, m_size, &contents)) {
+            return io_error("read", m_path);
+        }
+
+        std::string_view const log{contents};
+        std::size_t pos = 0;
+        while (log.size() - pos >= cRecordHeaderSize) {
+            BinaryReader header{log.substr(pos, cRecordHeaderSize)};
+            std::uint32_t const size = header.read_u32();
+            std::uint32_t const checksum = header.read_u32();
+            std::uint64_t const lsn = header.read_u64();
+            if (size > log.size() - pos - cRecordHeaderSize) {
+                break;
+            }
+            std::string_view const payload = log.substr(pos + cRecordHeaderSize, size);
+            if (checksum != get_checksum(lsn, payload) || lsn <= m_file_lsn) {
+                break;
+            }
+            // Records covered by the snapshot the store was loaded from are skipped
+            if (lsn > get_last_lsn()) {
+                StorageErr err = apply(lsn, payload);
+                if (false == err.success()) {
+                    return err;
+                }
+                std::lock_guard const lock{m_mutex};
+                m_last_lsn = lsn;
+            }
+            m_file_lsn = lsn;
+            pos += cRecordHeaderSize + size;
+            m_size += cRecordHeaderSize + size;
+        }
+
+        // No other process writes while the directory lock is held, so the rest is a torn record
+        if (pos < log.size() && 0 != ::ftruncate(m_fd, static_cast<off_t>(m_size))) {
+            return io_error("truncate", m_path);
+        }
+
+        struct stat path_stat{};
+        if (0 != ::stat(m_path.c_str(), &path_stat)) {
+            return io_error("stat", m_path);
+        }
+        if (path_stat.st_ino == m_inode) {
+            return StorageErr{};
+        }
+        // The log was replaced after a snapshot, so continue with the new file
+        StorageErr err = reopen();
+        if (false == err.success()) {
+            return err;
+        }
+    }
+}
+
+auto WriteAheadLog::append(std::string_view const payload) -> std::uint64_t {
+    std::uint64_t const lsn = get_last_lsn() + 1;
+    BinaryWriter record;
+    record.write_u32(static_cast<std::uint32_t>(payload.size()));
+    record.write_u32(get_checksum(lsn, payload));
+    record.write_u64(lsn);
+    std::string bytes = record.get_buffer();
+    bytes.append(payload);
+
+    bool const written = write_all(m_fd, bytes);
+    std::lock_guard const lock{m_mutex};
+    if (false == written) {
+        m_failed = true;
+        m_synced.notify_all();
+        return lsn;
+    }
+    m_last_lsn = lsn;
+    m_file_lsn = lsn;
+    m_size += bytes.size();
+    return lsn;
+}
+
+auto WriteAheadLog::sync(std::uint64_t const lsn) -> StorageErr {
+    std::unique_lock lock{m_mutex};
+    while (false == m_failed && m_synced_lsn < lsn) {
+        if (m_syncing) {
+            m_synced.wait(lock);
+            continue;
+        }
+        // Become the leader and flush the records of all waiting callers at once
+        m_syncing = true;
+        int const fd = m_fd;
+        std::uint64_t const target_lsn = m_last_lsn;
+        lock.unlock();
+        bool const flushed = 0 == ::fdatasync(fd);
+        lock.lock();
+        m_syncing = false;
+        ++m_num_syncs;
+        if (flushed) {
+            m_synced_lsn = std::max(m_synced_lsn, target_lsn);
+        } else {
+            m_failed = true;
+        }
+        m_synced.notify_all();
+    }
+    if (m_failed) {
+        return StorageErr{StorageErrType::ConnectionErr, "write-ahead log failed"};
+    }
+    return StorageErr{};
+}
+
+auto WriteAheadLog::replace() -> StorageErr {
+    std::filesystem::path temp_path = m_path;
+    temp_path += cTempFileSuffix;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    int const temp_fd = ::open(
+            temp_path.c_str(),
+            O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+            S_IRUSR | S_IWUSR
+    );
+    if (temp_fd < 0) {
+        return io_error("open", temp_path);
+    }
+    ::close(temp_fd);
+    if (0 != ::rename(temp_path.c_str(), m_path.c_str())) {
+        return io_error("rename", temp_path);
+    }
+
+    // Flush the directory so the replacement survives a crash
+    std::filesystem::path const directory = m_path.parent_path();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    int const dir_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0) {
+        return io_error("open", directory);
+    }
+    int const result = ::fsync(dir_fd);
+    ::close(dir_fd);
+    if (0 != result) {
+        return io_error("flush", directory);
+    }
+    return reopen();
+}
+
+auto WriteAheadLog::has_unread_records() const -> bool {
+    struct stat path_stat{};
+    if (0 != ::stat(m_path.c_str(), &path_stat)) {
+        // Let `read` report the error
+        return true;
+    }
+    return path_stat.st_ino != m_inode || static_cast<std::size_t>(path_stat.st_size) != m_size;
+}
+
+auto WriteAheadLog::get_error() -> StorageErr {
+    std::lock_guard const lock{m_mutex};
+    if (m_failed) {
+        return StorageErr{StorageErrType::ConnectionErr, "write-ahead log failed"};
+    }
+    return StorageErr{};
+}
+
+auto WriteAheadLog::get_last_lsn() -> std::uint64_t {
+    std::lock_guard const lock{m_mutex};
+    return m_last_lsn;
+}
+
+auto WriteAheadLog::get_num_syncs() -> std::size_t {
+    std::lock_guard const lock{m_mutex};
+    return m_num_syncs;
+}
+
+auto WriteAheadLog::reopen() -> StorageErr {
+    int fd = -1;
+    ino_t inode = 0;
+    StorageErr err = open_file(m_path, &fd, &inode);
+    if (false == err.success()) {
+        return err;
+    }
+    {
+        std::unique_lock lock{m_mutex};
+        m_synced.wait(lock, [&] { return false == m_syncing; });
+        ::close(m_fd);
+        m_fd = fd;
+        // The records of the previous file are covered by the snapshot that replaced it
+        m_synced_lsn = m_last_lsn;
+        m_synced.notify_all();
+    }
+    m_inode = inode;
+    m_size = 0;
+    m_file_lsn = 0;
+    return StorageErr{};
+}
+}  // namespace spider::core
@@ -0,0 +1,158 @@
+#ifndef SPIDER_STORAGE_WRITEAHEADLOG_HPP
+#define SPIDER_STORAGE_WRITEAHEADLOG_HPP
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <variant>
+
+#include <spider/core/Error.hpp>
+
+namespace spider::core {
+/**
+ * Append-only log of the changes to a durable store, shared by all processes using the store. A
+ * record is framed as its payload size, the CRC-32 of its sequence number and payload, its sequence
+ * number, then its payload.
+ *
+ * Processes take turns on the log under the lock of the store's directory. In its turn, a process
+ * reads the records the other processes appended since its last turn, then writes its own records
+ * to the file right away so the next process sees them. Records are flushed to disk after the turn,
+ * with a single `fdatasync` for all the callers waiting at the same time (group commit), so
+ * concurrent commits share the cost of a flush.
+ *
+ * Once a snapshot covers the log, the log is replaced by an empty file instead of being truncated,
+ * so a process that has not read the end of the old log yet still reads it through its open file.
+ */
+class WriteAheadLog {
+public:
+    // Delete copy and move constructors and assignment operators
+    WriteAheadLog(WriteAheadLog const&) = delete;
+    auto operator=(WriteAheadLog const&) -> WriteAheadLog& = delete;
+    WriteAheadLog(WriteAheadLog&&) = delete;
+    auto operator=(WriteAheadLog&&) -> WriteAheadLog& = delete;
+
+    ~WriteAheadLog();
+
+    /**
+     * Opens a log, creating it if it does not exist. Nothing is read until `read` is called.
+     *
+     * @param path
+     * @param last_lsn The sequence number of the last record applied to the store. Records up to
+     * it are skipped when reading.
+     * @return The log on success.
+     * @return StorageErrType::ConnectionErr if the file cannot be opened.
+     */
+    static auto open(std::filesystem::path const& path, std::uint64_t last_lsn)
+            -> std::variant<std::unique_ptr<WriteAheadLog>, StorageErr>;
+
+    /**
+     * Calls `apply` with the sequence number and payload of every record not read or appended
+     * through this log yet, in order, following the log to the file that replaced it. A torn or
+     * corrupt record, e.g. one partially written before a crash, ends the log, and the file is
+     * truncated before it so new records are appended after the last valid record. Must be called
+     * with the directory lock held.
+     *
+     * @param apply
+     * @return StorageErr::Success if all records are read.
+     * @return StorageErrType::ConnectionErr if the file cannot be read or truncated.
+     * @return The error of `apply` if it fails.
+     */
+    auto read(std::function<StorageErr(std::uint64_t, std::string_view)> const& apply)
+            -> StorageErr;
+
+    /**
+     * Writes a record at the end of the log. The log must be read up to its end first. Must be
+     * called with the directory lock held.
+     *
+     * @param payload
+     * @return The sequence number of the record. If the record cannot be written, the log fails and
+     * `sync` returns an error.
+     */
+    auto append(std::string_view payload) -> std::uint64_t;
+
+    /**
+     * Waits until a record and all records before it are flushed to disk.
+     *
+     * @param lsn
+     * @return StorageErr::Success if the record is durable.
+     * @return StorageErrType::ConnectionErr if writing or flushing the log failed. The log stays
+     * failed afterwards.
+     */
+    auto sync(std::uint64_t lsn) -> StorageErr;
+
+    /**
+     * Replaces the log with an empty file once its records are covered by a snapshot. Must be
+     * called with the directory lock held.
+     *
+     * @return StorageErr::Success if the log is empty.
+     * @return StorageErrType::ConnectionErr if the file cannot be replaced.
+     */
+    auto replace() -> StorageErr;
+
+    /**
+     * Checks, without the directory lock, whether other processes appended records or replaced the
+     * log since the last call to `read`. Records may be appended right after the check.
+     *
+     * @return Whether there may be records to read.
+     */
+    [[nodiscard]] auto has_unread_records() const -> bool;
+
+    /**
+     * @return StorageErr::Success unless writing or flushing the log failed.
+     */
+    [[nodiscard]] auto get_error() -> StorageErr;
+
+    /**
+     * @return The size in bytes of the records read from or appended to the current file.
+     */
+    [[nodiscard]] auto get_size() const -> std::size_t { return m_size; }
+
+    /**
+     * @return The sequence number of the last record read or appended.
+     */
+    [[nodiscard]] auto get_last_lsn() -> std::uint64_t;
+
+    /**
+     * @return The number of flushes to disk so far.
+     */
+    [[nodiscard]] auto get_num_syncs() -> std::size_t;
+
+private:
+    WriteAheadLog(std::filesystem::path path, int fd, ino_t inode, std::uint64_t last_lsn);
+
+    /**
+     * Switches to the file currently at the log's path, once the previous file is read to its end.
+     * Must be called with the directory lock held.
+     *
+     * @return StorageErr::Success if the file is opened.
+     * @return StorageErrType::ConnectionErr if the file cannot be opened.
+     */
+    auto reopen() -> StorageErr;
+
+    std::filesystem::path m_path;
+
+    // Only changed with the directory lock held
+    ino_t m_inode;
+    std::size_t m_size = 0;
+    // Sequence number of the last record of the current file
+    std::uint64_t m_file_lsn = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_synced;
+    int m_fd;
+    std::uint64_t m_last_lsn;
+    std::uint64_t m_synced_lsn;
+    bool m_syncing = false;
+    bool m_failed = false;
+    std::size_t m_num_syncs = 0;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_WRITEAHEADLOG_HPP
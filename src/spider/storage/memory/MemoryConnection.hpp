@@ -0,0 +1,39 @@
+#ifndef SPIDER_STORAGE_MEMORYCONNECTION_HPP
+#define SPIDER_STORAGE_MEMORYCONNECTION_HPP
+
+#include <memory>
+#include <utility>
+
+#include <spider/storage/memory/MemoryStore.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+// Connection to an in-memory store. Operations take effect immediately, so there is nothing to
+// commit or roll back.
+class MemoryConnection : public StorageConnection {
+public:
+    explicit MemoryConnection(std::shared_ptr<MemoryStore> store) : m_store{std::move(store)} {}
+
+    // Delete copy constructor and copy assignment operator
+    MemoryConnection(MemoryConnection const&) = delete;
+    auto operator=(MemoryConnection const&) -> MemoryConnection& = delete;
+    // Default move constructor and move assignment operator
+    MemoryConnection(MemoryConnection&&) = default;
+    auto operator=(MemoryConnection&&) -> MemoryConnection& = default;
+
+    ~MemoryConnection() override = default;
+
+    [[nodiscard]] auto get_store() const -> MemoryStore& { return *m_store; }
+
+    /**
+     * Brings the store up to date before an operation uses it. An in-memory store is only changed
+     * through its connections, so it is always up to date.
+     */
+    virtual auto refresh() -> void {}
+
+private:
+    std::shared_ptr<MemoryStore> m_store;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_MEMORYCONNECTION_HPP
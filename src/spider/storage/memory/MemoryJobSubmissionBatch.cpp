@@ -0,0 +1,18 @@
+#include "MemoryJobSubmissionBatch.hpp"
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/memory/MemoryConnection.hpp>
+#include <spider/storage/memory/MemoryStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+auto MemoryJobSubmissionBatch::submit_batch(StorageConnection& conn) -> StorageErr {
+    StorageErr err = MemoryMetadataStorage::insert_jobs(
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+            static_cast<MemoryConnection&>(conn).get_store(),
+            m_jobs
+    );
+    m_jobs.clear();
+    return err;
+}
+}  // namespace spider::core
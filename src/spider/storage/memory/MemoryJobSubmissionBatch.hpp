@@ -0,0 +1,38 @@
+#ifndef SPIDER_STORAGE_MEMORYJOBSUBMISSIONBATCH_HPP
+#define SPIDER_STORAGE_MEMORYJOBSUBMISSIONBATCH_HPP
+
+#include <utility>
+#include <vector>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/JobSubmissionBatch.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+// Forward declaration for friend class
+class MemoryStorageFactory;
+
+// Stages jobs and inserts them all at once, so other connections see either none or all of them.
+class MemoryJobSubmissionBatch : public JobSubmissionBatch {
+public:
+    MemoryJobSubmissionBatch(MemoryJobSubmissionBatch const&) = delete;
+    auto operator=(MemoryJobSubmissionBatch const&) -> MemoryJobSubmissionBatch& = delete;
+    MemoryJobSubmissionBatch(MemoryJobSubmissionBatch&&) = default;
+    auto operator=(MemoryJobSubmissionBatch&&) -> MemoryJobSubmissionBatch& = default;
+    ~MemoryJobSubmissionBatch() override = default;
+
+    auto submit_batch(StorageConnection& conn) -> StorageErr override;
+
+    auto add_job(MemoryStore::StagedJob job) -> void { m_jobs.push_back(std::move(job)); }
+
+protected:
+    MemoryJobSubmissionBatch() = default;
+
+    std::vector<MemoryStore::StagedJob> m_jobs;
+
+    friend class MemoryStorageFactory;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_MEMORYJOBSUBMISSIONBATCH_HPP
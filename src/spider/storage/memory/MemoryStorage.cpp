@@ -0,0 +1,1859 @@
+#include "MemoryStorage.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <fmt/format.h>
+
+#include <spider/core/Data.hpp>
+#include <spider/core/Driver.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/core/JobMetadata.hpp>
+#include <spider/core/KeyValueData.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/core/TaskGraph.hpp>
+#include <spider/storage/JobSubmissionBatch.hpp>
+#include <spider/storage/memory/MemoryConnection.hpp>
+#include <spider/storage/memory/MemoryJobSubmissionBatch.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+namespace {
+// Same lease expiry as the MySQL storage
+constexpr std::chrono::milliseconds cLeaseExpireTime{10};
+// Timeouts below this are treated as no timeout
+constexpr float cMinTimeout = 0.0001F;
+
+using IdSet = absl::flat_hash_set<boost::uuids::uuid>;
+
+auto get_store(StorageConnection& conn) -> MemoryStore& {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    auto& memory_conn = static_cast<MemoryConnection&>(conn);
+    memory_conn.refresh();
+    return memory_conn.get_store();
+}
+
+auto to_milliseconds(double const timeout) -> std::chrono::duration<double, std::milli> {
+    return std::chrono::duration<double, std::milli>{timeout};
+}
+
+/**
+ * Must be called with the metadata lock held.
+ *
+ * @param store
+ * @param task_id
+ * @param task
+ * @return The key of the task in the ready index.
+ */
+auto get_ready_task_key(
+        MemoryStore const& store,
+        boost::uuids::uuid const task_id,
+        MemoryStore::TaskEntry const& task
+) -> MemoryStore::ReadyTaskKey {
+    MemoryStore::JobEntry const& job = store.jobs.at(task.job_id);
+    return MemoryStore::ReadyTaskKey{job.priority, job.creation_time, task_id};
+}
+
+/**
+ * Adds a task to the ready index of all tasks and to the one of its client. Must be called with
+ * the metadata lock held exclusively.
+ *
+ * @param store
+ * @param task_id
+ * @param task
+ */
+auto insert_ready_task(
+        MemoryStore& store,
+        boost::uuids::uuid const task_id,
+        MemoryStore::TaskEntry const& task
+) -> void {
+    MemoryStore::ReadyTaskKey const key = get_ready_task_key(store, task_id, task);
+    store.ready_tasks.insert(key);
+    store.client_ready_tasks[store.jobs.at(task.job_id).client_id].insert(key);
+}
+
+/**
+ * Removes a task from the ready index of all tasks and from the one of its client. Must be called
+ * with the metadata lock held exclusively.
+ *
+ * @param store
+ * @param task_id
+ * @param task
+ */
+auto erase_ready_task(
+        MemoryStore& store,
+        boost::uuids::uuid const task_id,
+        MemoryStore::TaskEntry const& task
+) -> void {
+    MemoryStore::ReadyTaskKey const key = get_ready_task_key(store, task_id, task);
+    store.ready_tasks.erase(key);
+    auto const it = store.client_ready_tasks.find(store.jobs.at(task.job_id).client_id);
+    if (it == store.client_ready_tasks.end()) {
+        return;
+    }
+    it->second.erase(key);
+    if (it->second.empty()) {
+        store.client_ready_tasks.erase(it);
+    }
+}
+
+/**
+ * Sets the state of a task and keeps the ready index in sync. Must be called with the metadata
+ * lock held exclusively.
+ *
+ * @param store
+ * @param task_id
+ * @param task
+ * @param state
+ */
+auto set_state(
+        MemoryStore& store,
+        boost::uuids::uuid const task_id,
+        MemoryStore::TaskEntry& task,
+        TaskState const state
+) -> void {
+    if (state == task.state) {
+        return;
+    }
+    if (TaskState::Ready == task.state) {
+        erase_ready_task(store, task_id, task);
+    } else if (TaskState::Ready == state) {
+        insert_ready_task(store, task_id, task);
+    }
+    task.state = state;
+}
+
+auto build_task(boost::uuids::uuid const id, MemoryStore::TaskEntry const& entry) -> Task {
+    Task task{id, entry.function_name, entry.language, entry.state, entry.timeout};
+    for (TaskInput const& input : entry.inputs) {
+        task.add_input(input);
+    }
+    for (TaskOutput const& output : entry.outputs) {
+        task.add_output(output);
+    }
+    return task;
+}
+
+/**
+ * Builds the scheduling metadata of a task, with the localities of its data inputs. Must be called
+ * with the metadata lock held.
+ *
+ * @param store
+ * @param task_id
+ * @param task
+ * @return The scheduling metadata.
+ */
+auto build_schedule_metadata(
+        MemoryStore const& store,
+        boost::uuids::uuid const task_id,
+        MemoryStore::TaskEntry const& task
+) -> ScheduleTaskMetadata {
+    MemoryStore::JobEntry const& job = store.jobs.at(task.job_id);
+    ScheduleTaskMetadata metadata{task_id, task.function_name, task.job_id};
+    metadata.set_client_id(job.client_id);
+    metadata.set_job_creation_time(job.creation_time);
+    metadata.set_job_priority(job.priority);
+    for (TaskInput const& input : task.inputs) {
+        std::optional<boost::uuids::uuid> const data_id = input.get_data_id();
+        if (false == data_id.has_value()) {
+            continue;
+        }
+        store.data.read(data_id.value(), [&](auto const& data_map) {
+            auto const it = data_map.find(data_id.value());
+            if (it == data_map.end()) {
+                return;
+            }
+            for (std::string const& locality : it->second.locality) {
+                if (it->second.hard_locality) {
+                    metadata.add_hard_locality(locality);
+                } else {
+                    metadata.add_soft_locality(locality);
+                }
+            }
+        });
+    }
+    return metadata;
+}
+
+/**
+ * @param task
+ * @return The number of inputs of the task that wait for the output of a parent task.
+ */
+auto count_task_output_inputs(MemoryStore::TaskEntry const& task) -> std::uint32_t {
+    return static_cast<std::uint32_t>(std::ranges::count_if(task.inputs, [](TaskInput const& in) {
+        return in.get_task_output().has_value();
+    }));
+}
+
+/**
+ * Removes a task with its instances, lease, data references and key-value data, and unlinks it from
+ * the DAG index. Must be called with the metadata lock held exclusively, before the job of the task
+ * is removed.
+ *
+ * @param store
+ * @param task_id
+ */
+auto remove_task(MemoryStore& store, boost::uuids::uuid const task_id) -> void {
+    auto const task_it = store.tasks.find(task_id);
+    if (task_it == store.tasks.end()) {
+        return;
+    }
+    MemoryStore::TaskEntry const& task = task_it->second;
+    if (TaskState::Ready == task.state) {
+        erase_ready_task(store, task_id, task);
+    }
+    for (boost::uuids::uuid const& instance_id : task.instance_ids) {
+        store.instances.erase(instance_id);
+    }
+    store.leases.erase(task_id);
+
+    for (boost::uuids::uuid const& parent_id : task.parents) {
+        auto const parent_it = store.tasks.find(parent_id);
+        if (parent_it != store.tasks.end()) {
+            std::erase(parent_it->second.children, task_id);
+        }
+    }
+    for (boost::uuids::uuid const& child_id : task.children) {
+        auto const child_it = store.tasks.find(child_id);
+        if (child_it != store.tasks.end()) {
+            std::erase(child_it->second.parents, task_id);
+        }
+    }
+    for (TaskInput const& input : task.inputs) {
+        std::optional<std::tuple<boost::uuids::uuid, std::uint8_t>> const task_output
+                = input.get_task_output();
+        if (false == task_output.has_value()) {
+            continue;
+        }
+        auto const producer_it = store.tasks.find(std::get<0>(task_output.value()));
+        if (producer_it != store.tasks.end()) {
+            std::erase_if(producer_it->second.consumers, [&](auto const& consumer) {
+                return consumer.first == task_id;
+            });
+        }
+    }
+
+    IdSet data_ids;
+    store.task_data_refs.write(task_id, [&](auto& refs_map) {
+        auto const it = refs_map.find(task_id);
+        if (it != refs_map.end()) {
+            data_ids = std::move(it->second);
+            refs_map.erase(it);
+        }
+    });
+    for (boost::uuids::uuid const& data_id : data_ids) {
+        store.data.write(data_id, [&](auto& data_map) {
+            auto const it = data_map.find(data_id);
+            if (it != data_map.end()) {
+                it->second.task_refs.erase(task_id);
+            }
+        });
+    }
+    store.task_kv_data.write(task_id, [&](auto& kv_map) { kv_map.erase(task_id); });
+
+    store.tasks.erase(task_it);
+}
+
+/**
+ * Builds the stored form of a task. Inputs are normalized the same way the MySQL storage reads
+ * them back, and outputs keep only their types.
+ *
+ * @param job_id
+ * @param task
+ * @param state
+ * @return The task entry.
+ */
+auto build_task_entry(boost::uuids::uuid const job_id, Task const& task, TaskState const state)
+        -> MemoryStore::TaskEntry {
+    MemoryStore::TaskEntry entry;
+    entry.job_id = job_id;
+    entry.function_name = task.get_function_name();
+    entry.language = task.get_language();
+    entry.state = state;
+    entry.timeout = task.get_timeout();
+    entry.max_retries = task.get_max_retries();
+    for (TaskInput const& input : task.get_inputs()) {
+        std::optional<std::tuple<boost::uuids::uuid, std::uint8_t>> const task_output
+                = input.get_task_output();
+        std::optional<boost::uuids::uuid> const data_id = input.get_data_id();
+        std::optional<std::string> const value = input.get_value();
+        if (task_output.has_value()) {
+            entry.inputs.emplace_back(
+                    std::get<0>(task_output.value()),
+                    std::get<1>(task_output.value()),
+                    input.get_type()
+            );
+        } else if (data_id.has_value()) {
+            entry.inputs.emplace_back(data_id.value());
+        } else if (value.has_value()) {
+            entry.inputs.emplace_back(value.value(), input.get_type());
+        }
+    }
+    entry.remaining_inputs = count_task_output_inputs(entry);
+    for (TaskOutput const& output : task.get_outputs()) {
+        entry.outputs.emplace_back(output.get_type());
+    }
+    return entry;
+}
+
+/**
+ * Makes a scheduler lease a set of ready tasks. Must be called with the metadata lock held
+ * exclusively.
+ *
+ * @param store
+ * @param scheduler_id
+ * @param after_task_id If set, only tasks ordered after this task are leased.
+ * @param max_num_tasks
+ * @param tasks Tasks already in the vector are leased again but not added twice.
+ * @return StorageErr::Success if the tasks are leased.
+ * @return StorageErrType::OtherErr if there are tasks to lease but the scheduler is unknown.
+ */
+auto lease_ready_tasks(
+        MemoryStore& store,
+        boost::uuids::uuid const scheduler_id,
+        std::optional<boost::uuids::uuid> const& client_id,
+        std::optional<boost::uuids::uuid> const& after_task_id,
+        std::size_t const max_num_tasks,
+        std::vector<ScheduleTaskMetadata>* tasks
+) -> StorageErr {
+    MemoryStore::Clock::time_point const now = MemoryStore::Clock::now();
+    for (auto it = store.leases.begin(); it != store.leases.end();) {
+        if (now - it->second.lease_time > cLeaseExpireTime) {
+            store.leases.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+
+    std::set<MemoryStore::ReadyTaskKey> const* ready_tasks = &store.ready_tasks;
+    if (client_id.has_value()) {
+        auto const client_it = store.client_ready_tasks.find(client_id.value());
+        if (client_it == store.client_ready_tasks.end()) {
+            return StorageErr{};
+        }
+        ready_tasks = &client_it->second;
+    }
+    auto begin = ready_tasks->begin();
+    if (after_task_id.has_value()) {
+        auto const after_it = store.tasks.find(after_task_id.value());
+        if (after_it == store.tasks.end()) {
+            return StorageErr{};
+        }
+        begin = ready_tasks->upper_bound(
+                get_ready_task_key(store, after_task_id.value(), after_it->second)
+        );
+    }
+
+    std::vector<boost::uuids::uuid> leased_ids;
+    for (auto it = begin; it != ready_tasks->end(); ++it) {
+        MemoryStore::ReadyTaskKey const& key = *it;
+        if (leased_ids.size() >= max_num_tasks) {
+            break;
+        }
+        if (store.leases.contains(key.task_id)) {
+            continue;
+        }
+        MemoryStore::TaskEntry const& task = store.tasks.at(key.task_id);
+        if (JobStatus::Running != store.jobs.at(task.job_id).state) {
+            continue;
+        }
+        leased_ids.push_back(key.task_id);
+    }
+    if (leased_ids.empty()) {
+        return StorageErr{};
+    }
+    if (false == store.schedulers.contains(scheduler_id)) {
+        return StorageErr{
+                StorageErrType::OtherErr,
+                fmt::format("no scheduler with id {}", boost::uuids::to_string(scheduler_id))
+        };
+    }
+
+    IdSet existing_ids;
+    for (ScheduleTaskMetadata const& task : *tasks) {
+        existing_ids.insert(task.get_id());
+    }
+    for (boost::uuids::uuid const& task_id : leased_ids) {
+        store.leases.insert_or_assign(task_id, MemoryStore::LeaseEntry{scheduler_id, now});
+        if (false == existing_ids.contains(task_id)) {
+            tasks->push_back(build_schedule_metadata(store, task_id, store.tasks.at(task_id)));
+        }
+    }
+    return StorageErr{};
+}
+}  // namespace
+
+auto MemoryMetadataStorage::initialize(StorageConnection& /*conn*/) -> StorageErr {
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::add_driver(StorageConnection& conn, Driver const& driver)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    if (false == store.drivers.try_emplace(driver.get_id(), store.get_record_time()).second) {
+        return StorageErr{
+                StorageErrType::DuplicateKeyErr,
+                fmt::format("driver with id {} exists", boost::uuids::to_string(driver.get_id()))
+        };
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::add_scheduler(StorageConnection& conn, Scheduler const& scheduler)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    boost::uuids::uuid const& id = scheduler.get_id();
+    if (store.drivers.contains(id) || store.schedulers.contains(id)) {
+        return StorageErr{
+                StorageErrType::DuplicateKeyErr,
+                fmt::format("scheduler with id {} exists", boost::uuids::to_string(id))
+        };
+    }
+    store.drivers.emplace(id, store.get_record_time());
+    store.schedulers.emplace(
+            id,
+            MemoryStore::SchedulerEntry{scheduler.get_addr(), scheduler.get_port()}
+    );
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::remove_driver(StorageConnection& conn, boost::uuids::uuid id) noexcept
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    store.drivers.erase(id);
+    if (store.schedulers.erase(id) > 0) {
+        for (auto it = store.leases.begin(); it != store.leases.end();) {
+            if (it->second.scheduler_id == id) {
+                store.leases.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    IdSet data_ids;
+    store.driver_data_refs.write(id, [&](auto& refs_map) {
+        auto const it = refs_map.find(id);
+        if (it != refs_map.end()) {
+            data_ids = std::move(it->second);
+            refs_map.erase(it);
+        }
+    });
+    for (boost::uuids::uuid const& data_id : data_ids) {
+        store.data.write(data_id, [&](auto& data_map) {
+            auto const it = data_map.find(data_id);
+            if (it != data_map.end()) {
+                it->second.driver_refs.erase(id);
+            }
+        });
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_active_scheduler(
+        StorageConnection& conn,
+        std::vector<Scheduler>* schedulers
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    for (auto const& [id, scheduler] : store.schedulers) {
+        if (store.drivers.contains(id)) {
+            schedulers->emplace_back(id, scheduler.addr, scheduler.port);
+        }
+    }
+    return StorageErr{};
+}
+
+// NOLINTBEGIN(readability-function-cognitive-complexity)
+auto MemoryMetadataStorage::stage_job(
+        boost::uuids::uuid const job_id,
+        boost::uuids::uuid const client_id,
+        TaskGraph const& task_graph,
+        std::int32_t const priority
+) -> std::variant<MemoryStore::StagedJob, StorageErr> {
+    MemoryStore::StagedJob staged;
+    staged.id = job_id;
+    staged.job.client_id = client_id;
+    staged.job.creation_time = std::chrono::system_clock::now();
+    staged.job.priority = priority;
+    staged.job.remaining_tasks = static_cast<std::uint32_t>(task_graph.get_tasks().size());
+    staged.job.dependencies = task_graph.get_dependencies();
+    staged.job.input_tasks = task_graph.get_input_tasks();
+    staged.job.output_tasks = task_graph.get_output_tasks();
+
+    // Tasks are added once all their parents are added, starting from the input tasks
+    std::optional<std::vector<Task const*>> const tasks = task_graph.get_tasks_in_graph_order();
+    if (false == tasks.has_value()) {
+        return StorageErr{StorageErrType::KeyNotFoundErr, "Task graph inconsistent"};
+    }
+    std::vector<boost::uuids::uuid> const& input_task_ids = task_graph.get_input_tasks();
+    IdSet const heads(input_task_ids.cbegin(), input_task_ids.cend());
+    staged.job.task_ids.reserve(tasks->size());
+    staged.tasks.reserve(tasks->size());
+    for (Task const* task : tasks.value()) {
+        boost::uuids::uuid const task_id = task->get_id();
+        TaskState const state = heads.contains(task_id) ? TaskState::Ready : task->get_state();
+        staged.job.task_ids.push_back(task_id);
+        staged.tasks.emplace_back(task_id, build_task_entry(job_id, *task, state));
+    }
+    return staged;
+}
+
+auto MemoryMetadataStorage::insert_jobs(
+        MemoryStore& store,
+        std::vector<MemoryStore::StagedJob>& jobs
+) -> StorageErr {
+    std::unique_lock const lock{store.metadata_mutex};
+
+    // Check all jobs before changing the store, so that either all or none are inserted
+    IdSet new_job_ids;
+    absl::flat_hash_map<boost::uuids::uuid, MemoryStore::TaskEntry const*> new_tasks;
+    for (MemoryStore::StagedJob const& job : jobs) {
+        if (store.jobs.contains(job.id) || false == new_job_ids.insert(job.id).second) {
+            return StorageErr{
+                    StorageErrType::DuplicateKeyErr,
+                    fmt::format("job with id {} exists", boost::uuids::to_string(job.id))
+            };
+        }
+        for (auto const& [task_id, task] : job.tasks) {
+            if (store.tasks.contains(task_id) || false == new_tasks.emplace(task_id, &task).second)
+            {
+                return StorageErr{
+                        StorageErrType::DuplicateKeyErr,
+                        fmt::format("task with id {} exists", boost::uuids::to_string(task_id))
+                };
+            }
+        }
+    }
+    auto const find_task = [&](boost::uuids::uuid const& id) -> MemoryStore::TaskEntry const* {
+        if (auto const it = new_tasks.find(id); it != new_tasks.end()) {
+            return it->second;
+        }
+        if (auto const it = store.tasks.find(id); it != store.tasks.end()) {
+            return &it->second;
+        }
+        return nullptr;
+    };
+    for (MemoryStore::StagedJob const& job : jobs) {
+        for (auto const& [parent_id, child_id] : job.job.dependencies) {
+            if (nullptr == find_task(parent_id) || nullptr == find_task(child_id)) {
+                return StorageErr{
+                        StorageErrType::OtherErr,
+                        "Task graph inconsistent: dependency on a task not added"
+                };
+            }
+        }
+        for (auto const* task_ids : {&job.job.input_tasks, &job.job.output_tasks}) {
+            for (boost::uuids::uuid const& task_id : *task_ids) {
+                if (nullptr == find_task(task_id)) {
+                    return StorageErr{
+                            StorageErrType::OtherErr,
+                            fmt::format("no task with id {}", boost::uuids::to_string(task_id))
+                    };
+                }
+            }
+        }
+        for (auto const& [task_id, task] : job.tasks) {
+            for (TaskInput const& input : task.inputs) {
+                std::optional<std::tuple<boost::uuids::uuid, std::uint8_t>> const task_output
+                        = input.get_task_output();
+                if (task_output.has_value()) {
+                    MemoryStore::TaskEntry const* producer
+                            = find_task(std::get<0>(task_output.value()));
+                    if (nullptr == producer
+                        || std::get<1>(task_output.value()) >= producer->outputs.size())
+                    {
+                        return StorageErr{
+                                StorageErrType::OtherErr,
+                                "Task input references a missing task output"
+                        };
+                    }
+                    continue;
+                }
+                std::optional<boost::uuids::uuid> const data_id = input.get_data_id();
+                if (data_id.has_value()
+                    && false == store.data.read(data_id.value(), [&](auto const& data_map) {
+                           return data_map.contains(data_id.value());
+                       }))
+                {
+                    return StorageErr{
+                            StorageErrType::OtherErr,
+                            fmt::format(
+                                    "no data with id {}",
+                                    boost::uuids::to_string(data_id.value())
+                            )
+                    };
+                }
+            }
+        }
+    }
+
+    for (MemoryStore::StagedJob& job : jobs) {
+        store.client_jobs[job.job.client_id].insert(job.id);
+        MemoryStore::JobEntry const& job_entry
+                = store.jobs.emplace(job.id, std::move(job.job)).first->second;
+        for (auto& [task_id, task] : job.tasks) {
+            store.tasks.emplace(task_id, std::move(task));
+        }
+        for (boost::uuids::uuid const& task_id : job_entry.task_ids) {
+            MemoryStore::TaskEntry const& task = store.tasks.at(task_id);
+            if (TaskState::Ready == task.state) {
+                insert_ready_task(store, task_id, task);
+            }
+            for (std::size_t i = 0; i < task.inputs.size(); ++i) {
+                std::optional<std::tuple<boost::uuids::uuid, std::uint8_t>> const task_output
+                        = task.inputs[i].get_task_output();
+                if (task_output.has_value()) {
+                    store.tasks.at(std::get<0>(task_output.value()))
+                            .consumers.emplace_back(task_id, i);
+                }
+            }
+        }
+        for (auto const& [parent_id, child_id] : job_entry.dependencies) {
+            store.tasks.at(parent_id).children.push_back(child_id);
+            store.tasks.at(child_id).parents.push_back(parent_id);
+        }
+    }
+    return StorageErr{};
+}
+
+// NOLINTEND(readability-function-cognitive-complexity)
+
+auto MemoryMetadataStorage::add_job(
+        StorageConnection& conn,
+        boost::uuids::uuid job_id,
+        boost::uuids::uuid client_id,
+        TaskGraph const& task_graph,
+        std::int32_t priority
+) -> StorageErr {
+    std::variant<MemoryStore::StagedJob, StorageErr> staged
+            = stage_job(job_id, client_id, task_graph, priority);
+    if (std::holds_alternative<StorageErr>(staged)) {
+        return std::get<StorageErr>(staged);
+    }
+    std::vector<MemoryStore::StagedJob> jobs;
+    jobs.push_back(std::move(std::get<MemoryStore::StagedJob>(staged)));
+    return insert_jobs(get_store(conn), jobs);
+}
+
+auto MemoryMetadataStorage::add_job_batch(
+        StorageConnection& /*conn*/,
+        JobSubmissionBatch& batch,
+        boost::uuids::uuid job_id,
+        boost::uuids::uuid client_id,
+        TaskGraph const& task_graph,
+        std::int32_t priority
+) -> StorageErr {
+    std::variant<MemoryStore::StagedJob, StorageErr> staged
+            = stage_job(job_id, client_id, task_graph, priority);
+    if (std::holds_alternative<StorageErr>(staged)) {
+        return std::get<StorageErr>(staged);
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    static_cast<MemoryJobSubmissionBatch&>(batch).add_job(
+            std::move(std::get<MemoryStore::StagedJob>(staged))
+    );
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_job_metadata(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        JobMetadata* job
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.jobs.find(id);
+    if (it == store.jobs.end()) {
+        return StorageErr{
+                StorageErrType::KeyNotFoundErr,
+                fmt::format("No job with id {} ", boost::uuids::to_string(id))
+        };
+    }
+    *job = JobMetadata{id, it->second.client_id, it->second.creation_time, it->second.priority};
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_job_complete(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        bool* complete
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.jobs.find(id);
+    if (it == store.jobs.end()) {
+        return StorageErr{
+                StorageErrType::KeyNotFoundErr,
+                fmt::format("no job with id {}", boost::uuids::to_string(id))
+        };
+    }
+    *complete = JobStatus::Running != it->second.state;
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_job_status(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        JobStatus* status
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.jobs.find(id);
+    if (it == store.jobs.end()) {
+        return StorageErr{
+                StorageErrType::KeyNotFoundErr,
+                fmt::format("no job with id {}", boost::uuids::to_string(id))
+        };
+    }
+    *status = it->second.state;
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_job_output_tasks(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        std::vector<boost::uuids::uuid>* task_ids
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    task_ids->clear();
+    auto const it = store.jobs.find(id);
+    if (it != store.jobs.end()) {
+        *task_ids = it->second.output_tasks;
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_task_graph(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        TaskGraph* task_graph
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.jobs.find(id);
+    if (it == store.jobs.end() || it->second.task_ids.empty()) {
+        return StorageErr{
+                StorageErrType::KeyNotFoundErr,
+                fmt::format("no task graph with id {}", boost::uuids::to_string(id))
+        };
+    }
+    MemoryStore::JobEntry const& job = it->second;
+    for (boost::uuids::uuid const& task_id : job.task_ids) {
+        task_graph->add_task(build_task(task_id, store.tasks.at(task_id)));
+    }
+    for (auto const& [parent_id, child_id] : job.dependencies) {
+        task_graph->add_dependency(parent_id, child_id);
+    }
+    for (boost::uuids::uuid const& task_id : job.input_tasks) {
+        task_graph->add_input_task(task_id);
+    }
+    for (boost::uuids::uuid const& task_id : job.output_tasks) {
+        task_graph->add_output_task(task_id);
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_jobs_by_client_id(
+        StorageConnection& conn,
+        boost::uuids::uuid client_id,
+        std::vector<boost::uuids::uuid>* job_ids
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.client_jobs.find(client_id);
+    if (it != store.client_jobs.end()) {
+        job_ids->insert(job_ids->end(), it->second.cbegin(), it->second.cend());
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::remove_job(StorageConnection& conn, boost::uuids::uuid id) noexcept
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    auto const it = store.jobs.find(id);
+    if (it == store.jobs.end()) {
+        return StorageErr{};
+    }
+    for (boost::uuids::uuid const& task_id : it->second.task_ids) {
+        remove_task(store, task_id);
+    }
+    auto const client_it = store.client_jobs.find(it->second.client_id);
+    if (client_it != store.client_jobs.end()) {
+        client_it->second.erase(id);
+        if (client_it->second.empty()) {
+            store.client_jobs.erase(client_it);
+        }
+    }
+    store.jobs.erase(it);
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::reset_job(StorageConnection& conn, boost::uuids::uuid id)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    auto const it = store.jobs.find(id);
+    if (it == store.jobs.end()) {
+        return StorageErr{};
+    }
+    MemoryStore::JobEntry& job = it->second;
+    if (std::ranges::any_of(job.task_ids, [&](boost::uuids::uuid const& task_id) {
+            MemoryStore::TaskEntry const& task = store.tasks.at(task_id);
+            return task.retry >= task.max_retries;
+        }))
+    {
+        return StorageErr{StorageErrType::Success, "Some tasks have reached max retry count"};
+    }
+
+    for (boost::uuids::uuid const& task_id : job.task_ids) {
+        MemoryStore::TaskEntry& task = store.tasks.at(task_id);
+        ++task.retry;
+        for (TaskOutput& output : task.outputs) {
+            output = TaskOutput{output.get_type()};
+        }
+        for (TaskInput& input : task.inputs) {
+            std::optional<std::tuple<boost::uuids::uuid, std::uint8_t>> const task_output
+                    = input.get_task_output();
+            if (task_output.has_value()) {
+                input = TaskInput{
+                        std::get<0>(task_output.value()),
+                        std::get<1>(task_output.value()),
+                        input.get_type()
+                };
+            }
+        }
+        task.remaining_inputs = count_task_output_inputs(task);
+        set_state(
+                store,
+                task_id,
+                task,
+                0 == task.remaining_inputs ? TaskState::Ready : TaskState::Pending
+        );
+    }
+    job.state = JobStatus::Running;
+    job.remaining_tasks = static_cast<std::uint32_t>(job.task_ids.size());
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_task(StorageConnection& conn, boost::uuids::uuid id, Task* task)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.tasks.find(id);
+    if (it == store.tasks.end()) {
+        return StorageErr{
+                StorageErrType::KeyNotFoundErr,
+                fmt::format("no task with id {}", boost::uuids::to_string(id))
+        };
+    }
+    *task = build_task(id, it->second);
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_task_job_id(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        boost::uuids::uuid* job_id
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.tasks.find(id);
+    if (it == store.tasks.end()) {
+        return StorageErr{
+                StorageErrType::KeyNotFoundErr,
+                fmt::format("no task with id {}", boost::uuids::to_string(id))
+        };
+    }
+    *job_id = it->second.job_id;
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_ready_tasks(
+        StorageConnection& conn,
+        boost::uuids::uuid scheduler_id,
+        std::optional<boost::uuids::uuid> const& client_id,
+        std::optional<boost::uuids::uuid> const& after_task_id,
+        std::size_t max_num_tasks,
+        std::vector<ScheduleTaskMetadata>* tasks
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    return lease_ready_tasks(store, scheduler_id, client_id, after_task_id, max_num_tasks, tasks);
+}
+
+auto MemoryMetadataStorage::get_ready_clients(
+        StorageConnection& conn,
+        std::vector<boost::uuids::uuid>* ids
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    for (auto const& [client_id, ready_tasks] : store.client_ready_tasks) {
+        bool const has_running_job = std::ranges::any_of(
+                ready_tasks,
+                [&](MemoryStore::ReadyTaskKey const& key) {
+                    return JobStatus::Running
+                           == store.jobs.at(store.tasks.at(key.task_id).job_id).state;
+                }
+        );
+        if (has_running_job) {
+            ids->push_back(client_id);
+        }
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::set_task_state(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        TaskState state
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    auto const it = store.tasks.find(id);
+    if (it != store.tasks.end()) {
+        set_state(store, id, it->second, state);
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::set_task_running(StorageConnection& conn, boost::uuids::uuid id)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    auto const it = store.tasks.find(id);
+    if (it == store.tasks.end() || TaskState::Ready != it->second.state) {
+        return StorageErr{StorageErrType::KeyNotFoundErr, "Task not ready"};
+    }
+    set_state(store, id, it->second, TaskState::Running);
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::add_task_instance(
+        StorageConnection& conn,
+        TaskInstance const& instance
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    auto const it = store.tasks.find(instance.task_id);
+    if (it == store.tasks.end()) {
+        return StorageErr{
+                StorageErrType::OtherErr,
+                fmt::format("no task with id {}", boost::uuids::to_string(instance.task_id))
+        };
+    }
+    if (false
+        == store.instances
+                   .try_emplace(
+                           instance.id,
+                           MemoryStore::InstanceEntry{
+                                   instance.task_id,
+                                   std::nullopt,
+                                   store.get_record_time()
+                           }
+                   )
+                   .second)
+    {
+        return StorageErr{
+                StorageErrType::DuplicateKeyErr,
+                fmt::format("task instance with id {} exists", boost::uuids::to_string(instance.id))
+        };
+    }
+    it->second.instance_ids.push_back(instance.id);
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::create_task_instance_impl(
+        MemoryStore& store,
+        TaskInstance const& instance,
+        std::optional<boost::uuids::uuid> const& worker_id
+) -> StorageErr {
+    auto const task_it = store.tasks.find(instance.task_id);
+    if (task_it == store.tasks.end()) {
+        return StorageErr{StorageErrType::KeyNotFoundErr, "Task not found"};
+    }
+    MemoryStore::TaskEntry& task = task_it->second;
+    MemoryStore::Clock::time_point const now = MemoryStore::Clock::now();
+    bool const task_ready = TaskState::Ready == task.state;
+    // A running task gets another instance once all its instances time out
+    bool const all_timed_out
+            = TaskState::Running == task.state
+              && std::ranges::none_of(task.instance_ids, [&](boost::uuids::uuid const& id) {
+                     return task.timeout < cMinTimeout
+                            || now - store.instances.at(id).start_time
+                                       < to_milliseconds(task.timeout);
+                 });
+    if (false == task_ready && false == all_timed_out) {
+        return StorageErr{StorageErrType::OtherErr, "Task not ready or timed out"};
+    }
+    auto const job_it = store.jobs.find(task.job_id);
+    if (job_it == store.jobs.end()) {
+        return StorageErr{StorageErrType::KeyNotFoundErr, "Job not found"};
+    }
+    if (JobStatus::Running != job_it->second.state) {
+        return StorageErr{StorageErrType::OtherErr, "Job state wrong"};
+    }
+    if (false
+        == store.instances
+                   .try_emplace(
+                           instance.id,
+                           MemoryStore::InstanceEntry{
+                                   instance.task_id,
+                                   worker_id,
+                                   store.get_record_time()
+                           }
+                   )
+                   .second)
+    {
+        return StorageErr{
+                StorageErrType::DuplicateKeyErr,
+                fmt::format("task instance with id {} exists", boost::uuids::to_string(instance.id))
+        };
+    }
+    task.instance_ids.push_back(instance.id);
+    set_state(store, instance.task_id, task, TaskState::Running);
+    store.leases.erase(instance.task_id);
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::create_task_instance(
+        StorageConnection& conn,
+        TaskInstance const& instance
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    return create_task_instance_impl(store, instance, std::nullopt);
+}
+
+auto MemoryMetadataStorage::create_task_instances(
+        StorageConnection& conn,
+        std::vector<TaskInstance> const& instances,
+        std::vector<TaskInstance>* created
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    for (TaskInstance const& instance : instances) {
+        if (create_task_instance_impl(store, instance, std::nullopt).success()) {
+            created->push_back(instance);
+        }
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::start_task_instances(
+        StorageConnection& conn,
+        boost::uuids::uuid worker_id,
+        std::vector<TaskInstance> const& instances,
+        std::vector<TaskInstance>* created,
+        std::vector<Task>* tasks
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    for (TaskInstance const& instance : instances) {
+        if (create_task_instance_impl(store, instance, worker_id).success()) {
+            created->push_back(instance);
+            tasks->push_back(build_task(instance.task_id, store.tasks.at(instance.task_id)));
+        }
+    }
+    return StorageErr{};
+}
+
+// NOLINTBEGIN(readability-function-cognitive-complexity)
+auto MemoryMetadataStorage::task_finish_impl(
+        MemoryStore& store,
+        TaskInstance const& instance,
+        std::vector<TaskOutput> const& outputs
+) -> void {
+    auto const task_it = store.tasks.find(instance.task_id);
+    // Only the first finished instance of a running task is accepted
+    if (task_it == store.tasks.end() || task_it->second.instance_id.has_value()
+        || TaskState::Running != task_it->second.state)
+    {
+        return;
+    }
+    MemoryStore::TaskEntry& task = task_it->second;
+    task.instance_id = instance.id;
+    set_state(store, instance.task_id, task, TaskState::Succeed);
+
+    std::size_t const num_outputs = std::min(outputs.size(), task.outputs.size());
+    for (std::size_t i = 0; i < num_outputs; ++i) {
+        TaskOutput output{task.outputs[i].get_type()};
+        std::optional<std::string> const value = outputs[i].get_value();
+        std::optional<boost::uuids::uuid> const data_id = outputs[i].get_data_id();
+        if (value.has_value()) {
+            output.set_value(value.value());
+        } else if (data_id.has_value()) {
+            output.set_data_id(data_id.value());
+        }
+        task.outputs[i] = std::move(output);
+    }
+
+    // Pass the outputs to the inputs of the children
+    std::vector<boost::uuids::uuid> consumer_ids;
+    for (auto const& [consumer_id, position] : task.consumers) {
+        auto const consumer_it = store.tasks.find(consumer_id);
+        if (consumer_it == store.tasks.end()) {
+            continue;
+        }
+        MemoryStore::TaskEntry& consumer = consumer_it->second;
+        TaskInput& input = consumer.inputs[position];
+        std::tuple<boost::uuids::uuid, std::uint8_t> const task_output
+                = input.get_task_output().value();
+        std::size_t const output_position = std::get<1>(task_output);
+        if (output_position < outputs.size()) {
+            TaskInput updated{std::get<0>(task_output), std::get<1>(task_output), input.get_type()};
+            std::optional<std::string> const value = outputs[output_position].get_value();
+            std::optional<boost::uuids::uuid> const data_id
+                    = outputs[output_position].get_data_id();
+            if (value.has_value()) {
+                updated.set_value(value.value());
+            }
+            if (data_id.has_value()) {
+                updated.set_data_id(data_id.value());
+            }
+            input = std::move(updated);
+        }
+        if (consumer.remaining_inputs > 0) {
+            --consumer.remaining_inputs;
+        }
+        consumer_ids.push_back(consumer_id);
+    }
+    for (boost::uuids::uuid const& consumer_id : consumer_ids) {
+        MemoryStore::TaskEntry& consumer = store.tasks.at(consumer_id);
+        if (TaskState::Pending == consumer.state && 0 == consumer.remaining_inputs) {
+            set_state(store, consumer_id, consumer, TaskState::Ready);
+        }
+    }
+
+    auto const job_it = store.jobs.find(task.job_id);
+    if (job_it == store.jobs.end()) {
+        return;
+    }
+    MemoryStore::JobEntry& job = job_it->second;
+    if (job.remaining_tasks > 0) {
+        --job.remaining_tasks;
+    }
+    if (0 == job.remaining_tasks && JobStatus::Running == job.state) {
+        job.state = JobStatus::Succeeded;
+    }
+}
+
+// NOLINTEND(readability-function-cognitive-complexity)
+
+auto MemoryMetadataStorage::task_finish(
+        StorageConnection& conn,
+        TaskInstance const& instance,
+        std::vector<TaskOutput> const& outputs
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    task_finish_impl(store, instance, outputs);
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::task_finish_batch(
+        StorageConnection& conn,
+        std::vector<TaskInstance> const& instances,
+        std::vector<std::vector<TaskOutput>> const& outputs
+) -> StorageErr {
+    if (instances.size() != outputs.size()) {
+        return StorageErr{
+                StorageErrType::OtherErr,
+                "Number of task instances and task outputs mismatch"
+        };
+    }
+    if (instances.empty()) {
+        return StorageErr{};
+    }
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    for (std::size_t i = 0; i < instances.size(); ++i) {
+        task_finish_impl(store, instances[i], outputs[i]);
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::task_fail(
+        StorageConnection& conn,
+        TaskInstance const& instance,
+        std::string const& /*error*/
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    auto const instance_it = store.instances.find(instance.id);
+    if (instance_it != store.instances.end()) {
+        auto const owner_it = store.tasks.find(instance_it->second.task_id);
+        if (owner_it != store.tasks.end()) {
+            std::erase(owner_it->second.instance_ids, instance.id);
+        }
+        store.instances.erase(instance_it);
+    }
+
+    // The task fails once none of its instances are left
+    auto const task_it = store.tasks.find(instance.task_id);
+    if (task_it == store.tasks.end() || false == task_it->second.instance_ids.empty()) {
+        return StorageErr{};
+    }
+    set_state(store, instance.task_id, task_it->second, TaskState::Failed);
+    auto const job_it = store.jobs.find(task_it->second.job_id);
+    if (job_it != store.jobs.end()) {
+        job_it->second.state = JobStatus::Failed;
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_task_timeout(
+        StorageConnection& conn,
+        std::vector<ScheduleTaskMetadata>* tasks
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    MemoryStore::Clock::time_point const now = MemoryStore::Clock::now();
+    IdSet candidate_ids;
+    for (auto const& [instance_id, instance] : store.instances) {
+        candidate_ids.insert(instance.task_id);
+    }
+    IdSet existing_ids;
+    for (ScheduleTaskMetadata const& task : *tasks) {
+        existing_ids.insert(task.get_id());
+    }
+    for (boost::uuids::uuid const& task_id : candidate_ids) {
+        MemoryStore::TaskEntry const& task = store.tasks.at(task_id);
+        if (TaskState::Running != task.state || task.timeout <= cMinTimeout
+            || existing_ids.contains(task_id))
+        {
+            continue;
+        }
+        if (std::ranges::all_of(task.instance_ids, [&](boost::uuids::uuid const& id) {
+                return now - store.instances.at(id).start_time > to_milliseconds(task.timeout);
+            }))
+        {
+            tasks->push_back(build_schedule_metadata(store, task_id, task));
+        }
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_child_tasks(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        std::vector<Task>* children
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.tasks.find(id);
+    if (it == store.tasks.end()) {
+        return StorageErr{};
+    }
+    for (boost::uuids::uuid const& child_id : it->second.children) {
+        children->push_back(build_task(child_id, store.tasks.at(child_id)));
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_parent_tasks(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        std::vector<Task>* tasks
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.tasks.find(id);
+    if (it == store.tasks.end()) {
+        return StorageErr{};
+    }
+    for (boost::uuids::uuid const& parent_id : it->second.parents) {
+        tasks->push_back(build_task(parent_id, store.tasks.at(parent_id)));
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::update_heartbeat(StorageConnection& conn, boost::uuids::uuid id)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    auto const it = store.drivers.find(id);
+    if (it != store.drivers.end()) {
+        it->second = store.get_record_time();
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::heartbeat_timeout(
+        StorageConnection& conn,
+        double timeout,
+        std::vector<boost::uuids::uuid>* ids
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    MemoryStore::Clock::time_point const now = MemoryStore::Clock::now();
+    for (auto const& [id, heartbeat] : store.drivers) {
+        if (now - heartbeat > to_milliseconds(timeout)) {
+            ids->push_back(id);
+        }
+    }
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::find_dead_worker_instances(MemoryStore const& store, double timeout)
+        -> std::vector<boost::uuids::uuid> {
+    MemoryStore::Clock::time_point const now = MemoryStore::Clock::now();
+    std::vector<boost::uuids::uuid> instance_ids;
+    for (auto const& [instance_id, instance] : store.instances) {
+        if (false == instance.worker_id.has_value()) {
+            continue;
+        }
+        auto const driver_it = store.drivers.find(instance.worker_id.value());
+        if (driver_it == store.drivers.end() || now - driver_it->second > to_milliseconds(timeout))
+        {
+            instance_ids.push_back(instance_id);
+        }
+    }
+    return instance_ids;
+}
+
+auto MemoryMetadataStorage::recover_task_instances(
+        MemoryStore& store,
+        std::vector<boost::uuids::uuid> const& instance_ids,
+        std::vector<boost::uuids::uuid>* task_ids
+) -> void {
+    task_ids->clear();
+    std::vector<boost::uuids::uuid> candidate_ids;
+    IdSet seen_ids;
+    for (boost::uuids::uuid const& instance_id : instance_ids) {
+        auto const it = store.instances.find(instance_id);
+        if (it == store.instances.end()) {
+            continue;
+        }
+        boost::uuids::uuid const task_id = it->second.task_id;
+        if (seen_ids.insert(task_id).second) {
+            candidate_ids.push_back(task_id);
+        }
+        auto const task_it = store.tasks.find(task_id);
+        if (task_it != store.tasks.end()) {
+            std::erase(task_it->second.instance_ids, instance_id);
+        }
+        store.instances.erase(it);
+    }
+
+    for (boost::uuids::uuid const& task_id : candidate_ids) {
+        auto const task_it = store.tasks.find(task_id);
+        if (task_it == store.tasks.end()) {
+            continue;
+        }
+        MemoryStore::TaskEntry& task = task_it->second;
+        if (TaskState::Running == task.state && task.instance_ids.empty()) {
+            set_state(store, task_id, task, TaskState::Ready);
+            task_ids->push_back(task_id);
+        }
+    }
+}
+
+auto MemoryMetadataStorage::recover_dead_worker_tasks(
+        StorageConnection& conn,
+        double timeout,
+        std::vector<boost::uuids::uuid>* task_ids
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::unique_lock const lock{store.metadata_mutex};
+    recover_task_instances(store, find_dead_worker_instances(store, timeout), task_ids);
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::remove_task_instances(
+        StorageConnection& conn,
+        std::vector<TaskInstance> const& instances,
+        std::vector<boost::uuids::uuid>* task_ids
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::vector<boost::uuids::uuid> instance_ids;
+    instance_ids.reserve(instances.size());
+    for (TaskInstance const& instance : instances) {
+        instance_ids.push_back(instance.id);
+    }
+    std::unique_lock const lock{store.metadata_mutex};
+    recover_task_instances(store, instance_ids, task_ids);
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::remove_stale_submitting_jobs(
+        StorageConnection& /*conn*/,
+        double /*timeout*/
+) -> StorageErr {
+    // Jobs are inserted at once, so no job is left partly submitted
+    return StorageErr{};
+}
+
+auto MemoryMetadataStorage::get_scheduler_addr(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        std::string* addr,
+        int* port
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    auto const it = store.schedulers.find(id);
+    if (it == store.schedulers.end()) {
+        return StorageErr{
+                StorageErrType::KeyNotFoundErr,
+                fmt::format("no scheduler with id {}", boost::uuids::to_string(id))
+        };
+    }
+    *addr = it->second.addr;
+    *port = it->second.port;
+    return StorageErr{};
+}
+
+auto MemoryDataStorage::initialize(StorageConnection& /*conn*/) -> StorageErr {
+    return StorageErr{};
+}
+
+namespace {
+auto build_data_entry(Data const& data) -> MemoryStore::DataEntry {
+    MemoryStore::DataEntry entry;
+    entry.value = data.get_value();
+    entry.hard_locality = data.is_hard_locality();
+    entry.locality = data.get_locality();
+    return entry;
+}
+
+auto build_data(boost::uuids::uuid const id, MemoryStore::DataEntry const& entry) -> Data {
+    Data data{id, entry.value};
+    data.set_hard_locality(entry.hard_locality);
+    if (false == entry.locality.empty()) {
+        data.set_locality(entry.locality);
+    }
+    return data;
+}
+
+auto no_data_error(boost::uuids::uuid const id) -> StorageErr {
+    return StorageErr{
+            StorageErrType::KeyNotFoundErr,
+            fmt::format("no data with id {}", boost::uuids::to_string(id))
+    };
+}
+
+/**
+ * Adds a data entry referenced by a task or driver. Must be called with the metadata lock held.
+ *
+ * @param store
+ * @param refs_map The reverse index of the references of the tasks or drivers.
+ * @param data
+ * @param owner_id
+ * @param get_refs Returns the references of a data entry to add `owner_id` to.
+ * @return StorageErr::Success if the data is added.
+ * @return StorageErrType::DuplicateKeyErr if the data id is already used.
+ */
+template <class GetRefs>
+auto add_owned_data(
+        MemoryStore& store,
+        StripedHashMap<boost::uuids::uuid, IdSet>& refs_map,
+        Data const& data,
+        boost::uuids::uuid const owner_id,
+        GetRefs get_refs
+) -> StorageErr {
+    boost::uuids::uuid const data_id = data.get_id();
+    bool const inserted = store.data.write(data_id, [&](auto& data_map) {
+        auto const [it, emplaced] = data_map.try_emplace(data_id, build_data_entry(data));
+        if (false == emplaced) {
+            return false;
+        }
+        get_refs(it->second).insert(owner_id);
+        refs_map.write(owner_id, [&](auto& owner_map) { owner_map[owner_id].insert(data_id); });
+        return true;
+    });
+    if (false == inserted) {
+        return StorageErr{
+                StorageErrType::DuplicateKeyErr,
+                fmt::format("data with id {} exists", boost::uuids::to_string(data_id))
+        };
+    }
+    return StorageErr{};
+}
+
+/**
+ * Adds a reference from a task or driver to a data entry, and copies the data out if `data` is not
+ * null. Must be called with the metadata lock held.
+ *
+ * @return StorageErr::Success if the reference is added.
+ * @return StorageErrType::KeyNotFoundErr if the data does not exist.
+ */
+template <class GetRefs>
+auto add_data_reference(
+        MemoryStore& store,
+        StripedHashMap<boost::uuids::uuid, IdSet>& refs_map,
+        boost::uuids::uuid const data_id,
+        boost::uuids::uuid const owner_id,
+        GetRefs get_refs,
+        Data* data
+) -> StorageErr {
+    bool const found = store.data.write(data_id, [&](auto& data_map) {
+        auto const it = data_map.find(data_id);
+        if (it == data_map.end()) {
+            return false;
+        }
+        get_refs(it->second).insert(owner_id);
+        refs_map.write(owner_id, [&](auto& owner_map) { owner_map[owner_id].insert(data_id); });
+        if (nullptr != data) {
+            *data = build_data(data_id, it->second);
+        }
+        return true;
+    });
+    return found ? StorageErr{} : no_data_error(data_id);
+}
+
+template <class GetRefs>
+auto remove_data_reference(
+        MemoryStore& store,
+        StripedHashMap<boost::uuids::uuid, IdSet>& refs_map,
+        boost::uuids::uuid const data_id,
+        boost::uuids::uuid const owner_id,
+        GetRefs get_refs
+) -> void {
+    store.data.write(data_id, [&](auto& data_map) {
+        auto const it = data_map.find(data_id);
+        if (it != data_map.end()) {
+            get_refs(it->second).erase(owner_id);
+        }
+        refs_map.write(owner_id, [&](auto& owner_map) {
+            auto const owner_it = owner_map.find(owner_id);
+            if (owner_it == owner_map.end()) {
+                return;
+            }
+            owner_it->second.erase(data_id);
+            if (owner_it->second.empty()) {
+                owner_map.erase(owner_it);
+            }
+        });
+    });
+}
+
+auto task_refs(MemoryStore::DataEntry& entry) -> IdSet& {
+    return entry.task_refs;
+}
+
+auto driver_refs(MemoryStore::DataEntry& entry) -> IdSet& {
+    return entry.driver_refs;
+}
+
+auto no_owner_error(std::string_view const owner, boost::uuids::uuid const id) -> StorageErr {
+    return StorageErr{
+            StorageErrType::KeyNotFoundErr,
+            fmt::format("no {} with id {}", owner, boost::uuids::to_string(id))
+    };
+}
+}  // namespace
+
+auto MemoryDataStorage::add_driver_data(
+        StorageConnection& conn,
+        boost::uuids::uuid driver_id,
+        Data const& data
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    if (false == store.drivers.contains(driver_id)) {
+        return no_owner_error("driver", driver_id);
+    }
+    return add_owned_data(store, store.driver_data_refs, data, driver_id, driver_refs);
+}
+
+auto MemoryDataStorage::add_task_data(
+        StorageConnection& conn,
+        boost::uuids::uuid task_id,
+        Data const& data
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    if (false == store.tasks.contains(task_id)) {
+        return no_owner_error("task", task_id);
+    }
+    return add_owned_data(store, store.task_data_refs, data, task_id, task_refs);
+}
+
+auto MemoryDataStorage::get_data(StorageConnection& conn, boost::uuids::uuid id, Data* data)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    bool const found = store.data.read(id, [&](auto const& data_map) {
+        auto const it = data_map.find(id);
+        if (it == data_map.end()) {
+            return false;
+        }
+        *data = build_data(id, it->second);
+        return true;
+    });
+    return found ? StorageErr{} : no_data_error(id);
+}
+
+auto MemoryDataStorage::get_driver_data(
+        StorageConnection& conn,
+        boost::uuids::uuid driver_id,
+        boost::uuids::uuid data_id,
+        Data* data
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    if (false == store.drivers.contains(driver_id)) {
+        return no_owner_error("driver", driver_id);
+    }
+    return add_data_reference(
+            store,
+            store.driver_data_refs,
+            data_id,
+            driver_id,
+            driver_refs,
+            data
+    );
+}
+
+auto MemoryDataStorage::get_task_data(
+        StorageConnection& conn,
+        boost::uuids::uuid task_id,
+        boost::uuids::uuid data_id,
+        Data* data
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    if (false == store.tasks.contains(task_id)) {
+        return no_owner_error("task", task_id);
+    }
+    return add_data_reference(store, store.task_data_refs, data_id, task_id, task_refs, data);
+}
+
+auto MemoryDataStorage::set_data_locality(StorageConnection& conn, Data const& data)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    bool const found = store.data.write(data.get_id(), [&](auto& data_map) {
+        auto const it = data_map.find(data.get_id());
+        if (it == data_map.end()) {
+            return false;
+        }
+        it->second.locality = data.get_locality();
+        it->second.hard_locality = data.is_hard_locality();
+        return true;
+    });
+    return found ? StorageErr{} : no_data_error(data.get_id());
+}
+
+auto MemoryDataStorage::remove_data(StorageConnection& conn, boost::uuids::uuid id)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    store.data.write(id, [&](auto& data_map) {
+        auto const it = data_map.find(id);
+        if (it == data_map.end()) {
+            return;
+        }
+        for (boost::uuids::uuid const& task_id : it->second.task_refs) {
+            store.task_data_refs.write(task_id, [&](auto& refs_map) {
+                auto const refs_it = refs_map.find(task_id);
+                if (refs_it != refs_map.end()) {
+                    refs_it->second.erase(id);
+                }
+            });
+        }
+        for (boost::uuids::uuid const& driver_id : it->second.driver_refs) {
+            store.driver_data_refs.write(driver_id, [&](auto& refs_map) {
+                auto const refs_it = refs_map.find(driver_id);
+                if (refs_it != refs_map.end()) {
+                    refs_it->second.erase(id);
+                }
+            });
+        }
+        data_map.erase(it);
+    });
+    return StorageErr{};
+}
+
+auto MemoryDataStorage::add_task_reference(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        boost::uuids::uuid task_id
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    if (false == store.tasks.contains(task_id)) {
+        return no_owner_error("task", task_id);
+    }
+    return add_data_reference(store, store.task_data_refs, id, task_id, task_refs, nullptr);
+}
+
+auto MemoryDataStorage::remove_task_reference(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        boost::uuids::uuid task_id
+) noexcept -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    remove_data_reference(store, store.task_data_refs, id, task_id, task_refs);
+    return StorageErr{};
+}
+
+auto MemoryDataStorage::add_driver_reference(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        boost::uuids::uuid driver_id
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    if (false == store.drivers.contains(driver_id)) {
+        return no_owner_error("driver", driver_id);
+    }
+    return add_data_reference(store, store.driver_data_refs, id, driver_id, driver_refs, nullptr);
+}
+
+auto MemoryDataStorage::remove_driver_reference(
+        StorageConnection& conn,
+        boost::uuids::uuid id,
+        boost::uuids::uuid driver_id
+) noexcept -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    remove_data_reference(store, store.driver_data_refs, id, driver_id, driver_refs);
+    return StorageErr{};
+}
+
+auto MemoryDataStorage::remove_dangling_data(StorageConnection& conn) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    store.data.write_all([](auto& data_map) {
+        for (auto it = data_map.begin(); it != data_map.end();) {
+            if (it->second.task_refs.empty() && it->second.driver_refs.empty()) {
+                data_map.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    });
+    return StorageErr{};
+}
+
+auto MemoryDataStorage::add_client_kv_data(StorageConnection& conn, KeyValueData const& data)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    boost::uuids::uuid const& client_id = data.get_id();
+    bool const inserted = store.client_kv_data.write(client_id, [&](auto& kv_map) {
+        return kv_map[client_id].try_emplace(data.get_key(), data.get_value()).second;
+    });
+    if (false == inserted) {
+        return StorageErr{
+                StorageErrType::DuplicateKeyErr,
+                fmt::format(
+                        "data for client {} with key {} exists",
+                        boost::uuids::to_string(client_id),
+                        data.get_key()
+                )
+        };
+    }
+    return StorageErr{};
+}
+
+auto MemoryDataStorage::add_task_kv_data(StorageConnection& conn, KeyValueData const& data)
+        -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    std::shared_lock const lock{store.metadata_mutex};
+    boost::uuids::uuid const& task_id = data.get_id();
+    if (false == store.tasks.contains(task_id)) {
+        return no_owner_error("task", task_id);
+    }
+    bool const inserted = store.task_kv_data.write(task_id, [&](auto& kv_map) {
+        return kv_map[task_id].try_emplace(data.get_key(), data.get_value()).second;
+    });
+    if (false == inserted) {
+        return StorageErr{
+                StorageErrType::DuplicateKeyErr,
+                fmt::format(
+                        "data for task {} with key {} exists",
+                        boost::uuids::to_string(task_id),
+                        data.get_key()
+                )
+        };
+    }
+    return StorageErr{};
+}
+
+auto MemoryDataStorage::get_client_kv_data(
+        StorageConnection& conn,
+        boost::uuids::uuid const& client_id,
+        std::string const& key,
+        std::string* value
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    bool const found = store.client_kv_data.read(client_id, [&](auto const& kv_map) {
+        auto const it = kv_map.find(client_id);
+        if (it == kv_map.end()) {
+            return false;
+        }
+        auto const value_it = it->second.find(key);
+        if (value_it == it->second.end()) {
+            return false;
+        }
+        *value = value_it->second;
+        return true;
+    });
+    if (false == found) {
+        return StorageErr{
+                StorageErrType::KeyNotFoundErr,
+                fmt::format(
+                        "no data for client {} with key {}",
+                        boost::uuids::to_string(client_id),
+                        key
+                )
+        };
+    }
+    return StorageErr{};
+}
+
+auto MemoryDataStorage::get_task_kv_data(
+        StorageConnection& conn,
+        boost::uuids::uuid const& task_id,
+        std::string const& key,
+        std::string* value
+) -> StorageErr {
+    MemoryStore& store = get_store(conn);
+    bool const found = store.task_kv_data.read(task_id, [&](auto const& kv_map) {
+        auto const it = kv_map.find(task_id);
+        if (it == kv_map.end()) {
+            return false;
+        }
+        auto const value_it = it->second.find(key);
+        if (value_it == it->second.end()) {
+            return false;
+        }
+        *value = value_it->second;
+        return true;
+    });
+    if (false == found) {
+        return StorageErr{
+                StorageErrType::KeyNotFoundErr,
+                fmt::format(
+                        "no data for task {} with key {}",
+                        boost::uuids::to_string(task_id),
+                        key
+                )
+        };
+    }
+    return StorageErr{};
+}
+}  // namespace spider::core
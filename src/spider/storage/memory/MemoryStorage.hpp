@@ -0,0 +1,322 @@
+#ifndef SPIDER_STORAGE_MEMORYSTORAGE_HPP
+#define SPIDER_STORAGE_MEMORYSTORAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/Data.hpp>
+#include <spider/core/Driver.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/core/JobMetadata.hpp>
+#include <spider/core/KeyValueData.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/core/TaskGraph.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/JobSubmissionBatch.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+// Forward declaration for friend class
+class MemoryStorageFactory;
+class MemoryJobSubmissionBatch;
+
+// Metadata storage kept in the `MemoryStore` of the connection, with the same semantics as
+// `MySqlMetadataStorage`.
+class MemoryMetadataStorage : public MetadataStorage {
+public:
+    MemoryMetadataStorage(MemoryMetadataStorage const&) = default;
+    MemoryMetadataStorage(MemoryMetadataStorage&&) = default;
+    auto operator=(MemoryMetadataStorage const&) -> MemoryMetadataStorage& = default;
+    auto operator=(MemoryMetadataStorage&&) -> MemoryMetadataStorage& = default;
+    ~MemoryMetadataStorage() override = default;
+    auto initialize(StorageConnection& conn) -> StorageErr override;
+    auto add_driver(StorageConnection& conn, Driver const& driver) -> StorageErr override;
+    auto add_scheduler(StorageConnection& conn, Scheduler const& scheduler) -> StorageErr override;
+    auto remove_driver(StorageConnection& conn, boost::uuids::uuid id) noexcept
+            -> StorageErr override;
+    auto get_active_scheduler(StorageConnection& conn, std::vector<Scheduler>* schedulers)
+            -> StorageErr override;
+    using MetadataStorage::add_job;
+    auto add_job(
+            StorageConnection& conn,
+            boost::uuids::uuid job_id,
+            boost::uuids::uuid client_id,
+            TaskGraph const& task_graph,
+            std::int32_t priority
+    ) -> StorageErr override;
+    using MetadataStorage::add_job_batch;
+    auto add_job_batch(
+            StorageConnection& conn,
+            JobSubmissionBatch& batch,
+            boost::uuids::uuid job_id,
+            boost::uuids::uuid client_id,
+            TaskGraph const& task_graph,
+            std::int32_t priority
+    ) -> StorageErr override;
+    auto get_job_metadata(StorageConnection& conn, boost::uuids::uuid id, JobMetadata* job)
+            -> StorageErr override;
+    auto get_job_complete(StorageConnection& conn, boost::uuids::uuid id, bool* complete)
+            -> StorageErr override;
+    auto get_job_status(StorageConnection& conn, boost::uuids::uuid id, JobStatus* status)
+            -> StorageErr override;
+    auto get_job_output_tasks(
+            StorageConnection& conn,
+            boost::uuids::uuid id,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> StorageErr override;
+    auto get_task_graph(StorageConnection& conn, boost::uuids::uuid id, TaskGraph* task_graph)
+            -> StorageErr override;
+    auto get_jobs_by_client_id(
+            StorageConnection& conn,
+            boost::uuids::uuid client_id,
+            std::vector<boost::uuids::uuid>* job_ids
+    ) -> StorageErr override;
+    auto remove_job(StorageConnection& conn, boost::uuids::uuid id) noexcept -> StorageErr override;
+    auto reset_job(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr override;
+    auto get_task(StorageConnection& conn, boost::uuids::uuid id, Task* task)
+            -> StorageErr override;
+    auto get_task_job_id(StorageConnection& conn, boost::uuids::uuid id, boost::uuids::uuid* job_id)
+            -> StorageErr override;
+    using MetadataStorage::get_ready_tasks;
+    auto get_ready_tasks(
+            StorageConnection& conn,
+            boost::uuids::uuid scheduler_id,
+            std::optional<boost::uuids::uuid> const& client_id,
+            std::optional<boost::uuids::uuid> const& after_task_id,
+            std::size_t max_num_tasks,
+            std::vector<ScheduleTaskMetadata>* tasks
+    ) -> StorageErr override;
+    auto get_ready_clients(StorageConnection& conn, std::vector<boost::uuids::uuid>* ids)
+            -> StorageErr override;
+    auto set_task_state(StorageConnection& conn, boost::uuids::uuid id, TaskState state)
+            -> StorageErr override;
+    auto set_task_running(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr override;
+    auto add_task_instance(StorageConnection& conn, TaskInstance const& instance)
+            -> StorageErr override;
+    auto create_task_instance(StorageConnection& conn, TaskInstance const& instance)
+            -> StorageErr override;
+    auto create_task_instances(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<TaskInstance>* created
+    ) -> StorageErr override;
+    auto start_task_instances(
+            StorageConnection& conn,
+            boost::uuids::uuid worker_id,
+            std::vector<TaskInstance> const& instances,
+            std::vector<TaskInstance>* created,
+            std::vector<Task>* tasks
+    ) -> StorageErr override;
+    auto task_finish(
+            StorageConnection& conn,
+            TaskInstance const& instance,
+            std::vector<TaskOutput> const& outputs
+    ) -> StorageErr override;
+    auto task_finish_batch(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<std::vector<TaskOutput>> const& outputs
+    ) -> StorageErr override;
+    auto task_fail(StorageConnection& conn, TaskInstance const& instance, std::string const& error)
+            -> StorageErr override;
+    auto get_task_timeout(StorageConnection& conn, std::vector<ScheduleTaskMetadata>* tasks)
+            -> StorageErr override;
+    auto
+    get_child_tasks(StorageConnection& conn, boost::uuids::uuid id, std::vector<Task>* children)
+            -> StorageErr override;
+    auto get_parent_tasks(StorageConnection& conn, boost::uuids::uuid id, std::vector<Task>* tasks)
+            -> StorageErr override;
+    auto update_heartbeat(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr override;
+    auto
+    heartbeat_timeout(StorageConnection& conn, double timeout, std::vector<boost::uuids::uuid>* ids)
+            -> StorageErr override;
+    auto recover_dead_worker_tasks(
+            StorageConnection& conn,
+            double timeout,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> StorageErr override;
+    auto remove_task_instances(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> StorageErr override;
+    auto remove_stale_submitting_jobs(StorageConnection& conn, double timeout)
+            -> StorageErr override;
+    auto
+    get_scheduler_addr(StorageConnection& conn, boost::uuids::uuid id, std::string* addr, int* port)
+            -> StorageErr override;
+
+protected:
+    MemoryMetadataStorage() = default;
+
+    /**
+     * Builds a job and its tasks from a task graph without touching the store. Like the MySQL
+     * storage, only the tasks reachable from the input tasks are added.
+     *
+     * @param job_id
+     * @param client_id
+     * @param task_graph
+     * @param priority
+     * @return The staged job on success.
+     * @return StorageErrType::KeyNotFoundErr if an input task is not in the graph.
+     * @return StorageErrType::OtherErr if the graph references a task that is not added.
+     */
+    [[nodiscard]] static auto stage_job(
+            boost::uuids::uuid job_id,
+            boost::uuids::uuid client_id,
+            TaskGraph const& task_graph,
+            std::int32_t priority
+    ) -> std::variant<MemoryStore::StagedJob, StorageErr>;
+
+    /**
+     * Inserts staged jobs into the store, either all of them or none.
+     *
+     * @param store
+     * @param jobs
+     * @return StorageErr::Success if all jobs are inserted.
+     * @return StorageErrType::DuplicateKeyErr if a job or task id is already used.
+     * @return StorageErrType::OtherErr if a task input references a missing task output or data.
+     */
+    [[nodiscard]] static auto
+    insert_jobs(MemoryStore& store, std::vector<MemoryStore::StagedJob>& jobs) -> StorageErr;
+
+    /**
+     * Creates a task instance. Must be called with the metadata lock held exclusively. No change
+     * is made if an error is returned.
+     *
+     * @param store
+     * @param instance
+     * @param worker_id The worker running the instance, if known.
+     * @return StorageErr::Success if the instance is created. Error types otherwise.
+     */
+    [[nodiscard]] static auto create_task_instance_impl(
+            MemoryStore& store,
+            TaskInstance const& instance,
+            std::optional<boost::uuids::uuid> const& worker_id
+    ) -> StorageErr;
+
+    /**
+     * Accepts the outputs of a task instance unless another instance of the task has finished.
+     * Must be called with the metadata lock held exclusively.
+     *
+     * @param store
+     * @param instance
+     * @param outputs
+     */
+    static auto task_finish_impl(
+            MemoryStore& store,
+            TaskInstance const& instance,
+            std::vector<TaskOutput> const& outputs
+    ) -> void;
+
+    /**
+     * Finds the task instances run by workers that are removed or whose heartbeat timed out. Must
+     * be called with the metadata lock held.
+     *
+     * @param store
+     * @param timeout
+     * @return The ids of the instances.
+     */
+    [[nodiscard]] static auto find_dead_worker_instances(MemoryStore const& store, double timeout)
+            -> std::vector<boost::uuids::uuid>;
+
+    /**
+     * Removes task instances and makes their tasks ready again if no other instance is left. Must
+     * be called with the metadata lock held exclusively.
+     *
+     * @param store
+     * @param instance_ids
+     * @param task_ids Replaced with the ids of the tasks made ready.
+     */
+    static auto recover_task_instances(
+            MemoryStore& store,
+            std::vector<boost::uuids::uuid> const& instance_ids,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> void;
+
+    friend class MemoryStorageFactory;
+    friend class MemoryJobSubmissionBatch;
+};
+
+// Data storage kept in the `MemoryStore` of the connection, with the same semantics as
+// `MySqlDataStorage`.
+class MemoryDataStorage : public DataStorage {
+public:
+    MemoryDataStorage(MemoryDataStorage const&) = default;
+    MemoryDataStorage(MemoryDataStorage&&) = default;
+    auto operator=(MemoryDataStorage const&) -> MemoryDataStorage& = default;
+    auto operator=(MemoryDataStorage&&) -> MemoryDataStorage& = default;
+    ~MemoryDataStorage() override = default;
+    auto initialize(StorageConnection& conn) -> StorageErr override;
+    auto add_driver_data(StorageConnection& conn, boost::uuids::uuid driver_id, Data const& data)
+            -> StorageErr override;
+    auto add_task_data(StorageConnection& conn, boost::uuids::uuid task_id, Data const& data)
+            -> StorageErr override;
+    auto get_data(StorageConnection& conn, boost::uuids::uuid id, Data* data)
+            -> StorageErr override;
+    auto get_driver_data(
+            StorageConnection& conn,
+            boost::uuids::uuid driver_id,
+            boost::uuids::uuid data_id,
+            Data* data
+    ) -> StorageErr override;
+    auto get_task_data(
+            StorageConnection& conn,
+            boost::uuids::uuid task_id,
+            boost::uuids::uuid data_id,
+            Data* data
+    ) -> StorageErr override;
+    auto set_data_locality(StorageConnection& conn, Data const& data) -> StorageErr override;
+    auto remove_data(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr override;
+    auto
+    add_task_reference(StorageConnection& conn, boost::uuids::uuid id, boost::uuids::uuid task_id)
+            -> StorageErr override;
+    auto remove_task_reference(
+            StorageConnection& conn,
+            boost::uuids::uuid id,
+            boost::uuids::uuid task_id
+    ) noexcept -> StorageErr override;
+    auto add_driver_reference(
+            StorageConnection& conn,
+            boost::uuids::uuid id,
+            boost::uuids::uuid driver_id
+    ) -> StorageErr override;
+    auto remove_driver_reference(
+            StorageConnection& conn,
+            boost::uuids::uuid id,
+            boost::uuids::uuid driver_id
+    ) noexcept -> StorageErr override;
+    auto remove_dangling_data(StorageConnection& conn) -> StorageErr override;
+
+    auto add_client_kv_data(StorageConnection& conn, KeyValueData const& data)
+            -> StorageErr override;
+    auto add_task_kv_data(StorageConnection& conn, KeyValueData const& data) -> StorageErr override;
+    auto get_client_kv_data(
+            StorageConnection& conn,
+            boost::uuids::uuid const& client_id,
+            std::string const& key,
+            std::string* value
+    ) -> StorageErr override;
+    auto get_task_kv_data(
+            StorageConnection& conn,
+            boost::uuids::uuid const& task_id,
+            std::string const& key,
+            std::string* value
+    ) -> StorageErr override;
+
+protected:
+    MemoryDataStorage() = default;
+
+    friend class MemoryStorageFactory;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_MEMORYSTORAGE_HPP
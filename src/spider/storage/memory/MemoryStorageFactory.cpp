@@ -0,0 +1,45 @@
+#include "MemoryStorageFactory.hpp"
+
+#include <memory>
+#include <string>
+#include <variant>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/JobSubmissionBatch.hpp>
+#include <spider/storage/memory/MemoryConnection.hpp>
+#include <spider/storage/memory/MemoryJobSubmissionBatch.hpp>
+#include <spider/storage/memory/MemoryStorage.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+
+namespace spider::core {
+MemoryStorageFactory::MemoryStorageFactory(std::string const& url)
+        : m_store{MemoryStore::get(
+                  url.starts_with(cUrlScheme) ? url.substr(cUrlScheme.size()) : url
+          )} {}
+
+auto MemoryStorageFactory::provide_data_storage() -> std::unique_ptr<DataStorage> {
+    return std::unique_ptr<DataStorage>(new MemoryDataStorage());
+}
+
+auto MemoryStorageFactory::provide_metadata_storage() -> std::unique_ptr<MetadataStorage> {
+    return std::unique_ptr<MetadataStorage>(new MemoryMetadataStorage());
+}
+
+auto MemoryStorageFactory::provide_storage_connection()
+        -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> {
+    return std::unique_ptr<StorageConnection>(new MemoryConnection{m_store});
+}
+
+auto MemoryStorageFactory::create_storage_connection()
+        -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> {
+    return std::unique_ptr<StorageConnection>(new MemoryConnection{m_store});
+}
+
+auto MemoryStorageFactory::provide_job_submission_batch(StorageConnection& /*conn*/)
+        -> std::unique_ptr<JobSubmissionBatch> {
+    return std::unique_ptr<JobSubmissionBatch>(new MemoryJobSubmissionBatch());
+}
+}  // namespace spider::core
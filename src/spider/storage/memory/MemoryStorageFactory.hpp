@@ -0,0 +1,47 @@
+#ifndef SPIDER_STORAGE_MEMORYSTORAGEFACTORY_HPP
+#define SPIDER_STORAGE_MEMORYSTORAGEFACTORY_HPP
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/JobSubmissionBatch.hpp>
+#include <spider/storage/memory/MemoryStore.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageFactory.hpp>
+
+namespace spider::core {
+/**
+ * Factory of storages kept in memory, for tests and for embedding a scheduler, workers and clients
+ * in one process with `embedded::EmbeddedHost`. Factories created with the same `memory://<name>`
+ * URL in a process share the same store. The store is not visible to other processes, so the
+ * scheduler, worker and task executor binaries reject `memory://` URLs.
+ */
+class MemoryStorageFactory : public StorageFactory {
+public:
+    static constexpr std::string_view cUrlScheme = "memory://";
+
+    /**
+     * @param url `memory://` followed by the name of the store.
+     */
+    explicit MemoryStorageFactory(std::string const& url);
+
+    auto provide_data_storage() -> std::unique_ptr<DataStorage> override;
+    auto provide_metadata_storage() -> std::unique_ptr<MetadataStorage> override;
+    auto provide_storage_connection()
+            -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> override;
+    auto create_storage_connection()
+            -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> override;
+    auto provide_job_submission_batch(StorageConnection&)
+            -> std::unique_ptr<JobSubmissionBatch> override;
+
+private:
+    std::shared_ptr<MemoryStore> m_store;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_MEMORYSTORAGEFACTORY_HPP
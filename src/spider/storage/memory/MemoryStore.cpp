@@ -0,0 +1,21 @@
+#include "MemoryStore.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <absl/container/flat_hash_map.h>
+
+namespace spider::core {
+auto MemoryStore::get(std::string const& name) -> std::shared_ptr<MemoryStore> {
+    static std::mutex registry_mutex;
+    static absl::flat_hash_map<std::string, std::shared_ptr<MemoryStore>> registry;
+
+    std::lock_guard const lock{registry_mutex};
+    std::shared_ptr<MemoryStore>& store = registry[name];
+    if (nullptr == store) {
+        store = std::make_shared<MemoryStore>();
+    }
+    return store;
+}
+}  // namespace spider::core
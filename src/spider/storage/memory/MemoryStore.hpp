@@ -0,0 +1,167 @@
+#ifndef SPIDER_STORAGE_MEMORYSTORE_HPP
+#define SPIDER_STORAGE_MEMORYSTORE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/core/JobMetadata.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/storage/memory/StripedHashMap.hpp>
+
+namespace spider::core {
+/**
+ * State of an in-memory storage, shared by all connections to the same `memory://` URL in a
+ * process.
+ *
+ * Drivers, schedulers, jobs, tasks, task instances and scheduler leases are guarded by
+ * `metadata_mutex`, since a task state transition touches the parents, children and job of the
+ * task. Data, data references and key-value data live in striped maps. Operations lock
+ * `metadata_mutex` first if they read or change the metadata, shared unless they change it, then
+ * the stripes in the order `data`, then `task_data_refs` or `driver_data_refs`, then the key-value
+ * maps.
+ */
+struct MemoryStore {
+    using Clock = std::chrono::steady_clock;
+
+    struct SchedulerEntry {
+        std::string addr;
+        int port = 0;
+    };
+
+    struct JobEntry {
+        boost::uuids::uuid client_id;
+        std::chrono::system_clock::time_point creation_time;
+        std::int32_t priority = cDefaultJobPriority;
+        JobStatus state = JobStatus::Running;
+        std::uint32_t remaining_tasks = 0;
+        std::vector<boost::uuids::uuid> task_ids;
+        std::vector<std::pair<boost::uuids::uuid, boost::uuids::uuid>> dependencies;
+        std::vector<boost::uuids::uuid> input_tasks;
+        std::vector<boost::uuids::uuid> output_tasks;
+    };
+
+    struct TaskEntry {
+        boost::uuids::uuid job_id;
+        std::string function_name;
+        TaskLanguage language = TaskLanguage::Cpp;
+        TaskState state = TaskState::Pending;
+        float timeout = 0;
+        unsigned int max_retries = 0;
+        unsigned int retry = 0;
+        // Instance whose result was accepted
+        std::optional<boost::uuids::uuid> instance_id;
+        // Number of inputs still waiting for a parent output
+        std::uint32_t remaining_inputs = 0;
+        std::vector<TaskInput> inputs;
+        std::vector<TaskOutput> outputs;
+        // DAG index
+        std::vector<boost::uuids::uuid> parents;
+        std::vector<boost::uuids::uuid> children;
+        // Inputs consuming the outputs of this task, as the consumer task id and input position
+        std::vector<std::pair<boost::uuids::uuid, std::size_t>> consumers;
+        std::vector<boost::uuids::uuid> instance_ids;
+    };
+
+    struct InstanceEntry {
+        boost::uuids::uuid task_id;
+        std::optional<boost::uuids::uuid> worker_id;
+        Clock::time_point start_time;
+    };
+
+    struct LeaseEntry {
+        boost::uuids::uuid scheduler_id;
+        Clock::time_point lease_time;
+    };
+
+    struct DataEntry {
+        std::string value;
+        bool hard_locality = false;
+        std::vector<std::string> locality;
+        absl::flat_hash_set<boost::uuids::uuid> driver_refs;
+        absl::flat_hash_set<boost::uuids::uuid> task_refs;
+    };
+
+    // A job built from a task graph, ready to be inserted with its tasks
+    struct StagedJob {
+        boost::uuids::uuid id;
+        JobEntry job;
+        std::vector<std::pair<boost::uuids::uuid, TaskEntry>> tasks;
+    };
+
+    /**
+     * Orders ready tasks by job priority, highest first, then by job creation time, earliest
+     * first, then by task id.
+     */
+    struct ReadyTaskKey {
+        std::int32_t priority;
+        std::chrono::system_clock::time_point creation_time;
+        boost::uuids::uuid task_id;
+
+        auto operator<(ReadyTaskKey const& other) const -> bool {
+            if (priority != other.priority) {
+                return priority > other.priority;
+            }
+            if (creation_time != other.creation_time) {
+                return creation_time < other.creation_time;
+            }
+            return task_id < other.task_id;
+        }
+    };
+
+    /**
+     * Gets the store of a name, creating it on first use. Stores live until the process exits, like
+     * the database of a storage server outlives its connections.
+     *
+     * @param name
+     * @return The store.
+     */
+    static auto get(std::string const& name) -> std::shared_ptr<MemoryStore>;
+
+    /**
+     * @return The time to record for a heartbeat or a task instance start. While replaying a log,
+     * this is the epoch, as the original time is not known and the drivers and task instances
+     * restored from the log may not be alive anymore.
+     */
+    [[nodiscard]] auto get_record_time() const -> Clock::time_point {
+        return replaying ? Clock::time_point{} : Clock::now();
+    }
+
+    // Whether the operations are replayed from a log when reopening a durable store
+    bool replaying = false;
+
+    std::shared_mutex metadata_mutex;
+    absl::flat_hash_map<boost::uuids::uuid, Clock::time_point> drivers;
+    absl::flat_hash_map<boost::uuids::uuid, SchedulerEntry> schedulers;
+    absl::flat_hash_map<boost::uuids::uuid, JobEntry> jobs;
+    absl::flat_hash_map<boost::uuids::uuid, absl::flat_hash_set<boost::uuids::uuid>> client_jobs;
+    absl::flat_hash_map<boost::uuids::uuid, TaskEntry> tasks;
+    absl::flat_hash_map<boost::uuids::uuid, InstanceEntry> instances;
+    absl::flat_hash_map<boost::uuids::uuid, LeaseEntry> leases;
+    // Ready tasks, including the ones of jobs that are not running
+    std::set<ReadyTaskKey> ready_tasks;
+    // Ready tasks by the client of their job. Clients without ready tasks have no entry.
+    absl::flat_hash_map<boost::uuids::uuid, std::set<ReadyTaskKey>> client_ready_tasks;
+
+    StripedHashMap<boost::uuids::uuid, DataEntry> data;
+    // Reverse index of `DataEntry::task_refs` and `DataEntry::driver_refs`
+    StripedHashMap<boost::uuids::uuid, absl::flat_hash_set<boost::uuids::uuid>> task_data_refs;
+    StripedHashMap<boost::uuids::uuid, absl::flat_hash_set<boost::uuids::uuid>> driver_data_refs;
+    StripedHashMap<boost::uuids::uuid, absl::flat_hash_map<std::string, std::string>>
+            client_kv_data;
+    StripedHashMap<boost::uuids::uuid, absl::flat_hash_map<std::string, std::string>> task_kv_data;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_MEMORYSTORE_HPP
@@ -0,0 +1,89 @@
+#ifndef SPIDER_STORAGE_STRIPEDHASHMAP_HPP
+#define SPIDER_STORAGE_STRIPEDHASHMAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/hash/hash.h>
+
+namespace spider::core {
+/**
+ * A hash map split into stripes, each guarded by its own lock, so that operations on keys in
+ * different stripes run concurrently. A caller holds at most one stripe at a time.
+ */
+template <class Key, class Value, std::size_t NumStripes = 64>
+class StripedHashMap {
+public:
+    using Map = absl::flat_hash_map<Key, Value>;
+
+    /**
+     * Calls `func` with the map of the stripe holding `key`, with the stripe locked exclusively.
+     *
+     * @param key
+     * @param func
+     * @return The result of `func`.
+     */
+    template <class Func>
+    auto write(Key const& key, Func&& func) -> decltype(auto) {
+        Stripe& stripe = get_stripe(key);
+        std::lock_guard const lock{stripe.mutex};
+        return std::forward<Func>(func)(stripe.map);
+    }
+
+    /**
+     * Calls `func` with the map of the stripe holding `key`, with the stripe locked shared.
+     *
+     * @param key
+     * @param func
+     * @return The result of `func`.
+     */
+    template <class Func>
+    auto read(Key const& key, Func&& func) const -> decltype(auto) {
+        Stripe const& stripe = get_stripe(key);
+        std::shared_lock const lock{stripe.mutex};
+        return std::forward<Func>(func)(std::as_const(stripe.map));
+    }
+
+    /**
+     * Calls `func` with the map of every stripe in turn, each locked exclusively.
+     *
+     * @param func
+     */
+    template <class Func>
+    auto write_all(Func&& func) -> void {
+        for (Stripe& stripe : m_stripes) {
+            std::lock_guard const lock{stripe.mutex};
+            func(stripe.map);
+        }
+    }
+
+private:
+    struct Stripe {
+        mutable std::shared_mutex mutex;
+        Map map;
+    };
+
+    // The maps of the stripes probe with the low bits of the hash, so the stripe is picked with
+    // the high bits to keep the keys in a stripe spread over its map.
+    static constexpr int cStripeShift = std::numeric_limits<std::size_t>::digits - 16;
+
+    static auto get_stripe_index(Key const& key) -> std::size_t {
+        return (absl::Hash<Key>{}(key) >> cStripeShift) % NumStripes;
+    }
+
+    auto get_stripe(Key const& key) -> Stripe& { return m_stripes[get_stripe_index(key)]; }
+
+    auto get_stripe(Key const& key) const -> Stripe const& {
+        return m_stripes[get_stripe_index(key)];
+    }
+
+    std::array<Stripe, NumStripes> m_stripes;
+};
+}  // namespace spider::core
+
+#endif  // SPIDER_STORAGE_STRIPEDHASHMAP_HPP
@@ -1,6 +1,8 @@
 #include "MySqlConnection.hpp"
 
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <regex>
 #include <string>
 #include <utility>
@@ -9,7 +11,10 @@
 #include <mariadb/conncpp/Connection.hpp>
 #include <mariadb/conncpp/DriverManager.hpp>
 #include <mariadb/conncpp/Exception.hpp>
+#include <mariadb/conncpp/PreparedStatement.hpp>
 #include <mariadb/conncpp/Properties.hpp>
+#include <mariadb/conncpp/ResultSet.hpp>
+#include <mariadb/conncpp/Statement.hpp>
 #include <spdlog/spdlog.h>
 
 #include <spider/core/Error.hpp>
@@ -35,6 +40,18 @@ auto MySqlConnection::create(std::string const& url)
 }
 
 MySqlConnection::~MySqlConnection() {
+    if (m_lease.has_value() && *m_lease) {
+        // End any transaction left open so the next user does not see its snapshot or locks
+        try {
+            (*this)->rollback();
+        } catch (sql::SQLException& e) {
+            spdlog::warn("Failed to reset pooled connection: {}", e.what());
+            m_lease->discard();
+        }
+        m_lease.reset();
+    }
+    // Close the cached statements before the connection
+    m_statements.set_size(0);
     if (m_connection) {
         try {
             m_connection->close();
@@ -46,10 +63,63 @@ MySqlConnection::~MySqlConnection() {
 }
 
 auto MySqlConnection::operator*() const -> sql::Connection& {
+    if (m_lease.has_value()) {
+        return *static_cast<MySqlConnection&>(**m_lease);
+    }
     return *m_connection;
 }
 
 auto MySqlConnection::operator->() const -> sql::Connection* {
-    return &*m_connection;
+    return &**this;
+}
+
+auto MySqlConnection::is_valid() -> bool {
+    try {
+        return (*this)->isValid();
+    } catch (sql::SQLException&) {
+        return false;
+    }
+}
+auto MySqlConnection::prepare_statement(std::string const& sql) -> CachedStatement {
+    if (m_lease.has_value()) {
+        return static_cast<MySqlConnection&>(**m_lease).prepare_statement(sql);
+    }
+    std::optional<std::unique_ptr<sql::PreparedStatement>> cached = m_statements.take(sql);
+    if (cached.has_value()) {
+        return CachedStatement{cached.value().release(), StatementReleaser{this, sql}};
+    }
+    return CachedStatement{m_connection->prepareStatement(sql), StatementReleaser{this, sql}};
+}
+
+auto MySqlConnection::get_max_allowed_packet() -> std::size_t {
+    if (m_lease.has_value()) {
+        return static_cast<MySqlConnection&>(**m_lease).get_max_allowed_packet();
+    }
+    if (false == m_max_allowed_packet.has_value()) {
+        std::unique_ptr<sql::Statement> const statement{m_connection->createStatement()};
+        std::unique_ptr<sql::ResultSet> const res{
+                statement->executeQuery("SELECT @@max_allowed_packet")
+        };
+        res->next();
+        m_max_allowed_packet = res->getUInt64(1);
+    }
+    return m_max_allowed_packet.value();
+}
+
+auto MySqlConnection::StatementReleaser::operator()(sql::PreparedStatement* statement) const
+        -> void {
+    std::unique_ptr<sql::PreparedStatement> owned_statement{statement};
+    if (nullptr == m_conn || nullptr == owned_statement) {
+        return;
+    }
+    // Drop the parameters and pending batch of this use, so the next use starts clean
+    try {
+        owned_statement->clearParameters();
+        owned_statement->clearBatch();
+    } catch (sql::SQLException& e) {
+        spdlog::warn("Failed to reset prepared statement: {}", e.what());
+        return;
+    }
+    m_conn->m_statements.put(m_sql, std::move(owned_statement));
 }
 }  // namespace spider::core
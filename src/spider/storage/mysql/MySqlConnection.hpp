@@ -1,23 +1,50 @@
 #ifndef SPIDER_STORAGE_MYSQLCONNECTION_HPP
 #define SPIDER_STORAGE_MYSQLCONNECTION_HPP
 
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <variant>
 
 #include <mariadb/conncpp/Connection.hpp>
+#include <mariadb/conncpp/PreparedStatement.hpp>
 
 #include <spider/core/Error.hpp>
 #include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+#include <spider/utils/LruCache.hpp>
 
 namespace spider::core {
 // Forward declaration for friend class
 class MySqlStorageFactory;
 
-// RAII class for MySQL connection
+// RAII class for MySQL connection. A pooled connection wraps a lease of a connection in the pool
+// and returns it to the pool on destruction.
 class MySqlConnection : public StorageConnection {
 public:
+    // Maximum number of idle prepared statements kept by a connection
+    static constexpr std::size_t cStatementCacheSize = 256;
+
+    // Returns a prepared statement to the cache of its connection instead of closing it
+    class StatementReleaser {
+    public:
+        StatementReleaser() = default;
+
+        StatementReleaser(MySqlConnection* conn, std::string sql)
+                : m_conn{conn},
+                  m_sql{std::move(sql)} {}
+
+        auto operator()(sql::PreparedStatement* statement) const -> void;
+
+    private:
+        MySqlConnection* m_conn = nullptr;
+        std::string m_sql;
+    };
+
+    using CachedStatement = std::unique_ptr<sql::PreparedStatement, StatementReleaser>;
+
     // Delete copy constructor and copy assignment operator
     MySqlConnection(MySqlConnection const&) = delete;
     auto operator=(MySqlConnection const&) -> MySqlConnection& = delete;
@@ -30,6 +57,25 @@ public:
     auto operator*() const -> sql::Connection&;
     auto operator->() const -> sql::Connection*;
 
+    [[nodiscard]] auto is_valid() -> bool override;
+
+    /**
+     * Prepares a statement, reusing a statement with the same SQL prepared earlier on this
+     * connection if there is one. The statement is returned to the cache when it is destroyed, so
+     * it must not outlive the connection.
+     *
+     * @param sql
+     * @return The prepared statement.
+     * @throw sql::SQLException if the statement cannot be prepared.
+     */
+    auto prepare_statement(std::string const& sql) -> CachedStatement;
+
+    /**
+     * @return The largest packet the server accepts, queried once per connection.
+     * @throw sql::SQLException if the server variable cannot be read.
+     */
+    auto get_max_allowed_packet() -> std::size_t;
+
 private:
     static auto create(std::string const& url)
             -> std::variant<std::unique_ptr<StorageConnection>, StorageErr>;
@@ -37,7 +83,19 @@ private:
     explicit MySqlConnection(std::unique_ptr<sql::Connection> conn)
             : m_connection{std::move(conn)} {}
 
+    MySqlConnection(std::shared_ptr<StorageConnectionPool> pool, StorageConnectionPool::Lease lease)
+            : m_pool{std::move(pool)},
+              m_lease{std::move(lease)} {}
+
     std::unique_ptr<sql::Connection> m_connection;
+    // Keeps the pool alive until the lease is returned, so must be declared before the lease
+    std::shared_ptr<StorageConnectionPool> m_pool;
+    std::optional<StorageConnectionPool::Lease> m_lease;
+    // Idle prepared statements by SQL. Statements in use are removed until they are released.
+    LruCache<std::string, std::unique_ptr<sql::PreparedStatement>> m_statements{
+            cStatementCacheSize
+    };
+    std::optional<std::size_t> m_max_allowed_packet;
 
     friend class MySqlStorageFactory;
 };
@@ -23,6 +23,12 @@ MySqlJobSubmissionBatch::MySqlJobSubmissionBatch(StorageConnection& conn)
           m_task_input_data_stmt{
                   static_cast<MySqlConnection&>(conn)->prepareStatement(mysql::cInsertTaskInputData)
           },
+          m_task_input_value_data_stmt{static_cast<MySqlConnection&>(conn)->prepareStatement(
+                  mysql::cInsertTaskInputValueData
+          )},
+          m_data_ref_task_stmt{
+                  static_cast<MySqlConnection&>(conn)->prepareStatement(mysql::cInsertDataRefTask)
+          },
           m_task_output_stmt{
                   static_cast<MySqlConnection&>(conn)->prepareStatement(mysql::cInsertTaskOutput)
           },
@@ -42,10 +48,12 @@ auto MySqlJobSubmissionBatch::submit_batch(StorageConnection& conn) -> StorageEr
     try {
         m_job_stmt->executeBatch();
         m_task_stmt->executeBatch();
+        m_data_ref_task_stmt->executeBatch();
         m_task_output_stmt->executeBatch();  // Update task outputs in case of input reference
         m_task_input_output_stmt->executeBatch();
         m_task_input_value_stmt->executeBatch();
         m_task_input_data_stmt->executeBatch();
+        m_task_input_value_data_stmt->executeBatch();
         m_task_dependency_stmt->executeBatch();
         m_input_task_stmt->executeBatch();
         m_output_task_stmt->executeBatch();
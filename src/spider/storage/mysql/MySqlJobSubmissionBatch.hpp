@@ -35,6 +35,12 @@ public:
 
     auto get_task_input_data_stmt() -> sql::PreparedStatement& { return *m_task_input_data_stmt; }
 
+    auto get_task_input_value_data_stmt() -> sql::PreparedStatement& {
+        return *m_task_input_value_data_stmt;
+    }
+
+    auto get_data_ref_task_stmt() -> sql::PreparedStatement& { return *m_data_ref_task_stmt; }
+
     auto get_task_output_stmt() -> sql::PreparedStatement& { return *m_task_output_stmt; }
 
     auto get_task_dependency_stmt() -> sql::PreparedStatement& { return *m_task_dependency_stmt; }
@@ -51,6 +57,8 @@ private:
     std::unique_ptr<sql::PreparedStatement> m_task_input_output_stmt;
     std::unique_ptr<sql::PreparedStatement> m_task_input_value_stmt;
     std::unique_ptr<sql::PreparedStatement> m_task_input_data_stmt;
+    std::unique_ptr<sql::PreparedStatement> m_task_input_value_data_stmt;
+    std::unique_ptr<sql::PreparedStatement> m_data_ref_task_stmt;
     std::unique_ptr<sql::PreparedStatement> m_task_output_stmt;
     std::unique_ptr<sql::PreparedStatement> m_task_dependency_stmt;
     std::unique_ptr<sql::PreparedStatement> m_input_task_stmt;
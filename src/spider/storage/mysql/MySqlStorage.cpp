@@ -2,22 +2,27 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
-#include <deque>
+#include <initializer_list>
 #include <iomanip>
+#include <istream>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
 #include <boost/outcome/std_result.hpp>
+#include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <fmt/format.h>
@@ -146,6 +151,397 @@ auto string_to_task_state(std::string const& state) -> spider::core::TaskState {
     }
     return spider::core::TaskState::Pending;
 }
+
+/**
+ * @param num
+ * @return A comma-separated list of `num` SQL placeholders.
+ */
+auto get_placeholders(std::size_t const num) -> std::string {
+    std::string placeholders;
+    for (std::size_t i = 0; i < num; ++i) {
+        placeholders += (0 == i) ? "?" : ", ?";
+    }
+    return placeholders;
+}
+
+/**
+ * @param task
+ * @return The number of inputs of the task that wait for the output of a parent task.
+ */
+auto count_task_output_inputs(Task const& task) -> std::uint32_t {
+    std::uint32_t count = 0;
+    for (std::uint64_t i = 0; i < task.get_num_inputs(); ++i) {
+        if (task.get_input(i).get_task_output().has_value()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Values larger than the `value` columns are stored as chunks in `data_chunks`
+constexpr std::size_t cMaxInlineDataSize = 999;
+// Kept well below the default `max_allowed_packet` of 16 MiB
+constexpr std::size_t cDataChunkSize = 1024 * 1024;
+
+/**
+ * Reads the chunks of a data value in order, directly into a buffer of the value's size.
+ *
+ * @param conn
+ * @param id_bytes
+ * @param size Size of the value.
+ * @param num_chunks
+ * @param value Output value.
+ * @return Whether the chunks add up to the value.
+ * @throw sql::SQLException
+ */
+auto read_data_chunks(
+        MySqlConnection& conn,
+        sql::bytes* id_bytes,
+        std::size_t const size,
+        std::uint32_t const num_chunks,
+        std::string* value
+) -> bool {
+    MySqlConnection::CachedStatement statement(conn.prepare_statement(
+            "SELECT `value` FROM `data_chunks` WHERE `id` = ? ORDER BY `chunk_index`"
+    ));
+    // Stream the chunks instead of buffering the whole result set
+    statement->setFetchSize(1);
+    statement->setBytes(1, id_bytes);
+    std::unique_ptr<sql::ResultSet> const res(statement->executeQuery());
+    value->resize(size);
+    std::size_t offset = 0;
+    std::uint32_t num_read_chunks = 0;
+    while (res->next()) {
+        std::istream* chunk = res->getBinaryStream(1);
+        chunk->read(value->data() + offset, static_cast<std::streamsize>(size - offset));
+        offset += static_cast<std::size_t>(chunk->gcount());
+        ++num_read_chunks;
+    }
+    return offset == size && num_read_chunks == num_chunks;
+}
+
+/**
+ * Inserts a data with its value, splitting a value larger than the `value` column into chunks.
+ *
+ * @param conn
+ * @param id_bytes
+ * @param value
+ * @param hard_locality
+ * @throw sql::SQLException
+ */
+auto insert_data(
+        MySqlConnection& conn,
+        sql::bytes* id_bytes,
+        std::string const& value,
+        bool const hard_locality
+) -> void {
+    bool const is_chunked = value.size() > cMaxInlineDataSize;
+    std::size_t const num_chunks
+            = is_chunked ? (value.size() + cDataChunkSize - 1) / cDataChunkSize : 0;
+
+    MySqlConnection::CachedStatement statement(conn.prepare_statement(
+            "INSERT INTO `data` (`id`, `value`, `hard_locality`, `size`, `num_chunks`) "
+            "VALUES(?, ?, ?, ?, ?)"
+    ));
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    statement->setBytes(1, id_bytes);
+    statement->setString(2, is_chunked ? std::string{} : value);
+    statement->setBoolean(3, hard_locality);
+    statement->setUInt64(4, value.size());
+    statement->setUInt(5, static_cast<std::uint32_t>(num_chunks));
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    statement->executeUpdate();
+
+    if (false == is_chunked) {
+        return;
+    }
+    MySqlConnection::CachedStatement const chunk_statement(conn.prepare_statement(
+            "INSERT INTO `data_chunks` (`id`, `chunk_index`, `value`) VALUES (?, ?, ?)"
+    ));
+    for (std::size_t i = 0; i < num_chunks; ++i) {
+        std::size_t const offset = i * cDataChunkSize;
+        sql::bytes chunk{value.data() + offset, std::min(cDataChunkSize, value.size() - offset)};
+        chunk_statement->setBytes(1, id_bytes);
+        chunk_statement->setUInt(2, static_cast<std::uint32_t>(i));
+        chunk_statement->setBytes(3, &chunk);
+        chunk_statement->executeUpdate();
+    }
+}
+
+/**
+ * Reads the value of a data.
+ *
+ * @param conn
+ * @param id_bytes
+ * @param value Output value.
+ * @return Whether the data exists with all its chunks.
+ * @throw sql::SQLException
+ */
+auto read_data_value(MySqlConnection& conn, sql::bytes* id_bytes, std::string* value) -> bool {
+    MySqlConnection::CachedStatement statement(conn.prepare_statement(
+            "SELECT `value`, `size`, `num_chunks` FROM `data` WHERE `id` = ?"
+    ));
+    statement->setBytes(1, id_bytes);
+    std::unique_ptr<sql::ResultSet> const res(statement->executeQuery());
+    if (false == res->next()) {
+        return false;
+    }
+    std::uint32_t const num_chunks = res->getUInt(3);
+    if (0 == num_chunks) {
+        *value = get_sql_string(res->getString(1));
+        return true;
+    }
+    return read_data_chunks(conn, id_bytes, res->getUInt64(2), num_chunks, value);
+}
+
+/**
+ * Stores a task value too large for the `value` columns as a data. The caller must add a reference
+ * from the task to the data, so that the data is removed together with the task.
+ *
+ * @param conn
+ * @param value
+ * @return The id of the data.
+ * @throw sql::SQLException
+ */
+auto insert_value_data(MySqlConnection& conn, std::string const& value) -> boost::uuids::uuid {
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const id = gen();
+    sql::bytes id_bytes = uuid_get_bytes(id);
+    insert_data(conn, &id_bytes, value, false);
+    return id;
+}
+
+/**
+ * Stores the task output values too large for the `value` columns as data referenced by the task.
+ *
+ * @param conn
+ * @param task_id_bytes
+ * @param outputs
+ * @return The id of the data holding each output value, or std::nullopt if the value is inline.
+ * @throw sql::SQLException
+ */
+auto insert_output_value_data(
+        MySqlConnection& conn,
+        sql::bytes* task_id_bytes,
+        std::vector<TaskOutput> const& outputs
+) -> std::vector<std::optional<boost::uuids::uuid>> {
+    std::vector<std::optional<boost::uuids::uuid>> value_data_ids(outputs.size());
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+        std::optional<std::string> const& value = outputs[i].get_value();
+        if (false == value.has_value() || value.value().size() <= cMaxInlineDataSize) {
+            continue;
+        }
+        boost::uuids::uuid const id = insert_value_data(conn, value.value());
+        sql::bytes id_bytes = uuid_get_bytes(id);
+        MySqlConnection::CachedStatement const ref_statement(
+                conn.prepare_statement(mysql::cInsertDataRefTask)
+        );
+        ref_statement->setBytes(1, &id_bytes);
+        ref_statement->setBytes(2, task_id_bytes);
+        ref_statement->executeUpdate();
+        value_data_ids[i] = id;
+    }
+    return value_data_ids;
+}
+
+/**
+ * Gets a task value stored either inline or as a data.
+ *
+ * @param conn
+ * @param res
+ * @param value_index Column of the inline value.
+ * @param value_data_index Column of the id of the data holding the value.
+ * @return The value, or std::nullopt if the task input or output has no value.
+ * @throw sql::SQLException if the data holding the value is missing.
+ */
+auto get_task_value(
+        MySqlConnection& conn,
+        std::unique_ptr<sql::ResultSet> const& res,
+        std::int32_t const value_index,
+        std::int32_t const value_data_index
+) -> std::optional<std::string> {
+    if (false == res->isNull(value_index)) {
+        return get_sql_string(res->getString(value_index));
+    }
+    if (res->isNull(value_data_index)) {
+        return std::nullopt;
+    }
+    boost::uuids::uuid const id = read_id(res->getBinaryStream(value_data_index));
+    sql::bytes id_bytes = uuid_get_bytes(id);
+    std::string value;
+    if (false == read_data_value(conn, &id_bytes, &value)) {
+        throw sql::SQLException(
+                fmt::format("missing data {} of task value", boost::uuids::to_string(id))
+        );
+    }
+    return value;
+}
+
+// A parameter of a multi-row insert. `std::monostate` is bound as NULL.
+using SqlValue = std::variant<
+        std::monostate,
+        boost::uuids::uuid,
+        std::string,
+        std::int32_t,
+        std::uint32_t,
+        float>;
+
+// The most placeholders a prepared statement can have
+constexpr std::size_t cMaxNumPlaceholders = 65'535;
+// Room left in a packet for the protocol overhead of a statement
+constexpr std::size_t cPacketOverhead = 1024;
+// Jobs with more tasks are committed in chunks
+constexpr std::size_t cChunkedCommitNumTasks = 10'000;
+
+/**
+ * Inserts rows into a table with multi-row `INSERT` statements, instead of a statement and a round
+ * trip per row. Rows are buffered and sent once the next row would not fit in the server's
+ * `max_allowed_packet` or in the placeholder limit of a statement.
+ */
+class MultiRowInsert {
+public:
+    /**
+     * @param conn
+     * @param insert The statement to insert rows, up to the `VALUES` keyword.
+     * @param num_columns
+     * @param submitting_job_id The job submitted in chunks, if any. After each statement, the job's
+     * `creation_time` is refreshed and the transaction committed, so that the job is not removed as
+     * a stale submission while it is still being inserted.
+     * @throw sql::SQLException if `max_allowed_packet` cannot be read.
+     */
+    MultiRowInsert(
+            MySqlConnection& conn,
+            std::string insert,
+            std::size_t const num_columns,
+            std::optional<boost::uuids::uuid> const& submitting_job_id
+    )
+            : m_conn{&conn},
+              m_insert{std::move(insert)},
+              m_num_columns{num_columns},
+              m_submitting_job_id{submitting_job_id},
+              m_max_size{std::max(conn.get_max_allowed_packet(), 2 * cPacketOverhead)
+                         - cPacketOverhead},
+              m_max_num_rows{cMaxNumPlaceholders / num_columns},
+              m_size{m_insert.size()} {}
+
+    /**
+     * Adds a row, first sending the buffered rows if the row does not fit in their statement.
+     *
+     * @param row The values of all columns, in order.
+     * @throw sql::SQLException
+     */
+    auto add_row(std::initializer_list<SqlValue> const row) -> void {
+        // Values are escaped in the statement sent, which may double their size
+        std::size_t row_size = 4;
+        for (SqlValue const& value : row) {
+            row_size += 2 * get_size(value) + 4;
+        }
+        if (false == m_values.empty()
+            && (m_size + row_size > m_max_size || m_values.size() / m_num_columns == m_max_num_rows
+            ))
+        {
+            flush();
+        }
+        m_values.insert(m_values.end(), row.begin(), row.end());
+        m_size += row_size;
+    }
+
+    /**
+     * Sends the buffered rows.
+     *
+     * @throw sql::SQLException
+     */
+    auto flush() -> void {
+        if (m_values.empty()) {
+            return;
+        }
+        std::size_t const num_rows = m_values.size() / m_num_columns;
+        std::string const row = fmt::format("({})", get_placeholders(m_num_columns));
+        std::string sql = m_insert;
+        sql.reserve(m_insert.size() + num_rows * (row.size() + 2));
+        for (std::size_t i = 0; i < num_rows; ++i) {
+            sql += (0 == i) ? " " : ", ";
+            sql += row;
+        }
+
+        // Statements of different sizes are not reused, so they are not cached
+        std::unique_ptr<sql::PreparedStatement> const statement{(*m_conn)->prepareStatement(sql)};
+        std::vector<sql::bytes> id_bytes;
+        id_bytes.reserve(m_values.size());
+        for (std::size_t i = 0; i < m_values.size(); ++i) {
+            auto const index = static_cast<std::int32_t>(i + 1);
+            SqlValue const& value = m_values[i];
+            if (auto const* id = std::get_if<boost::uuids::uuid>(&value)) {
+                id_bytes.push_back(uuid_get_bytes(*id));
+                statement->setBytes(index, &id_bytes.back());
+            } else if (auto const* str = std::get_if<std::string>(&value)) {
+                statement->setString(index, *str);
+            } else if (auto const* int_value = std::get_if<std::int32_t>(&value)) {
+                statement->setInt(index, *int_value);
+            } else if (auto const* uint_value = std::get_if<std::uint32_t>(&value)) {
+                statement->setUInt(index, *uint_value);
+            } else if (auto const* float_value = std::get_if<float>(&value)) {
+                statement->setFloat(index, *float_value);
+            } else {
+                statement->setNull(index, sql::DataType::BINARY);
+            }
+        }
+        statement->executeUpdate();
+        if (m_submitting_job_id.has_value()) {
+            MySqlConnection::CachedStatement const refresh_statement{m_conn->prepare_statement(
+                    "UPDATE `jobs` SET `creation_time` = CURRENT_TIMESTAMP WHERE `id` = ?"
+            )};
+            sql::bytes job_id_bytes = uuid_get_bytes(m_submitting_job_id.value());
+            refresh_statement->setBytes(1, &job_id_bytes);
+            refresh_statement->executeUpdate();
+            (*m_conn)->commit();
+        }
+        m_values.clear();
+        m_size = m_insert.size();
+    }
+
+private:
+    /**
+     * @param value
+     * @return An upper bound of the size of the value before escaping.
+     */
+    static auto get_size(SqlValue const& value) -> std::size_t {
+        if (auto const* str = std::get_if<std::string>(&value)) {
+            return str->size();
+        }
+        return sizeof(boost::uuids::uuid);
+    }
+
+    MySqlConnection* m_conn;
+    std::string m_insert;
+    std::size_t m_num_columns;
+    std::optional<boost::uuids::uuid> m_submitting_job_id;
+    std::size_t m_max_size;
+    std::size_t m_max_num_rows;
+    std::vector<SqlValue> m_values;
+    // Estimated size of the statement of the buffered rows
+    std::size_t m_size;
+};
+
+/**
+ * Removes a job left partly inserted by a failed submission committed in chunks. The job is hidden
+ * from schedulers, so a failure is only logged.
+ *
+ * @param conn
+ * @param job_id_bytes
+ */
+auto remove_submitting_job(MySqlConnection& conn, sql::bytes* job_id_bytes) -> void {
+    try {
+        MySqlConnection::CachedStatement const statement{conn.prepare_statement(
+                "DELETE FROM `jobs` WHERE `id` = ? AND `state` = 'submitting'"
+        )};
+        statement->setBytes(1, job_id_bytes);
+        statement->executeUpdate();
+        conn->commit();
+    } catch (sql::SQLException& e) {
+        spdlog::warn("Failed to remove partly submitted job: {}", e.what());
+    }
+}
 }  // namespace
 
 // NOLINTBEGIN(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -168,8 +564,8 @@ auto MySqlMetadataStorage::initialize(StorageConnection& conn) -> StorageErr {
 
 auto MySqlMetadataStorage::add_driver(StorageConnection& conn, Driver const& driver) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `drivers` (`id`) VALUES (?)"
                 )
         );
@@ -190,16 +586,16 @@ auto MySqlMetadataStorage::add_driver(StorageConnection& conn, Driver const& dri
 auto MySqlMetadataStorage::add_scheduler(StorageConnection& conn, Scheduler const& scheduler)
         -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> driver_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement driver_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `drivers` (`id`) VALUES (?)"
                 )
         );
         sql::bytes id_bytes = uuid_get_bytes(scheduler.get_id());
         driver_statement->setBytes(1, &id_bytes);
         driver_statement->executeUpdate();
-        std::unique_ptr<sql::PreparedStatement> scheduler_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement scheduler_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `schedulers` (`id`, `address`, `port`) VALUES (?, ?, ?)"
                 )
         );
@@ -248,8 +644,8 @@ auto
 MySqlMetadataStorage::remove_driver(StorageConnection& conn, boost::uuids::uuid const id) noexcept
         -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "DELETE FROM `drivers` WHERE `id` = ?"
                 )
         );
@@ -267,94 +663,138 @@ MySqlMetadataStorage::remove_driver(StorageConnection& conn, boost::uuids::uuid
     return StorageErr{};
 }
 
-auto MySqlMetadataStorage::add_task(
+auto MySqlMetadataStorage::insert_job_tasks(
         MySqlConnection& conn,
-        sql::bytes job_id,
-        Task const& task,
-        std::optional<TaskState> const& state
+        boost::uuids::uuid const job_id,
+        TaskGraph const& task_graph,
+        std::vector<Task const*> const& tasks,
+        bool const commit_chunks
 ) -> boost::outcome_v2::std_checked<void, StorageErrType> {
-    // Add task
-    std::unique_ptr<sql::PreparedStatement> task_statement(
-            conn->prepareStatement(mysql::cInsertTask)
-    );
-    sql::bytes task_id_bytes = uuid_get_bytes(task.get_id());
+    // Tables are filled one after another, so that the rows a foreign key references are inserted
+    // before the rows referencing them, whatever the order of the tasks.
+    std::optional<boost::uuids::uuid> const submitting_job_id
+            = commit_chunks ? std::optional{job_id} : std::nullopt;
     // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
-    task_statement->setBytes(1, &task_id_bytes);
-    task_statement->setBytes(2, &job_id);
-    task_statement->setString(3, task.get_function_name());
-    task_statement->setString(
-            4,
-            YSTDLIB_ERROR_HANDLING_TRYX(task_language_to_string(task.get_language()))
-    );
-    if (state.has_value()) {
-        task_statement->setString(5, task_state_to_string(state.value()));
-    } else {
-        task_statement->setString(5, task_state_to_string(task.get_state()));
-    }
-    task_statement->setFloat(6, task.get_timeout());
-    task_statement->setUInt(7, task.get_max_retries());
-    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
-    task_statement->executeUpdate();
-
-    // Add task inputs
-    for (std::uint64_t i = 0; i < task.get_num_inputs(); ++i) {
-        TaskInput const input = task.get_input(i);
-        std::optional<std::tuple<boost::uuids::uuid, std::uint8_t>> const task_output
-                = input.get_task_output();
-        std::optional<boost::uuids::uuid> const data_id = input.get_data_id();
-        std::optional<std::string> const& value = input.get_value();
-        if (task_output.has_value()) {
-            std::tuple<boost::uuids::uuid, std::uint8_t> const pair = task_output.value();
-            std::unique_ptr<sql::PreparedStatement> input_statement(
-                    conn->prepareStatement(mysql::cInsertTaskInputOutput)
+    std::vector<boost::uuids::uuid> const& input_task_ids = task_graph.get_input_tasks();
+    absl::flat_hash_set<boost::uuids::uuid> const heads{
+            input_task_ids.cbegin(),
+            input_task_ids.cend()
+    };
+    MultiRowInsert task_insert{conn, mysql::cMultiInsertTask, 8, submitting_job_id};
+    for (Task const* task : tasks) {
+        TaskState const state
+                = heads.contains(task->get_id()) ? TaskState::Ready : task->get_state();
+        task_insert.add_row(
+                {task->get_id(),
+                 job_id,
+                 task->get_function_name(),
+                 YSTDLIB_ERROR_HANDLING_TRYX(task_language_to_string(task->get_language())),
+                 task_state_to_string(state),
+                 task->get_timeout(),
+                 static_cast<std::uint32_t>(task->get_max_retries()),
+                 count_task_output_inputs(*task)}
+        );
+    }
+    task_insert.flush();
+
+    MultiRowInsert output_insert{conn, mysql::cMultiInsertTaskOutput, 3, submitting_job_id};
+    for (Task const* task : tasks) {
+        for (std::uint64_t i = 0; i < task->get_num_outputs(); ++i) {
+            output_insert.add_row(
+                    {task->get_id(), static_cast<std::uint32_t>(i), task->get_output(i).get_type()}
             );
-            // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
-            input_statement->setBytes(1, &task_id_bytes);
-            input_statement->setUInt(2, i);
-            input_statement->setString(3, input.get_type());
-            sql::bytes task_output_id = uuid_get_bytes(std::get<0>(pair));
-            input_statement->setBytes(4, &task_output_id);
-            input_statement->setUInt(5, std::get<1>(pair));
-            // NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
-            input_statement->executeUpdate();
-        } else if (data_id.has_value()) {
-            std::unique_ptr<sql::PreparedStatement> input_statement(
-                    conn->prepareStatement(mysql::cInsertTaskInputData)
-            );
-            input_statement->setBytes(1, &task_id_bytes);
-            input_statement->setUInt(2, i);
-            input_statement->setString(3, input.get_type());
-            sql::bytes data_id_bytes = uuid_get_bytes(data_id.value());
-            input_statement->setBytes(4, &data_id_bytes);
-            input_statement->executeUpdate();
-        } else if (value.has_value()) {
-            std::unique_ptr<sql::PreparedStatement> input_statement(
-                    conn->prepareStatement(mysql::cInsertTaskInputValue)
-            );
-            input_statement->setBytes(1, &task_id_bytes);
-            input_statement->setUInt(2, i);
-            input_statement->setString(3, input.get_type());
-            input_statement->setString(4, value.value());
-            input_statement->executeUpdate();
         }
     }
+    output_insert.flush();
+
+    MultiRowInsert input_insert{conn, mysql::cMultiInsertTaskInput, 8, submitting_job_id};
+    MultiRowInsert ref_insert{conn, mysql::cMultiInsertDataRefTask, 2, submitting_job_id};
+    for (Task const* task : tasks) {
+        boost::uuids::uuid const task_id = task->get_id();
+        for (std::uint64_t i = 0; i < task->get_num_inputs(); ++i) {
+            TaskInput const input = task->get_input(i);
+            std::optional<std::tuple<boost::uuids::uuid, std::uint8_t>> const task_output
+                    = input.get_task_output();
+            std::optional<boost::uuids::uuid> const data_id = input.get_data_id();
+            std::optional<std::string> const& value = input.get_value();
+            auto const position = static_cast<std::uint32_t>(i);
+            if (task_output.has_value()) {
+                input_insert.add_row(
+                        {task_id,
+                         position,
+                         input.get_type(),
+                         std::get<0>(task_output.value()),
+                         static_cast<std::uint32_t>(std::get<1>(task_output.value())),
+                         std::monostate{},
+                         std::monostate{},
+                         std::monostate{}}
+                );
+            } else if (data_id.has_value()) {
+                input_insert.add_row(
+                        {task_id,
+                         position,
+                         input.get_type(),
+                         std::monostate{},
+                         std::monostate{},
+                         std::monostate{},
+                         data_id.value(),
+                         std::monostate{}}
+                );
+            } else if (value.has_value() && value.value().size() > cMaxInlineDataSize) {
+                boost::uuids::uuid const value_data_id = insert_value_data(conn, value.value());
+                ref_insert.add_row({value_data_id, task_id});
+                input_insert.add_row(
+                        {task_id,
+                         position,
+                         input.get_type(),
+                         std::monostate{},
+                         std::monostate{},
+                         std::monostate{},
+                         std::monostate{},
+                         value_data_id}
+                );
+            } else if (value.has_value()) {
+                input_insert.add_row(
+                        {task_id,
+                         position,
+                         input.get_type(),
+                         std::monostate{},
+                         std::monostate{},
+                         value.value(),
+                         std::monostate{},
+                         std::monostate{}}
+                );
+            }
+        }
+    }
+    input_insert.flush();
+    ref_insert.flush();
 
-    // Add task outputs
-    for (std::uint64_t i = 0; i < task.get_num_outputs(); i++) {
-        TaskOutput const output = task.get_output(i);
-        std::unique_ptr<sql::PreparedStatement> output_statement(
-                conn->prepareStatement(mysql::cInsertTaskOutput)
-        );
-        output_statement->setBytes(1, &task_id_bytes);
-        output_statement->setUInt(2, i);
-        output_statement->setString(3, output.get_type());
-        output_statement->executeUpdate();
+    MultiRowInsert dependency_insert{conn, mysql::cMultiInsertTaskDependency, 2, submitting_job_id};
+    for (auto const& [parent_id, child_id] : task_graph.get_dependencies()) {
+        dependency_insert.add_row({parent_id, child_id});
     }
+    dependency_insert.flush();
+
+    MultiRowInsert input_task_insert{conn, mysql::cMultiInsertInputTask, 3, submitting_job_id};
+    for (std::size_t i = 0; i < input_task_ids.size(); ++i) {
+        input_task_insert.add_row({job_id, input_task_ids[i], static_cast<std::uint32_t>(i)});
+    }
+    input_task_insert.flush();
+
+    std::vector<boost::uuids::uuid> const& output_task_ids = task_graph.get_output_tasks();
+    MultiRowInsert output_task_insert{conn, mysql::cMultiInsertOutputTask, 3, submitting_job_id};
+    for (std::size_t i = 0; i < output_task_ids.size(); ++i) {
+        output_task_insert.add_row({job_id, output_task_ids[i], static_cast<std::uint32_t>(i)});
+    }
+    output_task_insert.flush();
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
 
     return ystdlib::error_handling::success();
 }
 
 auto MySqlMetadataStorage::add_task_batch(
+        MySqlConnection& conn,
         MySqlJobSubmissionBatch& batch,
         sql::bytes job_id,
         Task const& task,
@@ -378,6 +818,7 @@ auto MySqlMetadataStorage::add_task_batch(
     }
     task_statement.setFloat(6, task.get_timeout());
     task_statement.setUInt(7, task.get_max_retries());
+    task_statement.setUInt(8, count_task_output_inputs(task));
     // NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
     task_statement.addBatch();
 
@@ -408,6 +849,20 @@ auto MySqlMetadataStorage::add_task_batch(
             sql::bytes data_id_bytes = uuid_get_bytes(data_id.value());
             input_statement.setBytes(4, &data_id_bytes);
             input_statement.addBatch();
+        } else if (value.has_value() && value.value().size() > cMaxInlineDataSize) {
+            // The data has no foreign key to the task, so it can be inserted before the batch
+            boost::uuids::uuid const value_data_id = insert_value_data(conn, value.value());
+            sql::bytes value_data_id_bytes = uuid_get_bytes(value_data_id);
+            sql::PreparedStatement& ref_statement = batch.get_data_ref_task_stmt();
+            ref_statement.setBytes(1, &value_data_id_bytes);
+            ref_statement.setBytes(2, &task_id_bytes);
+            ref_statement.addBatch();
+            sql::PreparedStatement& input_statement = batch.get_task_input_value_data_stmt();
+            input_statement.setBytes(1, &task_id_bytes);
+            input_statement.setUInt(2, i);
+            input_statement.setString(3, input.get_type());
+            input_statement.setBytes(4, &value_data_id_bytes);
+            input_statement.addBatch();
         } else if (value.has_value()) {
             sql::PreparedStatement& input_statement = batch.get_task_input_value_stmt();
             input_statement.setBytes(1, &task_id_bytes);
@@ -436,140 +891,68 @@ auto MySqlMetadataStorage::add_job(
         StorageConnection& conn,
         boost::uuids::uuid job_id,
         boost::uuids::uuid client_id,
-        TaskGraph const& task_graph
+        TaskGraph const& task_graph,
+        std::int32_t const priority
 ) -> StorageErr {
+    // Tasks are inserted in graph order, so that a task is inserted only if all its parents are.
+    std::optional<std::vector<Task const*>> const tasks = task_graph.get_tasks_in_graph_order();
+    if (false == tasks.has_value()) {
+        static_cast<MySqlConnection&>(conn)->rollback();
+        return StorageErr{StorageErrType::KeyNotFoundErr, "Task graph inconsistent"};
+    }
+    // A large job is committed in chunks instead of holding a single large transaction. It stays
+    // hidden from schedulers until all of it is inserted.
+    bool const commit_chunks = tasks->size() > cChunkedCommitNumTasks;
+
+    sql::bytes job_id_bytes = uuid_get_bytes(job_id);
     try {
-        sql::bytes job_id_bytes = uuid_get_bytes(job_id);
         sql::bytes client_id_bytes = uuid_get_bytes(client_id);
         {
-            std::unique_ptr<sql::PreparedStatement> statement{
-                    static_cast<MySqlConnection&>(conn)->prepareStatement(mysql::cInsertJob)
+            MySqlConnection::CachedStatement statement{
+                    static_cast<MySqlConnection&>(conn).prepare_statement(
+                            commit_chunks ? mysql::cInsertSubmittingJob : mysql::cInsertJob
+                    )
             };
             statement->setBytes(1, &job_id_bytes);
             statement->setBytes(2, &client_id_bytes);
+            statement->setInt(3, priority);
+            statement->setUInt(4, task_graph.get_tasks().size());
             statement->executeUpdate();
         }
-
-        // Tasks must be added in graph order to avoid the dangling reference.
-        std::vector<boost::uuids::uuid> const& input_task_ids = task_graph.get_input_tasks();
-        absl::flat_hash_set<boost::uuids::uuid> heads;
-        for (boost::uuids::uuid const task_id : input_task_ids) {
-            heads.insert(task_id);
-        }
-        std::deque<boost::uuids::uuid> queue;
-        // First go over all heads
-        for (boost::uuids::uuid const task_id : heads) {
-            std::optional<Task const*> const task_option = task_graph.get_task(task_id);
-            if (!task_option.has_value()) {
-                static_cast<MySqlConnection&>(conn)->rollback();
-                return StorageErr{
-                        StorageErrType::KeyNotFoundErr,
-                        "Task graph inconsistent: head task not found"
-                };
-            }
-            Task const* task = task_option.value();
-            if (auto const result = add_task(
-                        static_cast<MySqlConnection&>(conn),
-                        job_id_bytes,
-                        *task,
-                        TaskState::Ready
-                );
-                result.has_error())
-            {
-                static_cast<MySqlConnection&>(conn)->rollback();
-                return StorageErr{result.error(), "Cannot add task"};
-            }
-            for (boost::uuids::uuid const id : task_graph.get_child_tasks(task_id)) {
-                std::vector<boost::uuids::uuid> const parents = task_graph.get_parent_tasks(id);
-                if (std::ranges::all_of(
-                            parents,
-                            [&](boost::uuids::uuid const& parent) { return heads.contains(parent); }
-                    ))
-                {
-                    queue.push_back(id);
-                }
-            }
-        }
-        // Then go over all tasks in queue
-        while (!queue.empty()) {
-            boost::uuids::uuid const task_id = queue.back();
-            queue.pop_back();
-            if (!heads.contains(task_id)) {
-                heads.insert(task_id);
-                std::optional<Task const*> const task_option = task_graph.get_task(task_id);
-                if (!task_option.has_value()) {
-                    static_cast<MySqlConnection&>(conn)->rollback();
-                    return StorageErr{StorageErrType::KeyNotFoundErr, "Task graph inconsistent"};
-                }
-                Task const* task = task_option.value();
-                if (auto const result = add_task(
-                            static_cast<MySqlConnection&>(conn),
-                            job_id_bytes,
-                            *task,
-                            std::nullopt
-                    );
-                    result.has_error())
-                {
-                    static_cast<MySqlConnection&>(conn)->rollback();
-                    return StorageErr{result.error(), "Cannot add task"};
-                }
-                for (boost::uuids::uuid const id : task_graph.get_child_tasks(task_id)) {
-                    std::vector<boost::uuids::uuid> const parents = task_graph.get_parent_tasks(id);
-                    if (std::ranges::all_of(
-                                parents,
-                                [&](boost::uuids::uuid const& parent) {
-                                    return heads.contains(parent);
-                                }
-                        ))
-                    {
-                        queue.push_back(id);
-                    }
-                }
-            }
+        if (commit_chunks) {
+            static_cast<MySqlConnection&>(conn)->commit();
         }
 
-        // Add all dependencies
-        for (std::pair<boost::uuids::uuid, boost::uuids::uuid> const& pair :
-             task_graph.get_dependencies())
+        if (auto const result = insert_job_tasks(
+                    static_cast<MySqlConnection&>(conn),
+                    job_id,
+                    task_graph,
+                    tasks.value(),
+                    commit_chunks
+            );
+            result.has_error())
         {
-            std::unique_ptr<sql::PreparedStatement> dep_statement{
-                    static_cast<MySqlConnection&>(conn)->prepareStatement(
-                            mysql::cInsertTaskDependency
-                    )
-            };
-            sql::bytes parent_id_bytes = uuid_get_bytes(pair.first);
-            sql::bytes child_id_bytes = uuid_get_bytes(pair.second);
-            dep_statement->setBytes(1, &parent_id_bytes);
-            dep_statement->setBytes(2, &child_id_bytes);
-            dep_statement->executeUpdate();
+            static_cast<MySqlConnection&>(conn)->rollback();
+            if (commit_chunks) {
+                remove_submitting_job(static_cast<MySqlConnection&>(conn), &job_id_bytes);
+            }
+            return StorageErr{result.error(), "Cannot add task"};
         }
 
-        // Add input tasks
-        for (size_t i = 0; i < input_task_ids.size(); i++) {
-            std::unique_ptr<sql::PreparedStatement> input_statement{
-                    static_cast<MySqlConnection&>(conn)->prepareStatement(mysql::cInsertInputTask)
-            };
-            input_statement->setBytes(1, &job_id_bytes);
-            sql::bytes task_id_bytes = uuid_get_bytes(input_task_ids[i]);
-            input_statement->setBytes(2, &task_id_bytes);
-            input_statement->setUInt(3, i);
-            input_statement->executeUpdate();
-        }
-        // Add output tasks
-        std::vector<boost::uuids::uuid> const& output_task_ids = task_graph.get_output_tasks();
-        for (size_t i = 0; i < output_task_ids.size(); i++) {
-            std::unique_ptr<sql::PreparedStatement> output_statement{
-                    static_cast<MySqlConnection&>(conn)->prepareStatement(mysql::cInsertOutputTask)
+        if (commit_chunks) {
+            MySqlConnection::CachedStatement statement{
+                    static_cast<MySqlConnection&>(conn).prepare_statement(
+                            "UPDATE `jobs` SET `state` = 'running' WHERE `id` = ?"
+                    )
             };
-            output_statement->setBytes(1, &job_id_bytes);
-            sql::bytes task_id_bytes = uuid_get_bytes(output_task_ids[i]);
-            output_statement->setBytes(2, &task_id_bytes);
-            output_statement->setUInt(3, i);
-            output_statement->executeUpdate();
+            statement->setBytes(1, &job_id_bytes);
+            statement->executeUpdate();
         }
-
     } catch (sql::SQLException& e) {
         static_cast<MySqlConnection&>(conn)->rollback();
+        if (commit_chunks) {
+            remove_submitting_job(static_cast<MySqlConnection&>(conn), &job_id_bytes);
+        }
         if (e.getErrorCode() == ErDupKey || e.getErrorCode() == ErDupEntry) {
             return StorageErr{StorageErrType::DuplicateKeyErr, e.what()};
         }
@@ -584,7 +967,8 @@ auto MySqlMetadataStorage::add_job_batch(
         JobSubmissionBatch& batch,
         boost::uuids::uuid job_id,
         boost::uuids::uuid client_id,
-        TaskGraph const& task_graph
+        TaskGraph const& task_graph,
+        std::int32_t const priority
 ) -> StorageErr {
     try {
         sql::bytes job_id_bytes = uuid_get_bytes(job_id);
@@ -594,87 +978,38 @@ auto MySqlMetadataStorage::add_job_batch(
                     = static_cast<MySqlJobSubmissionBatch&>(batch).get_job_stmt();
             statement.setBytes(1, &job_id_bytes);
             statement.setBytes(2, &client_id_bytes);
+            statement.setInt(3, priority);
+            statement.setUInt(4, task_graph.get_tasks().size());
             statement.addBatch();
         }
 
         // Tasks must be added in graph order to avoid the dangling reference.
+        std::optional<std::vector<Task const*>> const tasks = task_graph.get_tasks_in_graph_order();
+        if (false == tasks.has_value()) {
+            static_cast<MySqlConnection&>(conn)->rollback();
+            return StorageErr{StorageErrType::KeyNotFoundErr, "Task graph inconsistent"};
+        }
         std::vector<boost::uuids::uuid> const& input_task_ids = task_graph.get_input_tasks();
-        absl::flat_hash_set<boost::uuids::uuid> heads;
-        for (boost::uuids::uuid const task_id : input_task_ids) {
-            heads.insert(task_id);
-        }
-        std::deque<boost::uuids::uuid> queue;
-        // First go over all heads
-        for (boost::uuids::uuid const task_id : heads) {
-            std::optional<Task const*> const task_option = task_graph.get_task(task_id);
-            if (!task_option.has_value()) {
-                static_cast<MySqlConnection&>(conn)->rollback();
-                return StorageErr{
-                        StorageErrType::KeyNotFoundErr,
-                        "Task graph inconsistent: head task not found"
-                };
-            }
-            Task const* task = task_option.value();
-
+        absl::flat_hash_set<boost::uuids::uuid> const heads{
+                input_task_ids.cbegin(),
+                input_task_ids.cend()
+        };
+        for (Task const* task : tasks.value()) {
+            std::optional<TaskState> const state
+                    = heads.contains(task->get_id()) ? std::optional{TaskState::Ready}
+                                                     : std::nullopt;
             if (auto const result = add_task_batch(
+                        static_cast<MySqlConnection&>(conn),
                         static_cast<MySqlJobSubmissionBatch&>(batch),
                         job_id_bytes,
                         *task,
-                        TaskState::Ready
+                        state
                 );
                 result.has_error())
             {
                 static_cast<MySqlConnection&>(conn)->rollback();
                 return StorageErr{result.error(), "Cannot add task"};
             }
-            for (boost::uuids::uuid const id : task_graph.get_child_tasks(task_id)) {
-                std::vector<boost::uuids::uuid> const parents = task_graph.get_parent_tasks(id);
-                if (std::ranges::all_of(
-                            parents,
-                            [&](boost::uuids::uuid const& parent) { return heads.contains(parent); }
-                    ))
-                {
-                    queue.push_back(id);
-                }
-            }
-        }
-        // Then go over all tasks in queue
-        while (!queue.empty()) {
-            boost::uuids::uuid const task_id = queue.back();
-            queue.pop_back();
-            if (!heads.contains(task_id)) {
-                heads.insert(task_id);
-                std::optional<Task const*> const task_option = task_graph.get_task(task_id);
-                if (!task_option.has_value()) {
-                    static_cast<MySqlConnection&>(conn)->rollback();
-                    return StorageErr{StorageErrType::KeyNotFoundErr, "Task graph inconsistent"};
-                }
-                Task const* task = task_option.value();
-
-                if (auto const result = add_task_batch(
-                            static_cast<MySqlJobSubmissionBatch&>(batch),
-                            job_id_bytes,
-                            *task,
-                            std::nullopt
-                    );
-                    result.has_error())
-                {
-                    static_cast<MySqlConnection&>(conn)->rollback();
-                    return StorageErr{result.error(), "Cannot add task"};
-                }
-                for (boost::uuids::uuid const id : task_graph.get_child_tasks(task_id)) {
-                    std::vector<boost::uuids::uuid> const parents = task_graph.get_parent_tasks(id);
-                    if (std::ranges::all_of(
-                                parents,
-                                [&](boost::uuids::uuid const& parent) {
-                                    return heads.contains(parent);
-                                }
-                        ))
-                    {
-                        queue.push_back(id);
-                    }
-                }
-            }
         }
 
         // Add all dependencies
@@ -738,32 +1073,42 @@ auto fetch_task(std::unique_ptr<sql::ResultSet> const& res)
     return Task{id, function_name, language, state, timeout};
 }
 
-auto fetch_task_input(Task* task, std::unique_ptr<sql::ResultSet> const& res) {
+auto fetch_task_input(
+        MySqlConnection& conn,
+        Task* task,
+        std::unique_ptr<sql::ResultSet> const& res
+) {
     // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     std::string const type = get_sql_string(res->getString(3));
+    std::optional<std::string> const value = get_task_value(conn, res, 6, 8);
     if (!res->isNull(4)) {
         TaskInput input = TaskInput(read_id(res->getBinaryStream(4)), res->getUInt(5), type);
-        if (!res->isNull(6)) {
-            input.set_value(get_sql_string(res->getString(6)));
+        if (value.has_value()) {
+            input.set_value(value.value());
         }
         if (!res->isNull(7)) {
             input.set_data_id(read_id(res->getBinaryStream(7)));
         }
         task->add_input(input);
-    } else if (!res->isNull(6)) {
-        task->add_input(TaskInput(get_sql_string(res->getString(6)), type));
+    } else if (value.has_value()) {
+        task->add_input(TaskInput(value.value(), type));
     } else if (!res->isNull(7)) {
         task->add_input(TaskInput(read_id(res->getBinaryStream(7))));
     }
     // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 }
 
-auto fetch_task_output(Task* task, std::unique_ptr<sql::ResultSet> const& res) {
+auto fetch_task_output(
+        MySqlConnection& conn,
+        Task* task,
+        std::unique_ptr<sql::ResultSet> const& res
+) {
     // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     std::string const type = get_sql_string(res->getString(3));
     TaskOutput output{type};
-    if (!res->isNull(4)) {
-        output.set_value(get_sql_string(res->getString(4)));
+    std::optional<std::string> const value = get_task_value(conn, res, 4, 6);
+    if (value.has_value()) {
+        output.set_value(value.value());
     } else if (!res->isNull(5)) {
         output.set_data_id(read_id(res->getBinaryStream(5)));
     }
@@ -771,8 +1116,11 @@ auto fetch_task_output(Task* task, std::unique_ptr<sql::ResultSet> const& res) {
     // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 }
 
-auto fetch_task_graph_task_input(TaskGraph* task_graph, std::unique_ptr<sql::ResultSet> const& res)
-        -> bool {
+auto fetch_task_graph_task_input(
+        MySqlConnection& conn,
+        TaskGraph* task_graph,
+        std::unique_ptr<sql::ResultSet> const& res
+) -> bool {
     // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     boost::uuids::uuid const task_id = read_id(res->getBinaryStream(1));
     std::string const type = get_sql_string(res->getString(3));
@@ -781,17 +1129,18 @@ auto fetch_task_graph_task_input(TaskGraph* task_graph, std::unique_ptr<sql::Res
         return false;
     }
     Task* task = task_option.value();
+    std::optional<std::string> const value = get_task_value(conn, res, 6, 8);
     if (!res->isNull(4)) {
         TaskInput input = TaskInput(read_id(res->getBinaryStream(4)), res->getUInt(5), type);
-        if (!res->isNull(6)) {
-            input.set_value(get_sql_string(res->getString(6)));
+        if (value.has_value()) {
+            input.set_value(value.value());
         }
         if (!res->isNull(7)) {
             input.set_data_id(read_id(res->getBinaryStream(7)));
         }
         task->add_input(input);
-    } else if (!res->isNull(6)) {
-        task->add_input(TaskInput(get_sql_string(res->getString(6)), type));
+    } else if (value.has_value()) {
+        task->add_input(TaskInput(value.value(), type));
     } else if (!res->isNull(7)) {
         task->add_input(TaskInput(read_id(res->getBinaryStream(7))));
     }
@@ -799,8 +1148,11 @@ auto fetch_task_graph_task_input(TaskGraph* task_graph, std::unique_ptr<sql::Res
     return true;
 }
 
-auto fetch_task_graph_task_output(TaskGraph* task_graph, std::unique_ptr<sql::ResultSet> const& res)
-        -> bool {
+auto fetch_task_graph_task_output(
+        MySqlConnection& conn,
+        TaskGraph* task_graph,
+        std::unique_ptr<sql::ResultSet> const& res
+) -> bool {
     // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     boost::uuids::uuid const task_id = read_id(res->getBinaryStream(1));
     std::optional<Task*> task_option = task_graph->get_task(task_id);
@@ -810,8 +1162,9 @@ auto fetch_task_graph_task_output(TaskGraph* task_graph, std::unique_ptr<sql::Re
     Task* task = task_option.value();
     std::string const type = get_sql_string(res->getString(3));
     TaskOutput output{type};
-    if (!res->isNull(4)) {
-        output.set_value(get_sql_string(res->getString(4)));
+    std::optional<std::string> const value = get_task_value(conn, res, 4, 6);
+    if (value.has_value()) {
+        output.set_value(value.value());
     } else if (!res->isNull(5)) {
         output.set_data_id(read_id(res->getBinaryStream(5)));
     }
@@ -830,25 +1183,26 @@ auto MySqlMetadataStorage::fetch_full_task(
     sql::bytes id_bytes = uuid_get_bytes(id);
 
     // Get task inputs
-    std::unique_ptr<sql::PreparedStatement> input_statement{conn->prepareStatement(
+    MySqlConnection::CachedStatement input_statement{conn.prepare_statement(
             "SELECT `task_id`, `position`, `type`, `output_task_id`, `output_task_position`, "
-            "`value`, `data_id` FROM `task_inputs` WHERE `task_id` = ? ORDER BY `position`"
+            "`value`, `data_id`, `value_data_id` FROM `task_inputs` WHERE `task_id` = ? ORDER BY "
+            "`position`"
     )};
     input_statement->setBytes(1, &id_bytes);
     std::unique_ptr<sql::ResultSet> const input_res{input_statement->executeQuery()};
     while (input_res->next()) {
-        fetch_task_input(&task, input_res);
+        fetch_task_input(conn, &task, input_res);
     }
 
     // Get task outputs
-    std::unique_ptr<sql::PreparedStatement> output_statement{conn->prepareStatement(
-            "SELECT `task_id`, `position`, `type`, `value`, `data_id` FROM "
+    MySqlConnection::CachedStatement output_statement{conn.prepare_statement(
+            "SELECT `task_id`, `position`, `type`, `value`, `data_id`, `value_data_id` FROM "
             "`task_outputs` WHERE `task_id` = ? ORDER BY `position`"
     )};
     output_statement->setBytes(1, &id_bytes);
     std::unique_ptr<sql::ResultSet> const output_res{output_statement->executeQuery()};
     while (output_res->next()) {
-        fetch_task_output(&task, output_res);
+        fetch_task_output(conn, &task, output_res);
     }
     return task;
 }
@@ -860,8 +1214,8 @@ auto MySqlMetadataStorage::get_task_graph(
 ) -> StorageErr {
     try {
         // Get all tasks
-        std::unique_ptr<sql::PreparedStatement> task_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement task_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `id`, `func_name`, `language`, `state`, `timeout` FROM `tasks` "
                         "WHERE `job_id` "
                         "= ?"
@@ -888,11 +1242,12 @@ auto MySqlMetadataStorage::get_task_graph(
         }
 
         // Get inputs
-        std::unique_ptr<sql::PreparedStatement> input_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement input_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `t1`.`task_id`, `t1`.`position`, `t1`.`type`, "
                         "`t1`.`output_task_id`, `t1`.`output_task_position`, `t1`.`value`, "
-                        "`t1`.`data_id` FROM `task_inputs` AS `t1` JOIN `tasks` ON `t1`.`task_id` "
+                        "`t1`.`data_id`, `t1`.`value_data_id` FROM `task_inputs` AS `t1` JOIN "
+                        "`tasks` ON `t1`.`task_id` "
                         "= `tasks`.`id` WHERE `tasks`.`job_id` = ? ORDER BY `t1`.`task_id`, "
                         "`t1`.`position`"
                 )
@@ -900,17 +1255,23 @@ auto MySqlMetadataStorage::get_task_graph(
         input_statement->setBytes(1, &id_bytes);
         std::unique_ptr<sql::ResultSet> const input_res(input_statement->executeQuery());
         while (input_res->next()) {
-            if (!fetch_task_graph_task_input(task_graph, input_res)) {
+            if (!fetch_task_graph_task_input(
+                        static_cast<MySqlConnection&>(conn),
+                        task_graph,
+                        input_res
+                ))
+            {
                 static_cast<MySqlConnection&>(conn)->rollback();
                 return StorageErr{StorageErrType::KeyNotFoundErr, "Task storage inconsistent"};
             }
         }
 
         // Get outputs
-        std::unique_ptr<sql::PreparedStatement> output_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement output_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `t1`.`task_id`, `t1`.`position`, `t1`.`type`, `t1`.`value`, "
-                        "`t1`.`data_id` FROM `task_outputs` AS `t1` JOIN `tasks` ON `t1`.`task_id` "
+                        "`t1`.`data_id`, `t1`.`value_data_id` FROM `task_outputs` AS `t1` JOIN "
+                        "`tasks` ON `t1`.`task_id` "
                         "= `tasks`.`id` WHERE `tasks`.`job_id` = ? ORDER BY `t1`.`task_id`, "
                         "`t1`.`position`"
                 )
@@ -918,15 +1279,20 @@ auto MySqlMetadataStorage::get_task_graph(
         output_statement->setBytes(1, &id_bytes);
         std::unique_ptr<sql::ResultSet> const output_res(output_statement->executeQuery());
         while (output_res->next()) {
-            if (!fetch_task_graph_task_output(task_graph, output_res)) {
+            if (!fetch_task_graph_task_output(
+                        static_cast<MySqlConnection&>(conn),
+                        task_graph,
+                        output_res
+                ))
+            {
                 static_cast<MySqlConnection&>(conn)->rollback();
                 return StorageErr{StorageErrType::KeyNotFoundErr, "Task storage inconsistent"};
             }
         }
 
         // Get dependencies
-        std::unique_ptr<sql::PreparedStatement> dep_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement dep_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `t1`.`parent`, `t1`.`child` FROM `task_dependencies` AS `t1` JOIN "
                         "`tasks` ON `t1`.`parent` = `tasks`.`id` WHERE `tasks`.`job_id` = ?"
                 )
@@ -941,8 +1307,8 @@ auto MySqlMetadataStorage::get_task_graph(
         }
 
         // Get input tasks
-        std::unique_ptr<sql::PreparedStatement> input_task_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement input_task_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `task_id`, `position` FROM `input_tasks` WHERE `job_id` = ? ORDER "
                         "BY `position`"
                 )
@@ -953,8 +1319,8 @@ auto MySqlMetadataStorage::get_task_graph(
             task_graph->add_input_task(read_id(input_task_res->getBinaryStream(1)));
         }
         // Get output tasks
-        std::unique_ptr<sql::PreparedStatement> output_task_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement output_task_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `task_id`, `position` FROM `output_tasks` WHERE `job_id` = ? ORDER "
                         "BY `position`"
                 )
@@ -999,9 +1365,10 @@ auto MySqlMetadataStorage::get_job_metadata(
         JobMetadata* job
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement{
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "SELECT `client_id`, `creation_time` FROM `jobs` WHERE `id` = ?"
+        MySqlConnection::CachedStatement statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "SELECT `client_id`, `creation_time`, `priority` FROM `jobs` WHERE "
+                        "`id` = ?"
                 )
         };
         sql::bytes id_bytes = uuid_get_bytes(id);
@@ -1028,7 +1395,12 @@ auto MySqlMetadataStorage::get_job_metadata(
                     )
             };
         }
-        *job = JobMetadata{id, client_id, optional_creation_time.value()};
+        *job = JobMetadata{
+                id,
+                client_id,
+                optional_creation_time.value(),
+                res->getInt("priority")
+        };
     } catch (sql::SQLException& e) {
         static_cast<MySqlConnection&>(conn)->rollback();
         return StorageErr{StorageErrType::OtherErr, e.what()};
@@ -1043,8 +1415,8 @@ auto MySqlMetadataStorage::get_job_complete(
         bool* complete
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> const statement{
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `state` FROM `jobs` WHERE `id` = ?"
                 )
         };
@@ -1060,7 +1432,7 @@ auto MySqlMetadataStorage::get_job_complete(
         }
         res->next();
         std::string const state = get_sql_string(res->getString("state"));
-        *complete = ("running" != state);
+        *complete = ("running" != state && "submitting" != state);
     } catch (sql::SQLException& e) {
         static_cast<MySqlConnection&>(conn)->rollback();
         return StorageErr{StorageErrType::OtherErr, e.what()};
@@ -1075,8 +1447,8 @@ auto MySqlMetadataStorage::get_job_status(
         JobStatus* status
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> const job_statement{
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const job_statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `state` FROM `jobs` WHERE `id` = ?"
                 )
         };
@@ -1092,7 +1464,7 @@ auto MySqlMetadataStorage::get_job_status(
         }
         res->next();
         std::string const state = get_sql_string(res->getString("state"));
-        if ("running" == state) {
+        if ("running" == state || "submitting" == state) {
             *status = JobStatus::Running;
         } else if ("success" == state) {
             *status = JobStatus::Succeeded;
@@ -1119,8 +1491,8 @@ auto MySqlMetadataStorage::get_job_output_tasks(
 ) -> StorageErr {
     try {
         task_ids->clear();
-        std::unique_ptr<sql::PreparedStatement> statement{
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `task_id` FROM `output_tasks` WHERE `job_id` = ? ORDER BY "
                         "`position`"
                 )
@@ -1145,9 +1517,10 @@ auto MySqlMetadataStorage::get_jobs_by_client_id(
         std::vector<boost::uuids::uuid>* job_ids
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement{
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "SELECT `id` FROM `jobs` WHERE `client_id` = ?"
+        MySqlConnection::CachedStatement statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "SELECT `id` FROM `jobs` WHERE `client_id` = ? AND `state` != "
+                        "'submitting'"
                 )
         };
         sql::bytes client_id_bytes = uuid_get_bytes(client_id);
@@ -1167,8 +1540,8 @@ auto MySqlMetadataStorage::get_jobs_by_client_id(
 auto MySqlMetadataStorage::remove_job(StorageConnection& conn, boost::uuids::uuid id) noexcept
         -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "DELETE FROM `jobs` WHERE `id` = ?"
                 )
         );
@@ -1187,8 +1560,8 @@ auto MySqlMetadataStorage::reset_job(StorageConnection& conn, boost::uuids::uuid
         -> StorageErr {
     try {
         // Check for retry count on all tasks
-        std::unique_ptr<sql::PreparedStatement> retry_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement retry_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `id` FROM `tasks` WHERE `job_id` = ? AND `retry` >= `max_retry`"
                 )
         );
@@ -1200,51 +1573,61 @@ auto MySqlMetadataStorage::reset_job(StorageConnection& conn, boost::uuids::uuid
             return StorageErr{StorageErrType::Success, "Some tasks have reached max retry count"};
         }
         // Increment the retry count for all tasks
-        std::unique_ptr<sql::PreparedStatement> increment_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement increment_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "UPDATE `tasks` SET `retry` = `retry` + 1 WHERE `job_id` = ?"
                 )
         );
         increment_statement->setBytes(1, &job_id_bytes);
         increment_statement->executeUpdate();
+        // Reset the number of inputs waiting for a parent output
+        MySqlConnection::CachedStatement const remaining_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `tasks` SET `remaining_inputs` = (SELECT COUNT(*) FROM "
+                        "`task_inputs` WHERE `task_inputs`.`task_id` = `tasks`.`id` AND "
+                        "`output_task_id` IS NOT NULL) WHERE `job_id` = ?"
+                )
+        );
+        remaining_statement->setBytes(1, &job_id_bytes);
+        remaining_statement->executeUpdate();
         // Reset states for all tasks. Head tasks should be ready and other tasks should be pending
-        std::unique_ptr<sql::PreparedStatement> state_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "UPDATE `tasks` SET `state` = IF(`id` NOT IN (SELECT `task_id` FROM "
-                        "`task_inputs` WHERE `task_id` IN (SELECT `id` FROM `tasks` WHERE `job_id` "
-                        "= ?) AND `output_task_id` IS NOT NULL), 'ready', 'pending') WHERE job_id "
-                        "= ?"
+        MySqlConnection::CachedStatement state_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `tasks` SET `state` = IF(`remaining_inputs` = 0, 'ready', "
+                        "'pending') WHERE `job_id` = ?"
                 )
         );
         state_statement->setBytes(1, &job_id_bytes);
-        state_statement->setBytes(2, &job_id_bytes);
         state_statement->executeUpdate();
         // Clear outputs for all tasks
-        std::unique_ptr<sql::PreparedStatement> output_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "UPDATE `task_outputs` SET `value` = NULL, `data_id` = NULL WHERE "
-                        "`task_id` IN (SELECT `id` FROM `tasks` WHERE `job_id` = ?)"
+        MySqlConnection::CachedStatement output_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `task_outputs` SET `value` = NULL, `data_id` = NULL, "
+                        "`value_data_id` = NULL WHERE `task_id` IN (SELECT `id` FROM `tasks` WHERE "
+                        "`job_id` = ?)"
                 )
         );
         output_statement->setBytes(1, &job_id_bytes);
         output_statement->executeUpdate();
         // Clear inputs for non-head tasks
-        std::unique_ptr<sql::PreparedStatement> input_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "UPDATE `task_inputs` SET `value` = NULL, `data_id` = NULL WHERE `task_id` "
-                        "IN (SELECT `id` FROM `tasks` WHERE `job_id` = ?) AND `output_task_id` IS "
-                        "NOT NULL"
+        MySqlConnection::CachedStatement input_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `task_inputs` SET `value` = NULL, `data_id` = NULL, "
+                        "`value_data_id` = NULL WHERE `task_id` IN (SELECT `id` FROM `tasks` "
+                        "WHERE `job_id` = ?) AND `output_task_id` IS NOT NULL"
                 )
         );
         input_statement->setBytes(1, &job_id_bytes);
         input_statement->executeUpdate();
         // Reset job state
-        std::unique_ptr<sql::PreparedStatement> job_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "UPDATE `jobs` SET `state` = 'running' WHERE `id` = ?"
+        MySqlConnection::CachedStatement job_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `jobs` SET `state` = 'running', `remaining_tasks` = (SELECT "
+                        "COUNT(*) FROM `tasks` WHERE `job_id` = ?) WHERE `id` = ?"
                 )
         );
         job_statement->setBytes(1, &job_id_bytes);
+        job_statement->setBytes(2, &job_id_bytes);
         job_statement->executeUpdate();
     } catch (sql::SQLException& e) {
         static_cast<MySqlConnection&>(conn)->rollback();
@@ -1257,8 +1640,8 @@ auto MySqlMetadataStorage::reset_job(StorageConnection& conn, boost::uuids::uuid
 auto MySqlMetadataStorage::get_task(StorageConnection& conn, boost::uuids::uuid id, Task* task)
         -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `id`, `func_name`, `language`, `state`, `timeout` FROM `tasks` "
                         "WHERE `id` = ?"
                 )
@@ -1294,8 +1677,8 @@ auto MySqlMetadataStorage::get_task_job_id(
         boost::uuids::uuid* job_id
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `job_id` FROM `tasks` WHERE `id` = ?"
                 )
         );
@@ -1324,12 +1707,15 @@ constexpr int cLeaseExpireTime = 1000 * 10;  // 10 ms
 auto MySqlMetadataStorage::get_ready_tasks(
         StorageConnection& conn,
         boost::uuids::uuid scheduler_id,
+        std::optional<boost::uuids::uuid> const& client_id,
+        std::optional<boost::uuids::uuid> const& after_task_id,
+        std::size_t const max_num_tasks,
         std::vector<ScheduleTaskMetadata>* tasks
 ) -> StorageErr {
     try {
         // Remove timeout scheduler leases
-        std::unique_ptr<sql::PreparedStatement> lease_timeout_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement lease_timeout_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "DELETE FROM `scheduler_leases` WHERE TIMESTAMPDIFF(MICROSECOND, "
                         "`lease_time`, CURRENT_TIMESTAMP()) > ?"
                 )
@@ -1337,83 +1723,101 @@ auto MySqlMetadataStorage::get_ready_tasks(
         lease_timeout_statement->setInt(1, cLeaseExpireTime);
         lease_timeout_statement->executeUpdate();
 
-        // Get all ready tasks from job that has not failed or cancelled
-        std::unique_ptr<sql::Statement> task_statement(
-                static_cast<MySqlConnection&>(conn)->createStatement()
-        );
-        std::unique_ptr<sql::ResultSet> const res{task_statement->executeQuery(
-                "SELECT `id`, `func_name`, `job_id` FROM `tasks` WHERE `state` = 'ready' "
-                "AND `job_id` NOT IN (SELECT `id` FROM `jobs` WHERE `state` != 'running') AND `id` "
-                "NOT IN (SELECT `task_id` FROM `scheduler_leases`)"
-        )};
+        // Get the first unleased ready tasks of running jobs in priority order, together with the
+        // metadata of their jobs. With a cursor, only the tasks ordered after the cursor task by
+        // (priority, creation_time, id) are read.
+        MySqlConnection::CachedStatement task_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(fmt::format(
+                        "SELECT `tasks`.`id`, `tasks`.`func_name`, `tasks`.`job_id`, "
+                        "`jobs`.`client_id`, `jobs`.`creation_time`, `jobs`.`priority` FROM "
+                        "`tasks` JOIN `jobs` ON `tasks`.`job_id` = `jobs`.`id` {} WHERE "
+                        "`tasks`.`state` = 'ready' AND `jobs`.`state` = 'running' {} {} AND NOT "
+                        "EXISTS (SELECT 1 FROM `scheduler_leases` WHERE "
+                        "`scheduler_leases`.`task_id` = `tasks`.`id`) ORDER BY `jobs`.`priority` "
+                        "DESC, `jobs`.`creation_time` ASC, `tasks`.`id` ASC LIMIT ?",
+                        after_task_id.has_value()
+                                ? "JOIN (SELECT `jobs`.`priority`, `jobs`.`creation_time` FROM "
+                                  "`tasks` JOIN `jobs` ON `tasks`.`job_id` = `jobs`.`id` WHERE "
+                                  "`tasks`.`id` = ?) AS `cursor_job`"
+                                : "",
+                        client_id.has_value() ? "AND `jobs`.`client_id` = ?" : "",
+                        after_task_id.has_value()
+                                ? "AND (`jobs`.`priority` < `cursor_job`.`priority` OR "
+                                  "(`jobs`.`priority` = `cursor_job`.`priority` AND "
+                                  "(`jobs`.`creation_time` > `cursor_job`.`creation_time` OR "
+                                  "(`jobs`.`creation_time` = `cursor_job`.`creation_time` AND "
+                                  "`tasks`.`id` > ?))))"
+                                : ""
+                ))
+        );
+        std::int32_t parameter_index = 1;
+        sql::bytes after_task_id_bytes;
+        if (after_task_id.has_value()) {
+            after_task_id_bytes = uuid_get_bytes(after_task_id.value());
+            task_statement->setBytes(parameter_index++, &after_task_id_bytes);
+        }
+        sql::bytes client_id_bytes;
+        if (client_id.has_value()) {
+            client_id_bytes = uuid_get_bytes(client_id.value());
+            task_statement->setBytes(parameter_index++, &client_id_bytes);
+        }
+        if (after_task_id.has_value()) {
+            task_statement->setBytes(parameter_index++, &after_task_id_bytes);
+        }
+        task_statement->setUInt64(parameter_index, max_num_tasks);
+        std::unique_ptr<sql::ResultSet> const res{task_statement->executeQuery()};
 
         if (res->rowsCount() == 0) {
             static_cast<MySqlConnection&>(conn)->commit();
             return StorageErr{};
         }
 
+        std::vector<boost::uuids::uuid> task_ids;
         absl::flat_hash_map<boost::uuids::uuid, ScheduleTaskMetadata> new_tasks;
-        absl::flat_hash_map<boost::uuids::uuid, std::vector<boost::uuids::uuid>> job_id_to_task_ids;
         while (res->next()) {
             boost::uuids::uuid const task_id = read_id(res->getBinaryStream("id"));
             boost::uuids::uuid const job_id = read_id(res->getBinaryStream("job_id"));
             std::string const function_name = get_sql_string(res->getString("func_name"));
-            new_tasks.emplace(task_id, ScheduleTaskMetadata{task_id, function_name, job_id});
-            if (job_id_to_task_ids.find(job_id) == job_id_to_task_ids.end()) {
-                job_id_to_task_ids[job_id] = std::vector<boost::uuids::uuid>{task_id};
-            } else {
-                job_id_to_task_ids[job_id].emplace_back(task_id);
-            }
-        }
-
-        // Get all job metadata
-        std::unique_ptr<sql::Statement> job_statement{
-                static_cast<MySqlConnection&>(conn)->createStatement()
-        };
-        std::unique_ptr<sql::ResultSet> const job_res{job_statement->executeQuery(
-                "SELECT `id` , `client_id` , `creation_time` FROM `jobs` WHERE `id` IN (SELECT "
-                "`id` FROM `jobs` WHERE `state` = 'running')"
-        )};
-
-        // Get job metadata
-        while (job_res->next()) {
-            boost::uuids::uuid const job_id = read_id(job_res->getBinaryStream("id"));
-            boost::uuids::uuid const client_id = read_id(job_res->getBinaryStream("client_id"));
             std::optional<std::chrono::system_clock::time_point> const optional_creation_time
-                    = parse_timestamp(get_sql_string(job_res->getString("creation_time")));
+                    = parse_timestamp(get_sql_string(res->getString("creation_time")));
             if (false == optional_creation_time.has_value()) {
                 static_cast<MySqlConnection&>(conn)->rollback();
                 return StorageErr{
                         StorageErrType::OtherErr,
                         fmt::format(
                                 "Cannot parse timestamp {}",
-                                get_sql_string(job_res->getString("creation_time"))
+                                get_sql_string(res->getString("creation_time"))
                         )
                 };
             }
-            // Job id will not be in job_id_to_task_ids if the job's tasks are leased
-            if (job_id_to_task_ids.find(job_id) == job_id_to_task_ids.end()) {
-                continue;
-            }
-            for (boost::uuids::uuid const& task_id : job_id_to_task_ids[job_id]) {
-                new_tasks[task_id].set_client_id(client_id);
-                new_tasks[task_id].set_job_creation_time(optional_creation_time.value());
-            }
-        }
-
-        // Get all data localities
-        std::unique_ptr<sql::Statement> locality_statement{
-                static_cast<MySqlConnection&>(conn)->createStatement()
+            ScheduleTaskMetadata task{task_id, function_name, job_id};
+            task.set_client_id(read_id(res->getBinaryStream("client_id")));
+            task.set_job_creation_time(optional_creation_time.value());
+            task.set_job_priority(res->getInt("priority"));
+            task_ids.push_back(task_id);
+            new_tasks.emplace(task_id, std::move(task));
+        }
+
+        // Get data localities of the fetched tasks
+        MySqlConnection::CachedStatement locality_statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(fmt::format(
+                        "SELECT `task_inputs`.`task_id`, `data`.`hard_locality`, "
+                        "`data_locality`.`address` FROM `task_inputs` JOIN `data` ON "
+                        "`task_inputs`.`data_id` = `data`.`id` JOIN `data_locality` ON "
+                        "`data`.`id` = `data_locality`.`id` WHERE `task_inputs`.`task_id` IN ({})",
+                        get_placeholders(task_ids.size())
+                ))
         };
-        std::unique_ptr<sql::ResultSet> const locality_res{locality_statement->executeQuery(
-                "SELECT `task_inputs`.`task_id`, `data`.`hard_locality`, "
-                "`data_locality`.`address` FROM `task_inputs` JOIN `data` ON "
-                "`task_inputs`.`data_id` = `data`.`id` JOIN `data_locality` ON `data`.`id` "
-                "= `data_locality`.`id` WHERE `task_inputs`.`task_id` IN (SELECT `id` "
-                "FROM `tasks` WHERE `state` = 'ready' AND `job_id` NOT IN (SELECT `id` FROM `jobs` "
-                "WHERE `state` != 'running')) AND `task_inputs`.`task_id` NOT IN (SELECT `task_id` "
-                "FROM `scheduler_leases`)"
-        )};
+        std::vector<sql::bytes> task_id_bytes;
+        task_id_bytes.reserve(task_ids.size());
+        for (boost::uuids::uuid const& task_id : task_ids) {
+            task_id_bytes.push_back(uuid_get_bytes(task_id));
+            locality_statement->setBytes(
+                    static_cast<std::int32_t>(task_id_bytes.size()),
+                    &task_id_bytes.back()
+            );
+        }
+        std::unique_ptr<sql::ResultSet> const locality_res{locality_statement->executeQuery()};
 
         while (locality_res->next()) {
             boost::uuids::uuid const task_id = read_id(locality_res->getBinaryStream("task_id"));
@@ -1427,28 +1831,27 @@ auto MySqlMetadataStorage::get_ready_tasks(
         }
 
         // Add scheduler lease
-        std::unique_ptr<sql::PreparedStatement> lease_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement lease_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `scheduler_leases` (`scheduler_id`, `task_id`) VALUES (?, ?)"
                 )
         );
         sql::bytes scheduler_id_bytes = uuid_get_bytes(scheduler_id);
-        for (auto const& [task_id, task] : new_tasks) {
-            sql::bytes task_id_bytes = uuid_get_bytes(task_id);
+        for (sql::bytes& id_bytes : task_id_bytes) {
             lease_statement->setBytes(1, &scheduler_id_bytes);
-            lease_statement->setBytes(2, &task_id_bytes);
+            lease_statement->setBytes(2, &id_bytes);
             lease_statement->addBatch();
         }
         lease_statement->executeBatch();
 
-        // Add all tasks to the output
-        absl::flat_hash_set<boost::uuids::uuid> task_ids;
+        // Add all tasks to the output in priority order
+        absl::flat_hash_set<boost::uuids::uuid> existing_task_ids;
         for (ScheduleTaskMetadata const& task : *tasks) {
-            task_ids.insert(task.get_id());
+            existing_task_ids.insert(task.get_id());
         }
-        for (auto const& [task_id, task] : new_tasks) {
-            if (task_ids.find(task_id) == task_ids.end()) {
-                tasks->emplace_back(task);
+        for (boost::uuids::uuid const& task_id : task_ids) {
+            if (false == existing_task_ids.contains(task_id)) {
+                tasks->emplace_back(std::move(new_tasks[task_id]));
             }
         }
     } catch (sql::SQLException& e) {
@@ -1459,14 +1862,38 @@ auto MySqlMetadataStorage::get_ready_tasks(
     return StorageErr{};
 }
 
+auto MySqlMetadataStorage::get_ready_clients(
+        StorageConnection& conn,
+        std::vector<boost::uuids::uuid>* ids
+) -> StorageErr {
+    try {
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "SELECT DISTINCT `jobs`.`client_id` FROM `tasks` JOIN `jobs` ON "
+                        "`tasks`.`job_id` = `jobs`.`id` WHERE `tasks`.`state` = 'ready' AND "
+                        "`jobs`.`state` = 'running'"
+                )
+        );
+        std::unique_ptr<sql::ResultSet> const res{statement->executeQuery()};
+        while (res->next()) {
+            ids->emplace_back(read_id(res->getBinaryStream("client_id")));
+        }
+    } catch (sql::SQLException& e) {
+        static_cast<MySqlConnection&>(conn)->rollback();
+        return StorageErr{StorageErrType::OtherErr, e.what()};
+    }
+    static_cast<MySqlConnection&>(conn)->commit();
+    return StorageErr{};
+}
+
 auto MySqlMetadataStorage::set_task_state(
         StorageConnection& conn,
         boost::uuids::uuid id,
         TaskState state
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "UPDATE `tasks` SET `state` = ? WHERE `id` = ?"
                 )
         );
@@ -1488,8 +1915,8 @@ auto MySqlMetadataStorage::set_task_state(
 auto MySqlMetadataStorage::set_task_running(StorageConnection& conn, boost::uuids::uuid id)
         -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "UPDATE `tasks` SET `state` = 'running' WHERE `id` = ? AND `state` = "
                         "'ready'"
                 )
@@ -1512,8 +1939,8 @@ auto MySqlMetadataStorage::set_task_running(StorageConnection& conn, boost::uuid
 auto MySqlMetadataStorage::add_task_instance(StorageConnection& conn, TaskInstance const& instance)
         -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> const statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `task_instances` (`id`, `task_id`, `start_time`) VALUES(?, ?, "
                         "CURRENT_TIMESTAMP())"
                 )
@@ -1538,86 +1965,188 @@ auto
 MySqlMetadataStorage::create_task_instance(StorageConnection& conn, TaskInstance const& instance)
         -> StorageErr {
     try {
-        // Check the state of the task
-        std::unique_ptr<sql::PreparedStatement> ready_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "SELECT `state` FROM `tasks` WHERE `id` = ? AND `state` = 'ready'"
-                )
-        );
-        sql::bytes id_bytes = uuid_get_bytes(instance.task_id);
-        ready_statement->setBytes(1, &id_bytes);
-        std::unique_ptr<sql::ResultSet> const ready_res(ready_statement->executeQuery());
-        bool const task_ready = ready_res->rowsCount() > 0;
-        // Check all task instances have timed out
-        std::unique_ptr<sql::PreparedStatement> not_timeout_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "SELECT `t1`.`id` FROM `task_instances` as `t1` JOIN `tasks` ON "
-                        "`t1`.`task_id` = `tasks`.`id` WHERE `t1`.`task_id` = ? AND "
-                        "(`tasks`.`timeout` < 0.0001 OR TIMESTAMPDIFF(MICROSECOND, "
-                        "`t1`.`start_time`, CURRENT_TIMESTAMP()) < `tasks`.`timeout` * 1000)"
-                )
-        );
-        not_timeout_statement->setBytes(1, &id_bytes);
-        std::unique_ptr<sql::ResultSet> const not_timeout_res(
-                not_timeout_statement->executeQuery()
-        );
-        bool const all_timeout = not_timeout_res->rowsCount() == 0;
-        if (!task_ready && !all_timeout) {
-            static_cast<MySqlConnection&>(conn)->rollback();
-            return StorageErr{StorageErrType::OtherErr, "Task not ready or timed out"};
-        }
-        // Check the job state
-        std::unique_ptr<sql::PreparedStatement> job_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "SELECT `state` FROM `jobs` WHERE `id` = (SELECT `job_id` FROM "
-                        "`tasks` WHERE `id` = ?)"
-                )
+        StorageErr const err = create_task_instance_impl(
+                static_cast<MySqlConnection&>(conn),
+                instance,
+                std::nullopt
         );
-        job_statement->setBytes(1, &id_bytes);
-        std::unique_ptr<sql::ResultSet> const job_res(job_statement->executeQuery());
-        if (job_res->rowsCount() == 0) {
+        if (!err.success()) {
             static_cast<MySqlConnection&>(conn)->rollback();
-            return StorageErr{StorageErrType::KeyNotFoundErr, "Job not found"};
+            return err;
         }
-        job_res->next();
-        std::string const job_state = get_sql_string(job_res->getString("state"));
-        if (job_state != "running") {
-            static_cast<MySqlConnection&>(conn)->rollback();
-            return StorageErr{StorageErrType::OtherErr, "Job state wrong"};
+    } catch (sql::SQLException& e) {
+        static_cast<MySqlConnection&>(conn)->rollback();
+        return StorageErr{StorageErrType::OtherErr, e.what()};
+    }
+
+    static_cast<MySqlConnection&>(conn)->commit();
+    return StorageErr{};
+}
+
+auto MySqlMetadataStorage::create_task_instances(
+        StorageConnection& conn,
+        std::vector<TaskInstance> const& instances,
+        std::vector<TaskInstance>* created
+) -> StorageErr {
+    std::vector<TaskInstance> created_instances;
+    created_instances.reserve(instances.size());
+    try {
+        for (TaskInstance const& instance : instances) {
+            StorageErr const err = create_task_instance_impl(
+                    static_cast<MySqlConnection&>(conn),
+                    instance,
+                    std::nullopt
+            );
+            if (err.success()) {
+                created_instances.push_back(instance);
+            }
         }
-        // Set the task state to running
-        std::unique_ptr<sql::PreparedStatement> const running_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "UPDATE `tasks` SET `state` = 'running' WHERE `id` = ?"
-                )
-        );
-        running_statement->setBytes(1, &id_bytes);
-        running_statement->executeUpdate();
-        // Insert task instance
-        std::unique_ptr<sql::PreparedStatement> const instance_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "INSERT INTO `task_instances` (`id`, `task_id`, `start_time`) VALUES(?, ?, "
-                        "CURRENT_TIMESTAMP())"
-                )
-        );
-        sql::bytes instance_id_bytes = uuid_get_bytes(instance.id);
-        instance_statement->setBytes(1, &instance_id_bytes);
-        instance_statement->setBytes(2, &id_bytes);
-        instance_statement->executeUpdate();
-        // Remove task from scheduler leases
-        std::unique_ptr<sql::PreparedStatement> const lease_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "DELETE FROM `scheduler_leases` WHERE `task_id` = ?"
+    } catch (sql::SQLException& e) {
+        static_cast<MySqlConnection&>(conn)->rollback();
+        if (e.getErrorCode() == ErDeadLock) {
+            return StorageErr{StorageErrType::DeadLockErr, e.what()};
+        }
+        return StorageErr{StorageErrType::OtherErr, e.what()};
+    }
+
+    static_cast<MySqlConnection&>(conn)->commit();
+    *created = std::move(created_instances);
+    return StorageErr{};
+}
+
+auto MySqlMetadataStorage::start_task_instances(
+        StorageConnection& conn,
+        boost::uuids::uuid const worker_id,
+        std::vector<TaskInstance> const& instances,
+        std::vector<TaskInstance>* created,
+        std::vector<Task>* tasks
+) -> StorageErr {
+    std::vector<TaskInstance> created_instances;
+    std::vector<Task> created_tasks;
+    created_instances.reserve(instances.size());
+    created_tasks.reserve(instances.size());
+    try {
+        MySqlConnection::CachedStatement task_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "SELECT `id`, `func_name`, `language`, `state`, `timeout` FROM `tasks` "
+                        "WHERE `id` = ?"
                 )
         );
-        lease_statement->setBytes(1, &id_bytes);
-        lease_statement->executeUpdate();
+        for (TaskInstance const& instance : instances) {
+            StorageErr const err = create_task_instance_impl(
+                    static_cast<MySqlConnection&>(conn),
+                    instance,
+                    worker_id
+            );
+            if (!err.success()) {
+                continue;
+            }
+            sql::bytes id_bytes = uuid_get_bytes(instance.task_id);
+            task_statement->setBytes(1, &id_bytes);
+            std::unique_ptr<sql::ResultSet> const res(task_statement->executeQuery());
+            if (false == res->next()) {
+                static_cast<MySqlConnection&>(conn)->rollback();
+                return StorageErr{
+                        StorageErrType::KeyNotFoundErr,
+                        fmt::format("no task with id {}", boost::uuids::to_string(instance.task_id))
+                };
+            }
+            auto fetch_task_result = fetch_full_task(static_cast<MySqlConnection&>(conn), res);
+            if (fetch_task_result.has_error()) {
+                static_cast<MySqlConnection&>(conn)->rollback();
+                return StorageErr{fetch_task_result.error(), "Failed to fetch full task"};
+            }
+            created_instances.push_back(instance);
+            created_tasks.push_back(std::move(fetch_task_result.value()));
+        }
     } catch (sql::SQLException& e) {
         static_cast<MySqlConnection&>(conn)->rollback();
+        if (e.getErrorCode() == ErDeadLock) {
+            return StorageErr{StorageErrType::DeadLockErr, e.what()};
+        }
         return StorageErr{StorageErrType::OtherErr, e.what()};
     }
 
     static_cast<MySqlConnection&>(conn)->commit();
+    *created = std::move(created_instances);
+    *tasks = std::move(created_tasks);
+    return StorageErr{};
+}
+
+auto MySqlMetadataStorage::create_task_instance_impl(
+        MySqlConnection& conn,
+        TaskInstance const& instance,
+        std::optional<boost::uuids::uuid> const& worker_id
+) -> StorageErr {
+    // Check the state of the task
+    MySqlConnection::CachedStatement state_statement(
+            conn.prepare_statement("SELECT `state` FROM `tasks` WHERE `id` = ?")
+    );
+    sql::bytes id_bytes = uuid_get_bytes(instance.task_id);
+    state_statement->setBytes(1, &id_bytes);
+    std::unique_ptr<sql::ResultSet> const state_res(state_statement->executeQuery());
+    if (false == state_res->next()) {
+        return StorageErr{StorageErrType::KeyNotFoundErr, "Task not found"};
+    }
+    TaskState const task_state = string_to_task_state(get_sql_string(state_res->getString(1)));
+    bool const task_ready = TaskState::Ready == task_state;
+    // Check all task instances of a running task have timed out
+    MySqlConnection::CachedStatement not_timeout_statement(conn.prepare_statement(
+            "SELECT `t1`.`id` FROM `task_instances` as `t1` JOIN `tasks` ON "
+            "`t1`.`task_id` = `tasks`.`id` WHERE `t1`.`task_id` = ? AND "
+            "(`tasks`.`timeout` < 0.0001 OR TIMESTAMPDIFF(MICROSECOND, "
+            "`t1`.`start_time`, CURRENT_TIMESTAMP()) < `tasks`.`timeout` * 1000)"
+    ));
+    not_timeout_statement->setBytes(1, &id_bytes);
+    std::unique_ptr<sql::ResultSet> const not_timeout_res(not_timeout_statement->executeQuery());
+    bool const all_timeout
+            = TaskState::Running == task_state && not_timeout_res->rowsCount() == 0;
+    if (!task_ready && !all_timeout) {
+        return StorageErr{StorageErrType::OtherErr, "Task not ready or timed out"};
+    }
+    // Check the job state
+    MySqlConnection::CachedStatement job_statement(conn.prepare_statement(
+            "SELECT `state` FROM `jobs` WHERE `id` = (SELECT `job_id` FROM "
+            "`tasks` WHERE `id` = ?)"
+    ));
+    job_statement->setBytes(1, &id_bytes);
+    std::unique_ptr<sql::ResultSet> const job_res(job_statement->executeQuery());
+    if (job_res->rowsCount() == 0) {
+        return StorageErr{StorageErrType::KeyNotFoundErr, "Job not found"};
+    }
+    job_res->next();
+    std::string const job_state = get_sql_string(job_res->getString("state"));
+    if (job_state != "running") {
+        return StorageErr{StorageErrType::OtherErr, "Job state wrong"};
+    }
+    // Set the task state to running
+    MySqlConnection::CachedStatement const running_statement(
+            conn.prepare_statement("UPDATE `tasks` SET `state` = 'running' WHERE `id` = ?")
+    );
+    running_statement->setBytes(1, &id_bytes);
+    running_statement->executeUpdate();
+    // Insert task instance
+    MySqlConnection::CachedStatement const instance_statement(conn.prepare_statement(
+            "INSERT INTO `task_instances` (`id`, `task_id`, `worker_id`, `start_time`) VALUES(?, "
+            "?, ?, CURRENT_TIMESTAMP())"
+    ));
+    sql::bytes instance_id_bytes = uuid_get_bytes(instance.id);
+    instance_statement->setBytes(1, &instance_id_bytes);
+    instance_statement->setBytes(2, &id_bytes);
+    sql::bytes worker_id_bytes;
+    if (worker_id.has_value()) {
+        worker_id_bytes = uuid_get_bytes(worker_id.value());
+        instance_statement->setBytes(3, &worker_id_bytes);
+    } else {
+        instance_statement->setNull(3, sql::DataType::BINARY);
+    }
+    instance_statement->executeUpdate();
+    // Remove task from scheduler leases
+    MySqlConnection::CachedStatement const lease_statement(
+            conn.prepare_statement("DELETE FROM `scheduler_leases` WHERE `task_id` = ?")
+    );
+    lease_statement->setBytes(1, &id_bytes);
+    lease_statement->executeUpdate();
     return StorageErr{};
 }
 
@@ -1628,8 +2157,8 @@ auto MySqlMetadataStorage::task_finish(
 ) -> StorageErr {
     try {
         // Try to submit task instance
-        std::unique_ptr<sql::PreparedStatement> const statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "UPDATE `tasks` SET `instance_id` = ?, `state` = 'success' WHERE `id` = ? "
                         "AND `instance_id` is NULL AND `state` = 'running'"
                 )
@@ -1644,17 +2173,26 @@ auto MySqlMetadataStorage::task_finish(
             return StorageErr{};
         }
 
+        // Values too large for the `value` columns are stored as data
+        std::vector<std::optional<boost::uuids::uuid>> const value_data_ids
+                = insert_output_value_data(
+                        static_cast<MySqlConnection&>(conn),
+                        &task_id_bytes,
+                        outputs
+                );
+
         // Update task outputs
-        std::unique_ptr<sql::PreparedStatement> output_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "UPDATE `task_outputs` SET `value` = ?, `data_id` = ? WHERE `task_id` = ? "
-                        "AND `position` = ?"
+        MySqlConnection::CachedStatement output_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `task_outputs` SET `value` = ?, `data_id` = ?, `value_data_id` = ? "
+                        "WHERE `task_id` = ? AND `position` = ?"
                 )
         );
+        // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
         for (size_t i = 0; i < outputs.size(); ++i) {
             TaskOutput const& output = outputs[i];
             std::optional<std::string> const& value = output.get_value();
-            if (value.has_value()) {
+            if (value.has_value() && false == value_data_ids[i].has_value()) {
                 output_statement->setString(1, value.value());
             } else {
                 output_statement->setNull(1, sql::DataType::VARCHAR);
@@ -1666,22 +2204,30 @@ auto MySqlMetadataStorage::task_finish(
             } else {
                 output_statement->setNull(2, sql::DataType::BINARY);
             }
-            output_statement->setBytes(3, &task_id_bytes);
-            output_statement->setUInt(4, i);
+            if (value_data_ids[i].has_value()) {
+                sql::bytes value_data_id_bytes = uuid_get_bytes(value_data_ids[i].value());
+                output_statement->setBytes(3, &value_data_id_bytes);
+            } else {
+                output_statement->setNull(3, sql::DataType::BINARY);
+            }
+            output_statement->setBytes(4, &task_id_bytes);
+            output_statement->setUInt(5, i);
             output_statement->executeUpdate();
         }
+        // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 
         // Update task inputs
-        std::unique_ptr<sql::PreparedStatement> input_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "UPDATE `task_inputs` SET `value` = ?, `data_id` = ? WHERE "
-                        "`output_task_id` = ? AND `output_task_position` = ?"
+        MySqlConnection::CachedStatement input_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `task_inputs` SET `value` = ?, `data_id` = ?, `value_data_id` = ? "
+                        "WHERE `output_task_id` = ? AND `output_task_position` = ?"
                 )
         );
+        // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
         for (size_t i = 0; i < outputs.size(); ++i) {
             TaskOutput const& output = outputs[i];
             std::optional<std::string> const& value = output.get_value();
-            if (value.has_value()) {
+            if (value.has_value() && false == value_data_ids[i].has_value()) {
                 input_statement->setString(1, value.value());
             } else {
                 input_statement->setNull(1, sql::DataType::VARCHAR);
@@ -1693,35 +2239,232 @@ auto MySqlMetadataStorage::task_finish(
             } else {
                 input_statement->setNull(2, sql::DataType::BINARY);
             }
-            input_statement->setBytes(3, &task_id_bytes);
-            input_statement->setUInt(4, i);
+            if (value_data_ids[i].has_value()) {
+                sql::bytes value_data_id_bytes = uuid_get_bytes(value_data_ids[i].value());
+                input_statement->setBytes(3, &value_data_id_bytes);
+            } else {
+                input_statement->setNull(3, sql::DataType::BINARY);
+            }
+            input_statement->setBytes(4, &task_id_bytes);
+            input_statement->setUInt(5, i);
             input_statement->executeUpdate();
         }
+        // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 
+        // Count down the inputs the children wait for
+        MySqlConnection::CachedStatement const remaining_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `tasks` JOIN (SELECT `task_id`, COUNT(*) AS `num_inputs` FROM "
+                        "`task_inputs` WHERE `output_task_id` = ? GROUP BY `task_id`) AS "
+                        "`consumed` ON `tasks`.`id` = `consumed`.`task_id` SET "
+                        "`tasks`.`remaining_inputs` = `tasks`.`remaining_inputs` - "
+                        "`consumed`.`num_inputs`"
+                )
+        );
+        remaining_statement->setBytes(1, &task_id_bytes);
+        remaining_statement->executeUpdate();
         // Set task states to ready if all inputs are available
-        std::unique_ptr<sql::PreparedStatement> ready_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement ready_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "UPDATE `tasks` SET `state` = 'ready' WHERE `id` IN (SELECT `task_id` FROM "
-                        "`task_inputs` WHERE `output_task_id` = ?) AND `state` = 'pending' AND NOT "
-                        "EXISTS (SELECT `task_id` FROM `task_inputs` WHERE `task_id` IN (SELECT "
-                        "`task_id` FROM `task_inputs` WHERE `output_task_id` = ?) AND `value` IS "
-                        "NULL AND `data_id` IS NULL)"
+                        "`task_inputs` WHERE `output_task_id` = ?) AND `state` = 'pending' AND "
+                        "`remaining_inputs` = 0"
                 )
         );
         ready_statement->setBytes(1, &task_id_bytes);
-        ready_statement->setBytes(2, &task_id_bytes);
         ready_statement->executeUpdate();
         // If all tasks in the job finishes, set the job state to success
-        std::unique_ptr<sql::PreparedStatement> job_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const job_remaining_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `jobs` SET `remaining_tasks` = `remaining_tasks` - 1 WHERE `id` = "
+                        "(SELECT `job_id` FROM `tasks` WHERE `id` = ?)"
+                )
+        );
+        job_remaining_statement->setBytes(1, &task_id_bytes);
+        job_remaining_statement->executeUpdate();
+        MySqlConnection::CachedStatement job_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "UPDATE `jobs` SET `state` = 'success' WHERE `id` = (SELECT `job_id` FROM "
-                        "`tasks` WHERE `id` = ?) AND NOT EXISTS (SELECT `job_id` FROM `tasks` "
-                        "WHERE `job_id` = (SELECT `job_id` FROM `tasks` WHERE `id` = ?) AND "
-                        "`state` != 'success') AND `state` = 'running'"
+                        "`tasks` WHERE `id` = ?) AND `remaining_tasks` = 0 AND `state` = "
+                        "'running'"
                 )
         );
         job_statement->setBytes(1, &task_id_bytes);
-        job_statement->setBytes(2, &task_id_bytes);
+        job_statement->executeUpdate();
+    } catch (sql::SQLException& e) {
+        static_cast<MySqlConnection&>(conn)->rollback();
+        if (e.getErrorCode() == ErDupKey || e.getErrorCode() == ErDupEntry) {
+            return StorageErr{StorageErrType::DuplicateKeyErr, e.what()};
+        }
+        if (e.getErrorCode() == ErDeadLock) {
+            return StorageErr{StorageErrType::DeadLockErr, e.what()};
+        }
+        return StorageErr{StorageErrType::OtherErr, e.what()};
+    }
+    static_cast<MySqlConnection&>(conn)->commit();
+    return StorageErr{};
+}
+
+auto MySqlMetadataStorage::task_finish_batch(
+        StorageConnection& conn,
+        std::vector<TaskInstance> const& instances,
+        std::vector<std::vector<TaskOutput>> const& outputs
+) -> StorageErr {
+    if (instances.size() != outputs.size()) {
+        return StorageErr{
+                StorageErrType::OtherErr,
+                "Number of task instances and task outputs mismatch"
+        };
+    }
+    if (instances.empty()) {
+        return StorageErr{};
+    }
+
+    // Lock the tasks in the same order in every batch to avoid deadlocks between workers
+    std::vector<std::size_t> order(instances.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [&](std::size_t const lhs, std::size_t const rhs) {
+        return instances[lhs].task_id < instances[rhs].task_id;
+    });
+
+    try {
+        // Try to submit task instances
+        MySqlConnection::CachedStatement const statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `tasks` SET `instance_id` = ?, `state` = 'success' WHERE `id` = ? "
+                        "AND `instance_id` is NULL AND `state` = 'running'"
+                )
+        );
+        // Update task outputs
+        MySqlConnection::CachedStatement output_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "UPDATE `task_outputs` SET `value` = ?, `data_id` = ?, `value_data_id` = ? "
+                        "WHERE `task_id` = ? AND `position` = ?"
+                )
+        );
+        std::vector<sql::bytes> finished_id_bytes;
+        for (std::size_t const index : order) {
+            sql::bytes id_bytes = uuid_get_bytes(instances[index].id);
+            sql::bytes task_id_bytes = uuid_get_bytes(instances[index].task_id);
+            statement->setBytes(1, &id_bytes);
+            statement->setBytes(2, &task_id_bytes);
+            if (0 == statement->executeUpdate()) {
+                continue;
+            }
+
+            std::vector<TaskOutput> const& task_outputs = outputs[index];
+            // Values too large for the `value` columns are stored as data
+            std::vector<std::optional<boost::uuids::uuid>> const value_data_ids
+                    = insert_output_value_data(
+                            static_cast<MySqlConnection&>(conn),
+                            &task_id_bytes,
+                            task_outputs
+                    );
+            // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            for (size_t i = 0; i < task_outputs.size(); ++i) {
+                TaskOutput const& output = task_outputs[i];
+                std::optional<std::string> const& value = output.get_value();
+                if (value.has_value() && false == value_data_ids[i].has_value()) {
+                    output_statement->setString(1, value.value());
+                } else {
+                    output_statement->setNull(1, sql::DataType::VARCHAR);
+                }
+                std::optional<boost::uuids::uuid> const& data_id = output.get_data_id();
+                sql::bytes data_id_bytes;
+                if (data_id.has_value()) {
+                    data_id_bytes = uuid_get_bytes(data_id.value());
+                    output_statement->setBytes(2, &data_id_bytes);
+                } else {
+                    output_statement->setNull(2, sql::DataType::BINARY);
+                }
+                sql::bytes value_data_id_bytes;
+                if (value_data_ids[i].has_value()) {
+                    value_data_id_bytes = uuid_get_bytes(value_data_ids[i].value());
+                    output_statement->setBytes(3, &value_data_id_bytes);
+                } else {
+                    output_statement->setNull(3, sql::DataType::BINARY);
+                }
+                output_statement->setBytes(4, &task_id_bytes);
+                output_statement->setUInt(5, i);
+                output_statement->executeUpdate();
+            }
+            // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            finished_id_bytes.push_back(std::move(task_id_bytes));
+        }
+        if (finished_id_bytes.empty()) {
+            static_cast<MySqlConnection&>(conn)->commit();
+            return StorageErr{};
+        }
+
+        std::string const placeholders = get_placeholders(finished_id_bytes.size());
+        auto const bind_finished_ids = [&](sql::PreparedStatement& batch_statement) {
+            for (std::size_t i = 0; i < finished_id_bytes.size(); ++i) {
+                batch_statement.setBytes(static_cast<std::int32_t>(i + 1), &finished_id_bytes[i]);
+            }
+        };
+
+        // Update the task inputs consuming the outputs of all finished tasks at once
+        MySqlConnection::CachedStatement const input_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(fmt::format(
+                        "UPDATE `task_inputs` JOIN `task_outputs` ON `task_inputs`.`output_task_id` "
+                        "= `task_outputs`.`task_id` AND `task_inputs`.`output_task_position` = "
+                        "`task_outputs`.`position` SET `task_inputs`.`value` = "
+                        "`task_outputs`.`value`, `task_inputs`.`data_id` = "
+                        "`task_outputs`.`data_id`, `task_inputs`.`value_data_id` = "
+                        "`task_outputs`.`value_data_id` WHERE `task_outputs`.`task_id` IN ({})",
+                        placeholders
+                ))
+        );
+        bind_finished_ids(*input_statement);
+        input_statement->executeUpdate();
+
+        // Count down the inputs the children wait for
+        MySqlConnection::CachedStatement const remaining_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(fmt::format(
+                        "UPDATE `tasks` JOIN (SELECT `task_id`, COUNT(*) AS `num_inputs` FROM "
+                        "`task_inputs` WHERE `output_task_id` IN ({}) GROUP BY `task_id`) AS "
+                        "`consumed` ON `tasks`.`id` = `consumed`.`task_id` SET "
+                        "`tasks`.`remaining_inputs` = `tasks`.`remaining_inputs` - "
+                        "`consumed`.`num_inputs`",
+                        placeholders
+                ))
+        );
+        bind_finished_ids(*remaining_statement);
+        remaining_statement->executeUpdate();
+
+        // Set task states to ready if all inputs are available
+        MySqlConnection::CachedStatement const ready_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(fmt::format(
+                        "UPDATE `tasks` SET `state` = 'ready' WHERE `id` IN (SELECT `task_id` FROM "
+                        "`task_inputs` WHERE `output_task_id` IN ({})) AND `state` = 'pending' AND "
+                        "`remaining_inputs` = 0",
+                        placeholders
+                ))
+        );
+        bind_finished_ids(*ready_statement);
+        ready_statement->executeUpdate();
+
+        // If all tasks in a job finishes, set the job state to success
+        MySqlConnection::CachedStatement const job_remaining_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(fmt::format(
+                        "UPDATE `jobs` JOIN (SELECT `job_id`, COUNT(*) AS `num_tasks` FROM "
+                        "`tasks` WHERE `id` IN ({}) GROUP BY `job_id`) AS `finished` ON "
+                        "`jobs`.`id` = `finished`.`job_id` SET `jobs`.`remaining_tasks` = "
+                        "`jobs`.`remaining_tasks` - `finished`.`num_tasks`",
+                        placeholders
+                ))
+        );
+        bind_finished_ids(*job_remaining_statement);
+        job_remaining_statement->executeUpdate();
+        MySqlConnection::CachedStatement const job_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(fmt::format(
+                        "UPDATE `jobs` SET `state` = 'success' WHERE `id` IN (SELECT `job_id` FROM "
+                        "`tasks` WHERE `id` IN ({})) AND `remaining_tasks` = 0 AND `state` = "
+                        "'running'",
+                        placeholders
+                ))
+        );
+        bind_finished_ids(*job_statement);
         job_statement->executeUpdate();
     } catch (sql::SQLException& e) {
         static_cast<MySqlConnection&>(conn)->rollback();
@@ -1744,8 +2487,8 @@ auto MySqlMetadataStorage::task_fail(
 ) -> StorageErr {
     try {
         // Remove task instance
-        std::unique_ptr<sql::PreparedStatement> const statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "DELETE FROM `task_instances` WHERE `id` = ?"
                 )
         );
@@ -1754,8 +2497,8 @@ auto MySqlMetadataStorage::task_fail(
         statement->executeUpdate();
 
         // Get number of remaining instances
-        std::unique_ptr<sql::PreparedStatement> const count_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const count_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT COUNT(*) FROM `task_instances` WHERE `task_id` = ?"
                 )
         );
@@ -1766,16 +2509,16 @@ auto MySqlMetadataStorage::task_fail(
         int32_t const count = count_res->getInt(1);
         if (count == 0) {
             // Set the task fail if the last task instance fails
-            std::unique_ptr<sql::PreparedStatement> const task_statement(
-                    static_cast<MySqlConnection&>(conn)->prepareStatement(
+            MySqlConnection::CachedStatement const task_statement(
+                    static_cast<MySqlConnection&>(conn).prepare_statement(
                             "UPDATE `tasks` SET `state` = 'fail' WHERE `id` = ?"
                     )
             );
             task_statement->setBytes(1, &task_id_bytes);
             task_statement->executeUpdate();
             // Set the job fails
-            std::unique_ptr<sql::PreparedStatement> const job_statement(
-                    static_cast<MySqlConnection&>(conn)->prepareStatement(
+            MySqlConnection::CachedStatement const job_statement(
+                    static_cast<MySqlConnection&>(conn).prepare_statement(
                             "UPDATE `jobs` SET `state` = 'fail' WHERE `id` = (SELECT `job_id` FROM "
                             "`tasks` WHERE `id` = ?)"
                     )
@@ -1832,7 +2575,8 @@ auto MySqlMetadataStorage::get_task_timeout(
                 static_cast<MySqlConnection&>(conn)->createStatement()
         };
         std::unique_ptr<sql::ResultSet> const job_res{job_statement->executeQuery(
-                "SELECT `jobs`.`id`, `jobs`.`client_id`, `jobs`.`creation_time` FROM `jobs` JOIN "
+                "SELECT `jobs`.`id`, `jobs`.`client_id`, `jobs`.`creation_time`, "
+                "`jobs`.`priority` FROM `jobs` JOIN "
                 "`tasks` ON `jobs`.`id` = `tasks`.`job_id` WHERE `tasks`.`id` IN (SELECT "
                 "`tasks`.`id` FROM `task_instances` JOIN `tasks` ON `task_instances`.`task_id` = "
                 "`tasks`.`id` WHERE `tasks`.`timeout` > 0.0001 AND `tasks`.`state` = 'running' AND "
@@ -1847,6 +2591,7 @@ auto MySqlMetadataStorage::get_task_timeout(
         while (job_res->next()) {
             boost::uuids::uuid const job_id = read_id(job_res->getBinaryStream("id"));
             boost::uuids::uuid const client_id = read_id(job_res->getBinaryStream("client_id"));
+            std::int32_t const priority = job_res->getInt("priority");
             std::optional<std::chrono::system_clock::time_point> const optional_creation_time
                     = parse_timestamp(get_sql_string(job_res->getString("creation_time")));
             if (false == optional_creation_time.has_value()) {
@@ -1862,6 +2607,7 @@ auto MySqlMetadataStorage::get_task_timeout(
             for (boost::uuids::uuid const& task_id : job_id_to_task_ids[job_id]) {
                 new_tasks[task_id].set_client_id(client_id);
                 new_tasks[task_id].set_job_creation_time(optional_creation_time.value());
+                new_tasks[task_id].set_job_priority(priority);
             }
         }
 
@@ -1918,8 +2664,8 @@ auto MySqlMetadataStorage::get_child_tasks(
         std::vector<Task>* children
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `id`, `func_name`, `language`, `state`, `timeout` FROM `tasks` "
                         "JOIN "
                         "`task_dependencies` as `t2` WHERE `tasks`.`id` = `t2`.`child` AND "
@@ -1954,8 +2700,8 @@ auto MySqlMetadataStorage::get_parent_tasks(
         std::vector<Task>* tasks
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `id`, `func_name`, `language`, `state`, `timeout` FROM `tasks` "
                         "JOIN "
                         "`task_dependencies` as `t2` WHERE `tasks`.`id` = `t2`.`parent` AND "
@@ -1987,8 +2733,8 @@ auto MySqlMetadataStorage::get_parent_tasks(
 auto MySqlMetadataStorage::update_heartbeat(StorageConnection& conn, boost::uuids::uuid id)
         -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "UPDATE `drivers` SET `heartbeat` = CURRENT_TIMESTAMP() WHERE `id` = ?"
                 )
         );
@@ -2005,6 +2751,78 @@ auto MySqlMetadataStorage::update_heartbeat(StorageConnection& conn, boost::uuid
 
 namespace {
 constexpr int cMillisecondToMicrosecond = 1000;
+
+/**
+ * Removes task instances and sets their running tasks without any other instance back to ready.
+ * Must be called inside a transaction, which is left open.
+ *
+ * @param conn
+ * @param instance_id_bytes
+ * @param task_ids Returns the tasks set back to ready.
+ * @throw sql::SQLException if a statement fails.
+ */
+auto remove_instances_and_ready_tasks(
+        MySqlConnection& conn,
+        std::vector<sql::bytes>* instance_id_bytes,
+        std::vector<boost::uuids::uuid>* task_ids
+) -> void {
+    if (instance_id_bytes->empty()) {
+        return;
+    }
+    std::string const instance_placeholders = get_placeholders(instance_id_bytes->size());
+    MySqlConnection::CachedStatement task_statement{conn.prepare_statement(fmt::format(
+            "SELECT DISTINCT `task_id` FROM `task_instances` WHERE `id` IN ({}) FOR UPDATE",
+            instance_placeholders
+    ))};
+    MySqlConnection::CachedStatement delete_statement{conn.prepare_statement(fmt::format(
+            "DELETE FROM `task_instances` WHERE `id` IN ({})",
+            instance_placeholders
+    ))};
+    for (std::size_t i = 0; i < instance_id_bytes->size(); ++i) {
+        auto const index = static_cast<std::int32_t>(i + 1);
+        task_statement->setBytes(index, &(*instance_id_bytes)[i]);
+        delete_statement->setBytes(index, &(*instance_id_bytes)[i]);
+    }
+    std::unique_ptr<sql::ResultSet> const task_res{task_statement->executeQuery()};
+    std::vector<sql::bytes> candidate_id_bytes;
+    while (task_res->next()) {
+        candidate_id_bytes.push_back(uuid_get_bytes(read_id(task_res->getBinaryStream("task_id"))));
+    }
+    if (candidate_id_bytes.empty()) {
+        return;
+    }
+    delete_statement->executeUpdate();
+
+    // Tasks still running on another instance, e.g. a retry after a timeout, are left alone. The
+    // selected tasks are locked, so exactly these are set back to ready.
+    MySqlConnection::CachedStatement ready_task_statement{conn.prepare_statement(fmt::format(
+            "SELECT `id` FROM `tasks` WHERE `id` IN ({}) AND `state` = 'running' AND NOT EXISTS "
+            "(SELECT 1 FROM `task_instances` WHERE `task_instances`.`task_id` = `tasks`.`id`) "
+            "FOR UPDATE",
+            get_placeholders(candidate_id_bytes.size())
+    ))};
+    for (std::size_t i = 0; i < candidate_id_bytes.size(); ++i) {
+        ready_task_statement->setBytes(static_cast<std::int32_t>(i + 1), &candidate_id_bytes[i]);
+    }
+    std::unique_ptr<sql::ResultSet> const ready_res{ready_task_statement->executeQuery()};
+    std::vector<sql::bytes> ready_id_bytes;
+    while (ready_res->next()) {
+        boost::uuids::uuid const task_id = read_id(ready_res->getBinaryStream("id"));
+        task_ids->push_back(task_id);
+        ready_id_bytes.push_back(uuid_get_bytes(task_id));
+    }
+    if (ready_id_bytes.empty()) {
+        return;
+    }
+    MySqlConnection::CachedStatement ready_statement{conn.prepare_statement(fmt::format(
+            "UPDATE `tasks` SET `state` = 'ready' WHERE `id` IN ({})",
+            get_placeholders(ready_id_bytes.size())
+    ))};
+    for (std::size_t i = 0; i < ready_id_bytes.size(); ++i) {
+        ready_statement->setBytes(static_cast<std::int32_t>(i + 1), &ready_id_bytes[i]);
+    }
+    ready_statement->executeUpdate();
+}
 }  // namespace
 
 auto MySqlMetadataStorage::heartbeat_timeout(
@@ -2013,8 +2831,8 @@ auto MySqlMetadataStorage::heartbeat_timeout(
         std::vector<boost::uuids::uuid>* ids
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `id` FROM `drivers` WHERE TIMESTAMPDIFF(MICROSECOND, `heartbeat`, "
                         "CURRENT_TIMESTAMP()) > ?"
                 )
@@ -2032,6 +2850,105 @@ auto MySqlMetadataStorage::heartbeat_timeout(
     return StorageErr{};
 }
 
+auto MySqlMetadataStorage::recover_dead_worker_tasks(
+        StorageConnection& conn,
+        double const timeout,
+        std::vector<boost::uuids::uuid>* task_ids
+) -> StorageErr {
+    std::vector<boost::uuids::uuid> recovered_task_ids;
+    try {
+        // Lock the instances of workers without a recent heartbeat, including removed workers, so
+        // that exactly these instances are removed
+        MySqlConnection::CachedStatement instance_statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "SELECT `task_instances`.`id` FROM `task_instances` LEFT JOIN `drivers` ON "
+                        "`task_instances`.`worker_id` = `drivers`.`id` WHERE "
+                        "`task_instances`.`worker_id` IS NOT NULL AND (`drivers`.`id` IS NULL OR "
+                        "TIMESTAMPDIFF(MICROSECOND, `drivers`.`heartbeat`, CURRENT_TIMESTAMP()) > "
+                        "?) FOR UPDATE"
+                )
+        };
+        instance_statement->setDouble(1, timeout * cMillisecondToMicrosecond);
+        std::unique_ptr<sql::ResultSet> const instance_res{instance_statement->executeQuery()};
+        std::vector<sql::bytes> instance_id_bytes;
+        while (instance_res->next()) {
+            instance_id_bytes.push_back(
+                    uuid_get_bytes(read_id(instance_res->getBinaryStream("id")))
+            );
+        }
+
+        // Mark the instances as lost by removing them
+        remove_instances_and_ready_tasks(
+                static_cast<MySqlConnection&>(conn),
+                &instance_id_bytes,
+                &recovered_task_ids
+        );
+    } catch (sql::SQLException& e) {
+        static_cast<MySqlConnection&>(conn)->rollback();
+        if (e.getErrorCode() == ErDeadLock) {
+            return StorageErr{StorageErrType::DeadLockErr, e.what()};
+        }
+        return StorageErr{StorageErrType::OtherErr, e.what()};
+    }
+    static_cast<MySqlConnection&>(conn)->commit();
+    *task_ids = std::move(recovered_task_ids);
+    return StorageErr{};
+}
+
+auto MySqlMetadataStorage::remove_task_instances(
+        StorageConnection& conn,
+        std::vector<TaskInstance> const& instances,
+        std::vector<boost::uuids::uuid>* task_ids
+) -> StorageErr {
+    std::vector<boost::uuids::uuid> ready_task_ids;
+    try {
+        std::vector<sql::bytes> instance_id_bytes;
+        instance_id_bytes.reserve(instances.size());
+        for (TaskInstance const& instance : instances) {
+            instance_id_bytes.push_back(uuid_get_bytes(instance.id));
+        }
+        remove_instances_and_ready_tasks(
+                static_cast<MySqlConnection&>(conn),
+                &instance_id_bytes,
+                &ready_task_ids
+        );
+    } catch (sql::SQLException& e) {
+        static_cast<MySqlConnection&>(conn)->rollback();
+        if (e.getErrorCode() == ErDeadLock) {
+            return StorageErr{StorageErrType::DeadLockErr, e.what()};
+        }
+        return StorageErr{StorageErrType::OtherErr, e.what()};
+    }
+    static_cast<MySqlConnection&>(conn)->commit();
+    *task_ids = std::move(ready_task_ids);
+    return StorageErr{};
+}
+
+auto MySqlMetadataStorage::remove_stale_submitting_jobs(
+        StorageConnection& conn,
+        double const timeout
+) -> StorageErr {
+    try {
+        // Tasks and their inputs, outputs and instances are removed by cascade
+        MySqlConnection::CachedStatement statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "DELETE FROM `jobs` WHERE `state` = 'submitting' AND "
+                        "TIMESTAMPDIFF(MICROSECOND, `creation_time`, CURRENT_TIMESTAMP()) > ?"
+                )
+        };
+        statement->setDouble(1, timeout * cMillisecondToMicrosecond);
+        statement->executeUpdate();
+    } catch (sql::SQLException& e) {
+        static_cast<MySqlConnection&>(conn)->rollback();
+        if (e.getErrorCode() == ErDeadLock) {
+            return StorageErr{StorageErrType::DeadLockErr, e.what()};
+        }
+        return StorageErr{StorageErrType::OtherErr, e.what()};
+    }
+    static_cast<MySqlConnection&>(conn)->commit();
+    return StorageErr{};
+}
+
 auto MySqlMetadataStorage::get_scheduler_addr(
         StorageConnection& conn,
         boost::uuids::uuid id,
@@ -2039,8 +2956,8 @@ auto MySqlMetadataStorage::get_scheduler_addr(
         int* port
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `address`, `port` FROM `schedulers` WHERE `id` = ?"
                 )
         );
@@ -2089,30 +3006,10 @@ auto MySqlDataStorage::add_driver_data(
         Data const& data
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "INSERT INTO `data` (`id`, `value`, `hard_locality`) VALUES(?, ?, ?)"
-                )
-        );
+        add_data(conn, data);
         sql::bytes id_bytes = uuid_get_bytes(data.get_id());
-        statement->setBytes(1, &id_bytes);
-        statement->setString(2, data.get_value());
-        statement->setBoolean(3, data.is_hard_locality());
-        statement->executeUpdate();
-
-        for (std::string const& addr : data.get_locality()) {
-            std::unique_ptr<sql::PreparedStatement> locality_statement(
-                    static_cast<MySqlConnection&>(conn)->prepareStatement(
-                            "INSERT INTO `data_locality` (`id`, "
-                            "`address`) VALUES (?, ?)"
-                    )
-            );
-            locality_statement->setBytes(1, &id_bytes);
-            locality_statement->setString(2, addr);
-            locality_statement->executeUpdate();
-        }
-        std::unique_ptr<sql::PreparedStatement> driver_ref_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement driver_ref_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `data_ref_driver` (`id`, `driver_id`) VALUES(?, ?)"
                 )
         );
@@ -2137,29 +3034,10 @@ auto MySqlDataStorage::add_task_data(
         Data const& data
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
-                        "INSERT INTO `data` (`id`, `value`, `hard_locality`) VALUES(?, ?, ?)"
-                )
-        );
+        add_data(conn, data);
         sql::bytes id_bytes = uuid_get_bytes(data.get_id());
-        statement->setBytes(1, &id_bytes);
-        statement->setString(2, data.get_value());
-        statement->setBoolean(3, data.is_hard_locality());
-        statement->executeUpdate();
-
-        for (std::string const& addr : data.get_locality()) {
-            std::unique_ptr<sql::PreparedStatement> locality_statement(
-                    static_cast<MySqlConnection&>(conn)->prepareStatement(
-                            "INSERT INTO `data_locality` (`id`, `address`) VALUES (?, ?)"
-                    )
-            );
-            locality_statement->setBytes(1, &id_bytes);
-            locality_statement->setString(2, addr);
-            locality_statement->executeUpdate();
-        }
-        std::unique_ptr<sql::PreparedStatement> task_ref_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement task_ref_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `data_ref_task` (`id`, `task_id`) VALUES(?, ?)"
                 )
         );
@@ -2178,14 +3056,36 @@ auto MySqlDataStorage::add_task_data(
     return StorageErr{};
 }
 
+auto MySqlDataStorage::add_data(StorageConnection& conn, Data const& data) -> void {
+    sql::bytes id_bytes = uuid_get_bytes(data.get_id());
+    insert_data(
+            static_cast<MySqlConnection&>(conn),
+            &id_bytes,
+            data.get_value(),
+            data.is_hard_locality()
+    );
+
+    for (std::string const& addr : data.get_locality()) {
+        MySqlConnection::CachedStatement locality_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
+                        "INSERT INTO `data_locality` (`id`, `address`) VALUES (?, ?)"
+                )
+        );
+        locality_statement->setBytes(1, &id_bytes);
+        locality_statement->setString(2, addr);
+        locality_statement->executeUpdate();
+    }
+}
+
 auto MySqlDataStorage::get_data_with_locality(
         StorageConnection& conn,
         boost::uuids::uuid const id,
         Data* data
 ) -> StorageErr {
-    std::unique_ptr<sql::PreparedStatement> statement(
-            static_cast<MySqlConnection&>(conn)->prepareStatement(
-                    "SELECT `id`, `value`, `hard_locality` FROM `data` WHERE `id` = ?"
+    MySqlConnection::CachedStatement statement(
+            static_cast<MySqlConnection&>(conn).prepare_statement(
+                    "SELECT `id`, `value`, `hard_locality`, `size`, `num_chunks` FROM `data` "
+                    "WHERE `id` = ?"
             )
     );
     sql::bytes id_bytes = uuid_get_bytes(id);
@@ -2199,11 +3099,32 @@ auto MySqlDataStorage::get_data_with_locality(
         };
     }
     res->next();
-    *data = Data{id, get_sql_string(res->getString(2))};
+    std::uint32_t const num_chunks = res->getUInt(5);
+    if (0 == num_chunks) {
+        *data = Data{id, get_sql_string(res->getString(2))};
+    } else {
+        std::string value;
+        if (false
+            == read_data_chunks(
+                    static_cast<MySqlConnection&>(conn),
+                    &id_bytes,
+                    res->getUInt64(4),
+                    num_chunks,
+                    &value
+            ))
+        {
+            static_cast<MySqlConnection&>(conn)->rollback();
+            return StorageErr{
+                    StorageErrType::OtherErr,
+                    fmt::format("incomplete chunks of data with id {}", boost::uuids::to_string(id))
+            };
+        }
+        *data = Data{id, std::move(value)};
+    }
     data->set_hard_locality(res->getBoolean(3));
 
-    std::unique_ptr<sql::PreparedStatement> locality_statement(
-            static_cast<MySqlConnection&>(conn)->prepareStatement(
+    MySqlConnection::CachedStatement locality_statement(
+            static_cast<MySqlConnection&>(conn).prepare_statement(
                     "SELECT `address` FROM `data_locality` WHERE `id` = ?"
             )
     );
@@ -2246,8 +3167,8 @@ auto MySqlDataStorage::get_driver_data(
             return err;
         }
         // Add data reference from driver
-        std::unique_ptr<sql::PreparedStatement> statement{
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `data_ref_driver` (`id`, `driver_id`) VALUES (?, ?)"
                 )
         };
@@ -2276,8 +3197,8 @@ auto MySqlDataStorage::get_task_data(
             return err;
         }
         // Add data reference from task
-        std::unique_ptr<sql::PreparedStatement> statement{
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement{
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `data_ref_task` (`id`, `task_id`) VALUES (?, ?)"
                 )
         };
@@ -2296,16 +3217,16 @@ auto MySqlDataStorage::get_task_data(
 
 auto MySqlDataStorage::set_data_locality(StorageConnection& conn, Data const& data) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> const delete_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const delete_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "DELETE FROM `data_locality` WHERE `id` = ?"
                 )
         );
         sql::bytes id_bytes = uuid_get_bytes(data.get_id());
         delete_statement->setBytes(1, &id_bytes);
         delete_statement->executeUpdate();
-        std::unique_ptr<sql::PreparedStatement> const insert_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const insert_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `data_locality` (`id`, `address`) VALUES(?, ?)"
                 )
         );
@@ -2314,8 +3235,8 @@ auto MySqlDataStorage::set_data_locality(StorageConnection& conn, Data const& da
             insert_statement->setString(2, addr);
             insert_statement->executeUpdate();
         }
-        std::unique_ptr<sql::PreparedStatement> const hard_locality_statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement const hard_locality_statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "UPDATE `data` SET `hard_locality` = ? WHERE `id` = ?"
                 )
         );
@@ -2332,8 +3253,8 @@ auto MySqlDataStorage::set_data_locality(StorageConnection& conn, Data const& da
 
 auto MySqlDataStorage::remove_data(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "DELETE FROM `data` WHERE `id` = ?"
                 )
         );
@@ -2354,8 +3275,8 @@ auto MySqlDataStorage::add_task_reference(
         boost::uuids::uuid task_id
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `data_ref_task` (`id`, `task_id`) VALUES(?, ?)"
                 )
         );
@@ -2381,8 +3302,8 @@ auto MySqlDataStorage::remove_task_reference(
         boost::uuids::uuid task_id
 ) noexcept -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "DELETE FROM `data_ref_task` WHERE `id` = ? AND `task_id` = ?"
                 )
         );
@@ -2405,8 +3326,8 @@ auto MySqlDataStorage::add_driver_reference(
         boost::uuids::uuid driver_id
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `data_ref_driver` (`id`, `driver_id`) VALUES(?, ?)"
                 )
         );
@@ -2432,8 +3353,8 @@ auto MySqlDataStorage::remove_driver_reference(
         boost::uuids::uuid driver_id
 ) noexcept -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "DELETE FROM `data_ref_driver` WHERE `id` = ? AND `driver_id` = ?"
                 )
         );
@@ -2471,8 +3392,8 @@ auto MySqlDataStorage::remove_dangling_data(StorageConnection& conn) -> StorageE
 auto MySqlDataStorage::add_client_kv_data(StorageConnection& conn, KeyValueData const& data)
         -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `client_kv_data` (`kv_key`, `value`, `client_id`) VALUES(?, "
                         "?, ?)"
                 )
@@ -2496,8 +3417,8 @@ auto MySqlDataStorage::add_client_kv_data(StorageConnection& conn, KeyValueData
 auto MySqlDataStorage::add_task_kv_data(StorageConnection& conn, KeyValueData const& data)
         -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "INSERT INTO `task_kv_data` (`kv_key`, `value`, `task_id`) VALUES(?, ?, ?)"
                 )
         );
@@ -2524,8 +3445,8 @@ auto MySqlDataStorage::get_client_kv_data(
         std::string* value
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `value` FROM `client_kv_data` WHERE `client_id` = ? AND `kv_key` = "
                         "?"
                 )
@@ -2562,8 +3483,8 @@ auto MySqlDataStorage::get_task_kv_data(
         std::string* value
 ) -> StorageErr {
     try {
-        std::unique_ptr<sql::PreparedStatement> statement(
-                static_cast<MySqlConnection&>(conn)->prepareStatement(
+        MySqlConnection::CachedStatement statement(
+                static_cast<MySqlConnection&>(conn).prepare_statement(
                         "SELECT `value` FROM `task_kv_data` WHERE `task_id` = ? AND `kv_key` = ?"
                 )
         );
@@ -1,6 +1,8 @@
 #ifndef SPIDER_STORAGE_MYSQLSTORAGE_HPP
 #define SPIDER_STORAGE_MYSQLSTORAGE_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -44,18 +46,22 @@ public:
             -> StorageErr override;
     auto get_active_scheduler(StorageConnection& conn, std::vector<Scheduler>* schedulers)
             -> StorageErr override;
+    using MetadataStorage::add_job;
     auto add_job(
             StorageConnection& conn,
             boost::uuids::uuid job_id,
             boost::uuids::uuid client_id,
-            TaskGraph const& task_graph
+            TaskGraph const& task_graph,
+            std::int32_t priority
     ) -> StorageErr override;
+    using MetadataStorage::add_job_batch;
     auto add_job_batch(
             StorageConnection& conn,
             JobSubmissionBatch& batch,
             boost::uuids::uuid job_id,
             boost::uuids::uuid client_id,
-            TaskGraph const& task_graph
+            TaskGraph const& task_graph,
+            std::int32_t priority
     ) -> StorageErr override;
     auto get_job_metadata(StorageConnection& conn, boost::uuids::uuid id, JobMetadata* job)
             -> StorageErr override;
@@ -81,11 +87,17 @@ public:
             -> StorageErr override;
     auto get_task_job_id(StorageConnection& conn, boost::uuids::uuid id, boost::uuids::uuid* job_id)
             -> StorageErr override;
+    using MetadataStorage::get_ready_tasks;
     auto get_ready_tasks(
             StorageConnection& conn,
             boost::uuids::uuid scheduler_id,
+            std::optional<boost::uuids::uuid> const& client_id,
+            std::optional<boost::uuids::uuid> const& after_task_id,
+            std::size_t max_num_tasks,
             std::vector<ScheduleTaskMetadata>* tasks
     ) -> StorageErr override;
+    auto get_ready_clients(StorageConnection& conn, std::vector<boost::uuids::uuid>* ids)
+            -> StorageErr override;
     auto set_task_state(StorageConnection& conn, boost::uuids::uuid id, TaskState state)
             -> StorageErr override;
     auto set_task_running(StorageConnection& conn, boost::uuids::uuid id) -> StorageErr override;
@@ -93,11 +105,28 @@ public:
             -> StorageErr override;
     auto create_task_instance(StorageConnection& conn, TaskInstance const& instance)
             -> StorageErr override;
+    auto create_task_instances(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<TaskInstance>* created
+    ) -> StorageErr override;
+    auto start_task_instances(
+            StorageConnection& conn,
+            boost::uuids::uuid worker_id,
+            std::vector<TaskInstance> const& instances,
+            std::vector<TaskInstance>* created,
+            std::vector<Task>* tasks
+    ) -> StorageErr override;
     auto task_finish(
             StorageConnection& conn,
             TaskInstance const& instance,
             std::vector<TaskOutput> const& outputs
     ) -> StorageErr override;
+    auto task_finish_batch(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<std::vector<TaskOutput>> const& outputs
+    ) -> StorageErr override;
     auto task_fail(StorageConnection& conn, TaskInstance const& instance, std::string const& error)
             -> StorageErr override;
     auto get_task_timeout(StorageConnection& conn, std::vector<ScheduleTaskMetadata>* tasks)
@@ -111,6 +140,18 @@ public:
     auto
     heartbeat_timeout(StorageConnection& conn, double timeout, std::vector<boost::uuids::uuid>* ids)
             -> StorageErr override;
+    auto recover_dead_worker_tasks(
+            StorageConnection& conn,
+            double timeout,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> StorageErr override;
+    auto remove_task_instances(
+            StorageConnection& conn,
+            std::vector<TaskInstance> const& instances,
+            std::vector<boost::uuids::uuid>* task_ids
+    ) -> StorageErr override;
+    auto remove_stale_submitting_jobs(StorageConnection& conn, double timeout)
+            -> StorageErr override;
     auto
     get_scheduler_addr(StorageConnection& conn, boost::uuids::uuid id, std::string* addr, int* port)
             -> StorageErr override;
@@ -118,14 +159,30 @@ public:
 private:
     MySqlMetadataStorage() = default;
 
-    [[nodiscard]] static auto add_task(
+    /**
+     * Inserts the tasks of a job with their inputs, outputs and dependencies, and the input and
+     * output tasks of the job. Rows are inserted with multi-row statements sized to fit in a
+     * packet.
+     *
+     * @param conn
+     * @param job_id
+     * @param task_graph
+     * @param tasks The tasks of the graph to insert, in graph order.
+     * @param commit_chunks Whether to commit after each statement.
+     * @return A void result on success, or an error code indicating the failure:
+     * - StorageErrType::TaskLanguageErr if the language of a task is unknown.
+     * @throw sql::SQLException
+     */
+    [[nodiscard]] static auto insert_job_tasks(
             MySqlConnection& conn,
-            sql::bytes job_id,
-            Task const& task,
-            std::optional<TaskState> const& state
+            boost::uuids::uuid job_id,
+            TaskGraph const& task_graph,
+            std::vector<Task const*> const& tasks,
+            bool commit_chunks
     ) -> boost::outcome_v2::std_checked<void, StorageErrType>;
 
     [[nodiscard]] static auto add_task_batch(
+            MySqlConnection& conn,
             MySqlJobSubmissionBatch& batch,
             sql::bytes job_id,
             Task const& task,
@@ -136,6 +193,22 @@ private:
     fetch_full_task(MySqlConnection& conn, std::unique_ptr<sql::ResultSet> const& res)
             -> boost::outcome_v2::std_checked<Task, StorageErrType>;
 
+    /**
+     * Creates a task instance inside the current transaction without committing or rolling back.
+     * No change is made if an error is returned.
+     *
+     * @param conn
+     * @param instance
+     * @param worker_id The worker running the instance, if known.
+     * @return StorageErr::Success if the instance is created. Error types otherwise.
+     * @throw sql::SQLException
+     */
+    [[nodiscard]] static auto create_task_instance_impl(
+            MySqlConnection& conn,
+            TaskInstance const& instance,
+            std::optional<boost::uuids::uuid> const& worker_id
+    ) -> StorageErr;
+
     friend class MySqlStorageFactory;
 };
 
@@ -204,6 +277,15 @@ public:
     ) -> StorageErr override;
 
 private:
+    /**
+     * Adds the data and its locality. A value larger than the inline column is split into chunks.
+     *
+     * @param conn
+     * @param data
+     * @throw sql::SQLException
+     */
+    static auto add_data(StorageConnection& conn, Data const& data) -> void;
+
     static auto get_data_with_locality(StorageConnection& conn, boost::uuids::uuid id, Data* data)
             -> StorageErr;
 
@@ -1,5 +1,6 @@
 #include "MySqlStorageFactory.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <utility>
@@ -13,9 +14,15 @@
 #include <spider/storage/mysql/MySqlJobSubmissionBatch.hpp>
 #include <spider/storage/mysql/MySqlStorage.hpp>
 #include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 
 namespace spider::core {
-MySqlStorageFactory::MySqlStorageFactory(std::string url) : m_url{std::move(url)} {}
+MySqlStorageFactory::MySqlStorageFactory(std::string url, std::size_t const max_pool_size)
+        : m_url{std::move(url)},
+          m_connection_pool{std::make_shared<StorageConnectionPool>(
+                  [url = m_url] { return MySqlConnection::create(url); },
+                  max_pool_size
+          )} {}
 
 auto MySqlStorageFactory::provide_data_storage() -> std::unique_ptr<DataStorage> {
     return std::unique_ptr<DataStorage>(new MySqlDataStorage());
@@ -27,6 +34,18 @@ auto MySqlStorageFactory::provide_metadata_storage() -> std::unique_ptr<Metadata
 
 auto MySqlStorageFactory::provide_storage_connection()
         -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> {
+    std::variant<StorageConnectionPool::Lease, StorageErr> lease = m_connection_pool->acquire();
+    if (std::holds_alternative<StorageErr>(lease)) {
+        return std::get<StorageErr>(lease);
+    }
+    return std::unique_ptr<StorageConnection>(new MySqlConnection{
+            m_connection_pool,
+            std::move(std::get<StorageConnectionPool::Lease>(lease))
+    });
+}
+
+auto MySqlStorageFactory::create_storage_connection()
+        -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> {
     std::variant<std::unique_ptr<StorageConnection>, StorageErr> connection
             = MySqlConnection::create(m_url);
     if (std::holds_alternative<StorageErr>(connection)) {
@@ -1,6 +1,7 @@
 #ifndef SPIDER_STORAGE_MYSQLSTORAGEFACTORY_HPP
 #define SPIDER_STORAGE_MYSQLSTORAGEFACTORY_HPP
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <variant>
@@ -10,22 +11,33 @@
 #include <spider/storage/JobSubmissionBatch.hpp>
 #include <spider/storage/MetadataStorage.hpp>
 #include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 #include <spider/storage/StorageFactory.hpp>
 
 namespace spider::core {
 class MySqlStorageFactory : public StorageFactory {
 public:
-    explicit MySqlStorageFactory(std::string url);
+    static constexpr std::size_t cDefaultMaxPoolSize = 32;
+
+    /**
+     * @param url
+     * @param max_pool_size Maximum number of connections provided at once. Connections are pooled
+     * and reused once the provided connection is destroyed.
+     */
+    explicit MySqlStorageFactory(std::string url, std::size_t max_pool_size = cDefaultMaxPoolSize);
 
     auto provide_data_storage() -> std::unique_ptr<DataStorage> override;
     auto provide_metadata_storage() -> std::unique_ptr<MetadataStorage> override;
     auto provide_storage_connection()
             -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> override;
+    auto create_storage_connection()
+            -> std::variant<std::unique_ptr<StorageConnection>, StorageErr> override;
     auto provide_job_submission_batch(StorageConnection&)
             -> std::unique_ptr<JobSubmissionBatch> override;
 
 private:
     std::string m_url;
+    std::shared_ptr<StorageConnectionPool> m_connection_pool;
 };
 }  // namespace spider::core
 
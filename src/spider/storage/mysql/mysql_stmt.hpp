@@ -24,11 +24,14 @@ std::string const cCreateSchedulerTable = R"(CREATE TABLE IF NOT EXISTS `schedul
 std::string const cCreateJobTable = R"(CREATE TABLE IF NOT EXISTS jobs (
     `id` BINARY(16) NOT NULL,
     `client_id` BINARY(16) NOT NULL,
-    `creation_time` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
-    `state` ENUM('running', 'success', 'cancel', 'fail') NOT NULL DEFAULT 'running',
+    `creation_time` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    `state` ENUM('submitting', 'running', 'success', 'cancel', 'fail') NOT NULL DEFAULT 'running',
+    `priority` INT NOT NULL DEFAULT 0,
+    `remaining_tasks` INT UNSIGNED NOT NULL DEFAULT 0, -- Number of tasks not succeeded yet
     KEY (`client_id`) USING BTREE,
     INDEX idx_jobs_creation_time (`creation_time`),
     INDEX idx_jobs_state (`state`),
+    INDEX idx_jobs_state_priority (`state`, `priority`, `creation_time`),
     PRIMARY KEY (`id`)
 ))";
 
@@ -42,6 +45,7 @@ std::string const cCreateTaskTable = R"(CREATE TABLE IF NOT EXISTS tasks (
     `max_retry` INT UNSIGNED DEFAULT 0,
     `retry` INT UNSIGNED DEFAULT 0,
     `instance_id` BINARY(16),
+    `remaining_inputs` INT UNSIGNED NOT NULL DEFAULT 0, -- Inputs waiting for a parent output
     CONSTRAINT `task_job_id` FOREIGN KEY (`job_id`) REFERENCES `jobs` (`id`) ON UPDATE NO ACTION ON DELETE CASCADE,
     INDEX (`state`),
     INDEX (`func_name`),
@@ -76,9 +80,12 @@ std::string const cCreateTaskInputTable = R"(CREATE TABLE IF NOT EXISTS `task_in
     `output_task_position` INT UNSIGNED,
     `value` VARBINARY(999), -- Use VARBINARY for all types of values
     `data_id` BINARY(16),
+    `value_data_id` BINARY(16), -- Data holding a value too large for `value`
     CONSTRAINT `input_task_id` FOREIGN KEY (`task_id`) REFERENCES `tasks` (`id`) ON UPDATE NO ACTION ON DELETE CASCADE,
     CONSTRAINT `input_task_output_match` FOREIGN KEY (`output_task_id`, `output_task_position`) REFERENCES task_outputs (`task_id`, `position`) ON UPDATE NO ACTION ON DELETE SET NULL,
     CONSTRAINT `input_data_id` FOREIGN KEY (`data_id`) REFERENCES `data` (`id`) ON UPDATE NO ACTION ON DELETE NO ACTION,
+    CONSTRAINT `input_value_data_id` FOREIGN KEY (`value_data_id`) REFERENCES `data` (`id`) ON UPDATE NO ACTION ON DELETE NO ACTION,
+    INDEX idx_task_inputs_output_task (`output_task_id`, `output_task_position`),
     PRIMARY KEY (`task_id`, `position`)
 ))";
 
@@ -88,8 +95,10 @@ std::string const cCreateTaskOutputTable = R"(CREATE TABLE IF NOT EXISTS `task_o
     `type` VARCHAR(999) NOT NULL,
     `value` VARBINARY(999),
     `data_id` BINARY(16),
+    `value_data_id` BINARY(16), -- Data holding a value too large for `value`
     CONSTRAINT `output_task_id` FOREIGN KEY (`task_id`) REFERENCES `tasks` (`id`) ON UPDATE NO ACTION ON DELETE CASCADE,
     CONSTRAINT `output_data_id` FOREIGN KEY (`data_id`) REFERENCES `data` (`id`) ON UPDATE NO ACTION ON DELETE NO ACTION,
+    CONSTRAINT `output_value_data_id` FOREIGN KEY (`value_data_id`) REFERENCES `data` (`id`) ON UPDATE NO ACTION ON DELETE NO ACTION,
     PRIMARY KEY (`task_id`, `position`)
 ))";
 
@@ -105,8 +114,10 @@ std::string const cCreateTaskDependencyTable = R"(CREATE TABLE IF NOT EXISTS `ta
 std::string const cCreateTaskInstanceTable = R"(CREATE TABLE IF NOT EXISTS `task_instances` (
     `id` BINARY(16) NOT NULL,
     `task_id` BINARY(16) NOT NULL,
+    `worker_id` BINARY(16),
     `start_time` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
     CONSTRAINT `instance_task_id` FOREIGN KEY (`task_id`) REFERENCES `tasks` (`id`) ON UPDATE NO ACTION ON DELETE CASCADE,
+    INDEX (`worker_id`),
     PRIMARY KEY (`id`)
 ))";
 
@@ -122,12 +133,22 @@ std::string const cCreateSchedulerLeaseTable = R"(CREATE TABLE IF NOT EXISTS `sc
 
 std::string const cCreateDataTable = R"(CREATE TABLE IF NOT EXISTS `data` (
     `id` BINARY(16) NOT NULL,
-    `value` VARBINARY(999) NOT NULL,
+    `value` VARBINARY(999) NOT NULL, -- Empty if the value is stored in chunks
     `hard_locality` BOOL DEFAULT FALSE,
     `persisted` BOOL DEFAULT FALSE,
+    `size` BIGINT UNSIGNED NOT NULL DEFAULT 0,
+    `num_chunks` INT UNSIGNED NOT NULL DEFAULT 0,
     PRIMARY KEY (`id`)
 ))";
 
+std::string const cCreateDataChunkTable = R"(CREATE TABLE IF NOT EXISTS `data_chunks` (
+    `id` BINARY(16) NOT NULL,
+    `chunk_index` INT UNSIGNED NOT NULL,
+    `value` MEDIUMBLOB NOT NULL,
+    CONSTRAINT `chunk_data_id` FOREIGN KEY (`id`) REFERENCES `data` (`id`) ON UPDATE NO ACTION ON DELETE CASCADE,
+    PRIMARY KEY (`id`, `chunk_index`)
+))";
+
 std::string const cCreateDataLocalityTable = R"(CREATE TABLE IF NOT EXISTS `data_locality` (
     `id` BINARY(16) NOT NULL,
     `address` VARCHAR(40) NOT NULL,
@@ -168,12 +189,13 @@ std::string const cCreateTaskKVDataTable = R"(CREATE TABLE IF NOT EXISTS `task_k
     CONSTRAINT `kv_data_task_id` FOREIGN KEY (`task_id`) REFERENCES `tasks` (`id`) ON UPDATE NO ACTION ON DELETE CASCADE
 ))";
 
-std::array<std::string const, 17> const cCreateStorage = {
+std::array<std::string const, 18> const cCreateStorage = {
         cCreateDriverTable,  // drivers table must be created before data_ref_driver
         cCreateSchedulerTable,
         cCreateJobTable,  // jobs table must be created before task
         cCreateTaskTable,  // tasks table must be created before data_ref_task
         cCreateDataTable,  // data table must be created before task_outputs
+        cCreateDataChunkTable,
         cCreateDataLocalityTable,
         cCreateDataRefDriverTable,
         cCreateDataRefTaskTable,
@@ -189,10 +211,15 @@ std::array<std::string const, 17> const cCreateStorage = {
                                     // task
 };
 
-std::string const cInsertJob = R"(INSERT INTO `jobs` (`id`, `client_id`) VALUES (?, ?))";
+std::string const cInsertJob
+        = R"(INSERT INTO `jobs` (`id`, `client_id`, `priority`, `remaining_tasks`) VALUES (?, ?, ?, ?))";
+
+// Inserts a job hidden from schedulers until its state is set to running
+std::string const cInsertSubmittingJob
+        = R"(INSERT INTO `jobs` (`id`, `client_id`, `priority`, `remaining_tasks`, `state`) VALUES (?, ?, ?, ?, 'submitting'))";
 
 std::string const cInsertTask
-        = R"(INSERT INTO `tasks` (`id`, `job_id`, `func_name`, `language`, `state`, `timeout`, `max_retry`) VALUES (?, ?, ?, ?, ?, ?, ?))";
+        = R"(INSERT INTO `tasks` (`id`, `job_id`, `func_name`, `language`, `state`, `timeout`, `max_retry`, `remaining_inputs`) VALUES (?, ?, ?, ?, ?, ?, ?, ?))";
 
 std::string const cInsertTaskInputOutput
         = R"(INSERT INTO `task_inputs` (`task_id`, `position`, `type`, `output_task_id`, `output_task_position`) VALUES (?, ?, ?, ?, ?))";
@@ -203,9 +230,15 @@ std::string const cInsertTaskInputData
 std::string const cInsertTaskInputValue
         = R"(INSERT INTO `task_inputs` (`task_id`, `position`, `type`, `value`) VALUES (?, ?, ?, ?))";
 
+std::string const cInsertTaskInputValueData
+        = R"(INSERT INTO `task_inputs` (`task_id`, `position`, `type`, `value_data_id`) VALUES (?, ?, ?, ?))";
+
 std::string const cInsertTaskOutput
         = R"(INSERT INTO `task_outputs` (`task_id`, `position`, `type`) VALUES (?, ?, ?))";
 
+std::string const cInsertDataRefTask
+        = R"(INSERT INTO `data_ref_task` (`id`, `task_id`) VALUES (?, ?))";
+
 std::string const cInsertTaskDependency
         = R"(INSERT INTO `task_dependencies` (parent, child) VALUES (?, ?))";
 
@@ -215,6 +248,28 @@ std::string const cInsertInputTask
 std::string const cInsertOutputTask
         = R"(INSERT INTO `output_tasks` (`job_id`, `task_id`, `position`) VALUES (?, ?, ?))";
 
+// Multi-row inserts, to be followed by the list of rows
+std::string const cMultiInsertTask
+        = R"(INSERT INTO `tasks` (`id`, `job_id`, `func_name`, `language`, `state`, `timeout`, `max_retry`, `remaining_inputs`) VALUES)";
+
+std::string const cMultiInsertTaskInput
+        = R"(INSERT INTO `task_inputs` (`task_id`, `position`, `type`, `output_task_id`, `output_task_position`, `value`, `data_id`, `value_data_id`) VALUES)";
+
+std::string const cMultiInsertTaskOutput
+        = R"(INSERT INTO `task_outputs` (`task_id`, `position`, `type`) VALUES)";
+
+std::string const cMultiInsertDataRefTask
+        = R"(INSERT INTO `data_ref_task` (`id`, `task_id`) VALUES)";
+
+std::string const cMultiInsertTaskDependency
+        = R"(INSERT INTO `task_dependencies` (parent, child) VALUES)";
+
+std::string const cMultiInsertInputTask
+        = R"(INSERT INTO `input_tasks` (`job_id`, `task_id`, `position`) VALUES)";
+
+std::string const cMultiInsertOutputTask
+        = R"(INSERT INTO `output_tasks` (`job_id`, `task_id`, `position`) VALUES)";
+
 // NOLINTEND(cert-err58-cpp)
 }  // namespace spider::core::mysql
 
@@ -2,6 +2,7 @@
 #define SPIDER_UTILS_TIMEDCACHE_HPP
 
 #include <cstddef>
+#include <list>
 #include <optional>
 #include <utility>
 
@@ -12,53 +13,123 @@ namespace utils {
 constexpr size_t cDefaultCacheSize = 100;
 }  // namespace utils
 
-template <class Key, class Value>
+/**
+ * Weighs every value as 1, so the capacity of the cache is the number of entries.
+ */
+template <class Value>
+struct UnitWeigher {
+    auto operator()(Value const& /*value*/) const -> size_t { return 1; }
+};
+
+/**
+ * A cache that evicts the least recently used entries once the total weight of the values exceeds
+ * the capacity. By default, the weight of a value is 1, so the capacity is the number of entries.
+ */
+template <class Key, class Value, class Weigher = UnitWeigher<Value>>
 class LruCache {
 public:
     LruCache() = default;
 
-    explicit LruCache(size_t const size) : m_size{size} {}
+    explicit LruCache(size_t const size, Weigher weigher = Weigher{})
+            : m_size{size},
+              m_weigher{std::move(weigher)} {}
 
+    /**
+     * Gets a value and marks it as the most recently used.
+     *
+     * @param key
+     * @return The value if it is in the cache, std::nullopt otherwise.
+     */
     auto get(Key const& key) -> std::optional<Value> {
         auto it = m_map.find(key);
         if (it == m_map.end()) {
             return std::nullopt;
         }
 
+        m_list.splice(m_list.begin(), m_list, it->second);
         return it->second->second;
     }
 
-    auto put(Key const& key, Value const& value) -> void {
+    /**
+     * Removes a value from the cache and returns it, e.g. to use a value that cannot be copied.
+     *
+     * @param key
+     * @return The value if it is in the cache, std::nullopt otherwise.
+     */
+    auto take(Key const& key) -> std::optional<Value> {
         auto it = m_map.find(key);
-        if (it != m_map.end()) {
-            update(it, key, value);
+        if (it == m_map.end()) {
+            return std::nullopt;
+        }
+        m_weight -= m_weigher(it->second->second);
+        std::optional<Value> value{std::move(it->second->second)};
+        m_list.erase(it->second);
+        m_map.erase(it);
+        return value;
+    }
+
+    /**
+     * Puts a value, evicting the least recently used values until it fits. A value heavier than the
+     * capacity is not cached.
+     *
+     * @param key
+     * @param value
+     */
+    auto put(Key const& key, Value value) -> void {
+        erase(key);
+        size_t const weight = m_weigher(value);
+        if (weight > m_size) {
             return;
         }
         // Pop if the size is greater than the threshold
-        if (m_map.size() >= m_size) {
+        while (m_weight + weight > m_size) {
             std::pair<Key, Value>& last = m_list.back();
+            m_weight -= m_weigher(last.second);
             m_map.erase(last.first);
             m_list.pop_back();
         }
 
-        m_list.push_front({key, value});
+        m_list.emplace_front(key, std::move(value));
         m_map[key] = m_list.begin();
+        m_weight += weight;
     }
 
-private:
-    auto update(
-            typename absl::flat_hash_map<Key, typename std::list<std::pair<Key, Value>>::iterator>::
-                    iterator& it,
-            Key const& key,
-            Value const& value
-    ) -> void {
-        auto list_it = it->second;
-        m_list.erase(list_it);
-        m_list.push_front({key, value});
-        it->second = m_list.begin();
+    auto erase(Key const& key) -> void {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            return;
+        }
+        m_weight -= m_weigher(it->second->second);
+        m_list.erase(it->second);
+        m_map.erase(it);
+    }
+
+    /**
+     * Sets the capacity, evicting the least recently used values until the cache fits.
+     *
+     * @param size
+     */
+    auto set_size(size_t const size) -> void {
+        m_size = size;
+        while (m_weight > m_size) {
+            std::pair<Key, Value>& last = m_list.back();
+            m_weight -= m_weigher(last.second);
+            m_map.erase(last.first);
+            m_list.pop_back();
+        }
     }
 
+    [[nodiscard]] auto get_size() const -> size_t { return m_size; }
+
+    /**
+     * @return The total weight of the cached values.
+     */
+    [[nodiscard]] auto get_weight() const -> size_t { return m_weight; }
+
+private:
     size_t m_size = utils::cDefaultCacheSize;
+    Weigher m_weigher;
+    size_t m_weight = 0;
     std::list<std::pair<Key, Value>> m_list;
     absl::flat_hash_map<Key, typename std::list<std::pair<Key, Value>>::iterator> m_map;
 };
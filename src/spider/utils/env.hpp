@@ -7,6 +7,8 @@
 
 namespace spider::utils {
 constexpr std::string_view cStorageUrlEnv{"SPIDER_STORAGE_URL"};
+// Maximum total size in bytes of the data cached by a process
+constexpr std::string_view cDataCacheSizeEnv{"SPIDER_DATA_CACHE_SIZE"};
 
 /**
  * Gets the value of an environment variable.
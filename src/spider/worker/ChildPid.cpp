@@ -2,16 +2,18 @@
 
 #include <unistd.h>
 
+#include <array>
 #include <csignal>
+#include <cstddef>
 
 namespace spider::core {
-auto ChildPid::get_pid() -> std::sig_atomic_t {
-    return m_pid;
+auto ChildPid::get_pid(std::size_t const slot) -> std::sig_atomic_t {
+    return m_pids.at(slot);
 }
 
-auto ChildPid::set_pid(pid_t const pid) -> void {
-    m_pid = pid;
+auto ChildPid::set_pid(pid_t const pid, std::size_t const slot) -> void {
+    m_pids.at(slot) = pid;
 }
 
-std::sig_atomic_t volatile ChildPid::m_pid = 0;
+std::array<std::sig_atomic_t volatile, ChildPid::cMaxNumPids> ChildPid::m_pids{};
 }  // namespace spider::core
@@ -3,26 +3,34 @@
 
 #include <unistd.h>
 
+#include <array>
 #include <csignal>
+#include <cstddef>
 
 namespace spider::core {
 /**
- * @brief A singleton class to manage the child process ID for signal handler.
+ * @brief A singleton class to manage the child process IDs for signal handler.
  *
- * User can set the child process ID using set_pid() method, and retrieve it using get_pid() method.
- * This class is signal-safe but is **not** thread-safe.
+ * Each task slot of the worker owns one entry. User can set the child process ID of a slot using
+ * set_pid() method, and retrieve it using get_pid() method.
+ * This class is signal-safe but is **not** thread-safe. Only the owner of a slot may set it.
  */
 class ChildPid {
 public:
+    // Maximum number of child processes, i.e. task slots, tracked at the same time
+    static constexpr std::size_t cMaxNumPids = 1024;
+
     /*
+     * @param slot The slot of the child process.
      * @return The process ID of the child process.
      */
-    [[nodiscard]] static auto get_pid() -> std::sig_atomic_t;
+    [[nodiscard]] static auto get_pid(std::size_t slot = 0) -> std::sig_atomic_t;
 
     /*
      * @param pid The process ID to set.
+     * @param slot The slot of the child process.
      */
-    static auto set_pid(pid_t pid) -> void;
+    static auto set_pid(pid_t pid, std::size_t slot = 0) -> void;
 
     // Delete constructor
     ChildPid() = delete;
@@ -37,7 +45,7 @@ public:
     ~ChildPid() = default;
 
 private:
-    static std::sig_atomic_t volatile m_pid;
+    static std::array<std::sig_atomic_t volatile, cMaxNumPids> m_pids;
 };
 }  // namespace spider::core
 
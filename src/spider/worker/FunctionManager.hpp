@@ -20,6 +20,7 @@
 #include <spider/client/Data.hpp>
 #include <spider/client/task.hpp>
 #include <spider/client/TaskContext.hpp>
+#include <spider/core/DataCache.hpp>
 #include <spider/core/DataImpl.hpp>
 #include <spider/core/Error.hpp>
 #include <spider/core/TaskContextImpl.hpp>
@@ -231,6 +232,35 @@ inline auto create_args_request(std::vector<msgpack::sbuffer> const& args_buffer
     return buffer;
 }
 
+/**
+ * Creates a request to run a task on a persistent task executor. Unlike an arguments request, it
+ * also carries the function name and the task id, since the executor is not started for a single
+ * task.
+ *
+ * @param func_name
+ * @param task_id
+ * @param args_buffers
+ * @return The request buffer.
+ */
+inline auto create_task_request(
+        std::string const& func_name,
+        boost::uuids::uuid const task_id,
+        std::vector<msgpack::sbuffer> const& args_buffers
+) -> msgpack::sbuffer {
+    msgpack::sbuffer buffer;
+    msgpack::packer packer{buffer};
+    packer.pack_array(2);
+    packer.pack(worker::TaskExecutorRequestType::Task);
+    packer.pack_array(3);
+    packer.pack(func_name);
+    packer.pack(task_id);
+    packer.pack_array(args_buffers.size());
+    for (msgpack::sbuffer const& args_buffer : args_buffers) {
+        buffer.write(args_buffer.data(), args_buffer.size());
+    }
+    return buffer;
+}
+
 // NOLINTEND(cppcoreguidelines-missing-std-forward)
 
 template <class F>
@@ -306,7 +336,17 @@ public:
                 if constexpr (cIsSpecializationV<T, spider::Data>) {
                     boost::uuids::uuid const data_id = arg.as<boost::uuids::uuid>();
                     std::unique_ptr<Data> data = std::make_unique<Data>();
-                    err = data_store->get_task_data(*conn, task_id, data_id, data.get());
+                    // A cached value still needs the task reference to keep the data alive
+                    std::optional<Data> cached_data = DataCache::get_instance().get(data_id);
+                    if (cached_data.has_value()) {
+                        err = data_store->add_task_reference(*conn, data_id, task_id);
+                        *data = std::move(cached_data.value());
+                    } else {
+                        err = data_store->get_task_data(*conn, task_id, data_id, data.get());
+                        if (err.success()) {
+                            DataCache::get_instance().put(*data);
+                        }
+                    }
                     if (!err.success()) {
                         return;
                     }
@@ -0,0 +1,97 @@
+#include "InProcessExecutor.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <spider/client/TaskContext.hpp>
+#include <spider/core/TaskContextImpl.hpp>
+#include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
+#include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageFactory.hpp>
+#include <spider/worker/FunctionManager.hpp>
+
+namespace spider::worker {
+InProcessExecutor::InProcessExecutor(
+        std::shared_ptr<core::StorageFactory> storage_factory,
+        std::shared_ptr<core::MetadataStorage> metadata_store,
+        std::shared_ptr<core::DataStorage> data_store,
+        std::size_t const num_threads,
+        std::vector<std::string> const& functions
+)
+        : m_storage_factory{std::move(storage_factory)},
+          m_metadata_store{std::move(metadata_store)},
+          m_data_store{std::move(data_store)},
+          m_functions{functions.cbegin(), functions.cend()},
+          m_pool{num_threads} {}
+
+InProcessExecutor::~InProcessExecutor() {
+    m_pool.join();
+}
+
+auto InProcessExecutor::runs_function(std::string const& func_name) const -> bool {
+    return m_functions.empty() || m_functions.contains(func_name);
+}
+
+auto InProcessExecutor::run(
+        std::string func_name,
+        boost::uuids::uuid const task_id,
+        std::vector<msgpack::sbuffer> args_buffers
+) -> boost::asio::awaitable<msgpack::sbuffer> {
+    co_return co_await boost::asio::co_spawn(
+            m_pool,
+            [&]() -> boost::asio::awaitable<msgpack::sbuffer> {
+                co_return run_function(func_name, task_id, args_buffers);
+            },
+            boost::asio::use_awaitable
+    );
+}
+
+auto InProcessExecutor::run_function(
+        std::string const& func_name,
+        boost::uuids::uuid const task_id,
+        std::vector<msgpack::sbuffer> const& args_buffers
+) const -> msgpack::sbuffer {
+    core::Function const* function = core::FunctionManager::get_instance().get_function(func_name);
+    if (nullptr == function) {
+        return core::create_error_response(
+                core::FunctionInvokeError::FunctionExecutionError,
+                fmt::format("Function {} not found.", func_name)
+        );
+    }
+
+    // Same layout as the arguments unpacked by a task executor process, without the round trip
+    msgpack::sbuffer args_buffer;
+    msgpack::packer packer{args_buffer};
+    packer.pack_array(args_buffers.size());
+    for (msgpack::sbuffer const& buffer : args_buffers) {
+        args_buffer.write(buffer.data(), buffer.size());
+    }
+
+    TaskContext task_context = core::TaskContextImpl::create_task_context(
+            task_id,
+            m_data_store,
+            m_metadata_store,
+            m_storage_factory
+    );
+    try {
+        return (*function)(task_context, task_id, args_buffer);
+    } catch (std::exception const& e) {
+        // An exception must not unwind into the worker's thread pool
+        spdlog::error("Function {} throws: {}", func_name, e.what());
+        return core::create_error_response(
+                core::FunctionInvokeError::FunctionExecutionError,
+                fmt::format("Function {} throws: {}", func_name, e.what())
+        );
+    }
+}
+}  // namespace spider::worker
@@ -0,0 +1,101 @@
+#ifndef SPIDER_WORKER_INPROCESSEXECUTOR_HPP
+#define SPIDER_WORKER_INPROCESSEXECUTOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_set.h>
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
+#include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageFactory.hpp>
+
+namespace spider::worker {
+/**
+ * Runs C++ tasks inside the worker process on a bounded thread pool, instead of spawning a task
+ * executor process per task. The task libraries must be loaded into the worker with `DllLoader`.
+ *
+ * Tasks are not isolated from the worker or from each other: a task that crashes, leaks or changes
+ * global state affects the whole worker, and a running task cannot be killed. Only use it for
+ * trusted, well-behaved libraries.
+ */
+class InProcessExecutor {
+public:
+    /**
+     * @param storage_factory
+     * @param metadata_store
+     * @param data_store
+     * @param num_threads Maximum number of tasks running at once.
+     * @param functions Functions to run in process. All C++ functions are run in process if empty.
+     */
+    InProcessExecutor(
+            std::shared_ptr<core::StorageFactory> storage_factory,
+            std::shared_ptr<core::MetadataStorage> metadata_store,
+            std::shared_ptr<core::DataStorage> data_store,
+            std::size_t num_threads,
+            std::vector<std::string> const& functions
+    );
+
+    // Delete copy & move constructors and assignment operators
+    InProcessExecutor(InProcessExecutor const&) = delete;
+    auto operator=(InProcessExecutor const&) -> InProcessExecutor& = delete;
+    InProcessExecutor(InProcessExecutor&&) = delete;
+    auto operator=(InProcessExecutor&&) -> InProcessExecutor& = delete;
+
+    /**
+     * Waits for the running tasks to finish.
+     */
+    ~InProcessExecutor();
+
+    /**
+     * @param func_name
+     * @return Whether the C++ function is run in process.
+     */
+    [[nodiscard]] auto runs_function(std::string const& func_name) const -> bool;
+
+    /**
+     * Runs a task on the thread pool and resumes on the caller's executor once it returns. The
+     * arguments are taken by value since the coroutine may outlive the caller's temporaries.
+     *
+     * @param func_name
+     * @param task_id
+     * @param args_buffers
+     * @return The response of the task, in the same format as the response of a task executor
+     * process: the result on success, or the error otherwise.
+     */
+    auto run(
+            std::string func_name,
+            boost::uuids::uuid task_id,
+            std::vector<msgpack::sbuffer> args_buffers
+    ) -> boost::asio::awaitable<msgpack::sbuffer>;
+
+private:
+    /**
+     * Runs a task on the calling thread.
+     *
+     * @param func_name
+     * @param task_id
+     * @param args_buffers
+     * @return The response of the task.
+     */
+    auto run_function(
+            std::string const& func_name,
+            boost::uuids::uuid task_id,
+            std::vector<msgpack::sbuffer> const& args_buffers
+    ) const -> msgpack::sbuffer;
+
+    std::shared_ptr<core::StorageFactory> m_storage_factory;
+    std::shared_ptr<core::MetadataStorage> m_metadata_store;
+    std::shared_ptr<core::DataStorage> m_data_store;
+    absl::flat_hash_set<std::string> m_functions;
+
+    boost::asio::thread_pool m_pool;
+};
+}  // namespace spider::worker
+
+#endif
@@ -0,0 +1,167 @@
+#include "ResultSubmitter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/uuid/uuid_io.hpp>
+#include <spdlog/spdlog.h>
+
+#include <spider/core/Error.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::worker {
+namespace {
+constexpr int cMaxNumRetries = 5;
+constexpr std::chrono::milliseconds cInitialBackoff{10};
+
+/**
+ * Runs a storage operation, retrying with jittered exponential backoff while it fails on deadlock.
+ * The jitter keeps workers that deadlocked on each other from retrying in lockstep.
+ *
+ * @param function The storage operation.
+ * @return The error of the last attempt.
+ */
+template <typename Function>
+auto retry_on_deadlock(Function const& function) -> core::StorageErr {
+    thread_local std::mt19937 generator{std::random_device{}()};
+    std::chrono::milliseconds backoff = cInitialBackoff;
+    core::StorageErr err;
+    for (int i = 0; i < cMaxNumRetries; ++i) {
+        err = function();
+        if (core::StorageErrType::DeadLockErr != err.type) {
+            return err;
+        }
+        std::uniform_int_distribution<std::chrono::milliseconds::rep> distribution{
+                backoff.count() / 2,
+                backoff.count()
+        };
+        std::this_thread::sleep_for(std::chrono::milliseconds{distribution(generator)});
+        backoff *= 2;
+    }
+    return err;
+}
+}  // namespace
+
+ResultSubmitter::ResultSubmitter(
+        std::shared_ptr<core::MetadataStorage> metadata_store,
+        core::StorageConnectionPool& conn_pool,
+        std::chrono::milliseconds const flush_interval,
+        std::size_t const max_batch_size
+)
+        : m_metadata_store{std::move(metadata_store)},
+          m_conn_pool{conn_pool},
+          m_flush_interval{flush_interval},
+          m_max_batch_size{std::max<std::size_t>(max_batch_size, 1)},
+          m_thread{[this] { flush_loop(); }} {}
+
+ResultSubmitter::~ResultSubmitter() {
+    {
+        std::lock_guard const lock{m_mutex};
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+auto ResultSubmitter::submit(core::TaskInstance instance, std::vector<core::TaskOutput> outputs)
+        -> std::future<bool> {
+    std::promise<bool> promise;
+    std::future<bool> future = promise.get_future();
+    {
+        std::lock_guard const lock{m_mutex};
+        m_results.push_back(
+                PendingResult{std::move(instance), std::move(outputs), std::move(promise)}
+        );
+    }
+    m_cv.notify_all();
+    return future;
+}
+
+auto ResultSubmitter::flush_loop() -> void {
+    while (true) {
+        std::vector<PendingResult> batch;
+        {
+            std::unique_lock lock{m_mutex};
+            m_cv.wait(lock, [this] { return m_stop || !m_results.empty(); });
+            if (m_results.empty()) {
+                // Stop requested and every result submitted
+                return;
+            }
+            // Wait for more results to coalesce unless the batch is already full
+            m_cv.wait_for(lock, m_flush_interval, [this] {
+                return m_stop || m_results.size() >= m_max_batch_size;
+            });
+            std::size_t const batch_size = std::min(m_results.size(), m_max_batch_size);
+            batch.reserve(batch_size);
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                batch.push_back(std::move(m_results.front()));
+                m_results.pop_front();
+            }
+        }
+
+        std::variant<core::StorageConnectionPool::Lease, core::StorageErr> conn_result
+                = m_conn_pool.acquire();
+        if (std::holds_alternative<core::StorageErr>(conn_result)) {
+            spdlog::error(
+                    "Failed to connect to storage: {}",
+                    std::get<core::StorageErr>(conn_result).description
+            );
+            for (PendingResult& result : batch) {
+                result.promise.set_value(false);
+            }
+            continue;
+        }
+        auto const& conn = std::get<core::StorageConnectionPool::Lease>(conn_result);
+        flush(*conn, batch);
+    }
+}
+
+auto ResultSubmitter::flush(core::StorageConnection& conn, std::vector<PendingResult>& batch)
+        -> void {
+    std::vector<core::TaskInstance> instances;
+    std::vector<std::vector<core::TaskOutput>> outputs;
+    instances.reserve(batch.size());
+    outputs.reserve(batch.size());
+    for (PendingResult const& result : batch) {
+        instances.push_back(result.instance);
+        outputs.push_back(result.outputs);
+    }
+    spdlog::debug("Submitting results of {} tasks", batch.size());
+    core::StorageErr const err = retry_on_deadlock([&] {
+        return m_metadata_store->task_finish_batch(conn, instances, outputs);
+    });
+    if (err.success()) {
+        for (PendingResult& result : batch) {
+            result.promise.set_value(true);
+        }
+        return;
+    }
+
+    spdlog::warn("Submit results of {} tasks fails: {}", batch.size(), err.description);
+    for (PendingResult& result : batch) {
+        core::StorageErr const task_err = retry_on_deadlock([&] {
+            return m_metadata_store->task_finish(conn, result.instance, result.outputs);
+        });
+        if (!task_err.success()) {
+            spdlog::error(
+                    "Submit task {} fails: {}",
+                    boost::uuids::to_string(result.instance.task_id),
+                    task_err.description
+            );
+        }
+        result.promise.set_value(task_err.success());
+    }
+}
+}  // namespace spider::worker
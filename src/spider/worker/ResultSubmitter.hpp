@@ -0,0 +1,95 @@
+#ifndef SPIDER_WORKER_RESULTSUBMITTER_HPP
+#define SPIDER_WORKER_RESULTSUBMITTER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <spider/core/Error.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+
+namespace spider::worker {
+/**
+ * Coalesces the results of the task slots of a worker and submits them to the storage in batches.
+ * Results queued within one flush interval are finished in a single transaction, so that a worker
+ * running many short tasks does not pay a transaction per task.
+ */
+class ResultSubmitter {
+public:
+    /**
+     * @param metadata_store
+     * @param conn_pool Pool of storage connections to submit the results with.
+     * @param flush_interval Time to wait for more results before a batch is submitted.
+     * @param max_batch_size Maximum number of results in a batch. A full batch is submitted
+     * without waiting for the flush interval.
+     */
+    ResultSubmitter(
+            std::shared_ptr<core::MetadataStorage> metadata_store,
+            core::StorageConnectionPool& conn_pool,
+            std::chrono::milliseconds flush_interval,
+            std::size_t max_batch_size
+    );
+
+    // Delete copy & move constructors and assignment operators
+    ResultSubmitter(ResultSubmitter const&) = delete;
+    auto operator=(ResultSubmitter const&) -> ResultSubmitter& = delete;
+    ResultSubmitter(ResultSubmitter&&) = delete;
+    auto operator=(ResultSubmitter&&) -> ResultSubmitter& = delete;
+
+    /**
+     * Submits the queued results and stops the flush thread.
+     */
+    ~ResultSubmitter();
+
+    /**
+     * Queues the outputs of a finished task instance.
+     *
+     * @param instance
+     * @param outputs
+     * @return A future that is set to whether the outputs are submitted.
+     */
+    auto submit(core::TaskInstance instance, std::vector<core::TaskOutput> outputs)
+            -> std::future<bool>;
+
+private:
+    struct PendingResult {
+        core::TaskInstance instance;
+        std::vector<core::TaskOutput> outputs;
+        std::promise<bool> promise;
+    };
+
+    auto flush_loop() -> void;
+
+    /**
+     * Submits a batch of results in one transaction. Falls back to submitting the results one by
+     * one if the batch cannot be submitted, so that one bad result does not fail the whole batch.
+     *
+     * @param conn
+     * @param batch
+     */
+    auto flush(core::StorageConnection& conn, std::vector<PendingResult>& batch) -> void;
+
+    std::shared_ptr<core::MetadataStorage> m_metadata_store;
+    core::StorageConnectionPool& m_conn_pool;
+    std::chrono::milliseconds m_flush_interval;
+    std::size_t m_max_batch_size;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<PendingResult> m_results;
+    bool m_stop = false;
+
+    std::thread m_thread;
+};
+}  // namespace spider::worker
+
+#endif
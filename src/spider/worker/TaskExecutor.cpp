@@ -93,6 +93,63 @@ auto TaskExecutor::spawn_cpp_executor(
     return executor;
 }
 
+auto TaskExecutor::spawn_persistent_cpp_executor(
+        boost::asio::io_context& context,
+        std::string const& storage_url,
+        std::vector<std::string> const& libs,
+        absl::flat_hash_map<
+                boost::process::v2::environment::key,
+                boost::process::v2::environment::value
+        > const& environment
+) -> std::unique_ptr<TaskExecutor> {
+    auto const exe
+            = boost::process::v2::environment::find_executable("spider_task_executor", environment);
+    if (exe.empty()) {
+        spdlog::error("Cannot find c++ task executor");
+        return nullptr;
+    }
+
+    auto const [input_pipe_read_end, input_pipe_write_end] = core::create_pipe();
+    auto const [output_pipe_read_end, output_pipe_write_end] = core::create_pipe();
+
+    std::vector<std::string> process_args{
+            "--persistent",
+            "--input-pipe",
+            std::to_string(input_pipe_read_end),
+            "--output-pipe",
+            std::to_string(output_pipe_write_end),
+    };
+    if (false == utils::get_env(utils::cStorageUrlEnv).has_value()) {
+        process_args.emplace_back("--storage_url");
+        process_args.emplace_back(storage_url);
+    }
+    if (false == libs.empty()) {
+        process_args.emplace_back("--libs");
+        process_args.insert(process_args.end(), libs.cbegin(), libs.cend());
+    }
+
+    // Must use `new` because `make_unique` cannot access the private constructor.
+    auto executor = std::unique_ptr<TaskExecutor>(new TaskExecutor(
+            context,
+            output_pipe_read_end,
+            input_pipe_write_end,
+            std::make_unique<Process>(Process::spawn(
+                    exe.string(),
+                    process_args,
+                    std::nullopt,
+                    std::nullopt,
+                    std::nullopt,
+                    {input_pipe_read_end, output_pipe_write_end}
+            ))
+    ));
+
+    // Close the following fds since they're no longer needed by the parent process.
+    close(input_pipe_read_end);
+    close(output_pipe_write_end);
+
+    return executor;
+}
+
 auto TaskExecutor::spawn_python_executor(
         boost::asio::io_context& context,
         std::string const& func_name,
@@ -179,8 +236,19 @@ auto TaskExecutor::error() -> bool {
 }
 
 void TaskExecutor::wait() {
+    if (m_persistent) {
+        // The process outlives the task, so only wait for the task to complete
+        std::unique_lock lock(m_state_mutex);
+        m_complete_cv.wait(lock, [this] {
+            return TaskExecutorState::Succeed == m_state || TaskExecutorState::Error == m_state
+                   || TaskExecutorState::Cancelled == m_state;
+        });
+        return;
+    }
     int const exit_code = m_process->wait();
     if (exit_code != 0) {
+        // The process may have exited after it sent its result in shared memory
+        remove_process_shared_memory(get_pid());
         std::lock_guard const lock(m_state_mutex);
         if (m_state != TaskExecutorState::Cancelled && m_state != TaskExecutorState::Error) {
             m_state = TaskExecutorState::Error;
@@ -198,6 +266,7 @@ void TaskExecutor::wait() {
                || TaskExecutorState::Cancelled == m_state;
     });
     lock.unlock();
+    remove_process_shared_memory(get_pid());
 }
 
 void TaskExecutor::cancel() {
@@ -208,22 +277,86 @@ void TaskExecutor::cancel() {
     packer.pack("Task cancelled");
 }
 
+auto TaskExecutor::run_task(
+        std::string const& func_name,
+        boost::uuids::uuid const task_id,
+        std::vector<msgpack::sbuffer> const& args_buffers
+) -> bool {
+    {
+        std::lock_guard const lock(m_state_mutex);
+        m_state = TaskExecutorState::Running;
+        m_result_buffer.clear();
+    }
+    m_output_done = false;
+    m_output_timer.expires_at(boost::asio::steady_timer::time_point::max());
+    boost::asio::co_spawn(
+            m_read_pipe.get_executor(),
+            process_output_handler(),
+            boost::asio::detached
+    );
+
+    return send_message(
+            m_write_pipe,
+            core::create_task_request(func_name, task_id, args_buffers),
+            &m_shared_memory_names
+    );
+}
+
+auto TaskExecutor::reusable() -> bool {
+    std::lock_guard const lock(m_state_mutex);
+    return m_persistent && false == m_process_failed
+           && (TaskExecutorState::Succeed == m_state || TaskExecutorState::Error == m_state);
+}
+
+auto TaskExecutor::stop() -> int {
+    boost::system::error_code ec;
+    m_write_pipe.close(ec);
+    int const exit_code = m_process->wait();
+    remove_process_shared_memory(get_pid());
+    return exit_code;
+}
+
+auto TaskExecutor::async_wait_output() -> boost::asio::awaitable<void> {
+    if (m_output_done) {
+        co_return;
+    }
+    // The timer never expires, so the wait only ends when the output handler cancels it
+    co_await m_output_timer.async_wait(boost::asio::as_tuple(boost::asio::use_awaitable));
+}
+
+auto TaskExecutor::notify_output_done() -> void {
+    m_output_done = true;
+    m_output_timer.cancel();
+}
+
 // NOLINTBEGIN(clang-analyzer-core.CallAndMessage)
 auto TaskExecutor::process_output_handler() -> boost::asio::awaitable<void> {
     while (true) {
         std::optional<msgpack::sbuffer> const response_option
                 = co_await receive_message_async(m_read_pipe);
         if (!response_option.has_value()) {
-            std::lock_guard const lock(m_state_mutex);
-            m_state = TaskExecutorState::Error;
-            core::create_error_buffer(
-                    core::FunctionInvokeError::FunctionExecutionError,
-                    "Pipe read fails",
-                    m_result_buffer
-            );
+            // The process may have exited before reading its arguments
+            for (std::string const& name : m_shared_memory_names) {
+                remove_shared_memory(name);
+            }
+            m_shared_memory_names.clear();
+            {
+                std::lock_guard const lock(m_state_mutex);
+                m_state = TaskExecutorState::Error;
+                m_process_failed = true;
+                core::create_error_buffer(
+                        core::FunctionInvokeError::FunctionExecutionError,
+                        "Pipe read fails",
+                        m_result_buffer
+                );
+            }
+            m_complete_cv.notify_all();
+            notify_output_done();
             co_return;
         }
         msgpack::sbuffer const& response = response_option.value();
+        // The process read its arguments before responding, so it already unlinked them
+        m_shared_memory_names.clear();
         switch (get_response_type(response)) {
             case TaskExecutorResponseType::Block:
                 break;
@@ -234,6 +367,7 @@ auto TaskExecutor::process_output_handler() -> boost::asio::awaitable<void> {
                     m_result_buffer.write(response.data(), response.size());
                 }
                 m_complete_cv.notify_all();
+                notify_output_done();
                 co_return;
             }
             case TaskExecutorResponseType::Ready:
@@ -245,6 +379,7 @@ auto TaskExecutor::process_output_handler() -> boost::asio::awaitable<void> {
                     m_result_buffer.write(response.data(), response.size());
                 }
                 m_complete_cv.notify_all();
+                notify_output_done();
                 co_return;
             }
             case TaskExecutorResponseType::Cancel: {
@@ -254,6 +389,7 @@ auto TaskExecutor::process_output_handler() -> boost::asio::awaitable<void> {
                     m_result_buffer.write(response.data(), response.size());
                 }
                 m_complete_cv.notify_all();
+                notify_output_done();
                 co_return;
             }
             case TaskExecutorResponseType::Unknown:
@@ -285,17 +421,29 @@ TaskExecutor::TaskExecutor(
         std::unique_ptr<Process> process,
         std::vector<msgpack::sbuffer> const& args_buffers
 )
-        : m_read_pipe{context},
-          m_write_pipe{context},
-          m_process{std::move(process)} {
-    m_read_pipe.assign(read_pipe_fd);
-    m_write_pipe.assign(write_pipe_fd);
+        : TaskExecutor{context, read_pipe_fd, write_pipe_fd, std::move(process)} {
+    m_persistent = false;
 
     // Set up handler for output file
     boost::asio::co_spawn(context, process_output_handler(), boost::asio::detached);
 
     // Send args
     auto const args_request = core::create_args_request(args_buffers);
-    send_message(m_write_pipe, args_request);
+    send_message(m_write_pipe, args_request, &m_shared_memory_names);
+}
+
+TaskExecutor::TaskExecutor(
+        boost::asio::io_context& context,
+        int const read_pipe_fd,
+        int const write_pipe_fd,
+        std::unique_ptr<Process> process
+)
+        : m_read_pipe{context},
+          m_write_pipe{context},
+          m_process{std::move(process)},
+          m_persistent{true},
+          m_output_timer{context, boost::asio::steady_timer::time_point::max()} {
+    m_read_pipe.assign(read_pipe_fd);
+    m_write_pipe.assign(write_pipe_fd);
 }
 }  // namespace spider::worker
@@ -45,6 +45,27 @@ public:
             std::vector<msgpack::sbuffer> const& args_buffers
     ) -> std::unique_ptr<TaskExecutor>;
 
+    /**
+     * Spawns a persistent C++ task executor. The executor loads the libraries and connects to the
+     * storage once, then runs the tasks sent by `run_task` one after another until `stop` is
+     * called.
+     *
+     * @param context
+     * @param storage_url
+     * @param libs
+     * @param environment
+     * @return The task executor, or nullptr if the executable cannot be found.
+     */
+    [[nodiscard]] static auto spawn_persistent_cpp_executor(
+            boost::asio::io_context& context,
+            std::string const& storage_url,
+            std::vector<std::string> const& libs,
+            absl::flat_hash_map<
+                    boost::process::v2::environment::key,
+                    boost::process::v2::environment::value
+            > const& environment
+    ) -> std::unique_ptr<TaskExecutor>;
+
     [[nodiscard]] static auto spawn_python_executor(
             boost::asio::io_context& context,
             std::string const& func_name,
@@ -75,8 +96,43 @@ public:
 
     void wait();
 
+    /**
+     * Waits asynchronously until the task executor reports a result, an error or a cancellation,
+     * or its output pipe fails. Several executors spawned on the same context can be awaited
+     * concurrently this way. Must be awaited on the executor's context.
+     * NOTE: The process may still be running, so `wait` must be called to reap it.
+     */
+    auto async_wait_output() -> boost::asio::awaitable<void>;
+
     void cancel();
 
+    /**
+     * Runs a task on a persistent task executor that is not running another task. Must be called
+     * on the executor's context.
+     *
+     * @param func_name
+     * @param task_id
+     * @param args_buffers
+     * @return Whether the task is sent to the executor process.
+     */
+    auto run_task(
+            std::string const& func_name,
+            boost::uuids::uuid task_id,
+            std::vector<msgpack::sbuffer> const& args_buffers
+    ) -> bool;
+
+    /**
+     * @return Whether the task executor is persistent and its process can run another task.
+     */
+    [[nodiscard]] auto reusable() -> bool;
+
+    /**
+     * Stops a persistent task executor by closing its input pipe, and reaps its process.
+     *
+     * @return The exit code of the process.
+     */
+    auto stop() -> int;
+
     template <class T>
     auto get_result() const -> std::optional<T> {
         return core::response_get_result<T>(m_result_buffer);
@@ -96,8 +152,21 @@ private:
             std::vector<msgpack::sbuffer> const& args_buffers
     );
 
+    // Constructor of a persistent task executor, which waits for `run_task`
+    explicit TaskExecutor(
+            boost::asio::io_context& context,
+            int read_pipe_fd,
+            int write_pipe_fd,
+            std::unique_ptr<Process> process
+    );
+
     auto process_output_handler() -> boost::asio::awaitable<void>;
 
+    /**
+     * Wakes up `async_wait_output` once the output handler returns.
+     */
+    auto notify_output_done() -> void;
+
     std::mutex m_state_mutex;
     std::condition_variable m_complete_cv;
     TaskExecutorState m_state = TaskExecutorState::Running;
@@ -108,6 +177,16 @@ private:
     boost::asio::writable_pipe m_write_pipe;
 
     msgpack::sbuffer m_result_buffer;
+
+    bool m_persistent = false;
+    // Set when the output pipe fails, i.e. the process exited
+    bool m_process_failed = false;
+
+    // Only accessed on the context, so no lock is needed
+    bool m_output_done = false;
+    // Shared memory objects holding arguments that the process may not have read yet
+    std::vector<std::string> m_shared_memory_names;
+    boost::asio::steady_timer m_output_timer;
 };
 }  // namespace spider::worker
 
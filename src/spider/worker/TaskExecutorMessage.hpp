@@ -35,6 +35,8 @@ enum class TaskExecutorRequestType : std::uint8_t {
     Unknown = 0,
     Arguments,
     Resume,
+    // Function name, task id and arguments of a task for a persistent task executor
+    Task,
 };
 
 class TaskExecutorRequestParser {
@@ -0,0 +1,95 @@
+#include "TaskFetcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+#include <spdlog/spdlog.h>
+
+#include <spider/scheduler/SchedulerMessage.hpp>
+#include <spider/utils/StopFlag.hpp>
+
+namespace spider::worker {
+namespace {
+constexpr int cReconnectTimeout = 100;
+}  // namespace
+
+auto TaskFetcher::fetch() -> std::optional<scheduler::ScheduledTask> {
+    {
+        std::lock_guard const lock{m_mutex};
+        ++m_num_idle_slots;
+    }
+    std::optional<scheduler::ScheduledTask> optional_task = pop_task();
+    if (optional_task.has_value()) {
+        return optional_task;
+    }
+
+    spdlog::debug("Fetching task");
+    // Wait for the slot currently talking to the scheduler, which may fetch a task for this slot
+    std::lock_guard const client_lock{m_client_mutex};
+    while (!core::StopFlag::is_stop_requested()) {
+        optional_task = pop_task();
+        if (optional_task.has_value()) {
+            return optional_task;
+        }
+
+        std::optional<boost::uuids::uuid> fail_task_id;
+        std::size_t num_tasks = 1;
+        {
+            std::lock_guard const lock{m_mutex};
+            if (false == m_failed_task_ids.empty()) {
+                fail_task_id = m_failed_task_ids.front();
+                m_failed_task_ids.pop_front();
+            }
+            num_tasks = std::max<std::size_t>(m_num_idle_slots, 1);
+        }
+
+        std::vector<scheduler::ScheduledTask> tasks
+                = m_client.get_next_tasks(fail_task_id, num_tasks);
+        if (tasks.empty() && fail_task_id.has_value() && false == m_client.is_connected()) {
+            // The session failed, so the scheduler may not have received the failed task
+            std::lock_guard const lock{m_mutex};
+            m_failed_task_ids.push_front(fail_task_id.value());
+        }
+        if (false == tasks.empty()) {
+            std::lock_guard const lock{m_mutex};
+            --m_num_idle_slots;
+            for (std::size_t i = 1; i < tasks.size(); ++i) {
+                m_tasks.push_back(std::move(tasks[i]));
+            }
+            return std::move(tasks.front());
+        }
+        // The scheduler holds the request until a task is ready, so only back off when the session
+        // is lost and needs to be re-established.
+        if (false == m_client.is_connected()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(cReconnectTimeout));
+        }
+    }
+
+    std::lock_guard const lock{m_mutex};
+    --m_num_idle_slots;
+    return std::nullopt;
+}
+
+auto TaskFetcher::add_failed_task(boost::uuids::uuid const task_id) -> void {
+    std::lock_guard const lock{m_mutex};
+    m_failed_task_ids.push_back(task_id);
+}
+
+auto TaskFetcher::pop_task() -> std::optional<scheduler::ScheduledTask> {
+    std::lock_guard const lock{m_mutex};
+    if (m_tasks.empty()) {
+        return std::nullopt;
+    }
+    scheduler::ScheduledTask task = std::move(m_tasks.front());
+    m_tasks.pop_front();
+    --m_num_idle_slots;
+    return task;
+}
+}  // namespace spider::worker
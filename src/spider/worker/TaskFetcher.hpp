@@ -0,0 +1,66 @@
+#ifndef SPIDER_WORKER_TASKFETCHER_HPP
+#define SPIDER_WORKER_TASKFETCHER_HPP
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/scheduler/SchedulerMessage.hpp>
+#include <spider/worker/TaskSource.hpp>
+
+namespace spider::worker {
+/**
+ * Shares one scheduler session between the task slots of a worker. Only one slot talks to the
+ * scheduler at a time, and it requests tasks for every idle slot in one round-trip. Tasks that are
+ * not for the requesting slot are kept for the other idle slots.
+ */
+class TaskFetcher {
+public:
+    explicit TaskFetcher(TaskSource& client) : m_client{client} {}
+
+    // Delete copy & move constructors and assignment operators
+    TaskFetcher(TaskFetcher const&) = delete;
+    auto operator=(TaskFetcher const&) -> TaskFetcher& = delete;
+    TaskFetcher(TaskFetcher&&) = delete;
+    auto operator=(TaskFetcher&&) -> TaskFetcher& = delete;
+    ~TaskFetcher() = default;
+
+    /**
+     * Gets the next task for an idle slot. Blocks until a task is assigned or a stop is requested.
+     *
+     * @return The assigned task.
+     * @return std::nullopt if a stop is requested.
+     */
+    auto fetch() -> std::optional<scheduler::ScheduledTask>;
+
+    /**
+     * Records a task that failed on this worker. The failure is reported to the scheduler with one
+     * of the following requests. It is kept until a request reaches the scheduler, so it is
+     * reported again over a new session if the current one fails.
+     *
+     * @param task_id
+     */
+    auto add_failed_task(boost::uuids::uuid task_id) -> void;
+
+private:
+    /**
+     * @return The next task kept for idle slots, if any. Marks the calling slot as busy if a task
+     * is returned.
+     */
+    auto pop_task() -> std::optional<scheduler::ScheduledTask>;
+
+    TaskSource& m_client;
+    // Serializes the use of the scheduler session
+    std::mutex m_client_mutex;
+
+    std::mutex m_mutex;
+    std::deque<scheduler::ScheduledTask> m_tasks;
+    std::deque<boost::uuids::uuid> m_failed_task_ids;
+    std::size_t m_num_idle_slots = 0;
+};
+}  // namespace spider::worker
+
+#endif
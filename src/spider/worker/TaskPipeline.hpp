@@ -0,0 +1,164 @@
+#ifndef SPIDER_WORKER_TASKPIPELINE_HPP
+#define SPIDER_WORKER_TASKPIPELINE_HPP
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
+
+namespace spider::worker {
+/**
+ * Runs a blocking function on the thread pool and resumes on the caller's executor once it returns,
+ * so that the event loop keeps serving the other task slots.
+ *
+ * @param pool
+ * @param function
+ * @return The result of the function.
+ */
+template <typename Function>
+auto run_blocking(boost::asio::thread_pool& pool, Function function)
+        -> boost::asio::awaitable<std::invoke_result_t<Function>> {
+    auto call = [function = std::move(function)]() mutable
+            -> boost::asio::awaitable<std::invoke_result_t<Function>> { co_return function(); };
+    co_return co_await boost::asio::co_spawn(pool, std::move(call), boost::asio::use_awaitable);
+}
+
+/**
+ * A blocking call started on the thread pool without suspending the calling slot, so that it
+ * overlaps with the slot's running task. The result is collected on the event loop with `get`.
+ *
+ * @tparam T The result type of the call. Must be default constructible.
+ */
+template <typename T>
+class BackgroundCall {
+public:
+    template <typename Function>
+    BackgroundCall(
+            boost::asio::io_context& context,
+            boost::asio::thread_pool& pool,
+            Function function
+    )
+            : m_state{std::make_shared<State>(context)} {
+        boost::asio::co_spawn(
+                context,
+                run_blocking(pool, std::move(function)),
+                [state = m_state](std::exception_ptr const& exception, T result) {
+                    state->exception = exception;
+                    state->result = std::move(result);
+                    state->timer.cancel();
+                }
+        );
+    }
+
+    /**
+     * Waits for the call to return. Must be awaited on the event loop, and at most once.
+     *
+     * @return The result of the call.
+     * @throw The exception thrown by the call, if any.
+     */
+    auto get() -> boost::asio::awaitable<T> {
+        if (false == m_state->result.has_value()) {
+            co_await m_state->timer.async_wait(boost::asio::as_tuple(boost::asio::use_awaitable));
+        }
+        if (nullptr != m_state->exception) {
+            std::rethrow_exception(m_state->exception);
+        }
+        co_return std::move(m_state->result.value());
+    }
+
+private:
+    // Shared with the completion handler, which may run after the call object is destroyed
+    struct State {
+        explicit State(boost::asio::io_context& context)
+                : timer{context, boost::asio::steady_timer::time_point::max()} {}
+
+        boost::asio::steady_timer timer;
+        std::optional<T> result;
+        std::exception_ptr exception;
+    };
+
+    std::shared_ptr<State> m_state;
+};
+
+/**
+ * Runs tasks one at a time on the event loop of `context`, fetching tasks and submitting results
+ * on `pool`.
+ *
+ * The result of a task is submitted in the background while the next task is fetched and run.
+ * Results are submitted in order, with at most one submission in flight.
+ *
+ * The next task is only fetched once the current task returns. A fetched task's instance is
+ * already started, so its timeout would run while it waits behind the current task, and the task
+ * could be scheduled again elsewhere.
+ *
+ * @tparam Task
+ * @tparam Result
+ * @param context The event loop.
+ * @param pool Thread pool for blocking calls. Needs two threads per pipeline.
+ * @param fetch Blocking call that gets the next task, or std::nullopt if there is none.
+ * @param stop_requested Returns whether to stop. Checked after each fetch.
+ * @param run Runs a task on the event loop. Returns std::nullopt if there is no result to submit.
+ * @param submit Blocking call that submits the result of a task. Returns whether it succeeded.
+ */
+template <typename Task, typename Result>
+auto run_task_pipeline(
+        boost::asio::io_context& context,
+        boost::asio::thread_pool& pool,
+        std::function<std::optional<Task>()> fetch,
+        std::function<bool()> stop_requested,
+        std::function<boost::asio::awaitable<std::optional<Result>>(Task)> run,
+        std::function<bool(Result)> submit
+) -> boost::asio::awaitable<void> {
+    using FetchCall = BackgroundCall<std::optional<Task>>;
+    auto const start_fetch = [&] {
+        return std::make_unique<FetchCall>(context, pool, [fetch] { return fetch(); });
+    };
+
+    std::unique_ptr<BackgroundCall<bool>> pending_submission;
+    std::unique_ptr<FetchCall> next_fetch;
+    while (true) {
+        if (nullptr == next_fetch) {
+            next_fetch = start_fetch();
+        }
+        std::optional<Task> optional_task = co_await next_fetch->get();
+        next_fetch = nullptr;
+        if (stop_requested()) {
+            // A task fetched here never started, so it is rescheduled once the worker is found dead
+            break;
+        }
+        if (false == optional_task.has_value()) {
+            continue;
+        }
+
+        std::optional<Result> result = co_await run(std::move(optional_task.value()));
+
+        // Fetch the next task while the result is submitted
+        next_fetch = start_fetch();
+        if (false == result.has_value()) {
+            continue;
+        }
+
+        // Submit the result in the background, after the submission of the previous task
+        if (nullptr != pending_submission) {
+            co_await pending_submission->get();
+        }
+        pending_submission = std::make_unique<BackgroundCall<bool>>(
+                context,
+                pool,
+                [submit, result = std::move(result.value())]() mutable {
+                    return submit(std::move(result));
+                }
+        );
+    }
+
+    if (nullptr != pending_submission) {
+        co_await pending_submission->get();
+    }
+}
+}  // namespace spider::worker
+
+#endif
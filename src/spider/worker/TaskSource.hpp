@@ -0,0 +1,46 @@
+#ifndef SPIDER_WORKER_TASKSOURCE_HPP
+#define SPIDER_WORKER_TASKSOURCE_HPP
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <spider/scheduler/SchedulerMessage.hpp>
+
+namespace spider::worker {
+/**
+ * Requests tasks for a worker. `WorkerClient` gets them from a scheduler; tests provide their own.
+ */
+class TaskSource {
+public:
+    TaskSource() = default;
+    TaskSource(TaskSource const&) = default;
+    auto operator=(TaskSource const&) -> TaskSource& = default;
+    TaskSource(TaskSource&&) = default;
+    auto operator=(TaskSource&&) -> TaskSource& = default;
+    virtual ~TaskSource() = default;
+
+    /**
+     * Requests up to `num_tasks` tasks in one round-trip.
+     *
+     * @param fail_task_id The id of the previously failed task, if any.
+     * @param num_tasks The maximum number of tasks to request.
+     * @return The assigned tasks. Empty if no task is available or the request fails.
+     */
+    virtual auto get_next_tasks(
+            std::optional<boost::uuids::uuid> const& fail_task_id,
+            std::size_t num_tasks
+    ) -> std::vector<scheduler::ScheduledTask>
+            = 0;
+
+    /**
+     * @return Whether the source has a live session, i.e. whether the last request reached the
+     * scheduler if it returned no task.
+     */
+    [[nodiscard]] virtual auto is_connected() const -> bool = 0;
+};
+}  // namespace spider::worker
+
+#endif  // SPIDER_WORKER_TASKSOURCE_HPP
@@ -1,6 +1,7 @@
 #include "WorkerClient.hpp"
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <memory>
 #include <optional>
@@ -8,7 +9,6 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
-#include <tuple>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -18,7 +18,6 @@
 
 #include <spider/core/Driver.hpp>
 #include <spider/core/Error.hpp>
-#include <spider/core/Task.hpp>
 #include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
 #include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
 #include <spider/io/msgpack_message.hpp>
@@ -71,7 +70,56 @@ WorkerClient::WorkerClient(
           m_storage_factory(std::move(storage_factory)) {}
 
 auto WorkerClient::get_next_task(std::optional<boost::uuids::uuid> const& fail_task_id)
-        -> std::optional<std::tuple<boost::uuids::uuid, boost::uuids::uuid>> {
+        -> std::optional<scheduler::ScheduledTask> {
+    std::vector<scheduler::ScheduledTask> tasks = get_next_tasks(fail_task_id, 1);
+    if (tasks.empty()) {
+        return std::nullopt;
+    }
+    return std::move(tasks.front());
+}
+
+auto WorkerClient::get_next_tasks(
+        std::optional<boost::uuids::uuid> const& fail_task_id,
+        std::size_t const num_tasks
+) -> std::vector<scheduler::ScheduledTask> {
+    if (nullptr == m_socket && false == connect()) {
+        return {};
+    }
+
+    scheduler::ScheduleTaskRequest const
+            request{m_worker_id, m_worker_addr, fail_task_id, num_tasks};
+    msgpack::sbuffer request_buffer;
+    msgpack::pack(request_buffer, request);
+
+    if (false == core::send_message(*m_socket, request_buffer)) {
+        disconnect();
+        return {};
+    }
+
+    // Receive response
+    std::optional<msgpack::sbuffer> const optional_response_buffer
+            = core::receive_message(*m_socket);
+    if (!optional_response_buffer.has_value()) {
+        disconnect();
+        return {};
+    }
+    msgpack::sbuffer const& response_buffer = optional_response_buffer.value();
+
+    scheduler::ScheduleTaskResponse response;
+    try {
+        msgpack::object_handle const response_handle
+                = msgpack::unpack(response_buffer.data(), response_buffer.size());
+        response_handle.get().convert(response);
+    } catch (std::runtime_error const& e) {
+        spdlog::error("Cannot parse schedule task response: {}", e.what());
+        disconnect();
+        return {};
+    }
+
+    return response.get_tasks();
+}
+
+auto WorkerClient::connect() -> bool {
     // Get schedulers
     std::vector<core::Scheduler> schedulers;
 
@@ -83,15 +131,15 @@ auto WorkerClient::get_next_task(std::optional<boost::uuids::uuid> const& fail_t
                     "Failed to connect to storage: {}",
                     std::get<core::StorageErr>(conn_result).description
             );
-            return std::nullopt;
+            return false;
         }
         auto conn = std::move(std::get<std::unique_ptr<core::StorageConnection>>(conn_result));
         if (!m_metadata_store->get_active_scheduler(*conn, &schedulers).success()) {
-            return std::nullopt;
+            return false;
         }
     }
     if (schedulers.empty()) {
-        return std::nullopt;
+        return false;
     }
 
     std::random_device random_device;
@@ -99,14 +147,10 @@ auto WorkerClient::get_next_task(std::optional<boost::uuids::uuid> const& fail_t
     std::ranges::shuffle(schedulers, rng);
 
     try {
-        // Create socket to scheduler
-        boost::asio::io_context context;
-        boost::asio::ip::tcp::socket socket(context);
-
         std::vector<boost::asio::ip::tcp::endpoint> endpoints;
         for (auto const& scheduler : schedulers) {
             auto const resolved_endpoints{
-                    resolve_hostname(context, scheduler.get_addr(), scheduler.get_port())
+                    resolve_hostname(m_context, scheduler.get_addr(), scheduler.get_port())
             };
             endpoints.insert(
                     endpoints.cend(),
@@ -116,63 +160,25 @@ auto WorkerClient::get_next_task(std::optional<boost::uuids::uuid> const& fail_t
         }
         if (endpoints.empty()) {
             spdlog::error("Failed to resolve any scheduler addresses.");
-            return std::nullopt;
-        }
-
-        boost::asio::connect(socket, endpoints);
-
-        scheduler::ScheduleTaskRequest request{m_worker_id, m_worker_addr};
-        if (fail_task_id.has_value()) {
-            request = scheduler::ScheduleTaskRequest{
-                    m_worker_id,
-                    m_worker_addr,
-                    fail_task_id.value()
-            };
-        }
-        msgpack::sbuffer request_buffer;
-        msgpack::pack(request_buffer, request);
-
-        core::send_message(socket, request_buffer);
-
-        // Receive response
-        std::optional<msgpack::sbuffer> const optional_response_buffer
-                = core::receive_message(socket);
-        if (!optional_response_buffer.has_value()) {
-            return std::nullopt;
-        }
-        msgpack::sbuffer const& response_buffer = optional_response_buffer.value();
-
-        scheduler::ScheduleTaskResponse response;
-        msgpack::object_handle const response_handle
-                = msgpack::unpack(response_buffer.data(), response_buffer.size());
-        response_handle.get().convert(response);
-
-        if (!response.has_task_id()) {
-            return std::nullopt;
-        }
-        boost::uuids::uuid const task_id = response.get_task_id();
-
-        std::variant<std::unique_ptr<core::StorageConnection>, core::StorageErr> conn_result
-                = m_storage_factory->provide_storage_connection();
-        if (std::holds_alternative<core::StorageErr>(conn_result)) {
-            spdlog::error(
-                    "Failed to connect to storage: {}",
-                    std::get<core::StorageErr>(conn_result).description
-            );
-            return std::nullopt;
+            return false;
         }
-        auto conn = std::move(std::get<std::unique_ptr<core::StorageConnection>>(conn_result));
 
-        core::TaskInstance const instance{task_id};
-        core::StorageErr const err = m_metadata_store->create_task_instance(*conn, instance);
-        if (!err.success()) {
-            return std::nullopt;
-        }
-        return std::make_tuple(task_id, instance.id);
+        auto socket = std::make_unique<boost::asio::ip::tcp::socket>(m_context);
+        boost::asio::connect(*socket, endpoints);
+        m_socket = std::move(socket);
+        return true;
     } catch (boost::system::system_error const& e) {
-        return std::nullopt;
-    } catch (std::runtime_error const& e) {
-        return std::nullopt;
+        spdlog::warn("Failed to connect to scheduler: {}", e.what());
+        return false;
+    }
+}
+
+auto WorkerClient::disconnect() -> void {
+    if (nullptr == m_socket) {
+        return;
     }
+    boost::system::error_code ec;
+    m_socket->close(ec);
+    m_socket = nullptr;
 }
 }  // namespace spider::worker
@@ -1,27 +1,30 @@
 #ifndef SPIDER_WORKER_WORKERCLIENT_HPP
 #define SPIDER_WORKER_WORKERCLIENT_HPP
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
-#include <tuple>
+#include <vector>
 
 #include <boost/uuid/uuid.hpp>
 
 #include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
+#include <spider/scheduler/SchedulerMessage.hpp>
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
 #include <spider/storage/StorageFactory.hpp>
+#include <spider/worker/TaskSource.hpp>
 
 namespace spider::worker {
-class WorkerClient {
+class WorkerClient final : public TaskSource {
 public:
     // Delete copy & move constructors and assignment operators
     WorkerClient(WorkerClient const&) = delete;
     auto operator=(WorkerClient const&) -> WorkerClient& = delete;
     WorkerClient(WorkerClient&&) = delete;
     auto operator=(WorkerClient&&) -> WorkerClient& = delete;
-    ~WorkerClient() = default;
+    ~WorkerClient() override = default;
 
     WorkerClient(
             boost::uuids::uuid worker_id,
@@ -31,16 +34,57 @@ public:
             std::shared_ptr<core::StorageFactory> storage_factory
     );
 
+    /**
+     * Requests the next task from the scheduler over the session connection. Connects to a
+     * scheduler first if there is no live session. The scheduler holds the request until a task is
+     * available or its long poll timeout expires.
+     *
+     * @param fail_task_id The id of the previously failed task, if any.
+     * @return The assigned task if any.
+     * @return std::nullopt if no task is available or the session fails.
+     */
     auto get_next_task(std::optional<boost::uuids::uuid> const& fail_task_id)
-            -> std::optional<std::tuple<boost::uuids::uuid, boost::uuids::uuid>>;
+            -> std::optional<scheduler::ScheduledTask>;
+
+    /**
+     * Requests up to `num_tasks` tasks from the scheduler in one round-trip. The scheduler creates
+     * the task instances and sends everything needed to run the tasks, so this does not touch the
+     * storage.
+     *
+     * @param fail_task_id The id of the previously failed task, if any.
+     * @param num_tasks The maximum number of tasks to request.
+     * @return The assigned tasks. Empty if no task is available or the session fails.
+     */
+    auto get_next_tasks(
+            std::optional<boost::uuids::uuid> const& fail_task_id,
+            std::size_t num_tasks
+    ) -> std::vector<scheduler::ScheduledTask> override;
+
+    /**
+     * @return Whether the client has a live session with a scheduler.
+     */
+    [[nodiscard]] auto is_connected() const -> bool override { return nullptr != m_socket; }
 
 private:
+    /**
+     * Opens a session with one of the active schedulers, chosen in random order so that workers
+     * spread across schedulers and fail over to the remaining ones.
+     *
+     * @return Whether the connection succeeds.
+     */
+    auto connect() -> bool;
+
+    auto disconnect() -> void;
+
     boost::uuids::uuid m_worker_id;
     std::string m_worker_addr;
 
     std::shared_ptr<core::DataStorage> m_data_store;
     std::shared_ptr<core::MetadataStorage> m_metadata_store;
     std::shared_ptr<core::StorageFactory> m_storage_factory;
+
+    boost::asio::io_context m_context;
+    std::unique_ptr<boost::asio::ip::tcp::socket> m_socket;
 };
 }  // namespace spider::worker
 #endif  // SPIDER_WORKER_WORKERCLIENT_HPP
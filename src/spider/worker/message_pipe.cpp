@@ -1,11 +1,22 @@
 #include "message_pipe.hpp"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
 #include <array>
+#include <cerrno>
 #include <cstddef>
+#include <cstring>
 #include <exception>
+#include <filesystem>
 #include <functional>
 #include <optional>
+#include <random>
 #include <string>
+#include <system_error>
 #include <vector>
 
 #include <fmt/format.h>
@@ -18,10 +29,155 @@ namespace spider::worker {
 constexpr size_t cHeaderSize = 16;
 
 namespace {
+// The header of a message in shared memory starts with this marker instead of a digit, and is
+// followed by the name of the shared memory object
+constexpr char cSharedMemoryMarker = 'm';
+// Shared memory names are "/spider-", the pid of the sender as 8 hex digits, "-" and 16 random hex
+// digits
+constexpr size_t cSharedMemoryNameSize = 33;
+// Where shared memory objects are listed on Linux, without the leading "/" of their names
+constexpr char const* cSharedMemoryDir = "/dev/shm";
+constexpr int cMaxNumNameAttempts = 8;
+
+struct MessageHeader {
+    bool shared_memory;
+    size_t body_size;
+};
+
+auto parse_header(std::array<char, cHeaderSize> const& header_buffer)
+        -> std::optional<MessageHeader> {
+    try {
+        if (cSharedMemoryMarker == header_buffer[0]) {
+            return MessageHeader{
+                    true,
+                    std::stoul(std::string{header_buffer.data() + 1, cHeaderSize - 1})
+            };
+        }
+        return MessageHeader{false, std::stoul(std::string{header_buffer.data(), cHeaderSize})};
+    } catch (std::exception& e) {
+        spdlog::error(
+                "Cannot parse header: {} {}",
+                e.what(),
+                std::string{header_buffer.data(), cHeaderSize}
+        );
+        return std::nullopt;
+    }
+}
+
+/**
+ * @param pid
+ * @return The prefix of the names of the shared memory objects created by the process, without the
+ * leading "/".
+ */
+auto get_shared_memory_prefix(pid_t const pid) -> std::string {
+    return fmt::format("spider-{:08x}-", pid);
+}
+
+/**
+ * Creates a shared memory object holding a copy of the buffer. The object is named after the
+ * calling process, so that it can be removed with `remove_process_shared_memory` if the receiver
+ * never reads it.
+ *
+ * @param buffer
+ * @return The name of the shared memory object on success.
+ * @return std::nullopt if the object cannot be created.
+ */
+auto write_shared_memory(msgpack::sbuffer const& buffer) -> std::optional<std::string> {
+    thread_local std::mt19937_64 generator{std::random_device{}()};
+    std::string name;
+    int fd = -1;
+    for (int i = 0; i < cMaxNumNameAttempts && fd < 0; ++i) {
+        name = fmt::format("/{}{:016x}", get_shared_memory_prefix(getpid()), generator());
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    }
+    if (fd < 0) {
+        spdlog::error("Cannot create shared memory: errno {}", errno);
+        return std::nullopt;
+    }
+    bool written = false;
+    if (0 == ftruncate(fd, static_cast<off_t>(buffer.size()))) {
+        void* address = mmap(nullptr, buffer.size(), PROT_WRITE, MAP_SHARED, fd, 0);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr)
+        if (MAP_FAILED != address) {
+            std::memcpy(address, buffer.data(), buffer.size());
+            munmap(address, buffer.size());
+            written = true;
+        }
+    }
+    int const error_number = errno;
+    close(fd);
+    if (false == written) {
+        spdlog::error("Cannot write shared memory {}: errno {}", name, error_number);
+        shm_unlink(name.c_str());
+        return std::nullopt;
+    }
+    return name;
+}
+
+/**
+ * Copies the content of a shared memory object into a buffer and unlinks the object.
+ *
+ * @param name_buffer The name of the shared memory object.
+ * @param size The size of the message in the shared memory object.
+ * @return The message on success.
+ * @return std::nullopt if the object cannot be read.
+ */
+auto read_shared_memory(std::array<char, cSharedMemoryNameSize> const& name_buffer, size_t size)
+        -> std::optional<msgpack::sbuffer> {
+    std::string const name{name_buffer.data(), cSharedMemoryNameSize};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+    int const fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        spdlog::error("Cannot open shared memory {}: errno {}", name, errno);
+        return std::nullopt;
+    }
+    // The mapping keeps the memory alive, so the name is no longer needed
+    shm_unlink(name.c_str());
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    int const error_number = errno;
+    close(fd);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr)
+    if (MAP_FAILED == address) {
+        spdlog::error("Cannot map shared memory {}: errno {}", name, error_number);
+        return std::nullopt;
+    }
+    msgpack::sbuffer buffer{size};
+    buffer.write(static_cast<char const*>(address), size);
+    munmap(address, size);
+    return buffer;
+}
+
 template <typename T>
-auto send_message_impl(T& output, msgpack::sbuffer const& request) -> bool {
+auto send_message_impl(
+        T& output,
+        msgpack::sbuffer const& request,
+        std::vector<std::string>* shared_memory_names
+) -> bool {
+    size_t const size = request.size();
+    if (size >= cSharedMemoryThreshold) {
+        std::optional<std::string> const name = write_shared_memory(request);
+        // Fall back to the pipe if the shared memory object cannot be created
+        if (name.has_value()) {
+            try {
+                boost::asio::write(
+                        output,
+                        boost::asio::buffer(
+                                fmt::format("{}{:015d}{}", cSharedMemoryMarker, size, name.value())
+                        )
+                );
+            } catch (boost::system::system_error const& e) {
+                spdlog::error("Failed to send message: {}", e.what());
+                shm_unlink(name->c_str());
+                return false;
+            }
+            if (nullptr != shared_memory_names) {
+                shared_memory_names->push_back(name.value());
+            }
+            return true;
+        }
+    }
     try {
-        size_t const size = request.size();
         std::string const size_str = fmt::format("{:016d}", size);
         boost::asio::write(output, boost::asio::buffer(size_str));
         boost::asio::write(output, boost::asio::buffer(request.data(), size));
@@ -33,13 +189,17 @@ auto send_message_impl(T& output, msgpack::sbuffer const& request) -> bool {
 }
 }  // namespace
 
-auto send_message(boost::asio::writable_pipe& pipe, msgpack::sbuffer const& request) -> bool {
-    return send_message_impl(pipe, request);
+auto send_message(
+        boost::asio::writable_pipe& pipe,
+        msgpack::sbuffer const& request,
+        std::vector<std::string>* shared_memory_names
+) -> bool {
+    return send_message_impl(pipe, request, shared_memory_names);
 }
 
 auto send_message(boost::asio::posix::stream_descriptor& fd, msgpack::sbuffer const& request)
         -> bool {
-    return send_message_impl(fd, request);
+    return send_message_impl(fd, request, nullptr);
 }
 
 auto receive_message(boost::asio::posix::stream_descriptor& fd) -> std::optional<msgpack::sbuffer> {
@@ -52,17 +212,21 @@ auto receive_message(boost::asio::posix::stream_descriptor& fd) -> std::optional
         }
         return std::nullopt;
     }
-    size_t body_size = 0;
-    try {
-        body_size = std::stoul(std::string{header_buffer.data(), cHeaderSize});
-    } catch (std::exception& e) {
-        spdlog::error(
-                "Cannot parse header: {} {}",
-                e.what(),
-                std::string{header_buffer.data(), cHeaderSize}
-        );
+    std::optional<MessageHeader> const header = parse_header(header_buffer);
+    if (false == header.has_value()) {
         return std::nullopt;
     }
+    size_t const body_size = header->body_size;
+    if (header->shared_memory) {
+        std::array<char, cSharedMemoryNameSize> name_buffer{0};
+        try {
+            boost::asio::read(fd, boost::asio::buffer(name_buffer));
+        } catch (boost::system::system_error& e) {
+            spdlog::error("Fail to read shared memory name: {}", e.what());
+            return std::nullopt;
+        }
+        return read_shared_memory(name_buffer, body_size);
+    }
 
     std::vector<char> body_buffer(body_size);
     try {
@@ -103,20 +267,31 @@ auto receive_message_async(std::reference_wrapper<boost::asio::readable_pipe> pi
         }
         co_return std::nullopt;
     }
-    size_t body_size = 0;
-    try {
-        body_size = std::stoul(std::string{header_buffer.data(), cHeaderSize});
-    } catch (std::exception& e) {
-        spdlog::error(
-                "Cannot parse header: {} {}",
-                e.what(),
-                std::string{header_buffer.data(), cHeaderSize}
-        );
+    std::optional<MessageHeader> const header = parse_header(header_buffer);
+    if (false == header.has_value()) {
         co_return std::nullopt;
     }
+    size_t const body_size = header->body_size;
     if (body_size == 0) {
         co_return std::nullopt;
     }
+    if (header->shared_memory) {
+        std::array<char, cSharedMemoryNameSize> name_buffer{0};
+        auto [name_ec, name_n] = co_await boost::asio::async_read(
+                pipe.get(),
+                boost::asio::buffer(name_buffer),
+                boost::asio::as_tuple(boost::asio::use_awaitable)
+        );
+        if (name_ec) {
+            spdlog::error(
+                    "Cannot read shared memory name from pipe {}: {}",
+                    name_ec.value(),
+                    name_ec.message()
+            );
+            co_return std::nullopt;
+        }
+        co_return read_shared_memory(name_buffer, body_size);
+    }
     std::vector<char> body_buffer(body_size);
     auto [body_ec, body_n] = co_await boost::asio::async_read(
             pipe.get(),
@@ -141,4 +316,23 @@ auto receive_message_async(std::reference_wrapper<boost::asio::readable_pipe> pi
     buffer.write(body_buffer.data(), body_buffer.size());
     co_return buffer;
 }
+
+auto remove_shared_memory(std::string const& name) -> void {
+    shm_unlink(name.c_str());
+}
+
+auto remove_process_shared_memory(pid_t const pid) -> void {
+    std::string const prefix = get_shared_memory_prefix(pid);
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it{cSharedMemoryDir, ec};
+         !ec && std::filesystem::directory_iterator{} != it;
+         it.increment(ec))
+    {
+        std::string const file_name = it->path().filename().string();
+        if (file_name.starts_with(prefix)) {
+            spdlog::warn("Removing unread shared memory /{}", file_name);
+            shm_unlink(fmt::format("/{}", file_name).c_str());
+        }
+    }
+}
 }  // namespace spider::worker
@@ -1,14 +1,37 @@
 #ifndef SPIDER_WORKER_MESSAGE_PIPE_HPP
 #define SPIDER_WORKER_MESSAGE_PIPE_HPP
 
+#include <sys/types.h>
+
+#include <cstddef>
 #include <functional>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
 #include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
 
 namespace spider::worker {
-auto send_message(boost::asio::writable_pipe& pipe, msgpack::sbuffer const& request) -> bool;
+// Messages of at least this size are written to a shared memory object, and only the name of the
+// object is sent through the pipe. The receiver maps the object and unlinks it. The name of the
+// object includes the pid of the sender.
+constexpr std::size_t cSharedMemoryThreshold = 64 * 1024;
+
+/**
+ * Sends a message through the pipe, or through shared memory if the message is large.
+ *
+ * @param pipe
+ * @param request
+ * @param shared_memory_names If not null, the name of the shared memory object created for the
+ * message is appended, so that the sender can remove it if the receiver exits without reading it.
+ * @return Whether the message is sent.
+ */
+auto send_message(
+        boost::asio::writable_pipe& pipe,
+        msgpack::sbuffer const& request,
+        std::vector<std::string>* shared_memory_names = nullptr
+) -> bool;
 
 auto send_message(boost::asio::posix::stream_descriptor& fd, msgpack::sbuffer const& request)
         -> bool;
@@ -17,6 +40,23 @@ auto receive_message_async(std::reference_wrapper<boost::asio::readable_pipe> pi
         -> boost::asio::awaitable<std::optional<msgpack::sbuffer>>;
 
 auto receive_message(boost::asio::posix::stream_descriptor& fd) -> std::optional<msgpack::sbuffer>;
+
+/**
+ * Removes a shared memory object created by `send_message`. Does nothing if the receiver already
+ * unlinked it.
+ *
+ * @param name
+ */
+auto remove_shared_memory(std::string const& name) -> void;
+
+/**
+ * Removes the shared memory objects created by `send_message` in a process and not read by their
+ * receivers, e.g. results of a task executor that exited before its worker read them. Must only be
+ * called once the process exited and its messages were received.
+ *
+ * @param pid
+ */
+auto remove_process_shared_memory(pid_t pid) -> void;
 }  // namespace spider::worker
 
 #endif  // SPIDER_WORKER_MESSAGE_PIPE_HPP
@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <optional>
@@ -10,6 +11,7 @@
 #include <boost/program_options/parsers.hpp>
 #include <boost/program_options/value_semantic.hpp>
 #include <boost/program_options/variables_map.hpp>
+#include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/string_generator.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <fmt/format.h>
@@ -18,9 +20,9 @@
 #include <spider/client/TaskContext.hpp>
 #include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
 #include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
+#include <spider/io/Serializer.hpp>  // IWYU pragma: keep
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
-#include <spider/storage/mysql/MySqlStorageFactory.hpp>
 #include <spider/storage/StorageFactory.hpp>
 #include <spider/utils/env.hpp>
 #include <spider/utils/logging.hpp>
@@ -59,6 +61,10 @@ auto parse_arg(int const argc, char** const& argv) -> boost::program_options::va
             boost::program_options::value<std::string>(),
             "storage server url"
     );
+    desc.add_options()(
+            "persistent",
+            "run the tasks of task requests until the input pipe closes, instead of `func`"
+    );
 
     boost::program_options::variables_map variables;
     boost::program_options::store(
@@ -69,6 +75,60 @@ auto parse_arg(int const argc, char** const& argv) -> boost::program_options::va
     boost::program_options::notify(variables);
     return variables;
 }
+
+/**
+ * Runs a function and sends its result, or the error if the function is not found, through the
+ * output pipe.
+ *
+ * @param out The output pipe.
+ * @param func_name
+ * @param task_id
+ * @param args_object The arguments of the function.
+ * @param storage_factory
+ * @param metadata_store
+ * @param data_store
+ * @return Whether the function is found.
+ */
+auto run_function(
+        boost::asio::posix::stream_descriptor& out,
+        std::string const& func_name,
+        boost::uuids::uuid const task_id,
+        msgpack::object const& args_object,
+        std::shared_ptr<spider::core::StorageFactory> const& storage_factory,
+        std::shared_ptr<spider::core::MetadataStorage> const& metadata_store,
+        std::shared_ptr<spider::core::DataStorage> const& data_store
+) -> bool {
+    msgpack::sbuffer args_buffer;
+    msgpack::packer packer{args_buffer};
+    packer.pack(args_object);
+    spdlog::debug("Args buffer parsed");
+
+    spdlog::debug("Function to run: {}", func_name);
+    spider::core::Function const* function
+            = spider::core::FunctionManager::get_instance().get_function(func_name);
+    if (nullptr == function) {
+        spider::worker::send_message(
+                out,
+                spider::core::create_error_response(
+                        spider::core::FunctionInvokeError::FunctionExecutionError,
+                        fmt::format("Function {} not found.", func_name)
+                )
+        );
+        return false;
+    }
+    spider::TaskContext task_context = spider::core::TaskContextImpl::create_task_context(
+            task_id,
+            data_store,
+            metadata_store,
+            storage_factory
+    );
+    msgpack::sbuffer const result_buffer = (*function)(task_context, task_id, args_buffer);
+    spdlog::debug("Function executed");
+
+    // Write result buffer to stdout
+    spider::worker::send_message(out, result_buffer);
+    return true;
+}
 }  // namespace
 
 constexpr int cCmdArgParseErr = 1;
@@ -79,6 +139,9 @@ constexpr int cFuncArgParseErr = 5;
 constexpr int cResultSendErr = 6;
 constexpr int cOtherErr = 7;
 
+// Number of elements in the body of a task request: function name, task id and arguments
+constexpr std::uint32_t cTaskRequestBodySize = 3;
+
 auto main(int const argc, char** argv) -> int {
     boost::program_options::variables_map const args = parse_arg(argc, argv);
 
@@ -88,21 +151,31 @@ auto main(int const argc, char** argv) -> int {
     int input_pipe_fd{-1};
     int output_pipe_fd{-1};
     boost::uuids::uuid task_id;
+    bool const persistent = args.contains("persistent");
     try {
-        if (!args.contains("func")) {
-            return cCmdArgParseErr;
-        }
-        func_name = args["func"].as<std::string>();
-        if (!args.contains("task_id")) {
-            return cCmdArgParseErr;
+        if (persistent) {
+            // A persistent executor runs many tasks, so it logs under its own id
+            spider::utils::setup_directory_logger(
+                    "task",
+                    "spider.executor",
+                    boost::uuids::random_generator{}()
+            );
+        } else {
+            if (!args.contains("func")) {
+                return cCmdArgParseErr;
+            }
+            func_name = args["func"].as<std::string>();
+            if (!args.contains("task_id")) {
+                return cCmdArgParseErr;
+            }
+            task_id_string = args["task_id"].as<std::string>();
+            task_id = boost::uuids::string_generator{}(task_id_string);
+
+            spider::utils::setup_directory_logger("task", "spider.executor", task_id);
         }
-        task_id_string = args["task_id"].as<std::string>();
         if (false == args.contains("input-pipe")) {
             return cCmdArgParseErr;
         }
-        task_id = boost::uuids::string_generator{}(task_id_string);
-
-        spider::utils::setup_directory_logger("task", "spider.executor", task_id);
 
         input_pipe_fd = args["input-pipe"].as<int>();
         if (input_pipe_fd < 0) {
@@ -135,6 +208,15 @@ auto main(int const argc, char** argv) -> int {
             return cCmdArgParseErr;
         }
 
+        if (spider::core::is_process_local_storage_url(storage_url)) {
+            spdlog::error(
+                    "Storage URL {} is only reachable from a single process and cannot be shared "
+                    "with other spider processes.",
+                    storage_url
+            );
+            return cCmdArgParseErr;
+        }
+
         if (!args.contains("libs")) {
             return cCmdArgParseErr;
         }
@@ -151,14 +233,10 @@ auto main(int const argc, char** argv) -> int {
         return cCmdArgParseErr;
     }
 
-    spdlog::debug("Function to run: {}", func_name);
-
     try {
-        // Parse task id
-
         // Set up storage
         std::shared_ptr<spider::core::StorageFactory> const storage_factory
-                = std::make_shared<spider::core::MySqlStorageFactory>(storage_url);
+                = spider::core::create_storage_factory(storage_url);
         std::shared_ptr<spider::core::MetadataStorage> const metadata_store
                 = storage_factory->provide_metadata_storage();
         std::shared_ptr<spider::core::DataStorage> const data_store
@@ -169,6 +247,43 @@ auto main(int const argc, char** argv) -> int {
         boost::asio::posix::stream_descriptor in(context, input_pipe_fd);
         boost::asio::posix::stream_descriptor out(context, output_pipe_fd);
 
+        if (persistent) {
+            // The worker closes the input pipe to stop the executor
+            while (true) {
+                std::optional<msgpack::sbuffer> const request_buffer_option
+                        = spider::worker::receive_message(in);
+                if (!request_buffer_option.has_value()) {
+                    spdlog::debug("Input pipe closed");
+                    return 0;
+                }
+                spider::worker::TaskExecutorRequestParser const request_parser{
+                        request_buffer_option.value()
+                };
+                if (spider::worker::TaskExecutorRequestType::Task != request_parser.get_type()) {
+                    spdlog::error("Expect task request.");
+                    return cFuncArgParseErr;
+                }
+                // NOLINTBEGIN(cppcoreguidelines-pro-type-union-access,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                msgpack::object const body = request_parser.get_body();
+                if (msgpack::type::ARRAY != body.type
+                    || cTaskRequestBodySize != body.via.array.size)
+                {
+                    spdlog::error("Cannot parse task request.");
+                    return cFuncArgParseErr;
+                }
+                run_function(
+                        out,
+                        body.via.array.ptr[0].as<std::string>(),
+                        body.via.array.ptr[1].as<boost::uuids::uuid>(),
+                        body.via.array.ptr[2],
+                        storage_factory,
+                        metadata_store,
+                        data_store
+                );
+                // NOLINTEND(cppcoreguidelines-pro-type-union-access,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+        }
+
         // Get args buffer from stdin
         std::optional<msgpack::sbuffer> request_buffer_option = spider::worker::receive_message(in);
         if (!request_buffer_option.has_value()) {
@@ -181,36 +296,21 @@ auto main(int const argc, char** argv) -> int {
             spdlog::error("Expect args request.");
             return cFuncArgParseErr;
         }
-        msgpack::object const args_object = request_parser.get_body();
-        msgpack::sbuffer args_buffer;
-        msgpack::packer packer{args_buffer};
-        packer.pack(args_object);
-        spdlog::debug("Args buffer parsed");
 
         // Run function
-        spider::core::Function const* function
-                = spider::core::FunctionManager::get_instance().get_function(func_name);
-        if (nullptr == function) {
-            spider::worker::send_message(
+        if (false
+            == run_function(
                     out,
-                    spider::core::create_error_response(
-                            spider::core::FunctionInvokeError::FunctionExecutionError,
-                            fmt::format("Function {} not found.", func_name)
-                    )
-            );
+                    func_name,
+                    task_id,
+                    request_parser.get_body(),
+                    storage_factory,
+                    metadata_store,
+                    data_store
+            ))
+        {
             return cResultSendErr;
         }
-        spider::TaskContext task_context = spider::core::TaskContextImpl::create_task_context(
-                task_id,
-                data_store,
-                metadata_store,
-                storage_factory
-        );
-        msgpack::sbuffer const result_buffer = (*function)(task_context, task_id, args_buffer);
-        spdlog::debug("Function executed");
-
-        // Write result buffer to stdout
-        spider::worker::send_message(out, result_buffer);
     } catch (std::exception& e) {
         spdlog::error("Exception thrown: {}", e.what());
         return cOtherErr;
@@ -0,0 +1,128 @@
+#include "task_result.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <spider/core/Data.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/core/Task.hpp>
+#include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
+#include <spider/io/Serializer.hpp>  // IWYU pragma: keep
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+#include <spider/worker/FunctionManager.hpp>
+#include <spider/worker/ResultSubmitter.hpp>
+#include <spider/worker/TaskExecutorMessage.hpp>
+
+namespace spider::worker {
+auto fail_task(
+        core::StorageConnectionPool& conn_pool,
+        std::shared_ptr<core::MetadataStorage> const& metadata_store,
+        core::TaskInstance const& instance,
+        std::string const& error
+) -> void {
+    std::variant<core::StorageConnectionPool::Lease, core::StorageErr> conn_result
+            = conn_pool.acquire();
+    if (std::holds_alternative<core::StorageErr>(conn_result)) {
+        spdlog::error(
+                "Failed to connect to storage: {}",
+                std::get<core::StorageErr>(conn_result).description
+        );
+        return;
+    }
+    auto const& conn = std::get<core::StorageConnectionPool::Lease>(conn_result);
+    metadata_store->task_fail(*conn, instance, error);
+}
+
+auto parse_outputs(core::Task const& task, std::vector<msgpack::sbuffer> const& result_buffers)
+        -> std::optional<std::vector<core::TaskOutput>> {
+    std::vector<core::TaskOutput> outputs;
+    outputs.reserve(task.get_num_outputs());
+    for (size_t i = 0; i < task.get_num_outputs(); ++i) {
+        std::string const type = task.get_output(i).get_type();
+        if (type == typeid(core::Data).name()) {
+            try {
+                msgpack::object_handle const handle
+                        = msgpack::unpack(result_buffers[i].data(), result_buffers[i].size());
+                msgpack::object const obj = handle.get();
+                boost::uuids::uuid data_id;
+                obj.convert(data_id);
+                outputs.emplace_back(data_id);
+            } catch (std::runtime_error const& e) {
+                spdlog::error(
+                        "Task {} failed to parse result as data id",
+                        task.get_function_name()
+                );
+                return std::nullopt;
+            }
+        } else {
+            msgpack::sbuffer const& buffer = result_buffers[i];
+            std::string const value{buffer.data(), buffer.size()};
+            outputs.emplace_back(value, type);
+        }
+    }
+    return outputs;
+}
+
+auto collect_in_process_result(core::Task const& task, msgpack::sbuffer const& response)
+        -> TaskResult {
+    if (TaskExecutorResponseType::Result != get_response_type(response)) {
+        auto const optional_error = core::response_get_error(response);
+        std::string const message
+                = optional_error.has_value() ? std::get<1>(optional_error.value()) : "";
+        spdlog::warn("Task {} failed: {}", task.get_function_name(), message);
+        return fmt::format("Task {} failed: {}", task.get_function_name(), message);
+    }
+
+    std::optional<std::vector<msgpack::sbuffer>> const optional_result_buffers
+            = core::response_get_result_buffers(response);
+    if (!optional_result_buffers.has_value()) {
+        spdlog::error("Task {} failed to parse result into buffers", task.get_function_name());
+        return fmt::format("Task {} failed to parse result into buffers", task.get_function_name());
+    }
+    std::optional<std::vector<core::TaskOutput>> optional_outputs
+            = parse_outputs(task, optional_result_buffers.value());
+    if (!optional_outputs.has_value()) {
+        return fmt::format(
+                "Task {} failed to parse result into TaskOutput",
+                task.get_function_name()
+        );
+    }
+    return std::move(optional_outputs.value());
+}
+
+auto submit_task_result(
+        core::StorageConnectionPool& conn_pool,
+        ResultSubmitter& submitter,
+        std::shared_ptr<core::MetadataStorage> const& metadata_store,
+        core::TaskInstance const& instance,
+        core::Task const& task,
+        TaskResult const& result
+) -> bool {
+    if (result.has_error()) {
+        fail_task(conn_pool, metadata_store, instance, result.error());
+        return false;
+    }
+
+    // Submit result
+    spdlog::debug("Submitting result for task {}", boost::uuids::to_string(task.get_id()));
+    if (false == submitter.submit(instance, result.value()).get()) {
+        spdlog::error("Submit task {} fails", task.get_function_name());
+        return false;
+    }
+    return true;
+}
+}  // namespace spider::worker
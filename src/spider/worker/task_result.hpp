@@ -0,0 +1,79 @@
+#ifndef SPIDER_WORKER_TASK_RESULT_HPP
+#define SPIDER_WORKER_TASK_RESULT_HPP
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/outcome/std_result.hpp>
+
+#include <spider/core/Task.hpp>
+#include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+#include <spider/worker/ResultSubmitter.hpp>
+
+namespace spider::worker {
+// The task outputs, or the error message of a failed execution
+using TaskResult = boost::outcome_v2::std_checked<std::vector<core::TaskOutput>, std::string>;
+
+/**
+ * Marks a task instance as failed.
+ *
+ * @param conn_pool Pool of storage connections shared by the task slots.
+ * @param metadata_store The metadata storage to use.
+ * @param instance The failed task instance.
+ * @param error The error message.
+ */
+auto fail_task(
+        core::StorageConnectionPool& conn_pool,
+        std::shared_ptr<core::MetadataStorage> const& metadata_store,
+        core::TaskInstance const& instance,
+        std::string const& error
+) -> void;
+
+/**
+ * Parses the task outputs from the result buffers of a task.
+ *
+ * @param task The task that was executed.
+ * @param result_buffers One buffer per output of the task.
+ * @return The task outputs.
+ * @return std::nullopt if a data output cannot be parsed as a data id.
+ */
+auto parse_outputs(core::Task const& task, std::vector<msgpack::sbuffer> const& result_buffers)
+        -> std::optional<std::vector<core::TaskOutput>>;
+
+/**
+ * Parses the task outputs from the response of a task run in process.
+ *
+ * @param task The task that was executed.
+ * @param response The response of the task.
+ * @return A result containing the task outputs on success, or the error message on failure.
+ */
+auto collect_in_process_result(core::Task const& task, msgpack::sbuffer const& response)
+        -> TaskResult;
+
+/**
+ * Submits the result of a task execution to the storage: the outputs if the task succeeded, or the
+ * failure otherwise. Outputs are batched with the results of the other slots by the submitter.
+ *
+ * @param conn_pool Pool of storage connections shared by the task slots.
+ * @param submitter Submitter batching the outputs of the task slots.
+ * @param metadata_store Metadata storage for submitting results.
+ * @param instance Task instance that was executed.
+ * @param task The task that was executed.
+ * @param result The task outputs, or the error message of the failed execution.
+ * @return true if results were successfully handled, false if any errors occurred.
+ */
+auto submit_task_result(
+        core::StorageConnectionPool& conn_pool,
+        ResultSubmitter& submitter,
+        std::shared_ptr<core::MetadataStorage> const& metadata_store,
+        core::TaskInstance const& instance,
+        core::Task const& task,
+        TaskResult const& result
+) -> bool;
+}  // namespace spider::worker
+
+#endif
@@ -8,10 +8,8 @@
 #include <functional>
 #include <memory>
 #include <optional>
-#include <stdexcept>
 #include <string>
 #include <thread>
-#include <tuple>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -34,23 +32,32 @@
 #include <spdlog/common.h>
 #include <spdlog/spdlog.h>
 
-#include <spider/core/Data.hpp>
+#include <spider/core/DataCache.hpp>
 #include <spider/core/Driver.hpp>
 #include <spider/core/Error.hpp>
 #include <spider/core/Task.hpp>
 #include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
 #include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
 #include <spider/io/Serializer.hpp>  // IWYU pragma: keep
+#include <spider/scheduler/SchedulerMessage.hpp>
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
-#include <spider/storage/mysql/MySqlStorageFactory.hpp>
 #include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 #include <spider/storage/StorageFactory.hpp>
 #include <spider/utils/env.hpp>
 #include <spider/utils/logging.hpp>
 #include <spider/utils/StopFlag.hpp>
 #include <spider/worker/ChildPid.hpp>
+#include <spider/worker/DllLoader.hpp>
+#include <spider/worker/FunctionManager.hpp>
+#include <spider/worker/InProcessExecutor.hpp>
+#include <spider/worker/ResultSubmitter.hpp>
+#include <spider/worker/task_result.hpp>
 #include <spider/worker/TaskExecutor.hpp>
+#include <spider/worker/TaskExecutorMessage.hpp>
+#include <spider/worker/TaskFetcher.hpp>
+#include <spider/worker/TaskPipeline.hpp>
 #include <spider/worker/WorkerClient.hpp>
 
 constexpr int cCmdArgParseErr = 1;
@@ -59,23 +66,34 @@ constexpr int cWorkerAddrErr = 3;
 constexpr int cStorageConnectionErr = 4;
 constexpr int cStorageErr = 5;
 constexpr int cTaskErr = 6;
+constexpr int cDllErr = 7;
 
 constexpr int cRetryCount = 5;
 
+constexpr std::size_t cDefaultNumSlots = 1;
+constexpr std::size_t cDefaultExecutorMaxTasks = 1;
+constexpr std::size_t cDefaultResultFlushMs = 5;
+constexpr std::size_t cDefaultResultBatchSize = 64;
+constexpr std::size_t cDefaultDataCacheSize = 64UL * 1024 * 1024;
+// A slot submits its previous result while it fetches its next task or reaps its executor
+constexpr std::size_t cNumBlockingCallsPerSlot = 2;
+
 namespace {
 /*
  * Signal handler for SIGTERM. It sets the stop flag to request a stop and sends SIGTERM to the task
- * executor.
+ * executors of all slots.
  * @param signal The signal number.
  */
 auto stop_task_handler(int signal) -> void {
     if (SIGTERM == signal) {
         spider::core::StopFlag::request_stop();
-        // Send SIGTERM to task executor
-        pid_t const pid = spider::core::ChildPid::get_pid();
-        if (pid > 0) {
-            // NOLINTNEXTLINE(misc-include-cleaner)
-            kill(pid, SIGTERM);
+        // Send SIGTERM to task executors
+        for (std::size_t slot = 0; slot < spider::core::ChildPid::cMaxNumPids; ++slot) {
+            pid_t const pid = spider::core::ChildPid::get_pid(slot);
+            if (pid > 0) {
+                // NOLINTNEXTLINE(misc-include-cleaner)
+                kill(pid, SIGTERM);
+            }
         }
     }
 }
@@ -94,6 +112,45 @@ auto parse_args(int const argc, char** argv) -> boost::program_options::variable
             "dynamic libraries that include the spider tasks"
     );
     desc.add_options()("host", boost::program_options::value<std::string>(), "worker host address");
+    desc.add_options()(
+            "slots",
+            boost::program_options::value<std::size_t>()->default_value(cDefaultNumSlots),
+            "number of tasks to run concurrently"
+    );
+    desc.add_options()(
+            "executor_max_tasks",
+            boost::program_options::value<std::size_t>()->default_value(cDefaultExecutorMaxTasks),
+            "number of c++ tasks a task executor process runs before it is replaced; values above "
+            "1 keep executors alive between tasks"
+    );
+    desc.add_options()(
+            "result_flush_ms",
+            boost::program_options::value<std::size_t>()->default_value(cDefaultResultFlushMs),
+            "time in milliseconds to wait for more task results before submitting them in one "
+            "transaction"
+    );
+    desc.add_options()(
+            "result_batch_size",
+            boost::program_options::value<std::size_t>()->default_value(cDefaultResultBatchSize),
+            "maximum number of task results submitted in one transaction"
+    );
+    desc.add_options()(
+            "in_process",
+            "run c++ tasks on a thread pool in the worker process instead of in task executor "
+            "processes; only use with trusted task libraries"
+    );
+    desc.add_options()(
+            "in_process_functions",
+            boost::program_options::value<std::vector<std::string>>(),
+            "c++ functions to run in the worker process; other tasks still run in task executor "
+            "processes"
+    );
+    desc.add_options()(
+            "data_cache_size",
+            boost::program_options::value<std::size_t>()->default_value(cDefaultDataCacheSize),
+            "maximum size in bytes of the task data cached by the worker and by each task "
+            "executor process; 0 disables the cache"
+    );
 
     boost::program_options::variables_map variables;
     boost::program_options::store(
@@ -105,7 +162,7 @@ auto parse_args(int const argc, char** argv) -> boost::program_options::variable
     return variables;
 }
 
-auto get_environment_variable() -> absl::flat_hash_map<
+auto get_environment_variable(std::size_t const data_cache_size) -> absl::flat_hash_map<
         boost::process::v2::environment::key,
         boost::process::v2::environment::value
 > {
@@ -132,6 +189,12 @@ auto get_environment_variable() -> absl::flat_hash_map<
         environment_variables.emplace("PATH", executable_dir.string());
     }
 
+    // Task executors size their data cache from the environment
+    environment_variables.insert_or_assign(
+            boost::process::v2::environment::key{std::string{spider::utils::cDataCacheSizeEnv}},
+            boost::process::v2::environment::value{std::to_string(data_cache_size)}
+    );
+
     return environment_variables;
 }
 
@@ -173,80 +236,28 @@ auto heartbeat_loop(
     }
 }
 
-constexpr int cFetchTaskTimeout = 100;
-
-auto
-fetch_task(spider::worker::WorkerClient& client, std::optional<boost::uuids::uuid> fail_task_id)
-        -> std::optional<std::tuple<boost::uuids::uuid, boost::uuids::uuid>> {
-    spdlog::debug("Fetching task");
-    while (!spider::core::StopFlag::is_stop_requested()) {
-        std::optional<std::tuple<boost::uuids::uuid, boost::uuids::uuid>> const optional_task_ids
-                = client.get_next_task(fail_task_id);
-        if (optional_task_ids.has_value()) {
-            return optional_task_ids;
-        }
-        // If the first request succeeds, later requests should not include the failed task id
-        fail_task_id = std::nullopt;
-        std::this_thread::sleep_for(std::chrono::milliseconds(cFetchTaskTimeout));
-    }
-    return std::nullopt;
-}
-
-/*
- * Sets up a task by fetching the task metadata from storage and creating argument buffers from task
- * inputs.
- *
- * @param conn The storage connection to use.
- * @param metadata_store The metadata storage to fetch task details.
- * @param instance The task instance to set up.
- * @param task Output parameter to store the fetched task details.
- * @return  A vector of buffers containing the serialized arguments of the task.
- * @return std::nullopt if any failure occurs.
- */
-auto setup_task(
-        spider::core::StorageConnection& conn,
-        std::shared_ptr<spider::core::MetadataStorage> const& metadata_store,
-        spider::core::TaskInstance const& instance,
-        spider::core::Task& task
-) -> std::optional<std::vector<msgpack::sbuffer>> {
-    // Get task details
-    auto const err = metadata_store->get_task(conn, instance.task_id, &task);
-    if (!err.success()) {
-        spdlog::error("Failed to fetch task detail: {}", err.description);
-        return std::nullopt;
-    }
-
-    std::optional<std::vector<msgpack::sbuffer>> optional_arg_buffers = task.get_arg_buffers();
-    if (!optional_arg_buffers.has_value()) {
-        spdlog::error("Failed to fetch task arguments");
-        metadata_store->task_fail(conn, instance, fmt::format("Failed to fetch task arguments"));
-        return std::nullopt;
-    }
-    return optional_arg_buffers;
-}
-
 /**
- * Sets up a task executor by fetching the task from metadata storage and spawning a task executor
- * process.
+ * Sets up a task executor by spawning a task executor process for the task assigned by the
+ * scheduler. The scheduler already created the task instance and sent the task arguments, so the
+ * storage is only used to report failures.
  *
- * @param conn The storage connection. This function takes the ownership of the pointer so it will
- * be released when the function ends.
+ * @param conn_pool Pool of storage connections shared by the task slots.
  * @param metadata_store The metadata storage to use.
  * @param storage_url The URL of the storage.
- * @param instance The task instance.
+ * @param scheduled_task The task assigned by the scheduler.
  * @param libs The dynamic libraries that include the spider tasks.
  * @param environment The environment variables for the task executor.
  * @param context The context for asynchronous operations.
  * @return A result containing a pair on success, or the ID of the failed task on failure.
  * The pair:
  * - A unique pointer to the spawned task executor.
- * - The task fetched from metadata storage.
+ * - The task with its outputs.
  */
 [[nodiscard]] auto setup_executor(
-        std::unique_ptr<spider::core::StorageConnection> conn,
+        spider::core::StorageConnectionPool& conn_pool,
         std::shared_ptr<spider::core::MetadataStorage> const& metadata_store,
         std::string const& storage_url,
-        spider::core::TaskInstance const& instance,
+        spider::scheduler::ScheduledTask const& scheduled_task,
         std::vector<std::string> const& libs,
         absl::flat_hash_map<
                 boost::process::v2::environment::key,
@@ -258,22 +269,15 @@ auto setup_task(
                 std::pair<std::unique_ptr<spider::worker::TaskExecutor>, spider::core::Task>,
                 boost::uuids::uuid
         > {
-    spider::core::Task task{""};
-
+    spider::core::TaskInstance const instance = scheduled_task.get_instance();
+    spider::core::Task task = scheduled_task.get_task();
     spdlog::debug("Fetched task {}", boost::uuids::to_string(instance.task_id));
-    // Fetch task detail from metadata storage
-    auto const optional_arg_buffers = setup_task(*conn, metadata_store, instance, task);
-    if (false == optional_arg_buffers.has_value()) {
-        spdlog::error("Failed to setup task `{}`.", task.get_function_name());
-        return instance.task_id;
-    }
-    auto const& arg_buffers = optional_arg_buffers.value();
 
-    auto const language = task.get_language();
+    std::vector<msgpack::sbuffer> const arg_buffers = scheduled_task.get_arg_buffers();
 
     std::unique_ptr<spider::worker::TaskExecutor> executor;
     // Execute task
-    switch (language) {
+    switch (task.get_language()) {
         case spider::core::TaskLanguage::Cpp: {
             executor = spider::worker::TaskExecutor::spawn_cpp_executor(
                     context,
@@ -299,87 +303,43 @@ auto setup_task(
         }
         default: {
             spdlog::error("Unsupported task language for task `{}`.", task.get_function_name());
-            metadata_store->task_fail(*conn, instance, "Unsupported task language.");
+            spider::worker::fail_task(
+                    conn_pool,
+                    metadata_store,
+                    instance,
+                    "Unsupported task language."
+            );
             return task.get_id();
         }
     }
 
     if (nullptr != executor) {
-        return std::make_pair(std::move(executor), task);
+        return std::make_pair(std::move(executor), std::move(task));
     }
     spdlog::error("Failed to spawn task executor for task `{}`.", task.get_function_name());
-    metadata_store->task_fail(*conn, instance, "Failed to spawn task executor.");
+    spider::worker::fail_task(
+            conn_pool,
+            metadata_store,
+            instance,
+            "Failed to spawn task executor."
+    );
 
     return task.get_id();
 }
 
-auto
-parse_outputs(spider::core::Task const& task, std::vector<msgpack::sbuffer> const& result_buffers)
-        -> std::optional<std::vector<spider::core::TaskOutput>> {
-    std::vector<spider::core::TaskOutput> outputs;
-    outputs.reserve(task.get_num_outputs());
-    for (size_t i = 0; i < task.get_num_outputs(); ++i) {
-        std::string const type = task.get_output(i).get_type();
-        if (type == typeid(spider::core::Data).name()) {
-            try {
-                msgpack::object_handle const handle
-                        = msgpack::unpack(result_buffers[i].data(), result_buffers[i].size());
-                msgpack::object const obj = handle.get();
-                boost::uuids::uuid data_id;
-                obj.convert(data_id);
-                outputs.emplace_back(data_id);
-            } catch (std::runtime_error const& e) {
-                spdlog::error(
-                        "Task {} failed to parse result as data id",
-                        task.get_function_name()
-                );
-                return std::nullopt;
-            }
-        } else {
-            msgpack::sbuffer const& buffer = result_buffers[i];
-            std::string const value{buffer.data(), buffer.size()};
-            outputs.emplace_back(value, type);
-        }
-    }
-    return outputs;
-}
-
 /**
- * Handles the result of a task execution. Parse the task outputs and submit them to the storage.
+ * Collects the result of a task execution and parses the task outputs from it. Does not touch the
+ * storage, so the executor can take the next task while the result is submitted.
  *
- * @param storage_factory Factory for creating storage connections.
- * @param metadata_store Metadata storage for submitting results.
- * @param instance Task instance that was executed.
  * @param task The task that was executed.
  * @param executor The executor that ran the task.
- * @return true if results were successfully handled, false if any errors occurred.
+ * @return A result containing the task outputs on success, or the error message on failure.
  */
-auto handle_executor_result(
-        std::shared_ptr<spider::core::StorageFactory> const& storage_factory,
-        std::shared_ptr<spider::core::MetadataStorage> const& metadata_store,
-        spider::core::TaskInstance const& instance,
-        spider::core::Task const& task,
-        spider::worker::TaskExecutor& executor
-) -> bool {
-    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
-            conn_result = storage_factory->provide_storage_connection();
-    if (std::holds_alternative<spider::core::StorageErr>(conn_result)) {
-        spdlog::error(
-                "Failed to connect to storage: {}",
-                std::get<spider::core::StorageErr>(conn_result).description
-        );
-        return false;
-    }
-    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
-
+auto collect_executor_result(spider::core::Task const& task, spider::worker::TaskExecutor& executor)
+        -> spider::worker::TaskResult {
     if (!executor.succeed()) {
         spdlog::warn("Task {} failed", task.get_function_name());
-        metadata_store->task_fail(
-                *conn,
-                instance,
-                fmt::format("Task {} failed", task.get_function_name())
-        );
-        return false;
+        return fmt::format("Task {} failed", task.get_function_name());
     }
 
     // Parse result
@@ -387,118 +347,314 @@ auto handle_executor_result(
             = executor.get_result_buffers();
     if (!optional_result_buffers.has_value()) {
         spdlog::error("Task {} failed to parse result into buffers", task.get_function_name());
-        metadata_store->task_fail(
-                *conn,
-                instance,
-                fmt::format("Task {} failed to parse result into buffers", task.get_function_name())
-        );
-        return false;
+        return fmt::format("Task {} failed to parse result into buffers", task.get_function_name());
     }
     std::vector<msgpack::sbuffer> const& result_buffers = optional_result_buffers.value();
-    std::optional<std::vector<spider::core::TaskOutput>> const optional_outputs
-            = parse_outputs(task, result_buffers);
+    std::optional<std::vector<spider::core::TaskOutput>> optional_outputs
+            = spider::worker::parse_outputs(task, result_buffers);
     if (!optional_outputs.has_value()) {
-        metadata_store->task_fail(
-                *conn,
-                instance,
-                fmt::format(
-                        "Task {} failed to parse result into TaskOutput",
-                        task.get_function_name()
-                )
+        return fmt::format(
+                "Task {} failed to parse result into TaskOutput",
+                task.get_function_name()
         );
-        return false;
     }
+    return std::move(optional_outputs.value());
+}
 
-    std::vector<spider::core::TaskOutput> const& outputs = optional_outputs.value();
-    // Submit result
-    spdlog::debug("Submitting result for task {}", boost::uuids::to_string(task.get_id()));
-    spider::core::StorageErr err;
-    for (int i = 0; i < cRetryCount; ++i) {
-        err = metadata_store->task_finish(*conn, instance, outputs);
-        if (err.success()) {
-            break;
-        }
-        if (spider::core::StorageErrType::DeadLockErr != err.type) {
-            spdlog::error("Submit task {} fails: {}", task.get_function_name(), err.description);
-            break;
-        }
+/**
+ * Sends a C++ task to the persistent task executor of a slot, replacing the executor if it cannot
+ * take the task, e.g. because its process exited while idle.
+ *
+ * @param executor The persistent task executor of the slot. Spawned if nullptr.
+ * @param slot The index of the slot.
+ * @param task The task to run.
+ * @param arg_buffers The arguments of the task.
+ * @param storage_url The URL of the storage.
+ * @param libs The dynamic libraries that include the spider tasks.
+ * @param environment The environment variables for the task executor.
+ * @param context The context for asynchronous operations.
+ * @return Whether the task is sent to an executor.
+ */
+auto run_on_persistent_executor(
+        std::unique_ptr<spider::worker::TaskExecutor>& executor,
+        std::size_t const slot,
+        spider::core::Task const& task,
+        std::vector<msgpack::sbuffer> const& arg_buffers,
+        std::string const& storage_url,
+        std::vector<std::string> const& libs,
+        absl::flat_hash_map<
+                boost::process::v2::environment::key,
+                boost::process::v2::environment::value
+        > const& environment,
+        boost::asio::io_context& context
+) -> bool {
+    if (nullptr != executor
+        && executor->run_task(task.get_function_name(), task.get_id(), arg_buffers))
+    {
+        return true;
     }
-    if (!err.success()) {
-        spdlog::error("Submit task {} fails: {}", task.get_function_name(), err.description);
+    if (nullptr != executor) {
+        spdlog::warn("Replacing task executor {} that failed to take a task", executor->get_pid());
+        executor->stop();
+        executor = nullptr;
+        spider::core::ChildPid::set_pid(0, slot);
+    }
+
+    executor = spider::worker::TaskExecutor::spawn_persistent_cpp_executor(
+            context,
+            storage_url,
+            libs,
+            environment
+    );
+    if (nullptr == executor) {
         return false;
     }
-    return true;
+    spider::core::ChildPid::set_pid(executor->get_pid(), slot);
+    return executor->run_task(task.get_function_name(), task.get_id(), arg_buffers);
 }
 
-// NOLINTBEGIN(clang-analyzer-unix.BlockInCriticalSection)
-auto task_loop(
-        std::shared_ptr<spider::core::StorageFactory> const& storage_factory,
+// The result of a task run by a slot, to be submitted
+struct SlotTaskResult {
+    spider::core::TaskInstance instance;
+    spider::core::Task task;
+    spider::worker::TaskResult result;
+};
+
+/**
+ * Runs tasks one at a time in a task slot. All slots run on one event loop, which also handles the
+ * outputs of their task executors. Fetching tasks, reaping executors and submitting results block,
+ * so they run on `blocking_pool`.
+ *
+ * The slot runs a task pipeline: it submits the result of a task while it fetches and runs the next
+ * one. It only fetches the next task once the current task finishes.
+ *
+ * If `executor_max_tasks` is above 1, the slot keeps a persistent executor for C++ tasks, and
+ * replaces it after it runs `executor_max_tasks` tasks or its process exits. The replacement is
+ * spawned right away, so that the next task does not wait for it.
+ *
+ * C++ tasks selected by `in_process_executor` run on its thread pool instead of in an executor.
+ *
+ * @param slot The index of the slot.
+ * @param context The event loop.
+ * @param blocking_pool Thread pool for blocking calls, with `cNumBlockingCallsPerSlot` threads per
+ * slot.
+ * @param fetcher Fetcher sharing the scheduler session between slots.
+ * @param conn_pool Pool of storage connections shared by the slots.
+ * @param submitter Submitter batching the outputs of the slots.
+ * @param metadata_store The metadata storage to use.
+ * @param storage_url The URL of the storage.
+ * @param libs The dynamic libraries that include the spider tasks.
+ * @param environment The environment variables for the task executors.
+ * @param executor_max_tasks The number of C++ tasks a task executor runs before it is replaced.
+ * @param in_process_executor Executor running C++ tasks in the worker process, or nullptr if all
+ * tasks run in task executor processes.
+ */
+auto slot_loop(
+        std::size_t const slot,
+        boost::asio::io_context& context,
+        boost::asio::thread_pool& blocking_pool,
+        spider::worker::TaskFetcher& fetcher,
+        spider::core::StorageConnectionPool& conn_pool,
+        spider::worker::ResultSubmitter& submitter,
         std::shared_ptr<spider::core::MetadataStorage> const& metadata_store,
-        spider::worker::WorkerClient& client,
         std::string const& storage_url,
         std::vector<std::string> const& libs,
         absl::flat_hash_map<
                 boost::process::v2::environment::key,
                 boost::process::v2::environment::value
-        > const& environment
-) -> void {
-    std::optional<boost::uuids::uuid> fail_task_id = std::nullopt;
-    while (!spider::core::StopFlag::is_stop_requested()) {
-        boost::asio::io_context context;
-
-        auto const& optional_task = fetch_task(client, fail_task_id);
-        if (false == optional_task.has_value()) {
-            continue;
-        }
-        auto const [task_id, task_instance_id] = optional_task.value();
-        spider::core::TaskInstance const instance{task_instance_id, task_id};
-
-        auto conn_result = storage_factory->provide_storage_connection();
-        if (std::holds_alternative<spider::core::StorageErr>(conn_result)) {
-            spdlog::error(
-                    "Failed to connect to storage: {}",
-                    std::get<spider::core::StorageErr>(conn_result).description
+        > const& environment,
+        std::size_t const executor_max_tasks,
+        spider::worker::InProcessExecutor* in_process_executor
+) -> boost::asio::awaitable<void> {
+    std::unique_ptr<spider::worker::TaskExecutor> persistent_executor;
+    std::size_t num_persistent_executor_tasks = 0;
+
+    auto const run_task = [&](spider::scheduler::ScheduledTask scheduled_task)
+            -> boost::asio::awaitable<std::optional<SlotTaskResult>> {
+        spider::core::TaskInstance const instance = scheduled_task.get_instance();
+        spider::core::Task task = scheduled_task.get_task();
+
+        std::unique_ptr<spider::worker::TaskExecutor> one_shot_executor;
+        spider::worker::TaskExecutor* executor = nullptr;
+        std::optional<spider::worker::TaskResult> result;
+        if (nullptr != in_process_executor
+            && spider::core::TaskLanguage::Cpp == task.get_language()
+            && in_process_executor->runs_function(task.get_function_name()))
+        {
+            msgpack::sbuffer const response = co_await in_process_executor->run(
+                    task.get_function_name(),
+                    task.get_id(),
+                    scheduled_task.get_arg_buffers()
             );
-            continue;
+            result = spider::worker::collect_in_process_result(task, response);
+        } else if (executor_max_tasks > 1
+                   && spider::core::TaskLanguage::Cpp == task.get_language())
+        {
+            if (false
+                == run_on_persistent_executor(
+                        persistent_executor,
+                        slot,
+                        task,
+                        scheduled_task.get_arg_buffers(),
+                        storage_url,
+                        libs,
+                        environment,
+                        context
+                ))
+            {
+                spdlog::error(
+                        "Failed to spawn task executor for task `{}`.",
+                        task.get_function_name()
+                );
+                spider::worker::fail_task(
+            conn_pool,
+            metadata_store,
+            instance,
+            "Failed to spawn task executor."
+    );
+                fetcher.add_failed_task(task.get_id());
+                co_return std::nullopt;
+            }
+            executor = persistent_executor.get();
+        } else {
+            auto executor_setup_result = setup_executor(
+                    conn_pool,
+                    metadata_store,
+                    storage_url,
+                    scheduled_task,
+                    libs,
+                    environment,
+                    context
+            );
+            if (executor_setup_result.has_error()) {
+                fetcher.add_failed_task(executor_setup_result.error());
+                co_return std::nullopt;
+            }
+            one_shot_executor = std::move(executor_setup_result.value().first);
+            task = std::move(executor_setup_result.value().second);
+            executor = one_shot_executor.get();
+            spider::core::ChildPid::set_pid(executor->get_pid(), slot);
         }
-        auto pre_execution_conn = std::get<std::unique_ptr<spider::core::StorageConnection>>(
-                std::move(conn_result)
-        );
 
-        auto executor_setup_result = setup_executor(
-                std::move(pre_execution_conn),
-                metadata_store,
-                storage_url,
-                instance,
-                libs,
-                environment,
-                context
-        );
-        if (executor_setup_result.has_error()) {
-            fail_task_id = executor_setup_result.error();
-            continue;
+        if (nullptr != executor) {
+            // Double check if stop token is set to avoid any missing signal
+            if (spider::core::StopFlag::is_stop_requested()) {
+                // NOLINTNEXTLINE(misc-include-cleaner)
+                kill(executor->get_pid(), SIGTERM);
+            }
+
+            co_await executor->async_wait_output();
+            result = co_await spider::worker::run_blocking(blocking_pool, [&] {
+                executor->wait();
+                if (nullptr != one_shot_executor) {
+                    spider::core::ChildPid::set_pid(0, slot);
+                }
+                return collect_executor_result(task, *executor);
+            });
         }
-        auto& [executor, task] = executor_setup_result.value();
 
-        auto const pid = executor->get_pid();
-        spider::core::ChildPid::set_pid(pid);
-        // Double check if stop token is set to avoid any missing signal
-        if (spider::core::StopFlag::is_stop_requested()) {
-            // NOLINTNEXTLINE(misc-include-cleaner)
-            kill(pid, SIGTERM);
+        if (nullptr != executor && executor == persistent_executor.get()) {
+            ++num_persistent_executor_tasks;
+            if (num_persistent_executor_tasks >= executor_max_tasks
+                || false == persistent_executor->reusable())
+            {
+                co_await spider::worker::run_blocking(blocking_pool, [&] {
+                    return persistent_executor->stop();
+                });
+                spider::core::ChildPid::set_pid(0, slot);
+                num_persistent_executor_tasks = 0;
+                persistent_executor = spider::worker::TaskExecutor::spawn_persistent_cpp_executor(
+                        context,
+                        storage_url,
+                        libs,
+                        environment
+                );
+                if (nullptr != persistent_executor) {
+                    spider::core::ChildPid::set_pid(persistent_executor->get_pid(), slot);
+                }
+            }
         }
 
-        context.run();
-        executor->wait();
+        co_return SlotTaskResult{instance, std::move(task), std::move(result.value())};
+    };
 
-        spider::core::ChildPid::set_pid(0);
+    co_await spider::worker::run_task_pipeline<spider::scheduler::ScheduledTask, SlotTaskResult>(
+            context,
+            blocking_pool,
+            [&fetcher] { return fetcher.fetch(); },
+            [] { return spider::core::StopFlag::is_stop_requested(); },
+            run_task,
+            [&conn_pool, &submitter, &metadata_store, &fetcher](SlotTaskResult task_result) {
+                bool const success = spider::worker::submit_task_result(
+                        conn_pool,
+                        submitter,
+                        metadata_store,
+                        task_result.instance,
+                        task_result.task,
+                        task_result.result
+                );
+                if (false == success) {
+                    fetcher.add_failed_task(task_result.task.get_id());
+                }
+                return success;
+            }
+    );
 
-        if (handle_executor_result(storage_factory, metadata_store, instance, task, *executor)) {
-            fail_task_id = std::nullopt;
-        } else {
-            fail_task_id = task.get_id();
-        }
+    if (nullptr != persistent_executor) {
+        co_await spider::worker::run_blocking(blocking_pool, [&] {
+            return persistent_executor->stop();
+        });
+        spider::core::ChildPid::set_pid(0, slot);
+    }
+}
+
+// NOLINTBEGIN(clang-analyzer-unix.BlockInCriticalSection)
+auto task_loop(
+        std::shared_ptr<spider::core::StorageFactory> const& storage_factory,
+        std::shared_ptr<spider::core::MetadataStorage> const& metadata_store,
+        spider::worker::WorkerClient& client,
+        std::string const& storage_url,
+        std::vector<std::string> const& libs,
+        absl::flat_hash_map<
+                boost::process::v2::environment::key,
+                boost::process::v2::environment::value
+        > const& environment,
+        std::size_t const num_slots,
+        std::size_t const executor_max_tasks,
+        std::chrono::milliseconds const result_flush_interval,
+        std::size_t const result_batch_size,
+        spider::worker::InProcessExecutor* in_process_executor
+) -> void {
+    boost::asio::io_context context;
+    boost::asio::thread_pool blocking_pool{num_slots * cNumBlockingCallsPerSlot};
+    // One more connection for the result submitter
+    spider::core::StorageConnectionPool conn_pool{storage_factory, num_slots + 1};
+    spider::worker::ResultSubmitter
+            submitter{metadata_store, conn_pool, result_flush_interval, result_batch_size};
+    spider::worker::TaskFetcher fetcher{client};
+    for (std::size_t slot = 0; slot < num_slots; ++slot) {
+        boost::asio::co_spawn(
+                context,
+                slot_loop(
+                        slot,
+                        context,
+                        blocking_pool,
+                        fetcher,
+                        conn_pool,
+                        submitter,
+                        metadata_store,
+                        storage_url,
+                        libs,
+                        environment,
+                        executor_max_tasks,
+                        in_process_executor
+                ),
+                boost::asio::detached
+        );
     }
+    // Returns once every slot stops
+    context.run();
+    blocking_pool.join();
 }
 
 // NOLINTEND(clang-analyzer-unix.BlockInCriticalSection)
@@ -517,6 +673,13 @@ auto main(int argc, char** argv) -> int {
     std::string storage_url;
     std::vector<std::string> libs;
     std::string worker_addr;
+    std::size_t num_slots = cDefaultNumSlots;
+    std::size_t executor_max_tasks = cDefaultExecutorMaxTasks;
+    std::size_t result_flush_interval = cDefaultResultFlushMs;
+    std::size_t result_batch_size = cDefaultResultBatchSize;
+    bool in_process = false;
+    std::vector<std::string> in_process_functions;
+    std::size_t data_cache_size = cDefaultDataCacheSize;
     try {
         auto const optional_storage_url_env = spider::utils::get_env(spider::utils::cStorageUrlEnv);
         if (optional_storage_url_env.has_value()) {
@@ -536,6 +699,15 @@ auto main(int argc, char** argv) -> int {
             return cCmdArgParseErr;
         }
 
+        if (spider::core::is_process_local_storage_url(storage_url)) {
+            spdlog::error(
+                    "Storage URL {} is only reachable from a single process and cannot be shared "
+                    "with other spider processes.",
+                    storage_url
+            );
+            return cCmdArgParseErr;
+        }
+
         if (!args.contains("host")) {
             spdlog::error("Missing host");
             return cCmdArgParseErr;
@@ -544,6 +716,27 @@ auto main(int argc, char** argv) -> int {
         if (args.contains("libs")) {
             libs = args["libs"].as<std::vector<std::string>>();
         }
+        num_slots = args["slots"].as<std::size_t>();
+        if (0 == num_slots || num_slots > spider::core::ChildPid::cMaxNumPids) {
+            spdlog::error("slots must be between 1 and {}", spider::core::ChildPid::cMaxNumPids);
+            return cCmdArgParseErr;
+        }
+        executor_max_tasks = args["executor_max_tasks"].as<std::size_t>();
+        if (0 == executor_max_tasks) {
+            spdlog::error("executor_max_tasks must be positive");
+            return cCmdArgParseErr;
+        }
+        result_flush_interval = args["result_flush_ms"].as<std::size_t>();
+        result_batch_size = args["result_batch_size"].as<std::size_t>();
+        if (0 == result_batch_size) {
+            spdlog::error("result_batch_size must be positive");
+            return cCmdArgParseErr;
+        }
+        if (args.contains("in_process_functions")) {
+            in_process_functions = args["in_process_functions"].as<std::vector<std::string>>();
+        }
+        in_process = args.contains("in_process") || false == in_process_functions.empty();
+        data_cache_size = args["data_cache_size"].as<std::size_t>();
     } catch (boost::bad_any_cast const& e) {
         spdlog::error("Error: {}", e.what());
         return cCmdArgParseErr;
@@ -565,12 +758,33 @@ auto main(int argc, char** argv) -> int {
 
     // Create storage
     std::shared_ptr<spider::core::StorageFactory> const storage_factory
-            = std::make_shared<spider::core::MySqlStorageFactory>(storage_url);
+            = spider::core::create_storage_factory(storage_url);
     std::shared_ptr<spider::core::MetadataStorage> const metadata_store
             = storage_factory->provide_metadata_storage();
     std::shared_ptr<spider::core::DataStorage> const data_store
             = storage_factory->provide_data_storage();
 
+    spider::core::DataCache::get_instance().set_capacity(data_cache_size);
+
+    // Load the task libraries into the worker to run tasks in process
+    std::unique_ptr<spider::worker::InProcessExecutor> in_process_executor;
+    if (in_process) {
+        spider::worker::DllLoader& dll_loader = spider::worker::DllLoader::get_instance();
+        for (std::string const& lib : libs) {
+            if (false == dll_loader.load_dll(lib)) {
+                spdlog::error("Failed to load task library {}", lib);
+                return cDllErr;
+            }
+        }
+        in_process_executor = std::make_unique<spider::worker::InProcessExecutor>(
+                storage_factory,
+                metadata_store,
+                data_store,
+                num_slots,
+                in_process_functions
+        );
+    }
+
     spider::core::Driver driver{worker_id};
 
     {  // Keep the scope of RAII storage connection
@@ -602,7 +816,7 @@ auto main(int argc, char** argv) -> int {
             boost::process::v2::environment::key,
             boost::process::v2::environment::value
     > const environment_variables
-            = get_environment_variable();
+            = get_environment_variable(data_cache_size);
 
     // Start a thread that periodically updates the scheduler's heartbeat
     std::thread heartbeat_thread{
@@ -621,6 +835,11 @@ auto main(int argc, char** argv) -> int {
             std::cref(storage_url),
             std::cref(libs),
             std::cref(environment_variables),
+            num_slots,
+            executor_max_tasks,
+            std::chrono::milliseconds{result_flush_interval},
+            result_batch_size,
+            in_process_executor.get(),
     };
 
     heartbeat_thread.join();
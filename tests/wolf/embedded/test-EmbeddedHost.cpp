@@ -0,0 +1,67 @@
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+
+#include <memory>
+#include <stdexcept>
+#include <variant>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <spider/client/Driver.hpp>
+#include <spider/client/Job.hpp>
+#include <spider/client/TaskContext.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/embedded/EmbeddedHost.hpp>
+
+namespace {
+constexpr char const* cStorageUrl = "memory://embedded_host_test";
+constexpr unsigned short cPort = 6023;
+
+auto embedded_sum(spider::TaskContext& /*context*/, int const x, int const y) -> int {
+    return x + y;
+}
+
+auto embedded_throw(spider::TaskContext& /*context*/, int const /*x*/) -> int {
+    throw std::runtime_error("embedded error");
+}
+
+SPIDER_REGISTER_TASK(embedded_sum);
+SPIDER_REGISTER_TASK(embedded_throw);
+
+TEST_CASE("Embedded host runs jobs of a driver in the same process", "[embedded]") {
+    std::variant<std::unique_ptr<spider::embedded::EmbeddedHost>, spider::core::StorageErr>
+            host_result = spider::embedded::EmbeddedHost::start(cStorageUrl, cPort, 2);
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::embedded::EmbeddedHost>>(host_result));
+    auto& host = std::get<std::unique_ptr<spider::embedded::EmbeddedHost>>(host_result);
+
+    {
+        spider::Driver driver{cStorageUrl};
+
+        // Task registered in the process should run on the embedded worker
+        spider::Job<int> sum_job = driver.start(&embedded_sum, 2, 3);
+        sum_job.wait_complete();
+        REQUIRE(spider::JobStatus::Succeeded == sum_job.get_status());
+        REQUIRE(5 == sum_job.get_result());
+
+        // Exception thrown by the task should fail the job
+        spider::Job<int> throw_job = driver.start(&embedded_throw, 1);
+        throw_job.wait_complete();
+        REQUIRE(spider::JobStatus::Failed == throw_job.get_status());
+    }
+
+    host->stop();
+
+    // A new host can start once the previous one stops
+    std::variant<std::unique_ptr<spider::embedded::EmbeddedHost>, spider::core::StorageErr>
+            restart_result = spider::embedded::EmbeddedHost::start(cStorageUrl, cPort, 1);
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::embedded::EmbeddedHost>>(
+            restart_result
+    ));
+    spider::Driver driver{cStorageUrl};
+    spider::Job<int> job = driver.start(&embedded_sum, 4, 5);
+    job.wait_complete();
+    REQUIRE(spider::JobStatus::Succeeded == job.get_status());
+    REQUIRE(9 == job.get_result());
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
@@ -0,0 +1,255 @@
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,clang-analyzer-optin.core.EnumCastOutOfRange)
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include <spider/core/Task.hpp>
+#include <spider/scheduler/ReadyQueue.hpp>
+
+namespace {
+auto create_task(
+        boost::uuids::random_generator& gen,
+        std::chrono::system_clock::time_point const creation_time,
+        std::vector<std::string> const& hard_localities
+) -> spider::core::ScheduleTaskMetadata {
+    spider::core::ScheduleTaskMetadata task{gen(), "task", gen()};
+    task.set_job_creation_time(creation_time);
+    for (std::string const& locality : hard_localities) {
+        task.add_hard_locality(locality);
+    }
+    return task;
+}
+
+/**
+ * The sort-and-scan ready queue `FifoPolicy` used before `ReadyQueue`, kept as the benchmark
+ * baseline.
+ */
+class SortedVectorQueue {
+public:
+    auto push_all(std::vector<spider::core::ScheduleTaskMetadata> const& tasks) -> void {
+        m_tasks.insert(m_tasks.end(), tasks.cbegin(), tasks.cend());
+        std::ranges::sort(
+                m_tasks,
+                [](spider::core::ScheduleTaskMetadata const& a,
+                   spider::core::ScheduleTaskMetadata const& b) {
+                    return a.get_job_creation_time() > b.get_job_creation_time();
+                }
+        );
+    }
+
+    auto pop(std::string const& worker_addr) -> std::optional<boost::uuids::uuid> {
+        auto const reverse_begin = std::reverse_iterator(m_tasks.end());
+        auto const reverse_end = std::reverse_iterator(m_tasks.begin());
+        auto const it = std::find_if(
+                reverse_begin,
+                reverse_end,
+                [&](spider::core::ScheduleTaskMetadata const& task) {
+                    std::vector<std::string> const& hard_localities = task.get_hard_localities();
+                    return hard_localities.empty()
+                           || std::ranges::find(hard_localities, worker_addr)
+                                      != hard_localities.end();
+                }
+        );
+        if (it == reverse_end) {
+            return std::nullopt;
+        }
+        boost::uuids::uuid const task_id = it->get_id();
+        m_tasks.erase(std::next(it).base());
+        return task_id;
+    }
+
+private:
+    std::vector<spider::core::ScheduleTaskMetadata> m_tasks;
+};
+
+TEST_CASE("Ready queue pops in creation time order", "[scheduler]") {
+    boost::uuids::random_generator gen;
+    auto const now = std::chrono::system_clock::now();
+    spider::core::ScheduleTaskMetadata const late = create_task(gen, now, {});
+    spider::core::ScheduleTaskMetadata const early
+            = create_task(gen, now - std::chrono::seconds(1), {});
+
+    spider::scheduler::ReadyQueue queue;
+    queue.push(late);
+    queue.push(early);
+    // Duplicate push should be ignored
+    queue.push(late);
+    REQUIRE(2 == queue.size());
+
+    std::optional<spider::core::ScheduleTaskMetadata> task = queue.pop("");
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_id() == early.get_id());
+    task = queue.pop("");
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_id() == late.get_id());
+    REQUIRE_FALSE(queue.pop("").has_value());
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("Ready queue respects hard locality", "[scheduler]") {
+    boost::uuids::random_generator gen;
+    auto const now = std::chrono::system_clock::now();
+    spider::core::ScheduleTaskMetadata const local
+            = create_task(gen, now - std::chrono::seconds(2), {"10.0.0.1", "10.0.0.2"});
+    spider::core::ScheduleTaskMetadata const free = create_task(gen, now, {});
+
+    spider::scheduler::ReadyQueue queue;
+    queue.push(local);
+    queue.push(free);
+
+    // Worker on another host only gets the task without hard locality
+    std::optional<spider::core::ScheduleTaskMetadata> task = queue.pop("10.0.0.3");
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_id() == free.get_id());
+    REQUIRE_FALSE(queue.pop("10.0.0.3").has_value());
+
+    // Task with several localities is popped only once
+    task = queue.pop("10.0.0.2");
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_id() == local.get_id());
+    REQUIRE_FALSE(queue.pop("10.0.0.1").has_value());
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("Ready queue ages job priority", "[scheduler]") {
+    constexpr std::chrono::seconds cPriorityAging{60};
+    boost::uuids::random_generator gen;
+    auto const now = std::chrono::system_clock::now();
+    spider::core::ScheduleTaskMetadata const low = create_task(gen, now, {});
+    spider::core::ScheduleTaskMetadata high = create_task(gen, now + cPriorityAging / 2, {});
+    high.set_job_priority(1);
+    spider::core::ScheduleTaskMetadata late_high = create_task(gen, now + cPriorityAging * 2, {});
+    late_high.set_job_priority(1);
+
+    spider::scheduler::ReadyQueue queue{cPriorityAging};
+    queue.push(late_high);
+    queue.push(low);
+    queue.push(high);
+
+    // Higher priority task runs first unless the lower priority task waited long enough
+    std::optional<spider::core::ScheduleTaskMetadata> task = queue.pop("");
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_id() == high.get_id());
+    task = queue.pop("");
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_id() == low.get_id());
+    task = queue.pop("");
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_id() == late_high.get_id());
+}
+
+TEST_CASE("Ready queue drops entries of other localities", "[scheduler]") {
+    constexpr std::size_t cNumTasks = 10'000;
+    boost::uuids::random_generator gen;
+    auto const now = std::chrono::system_clock::now();
+    std::vector<spider::core::ScheduleTaskMetadata> tasks;
+    tasks.reserve(cNumTasks);
+    for (std::size_t i = 0; i < cNumTasks; ++i) {
+        spider::core::ScheduleTaskMetadata task = create_task(
+                gen,
+                now + std::chrono::milliseconds(i),
+                {"10.0.0.1", "10.0.0.2"}
+        );
+        task.add_soft_locality("10.0.0.2");
+        tasks.push_back(std::move(task));
+    }
+
+    spider::scheduler::ReadyQueue queue;
+    for (spider::core::ScheduleTaskMetadata const& task : tasks) {
+        queue.push(task);
+    }
+    REQUIRE(3 * cNumTasks == queue.get_num_entries());
+
+    // No worker pops from the second address, so its entries never reach a head
+    for (spider::core::ScheduleTaskMetadata const& task : tasks) {
+        std::optional<spider::core::ScheduleTaskMetadata> const popped = queue.pop("10.0.0.1");
+        REQUIRE(popped.has_value());
+        REQUIRE(popped->get_id() == task.get_id());
+    }
+    REQUIRE(queue.empty());
+    REQUIRE(queue.get_num_entries() < cNumTasks);
+
+    // The queue still pops in order after dropping entries
+    queue.push(tasks[1]);
+    queue.push(tasks[0]);
+    std::optional<spider::core::ScheduleTaskMetadata> task = queue.pop("10.0.0.2");
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_id() == tasks[0].get_id());
+    task = queue.pop("10.0.0.2");
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_id() == tasks[1].get_id());
+}
+
+TEST_CASE("Ready queue benchmark", "[scheduler][.benchmark]") {
+    constexpr std::size_t cNumTasks = 100'000;
+    constexpr std::size_t cNumHosts = 64;
+    constexpr std::size_t cNumPops = 1000;
+
+    boost::uuids::random_generator gen;
+    auto const now = std::chrono::system_clock::now();
+    // The older half of the tasks are pinned to other hosts, so they are ahead of every task the
+    // worker on `host-0` can run.
+    std::vector<spider::core::ScheduleTaskMetadata> tasks;
+    tasks.reserve(cNumTasks);
+    for (std::size_t i = 0; i < cNumTasks; ++i) {
+        std::vector<std::string> hard_localities;
+        if (i < cNumTasks / 2) {
+            hard_localities.push_back(fmt::format("host-{}", 1 + i % (cNumHosts - 1)));
+        }
+        tasks.push_back(create_task(gen, now + std::chrono::microseconds(i), hard_localities));
+    }
+
+    BENCHMARK("Sorted vector refill") {
+        SortedVectorQueue queue;
+        queue.push_all(tasks);
+        return queue.pop("host-0").has_value();
+    };
+
+    BENCHMARK("Ready queue refill") {
+        spider::scheduler::ReadyQueue queue;
+        for (spider::core::ScheduleTaskMetadata const& task : tasks) {
+            queue.push(task);
+        }
+        return queue.pop("host-0").has_value();
+    };
+
+    BENCHMARK("Sorted vector refill and pop behind pinned tasks") {
+        SortedVectorQueue queue;
+        queue.push_all(tasks);
+        std::size_t num_popped = 0;
+        for (std::size_t i = 0; i < cNumPops; ++i) {
+            if (queue.pop("host-0").has_value()) {
+                ++num_popped;
+            }
+        }
+        return num_popped;
+    };
+
+    BENCHMARK("Ready queue refill and pop behind pinned tasks") {
+        spider::scheduler::ReadyQueue queue;
+        for (spider::core::ScheduleTaskMetadata const& task : tasks) {
+            queue.push(task);
+        }
+        std::size_t num_popped = 0;
+        for (std::size_t i = 0; i < cNumPops; ++i) {
+            if (queue.pop("host-0").has_value()) {
+                ++num_popped;
+            }
+        }
+        return num_popped;
+    };
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,clang-analyzer-optin.core.EnumCastOutOfRange)
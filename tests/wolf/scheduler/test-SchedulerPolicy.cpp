@@ -1,11 +1,13 @@
 // NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,clang-analyzer-optin.core.EnumCastOutOfRange)
 
 #include <chrono>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <thread>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid.hpp>
@@ -17,10 +19,14 @@
 #include <spider/core/Error.hpp>
 #include <spider/core/Task.hpp>
 #include <spider/core/TaskGraph.hpp>
+#include <spider/scheduler/FairSharePolicy.hpp>
 #include <spider/scheduler/FifoPolicy.hpp>
+#include <spider/scheduler/LocalityPolicy.hpp>
+#include <spider/scheduler/SchedulerPolicy.hpp>
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
 #include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 #include <spider/storage/StorageFactory.hpp>
 #include <tests/wolf/storage/StorageTestHelper.hpp>
 
@@ -69,7 +75,9 @@ TEMPLATE_LIST_TEST_CASE(
     boost::uuids::uuid const job_id_2 = gen();
     REQUIRE(metadata_store->add_job(*conn, job_id_2, client_id, graph_2).success());
 
-    spider::scheduler::FifoPolicy policy{scheduler_id, metadata_store, data_store, conn};
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(storage_factory, 1);
+    spider::scheduler::FifoPolicy policy{scheduler_id, metadata_store, data_store, conn_pool};
 
     // Schedule the earlier task
     std::optional<boost::uuids::uuid> optional_task_id = policy.schedule_next(gen(), "");
@@ -98,6 +106,60 @@ TEMPLATE_LIST_TEST_CASE(
     REQUIRE(metadata_store->remove_driver(*conn, scheduler_id).success());
 }
 
+TEMPLATE_LIST_TEST_CASE(
+        "Requeued tasks are scheduled again",
+        "[scheduler][storage]",
+        spider::test::StorageFactoryTypeList
+) {
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::shared_ptr<spider::core::MetadataStorage> const metadata_store
+            = storage_factory->provide_metadata_storage();
+    std::shared_ptr<spider::core::DataStorage> const data_store
+            = storage_factory->provide_data_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    std::shared_ptr<spider::core::StorageConnection> const conn
+            = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+
+    // Add scheduler
+    boost::uuids::uuid const scheduler_id = gen();
+    REQUIRE(metadata_store
+                    ->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", 8080})
+                    .success());
+
+    spider::core::Task const task{"task"};
+    spider::core::TaskGraph graph;
+    graph.add_task(task);
+    graph.add_input_task(task.get_id());
+    graph.add_output_task(task.get_id());
+    boost::uuids::uuid const job_id = gen();
+    REQUIRE(metadata_store->add_job(*conn, job_id, gen(), graph).success());
+
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(storage_factory, 1);
+    spider::scheduler::FifoPolicy policy{scheduler_id, metadata_store, data_store, conn_pool};
+
+    std::vector<spider::core::ScheduleTaskMetadata> tasks
+            = policy.schedule_next_batch(gen(), "", 1);
+    REQUIRE(1 == tasks.size());
+    REQUIRE(tasks[0].get_id() == task.get_id());
+    REQUIRE(policy.schedule_fetched_batch(gen(), "", 1).empty());
+
+    // A requeued task is scheduled from the fetched tasks, without fetching it again
+    policy.requeue_tasks(std::move(tasks));
+    tasks = policy.schedule_fetched_batch(gen(), "", 1);
+    REQUIRE(1 == tasks.size());
+    REQUIRE(tasks[0].get_id() == task.get_id());
+
+    REQUIRE(metadata_store->remove_job(*conn, job_id).success());
+    REQUIRE(metadata_store->remove_driver(*conn, scheduler_id).success());
+}
+
 TEMPLATE_LIST_TEST_CASE(
         "Schedule hard locality",
         "[scheduler][storage]",
@@ -140,7 +202,9 @@ TEMPLATE_LIST_TEST_CASE(
     graph.add_output_task(task.get_id());
     REQUIRE(metadata_store->add_job(*conn, job_id, client_id, graph).success());
 
-    spider::scheduler::FifoPolicy policy{scheduler_id, metadata_store, data_store, conn};
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(storage_factory, 1);
+    spider::scheduler::FifoPolicy policy{scheduler_id, metadata_store, data_store, conn_pool};
     // Schedule with wrong address
     REQUIRE_FALSE(policy.schedule_next(gen(), "").has_value());
     // Schedule with correct address
@@ -158,6 +222,78 @@ TEMPLATE_LIST_TEST_CASE(
     REQUIRE(metadata_store->remove_driver(*conn, client_id).success());
 }
 
+TEMPLATE_LIST_TEST_CASE(
+        "Schedule tasks beyond the first fetched page",
+        "[scheduler][storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::shared_ptr<spider::core::MetadataStorage> const metadata_store
+            = storage_factory->provide_metadata_storage();
+    std::shared_ptr<spider::core::DataStorage> const data_store
+            = storage_factory->provide_data_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    std::shared_ptr<spider::core::StorageConnection> const conn
+            = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+
+    // Add scheduler
+    boost::uuids::uuid const scheduler_id = gen();
+    REQUIRE(metadata_store
+                    ->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", 8080})
+                    .success());
+
+    // Fill the first page with high priority tasks that only run on another address
+    boost::uuids::uuid const client_id = gen();
+    spider::core::Data data{"value"};
+    data.set_hard_locality(true);
+    data.set_locality({"127.0.0.1"});
+    REQUIRE(metadata_store->add_driver(*conn, spider::core::Driver{client_id}).success());
+    REQUIRE(data_store->add_driver_data(*conn, client_id, data).success());
+    spider::core::TaskGraph local_graph;
+    for (std::size_t i = 0; i < spider::scheduler::SchedulerPolicy::cMaxFetchTasks; ++i) {
+        spider::core::Task task{"local"};
+        task.add_input(spider::core::TaskInput{data.get_id()});
+        local_graph.add_task(task);
+        local_graph.add_input_task(task.get_id());
+        local_graph.add_output_task(task.get_id());
+    }
+    boost::uuids::uuid const local_job_id = gen();
+    REQUIRE(metadata_store->add_job(*conn, local_job_id, client_id, local_graph, 1).success());
+
+    spider::core::Task const task{"task"};
+    spider::core::TaskGraph graph;
+    graph.add_task(task);
+    graph.add_input_task(task.get_id());
+    graph.add_output_task(task.get_id());
+    boost::uuids::uuid const job_id = gen();
+    REQUIRE(metadata_store->add_job(*conn, job_id, client_id, graph, 0).success());
+
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(storage_factory, 1);
+    spider::scheduler::FifoPolicy policy{scheduler_id, metadata_store, data_store, conn_pool};
+    // The first page has no task for the address
+    REQUIRE_FALSE(policy.schedule_next(gen(), "10.0.0.1").has_value());
+    // The next fetch continues after the first page
+    std::optional<boost::uuids::uuid> const optional_task_id
+            = policy.schedule_next(gen(), "10.0.0.1");
+    REQUIRE(optional_task_id.has_value());
+    if (optional_task_id.has_value()) {
+        REQUIRE(optional_task_id.value() == task.get_id());
+    }
+
+    REQUIRE(metadata_store->remove_job(*conn, local_job_id).success());
+    REQUIRE(metadata_store->remove_job(*conn, job_id).success());
+    REQUIRE(data_store->remove_data(*conn, data.get_id()).success());
+    REQUIRE(metadata_store->remove_driver(*conn, scheduler_id).success());
+    REQUIRE(metadata_store->remove_driver(*conn, client_id).success());
+}
+
 TEMPLATE_LIST_TEST_CASE(
         "Schedule soft locality",
         "[scheduler][storage]",
@@ -200,7 +336,9 @@ TEMPLATE_LIST_TEST_CASE(
     graph.add_output_task(task.get_id());
     REQUIRE(metadata_store->add_job(*conn, job_id, client_id, graph).success());
 
-    spider::scheduler::FifoPolicy policy{scheduler_id, metadata_store, data_store, conn};
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(storage_factory, 1);
+    spider::scheduler::FifoPolicy policy{scheduler_id, metadata_store, data_store, conn_pool};
 
     // Schedule with wrong address
     std::optional<boost::uuids::uuid> const optional_task_id = policy.schedule_next(gen(), "");
@@ -215,6 +353,168 @@ TEMPLATE_LIST_TEST_CASE(
     REQUIRE(metadata_store->remove_driver(*conn, scheduler_id).success());
     REQUIRE(metadata_store->remove_driver(*conn, client_id).success());
 }
+
+TEMPLATE_LIST_TEST_CASE(
+        "Locality policy prefers soft locality",
+        "[scheduler][storage]",
+        spider::test::StorageFactoryTypeList
+) {
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::shared_ptr<spider::core::MetadataStorage> const metadata_store
+            = storage_factory->provide_metadata_storage();
+    std::shared_ptr<spider::core::DataStorage> const data_store
+            = storage_factory->provide_data_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    std::shared_ptr<spider::core::StorageConnection> const conn
+            = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+
+    // Add scheduler
+    boost::uuids::uuid const scheduler_id = gen();
+    REQUIRE(metadata_store
+                    ->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", 8080})
+                    .success());
+
+    boost::uuids::uuid const client_id = gen();
+    REQUIRE(metadata_store->add_driver(*conn, spider::core::Driver{client_id}).success());
+
+    // Submit a task without locality, then two tasks with soft locality
+    spider::core::Task const task_1{"task_1"};
+    spider::core::TaskGraph graph_1;
+    graph_1.add_task(task_1);
+    graph_1.add_input_task(task_1.get_id());
+    graph_1.add_output_task(task_1.get_id());
+    boost::uuids::uuid const job_id_1 = gen();
+    REQUIRE(metadata_store->add_job(*conn, job_id_1, client_id, graph_1).success());
+
+    spider::core::Data data;
+    data.set_hard_locality(false);
+    data.set_locality({"127.0.0.1"});
+    REQUIRE(data_store->add_driver_data(*conn, client_id, data).success());
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    spider::core::Task task_2{"task_2"};
+    task_2.add_input(spider::core::TaskInput{data.get_id()});
+    spider::core::TaskGraph graph_2;
+    graph_2.add_task(task_2);
+    graph_2.add_input_task(task_2.get_id());
+    graph_2.add_output_task(task_2.get_id());
+    boost::uuids::uuid const job_id_2 = gen();
+    REQUIRE(metadata_store->add_job(*conn, job_id_2, client_id, graph_2).success());
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    spider::core::Task task_3{"task_3"};
+    task_3.add_input(spider::core::TaskInput{data.get_id()});
+    spider::core::TaskGraph graph_3;
+    graph_3.add_task(task_3);
+    graph_3.add_input_task(task_3.get_id());
+    graph_3.add_output_task(task_3.get_id());
+    boost::uuids::uuid const job_id_3 = gen();
+    REQUIRE(metadata_store->add_job(*conn, job_id_3, client_id, graph_3).success());
+
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(storage_factory, 1);
+    spider::scheduler::LocalityPolicy
+            policy{scheduler_id, metadata_store, data_store, conn_pool, 1};
+
+    // Local task is scheduled before the earlier task
+    std::optional<boost::uuids::uuid> optional_task_id = policy.schedule_next(gen(), "127.0.0.1");
+    REQUIRE(optional_task_id.has_value());
+    if (optional_task_id.has_value()) {
+        REQUIRE(optional_task_id.value() == task_2.get_id());
+    }
+
+    // Earlier task is scheduled once its skip budget is used up
+    optional_task_id = policy.schedule_next(gen(), "127.0.0.1");
+    REQUIRE(optional_task_id.has_value());
+    if (optional_task_id.has_value()) {
+        REQUIRE(optional_task_id.value() == task_1.get_id());
+    }
+
+    optional_task_id = policy.schedule_next(gen(), "127.0.0.1");
+    REQUIRE(optional_task_id.has_value());
+    if (optional_task_id.has_value()) {
+        REQUIRE(optional_task_id.value() == task_3.get_id());
+    }
+
+    REQUIRE(metadata_store->remove_job(*conn, job_id_1).success());
+    REQUIRE(metadata_store->remove_job(*conn, job_id_2).success());
+    REQUIRE(metadata_store->remove_job(*conn, job_id_3).success());
+    REQUIRE(data_store->remove_data(*conn, data.get_id()).success());
+    REQUIRE(metadata_store->remove_driver(*conn, scheduler_id).success());
+    REQUIRE(metadata_store->remove_driver(*conn, client_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Fair share policy does not starve clients behind a bulk client",
+        "[scheduler][storage]",
+        spider::test::StorageFactoryTypeList
+) {
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::shared_ptr<spider::core::MetadataStorage> const metadata_store
+            = storage_factory->provide_metadata_storage();
+    std::shared_ptr<spider::core::DataStorage> const data_store
+            = storage_factory->provide_data_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    std::shared_ptr<spider::core::StorageConnection> const conn
+            = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+
+    // Add scheduler
+    boost::uuids::uuid const scheduler_id = gen();
+    REQUIRE(metadata_store
+                    ->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", 8080})
+                    .success());
+
+    // First client submits more tasks than fit in a fetched page before second client submits one
+    boost::uuids::uuid const bulk_client_id = gen();
+    spider::core::TaskGraph bulk_graph;
+    for (std::size_t i = 0; i <= spider::scheduler::SchedulerPolicy::cMaxFetchTasks; ++i) {
+        spider::core::Task const task{"bulk"};
+        bulk_graph.add_task(task);
+        bulk_graph.add_input_task(task.get_id());
+        bulk_graph.add_output_task(task.get_id());
+    }
+    boost::uuids::uuid const bulk_job_id = gen();
+    REQUIRE(metadata_store->add_job(*conn, bulk_job_id, bulk_client_id, bulk_graph).success());
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    boost::uuids::uuid const client_id = gen();
+    spider::core::Task const task{"interactive"};
+    spider::core::TaskGraph graph;
+    graph.add_task(task);
+    graph.add_input_task(task.get_id());
+    graph.add_output_task(task.get_id());
+    boost::uuids::uuid const job_id = gen();
+    REQUIRE(metadata_store->add_job(*conn, job_id, client_id, graph).success());
+
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(storage_factory, 1);
+    spider::scheduler::FairSharePolicy
+            policy{scheduler_id, metadata_store, data_store, conn_pool};
+
+    // Second client's task is one of the first two dispatched
+    std::optional<boost::uuids::uuid> const first_task_id = policy.schedule_next(gen(), "");
+    std::optional<boost::uuids::uuid> const second_task_id = policy.schedule_next(gen(), "");
+    REQUIRE(first_task_id.has_value());
+    REQUIRE(second_task_id.has_value());
+    REQUIRE((first_task_id == task.get_id() || second_task_id == task.get_id()));
+
+    // First client's tasks are still dispatched
+    REQUIRE(policy.schedule_next(gen(), "").has_value());
+    REQUIRE(policy.schedule_next(gen(), "").has_value());
+
+    REQUIRE(metadata_store->remove_job(*conn, bulk_job_id).success());
+    REQUIRE(metadata_store->remove_job(*conn, job_id).success());
+    REQUIRE(metadata_store->remove_driver(*conn, scheduler_id).success());
+}
 }  // namespace
 
 // NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,clang-analyzer-optin.core.EnumCastOutOfRange)
@@ -1,5 +1,6 @@
 // NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,clang-analyzer-optin.core.EnumCastOutOfRange)
 #include <chrono>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <thread>
@@ -25,6 +26,7 @@
 #include <spider/storage/DataStorage.hpp>
 #include <spider/storage/MetadataStorage.hpp>
 #include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
 #include <spider/storage/StorageFactory.hpp>
 #include <tests/wolf/storage/StorageTestHelper.hpp>
 
@@ -36,7 +38,7 @@ TEMPLATE_LIST_TEST_CASE(
         "[scheduler][server][storage]",
         spider::test::StorageFactoryTypeList
 ) {
-    std::unique_ptr<spider::core::StorageFactory> storage_factory
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
             = spider::test::create_storage_factory<TestType>();
     std::shared_ptr<spider::core::MetadataStorage> const metadata_store
             = storage_factory->provide_metadata_storage();
@@ -56,16 +58,25 @@ TEMPLATE_LIST_TEST_CASE(
                     ->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", 8080})
                     .success());
 
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(storage_factory, 2);
     std::shared_ptr<spider::scheduler::SchedulerPolicy> const policy
             = std::make_shared<spider::scheduler::FifoPolicy>(
                     scheduler_id,
                     metadata_store,
                     data_store,
-                    conn
+                    conn_pool
             );
 
     constexpr unsigned short cPort = 6021;
-    spider::scheduler::SchedulerServer server{cPort, policy, metadata_store, data_store, conn};
+    spider::scheduler::SchedulerServer server{
+            cPort,
+            policy,
+            metadata_store,
+            data_store,
+            conn_pool,
+            1
+    };
 
     // Pause and resume server
     server.pause();
@@ -114,6 +125,12 @@ TEMPLATE_LIST_TEST_CASE(
                 = object.as<spider::scheduler::ScheduleTaskResponse>();
         REQUIRE(res.has_task_id());
         REQUIRE(res.get_task_id() == parent_task.get_id());
+        // Server creates the task instance and sends the task details
+        REQUIRE(1 == res.get_tasks().size());
+        spider::scheduler::ScheduledTask const& scheduled_task = res.get_tasks().front();
+        REQUIRE(scheduled_task.get_instance().task_id == parent_task.get_id());
+        REQUIRE(scheduled_task.get_function_name() == "parent");
+        REQUIRE(scheduled_task.get_language() == spider::core::TaskLanguage::Cpp);
     }
     socket.close();
     server.stop();
@@ -121,6 +138,108 @@ TEMPLATE_LIST_TEST_CASE(
     // Clean up
     REQUIRE(metadata_store->remove_driver(*conn, scheduler_id).success());
 }
+
+TEMPLATE_LIST_TEST_CASE(
+        "Scheduler server pushes task to waiting session",
+        "[scheduler][server][storage]",
+        spider::test::StorageFactoryTypeList
+) {
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::shared_ptr<spider::core::MetadataStorage> const metadata_store
+            = storage_factory->provide_metadata_storage();
+    std::shared_ptr<spider::core::DataStorage> const data_store
+            = storage_factory->provide_data_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    std::shared_ptr<spider::core::StorageConnection> const conn
+            = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    // Add scheduler
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const scheduler_id = gen();
+    REQUIRE(metadata_store
+                    ->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", 8080})
+                    .success());
+
+    std::shared_ptr<spider::core::StorageConnectionPool> const conn_pool
+            = std::make_shared<spider::core::StorageConnectionPool>(storage_factory, 2);
+    std::shared_ptr<spider::scheduler::SchedulerPolicy> const policy
+            = std::make_shared<spider::scheduler::FifoPolicy>(
+                    scheduler_id,
+                    metadata_store,
+                    data_store,
+                    conn_pool
+            );
+
+    constexpr std::size_t cNumThreads = 4;
+    constexpr unsigned short cPort = 6022;
+    spider::scheduler::SchedulerServer server{
+            cPort,
+            policy,
+            metadata_store,
+            data_store,
+            conn_pool,
+            cNumThreads
+    };
+    std::this_thread::sleep_for(std::chrono::milliseconds(cServerWarmupTime));
+
+    boost::asio::io_context context;
+    boost::asio::ip::tcp::endpoint const endpoint{boost::asio::ip::tcp::v4(), cPort};
+    boost::asio::ip::tcp::socket socket{context};
+    boost::asio::connect(socket, std::vector{endpoint});
+
+    // Send request before any task is ready so that the request waits on the server
+    spider::scheduler::ScheduleTaskRequest const req{gen(), ""};
+    msgpack::sbuffer req_buffer;
+    msgpack::pack(req_buffer, req);
+    REQUIRE(spider::core::send_message(socket, req_buffer));
+    std::this_thread::sleep_for(std::chrono::milliseconds(cServerWarmupTime));
+
+    spider::core::Task const task{"task"};
+    spider::core::TaskGraph graph;
+    graph.add_task(task);
+    graph.add_input_task(task.get_id());
+    graph.add_output_task(task.get_id());
+    boost::uuids::uuid const job_id = gen();
+    REQUIRE(metadata_store->add_job(*conn, job_id, gen(), graph).success());
+
+    // Server should push the task on the same session
+    std::optional<msgpack::sbuffer> const& res_buffer = spider::core::receive_message(socket);
+    REQUIRE(res_buffer.has_value());
+    if (res_buffer.has_value()) {
+        msgpack::object_handle const handle
+                = msgpack::unpack(res_buffer.value().data(), res_buffer.value().size());
+        spider::scheduler::ScheduleTaskResponse const res
+                = handle.get().as<spider::scheduler::ScheduleTaskResponse>();
+        REQUIRE(res.has_task_id());
+        REQUIRE(res.get_task_id() == task.get_id());
+    }
+
+    // Session stays open and answers with empty response when no task is ready
+    REQUIRE(spider::core::send_message(socket, req_buffer));
+    std::optional<msgpack::sbuffer> const& empty_res_buffer
+            = spider::core::receive_message(socket);
+    REQUIRE(empty_res_buffer.has_value());
+    if (empty_res_buffer.has_value()) {
+        msgpack::object_handle const handle = msgpack::unpack(
+                empty_res_buffer.value().data(),
+                empty_res_buffer.value().size()
+        );
+        spider::scheduler::ScheduleTaskResponse const res
+                = handle.get().as<spider::scheduler::ScheduleTaskResponse>();
+        REQUIRE_FALSE(res.has_task_id());
+    }
+
+    socket.close();
+    server.stop();
+
+    // Clean up
+    REQUIRE(metadata_store->remove_job(*conn, job_id).success());
+    REQUIRE(metadata_store->remove_driver(*conn, scheduler_id).success());
+}
 }  // namespace
 
 // NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,clang-analyzer-optin.core.EnumCastOutOfRange)
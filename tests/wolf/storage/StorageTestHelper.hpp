@@ -3,6 +3,7 @@
 // NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity)
 
 #include <concepts>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -10,6 +11,8 @@
 
 #include <boost/process/v2/environment.hpp>
 
+#include <spider/storage/durable/DurableStorageFactory.hpp>
+#include <spider/storage/memory/MemoryStorageFactory.hpp>
 #include <spider/storage/mysql/MySqlStorageFactory.hpp>
 #include <spider/storage/StorageFactory.hpp>
 
@@ -17,8 +20,14 @@ namespace spider::test {
 constexpr std::string_view cMySqlStorageUrl
         = "jdbc:mariadb://localhost:3306/spider_test?user=root&password=password";
 
+constexpr std::string_view cMemoryStorageUrl = "memory://spider_test";
+
 using StorageFactoryTypeList = std::tuple<core::MySqlStorageFactory>;
 
+// Storages that tests can share with the test process only, e.g. to test the storage API
+using InProcessStorageFactoryTypeList = std::
+        tuple<core::MySqlStorageFactory, core::MemoryStorageFactory, core::DurableStorageFactory>;
+
 template <class T>
 requires std::same_as<T, core::MySqlStorageFactory>
 auto get_storage_url() -> std::string {
@@ -32,7 +41,21 @@ auto get_storage_url() -> std::string {
 }
 
 template <class T>
-requires std::same_as<T, core::MySqlStorageFactory>
+requires std::same_as<T, core::MemoryStorageFactory>
+auto get_storage_url() -> std::string {
+    return std::string{cMemoryStorageUrl};
+}
+
+template <class T>
+requires std::same_as<T, core::DurableStorageFactory>
+auto get_storage_url() -> std::string {
+    return std::string{core::DurableStorageFactory::cUrlScheme}
+           + (std::filesystem::temp_directory_path() / "spider_test_durable").string();
+}
+
+template <class T>
+requires std::same_as<T, core::MySqlStorageFactory> || std::same_as<T, core::MemoryStorageFactory>
+         || std::same_as<T, core::DurableStorageFactory>
 auto create_storage_factory() -> std::unique_ptr<core::StorageFactory> {
     return std::make_unique<T>(get_storage_url<T>());
 }
@@ -1,5 +1,7 @@
 // NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+#include <cstddef>
 #include <memory>
+#include <string>
 #include <utility>
 #include <variant>
 
@@ -25,7 +27,7 @@ namespace {
 TEMPLATE_LIST_TEST_CASE(
         "Add, get and remove data",
         "[storage]",
-        spider::test::StorageFactoryTypeList
+        spider::test::InProcessStorageFactoryTypeList
 ) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
@@ -67,10 +69,54 @@ TEMPLATE_LIST_TEST_CASE(
     REQUIRE(metadata_storage->remove_driver(*conn, driver_id).success());
 }
 
+TEMPLATE_LIST_TEST_CASE(
+        "Add and get chunked data",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> metadata_storage
+            = storage_factory->provide_metadata_storage();
+    std::unique_ptr<spider::core::DataStorage> data_storage
+            = storage_factory->provide_data_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    // Value spans several chunks, with a partial last chunk
+    constexpr std::size_t cValueSize = 5 * 1024 * 1024 / 2;
+    std::string value(cValueSize, '\0');
+    for (std::size_t i = 0; i < cValueSize; ++i) {
+        value[i] = static_cast<char>(i % 251);
+    }
+    spider::core::Data data{value};
+    data.set_locality({"127.0.0.1"});
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const driver_id = gen();
+    REQUIRE(metadata_storage->add_driver(*conn, spider::core::Driver{driver_id}).success());
+    REQUIRE(data_storage->add_driver_data(*conn, driver_id, data).success());
+
+    // Get data should match
+    spider::core::Data result{"temp"};
+    REQUIRE(data_storage->get_data(*conn, data.get_id(), &result).success());
+    REQUIRE(spider::test::data_equal(data, result));
+
+    // Remove data should also remove the chunks
+    REQUIRE(data_storage->remove_data(*conn, data.get_id()).success());
+    REQUIRE(spider::core::StorageErrType::KeyNotFoundErr
+            == data_storage->get_data(*conn, data.get_id(), &result).type);
+
+    // Clean up
+    REQUIRE(metadata_storage->remove_driver(*conn, driver_id).success());
+}
+
 TEMPLATE_LIST_TEST_CASE(
         "Add and get driver key value data",
         "[storage]",
-        spider::test::StorageFactoryTypeList
+        spider::test::InProcessStorageFactoryTypeList
 ) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
@@ -112,7 +158,7 @@ TEMPLATE_LIST_TEST_CASE(
 TEMPLATE_LIST_TEST_CASE(
         "Add and get task key value data",
         "[storage]",
-        spider::test::StorageFactoryTypeList
+        spider::test::InProcessStorageFactoryTypeList
 ) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
@@ -157,7 +203,7 @@ TEMPLATE_LIST_TEST_CASE(
 TEMPLATE_LIST_TEST_CASE(
         "Add and remove task reference for task",
         "[storage]",
-        spider::test::StorageFactoryTypeList
+        spider::test::InProcessStorageFactoryTypeList
 ) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
@@ -215,7 +261,7 @@ TEMPLATE_LIST_TEST_CASE(
 TEMPLATE_LIST_TEST_CASE(
         "Add and remove data reference for driver",
         "[storage]",
-        spider::test::StorageFactoryTypeList
+        spider::test::InProcessStorageFactoryTypeList
 ) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
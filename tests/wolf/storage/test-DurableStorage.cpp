@@ -0,0 +1,299 @@
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include <spider/core/Driver.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/core/KeyValueData.hpp>
+#include <spider/storage/DataStorage.hpp>
+#include <spider/storage/durable/DurableStorageFactory.hpp>
+#include <spider/storage/durable/DurableStore.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageFactory.hpp>
+
+namespace {
+auto get_connection(spider::core::StorageFactory& storage_factory)
+        -> std::unique_ptr<spider::core::StorageConnection> {
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory.provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    return std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+}
+
+/**
+ * @param name
+ * @return An empty directory for a test to store data in.
+ */
+auto create_test_directory(std::string const& name) -> std::filesystem::path {
+    std::filesystem::path const directory
+            = std::filesystem::temp_directory_path() / fmt::format("spider_test_{}", name);
+    std::filesystem::remove_all(directory);
+    return directory;
+}
+
+auto get_storage_url(std::filesystem::path const& directory) -> std::string {
+    return std::string{spider::core::DurableStorageFactory::cUrlScheme} + directory.string();
+}
+
+auto get_kv_value(
+        spider::core::StorageFactory& storage_factory,
+        boost::uuids::uuid const client_id,
+        std::string const& key
+) -> std::string {
+    std::unique_ptr<spider::core::DataStorage> const storage
+            = storage_factory.provide_data_storage();
+    std::unique_ptr<spider::core::StorageConnection> const conn = get_connection(storage_factory);
+    std::string value;
+    REQUIRE(storage->get_client_kv_data(*conn, client_id, key, &value).success());
+    return value;
+}
+
+TEST_CASE("Durable storage URLs can be shared by processes", "[storage]") {
+    REQUIRE_FALSE(spider::core::is_process_local_storage_url(
+            get_storage_url(std::filesystem::temp_directory_path())
+    ));
+}
+
+TEST_CASE("Durable storage recovers changes after reopening", "[storage]") {
+    std::filesystem::path const directory = create_test_directory("durable_reopen");
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const client_id = gen();
+
+    {
+        std::shared_ptr<spider::core::StorageFactory> const storage_factory
+                = spider::core::create_storage_factory(get_storage_url(directory));
+        REQUIRE(nullptr
+                != std::dynamic_pointer_cast<spider::core::DurableStorageFactory>(storage_factory
+                ));
+        std::unique_ptr<spider::core::DataStorage> const storage
+                = storage_factory->provide_data_storage();
+        std::unique_ptr<spider::core::StorageConnection> const conn
+                = get_connection(*storage_factory);
+        REQUIRE(storage->add_client_kv_data(*conn, {"first", "1", client_id}).success());
+        REQUIRE(storage->add_client_kv_data(*conn, {"second", "2", client_id}).success());
+    }
+
+    // Reopening replays the log
+    {
+        std::shared_ptr<spider::core::StorageFactory> const storage_factory
+                = spider::core::create_storage_factory(get_storage_url(directory));
+        REQUIRE("1" == get_kv_value(*storage_factory, client_id, "first"));
+        REQUIRE("2" == get_kv_value(*storage_factory, client_id, "second"));
+
+        std::unique_ptr<spider::core::DataStorage> const storage
+                = storage_factory->provide_data_storage();
+        std::unique_ptr<spider::core::StorageConnection> const conn
+                = get_connection(*storage_factory);
+        REQUIRE(storage->add_client_kv_data(*conn, {"third", "3", client_id}).success());
+
+        std::variant<std::shared_ptr<spider::core::DurableStore>, spider::core::StorageErr> const
+                store_result = spider::core::DurableStore::open(directory.string());
+        REQUIRE(std::holds_alternative<std::shared_ptr<spider::core::DurableStore>>(store_result));
+        REQUIRE(std::get<std::shared_ptr<spider::core::DurableStore>>(store_result)
+                        ->snapshot()
+                        .success());
+        REQUIRE(storage->add_client_kv_data(*conn, {"fourth", "4", client_id}).success());
+    }
+
+    // Reopening loads the snapshot and replays the log after it
+    {
+        std::shared_ptr<spider::core::StorageFactory> const storage_factory
+                = spider::core::create_storage_factory(get_storage_url(directory));
+        REQUIRE("1" == get_kv_value(*storage_factory, client_id, "first"));
+        REQUIRE("2" == get_kv_value(*storage_factory, client_id, "second"));
+        REQUIRE("3" == get_kv_value(*storage_factory, client_id, "third"));
+        REQUIRE("4" == get_kv_value(*storage_factory, client_id, "fourth"));
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Durable storage is shared by processes", "[storage]") {
+    std::filesystem::path const directory = create_test_directory("durable_processes");
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const client_id = gen();
+    boost::uuids::uuid const driver_id = gen();
+
+    std::array<int, 2> parent_ready{};
+    REQUIRE(0 == ::pipe(parent_ready.data()));
+    pid_t const pid = ::fork();
+    REQUIRE(pid >= 0);
+    if (0 == pid) {
+        // Opens the directory in another process once the parent has it open, and changes it. The
+        // checks of the child are reported through its exit status.
+        char ready = 0;
+        if (1 != ::read(parent_ready[0], &ready, 1)) {
+            ::_exit(1);
+        }
+        std::shared_ptr<spider::core::StorageFactory> const storage_factory
+                = spider::core::create_storage_factory(get_storage_url(directory));
+        std::unique_ptr<spider::core::DataStorage> const data_storage
+                = storage_factory->provide_data_storage();
+        std::unique_ptr<spider::core::MetadataStorage> const metadata_storage
+                = storage_factory->provide_metadata_storage();
+        std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+                conn_result = storage_factory->provide_storage_connection();
+        if (std::holds_alternative<spider::core::StorageErr>(conn_result)) {
+            ::_exit(1);
+        }
+        auto const& conn = std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result);
+        std::string value;
+        bool const succeeded
+                = data_storage->get_client_kv_data(*conn, client_id, "parent", &value).success()
+                  && "1" == value
+                  && data_storage->add_client_kv_data(*conn, {"child", "2", client_id}).success()
+                  && metadata_storage->add_driver(*conn, spider::core::Driver{driver_id}).success()
+                  && std::get<std::shared_ptr<spider::core::DurableStore>>(
+                             spider::core::DurableStore::open(directory.string())
+                  )
+                             ->snapshot()
+                             .success()
+                  && data_storage->add_client_kv_data(*conn, {"snapshot", "3", client_id})
+                             .success();
+        ::_exit(succeeded ? 0 : 1);
+    }
+
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::core::create_storage_factory(get_storage_url(directory));
+    std::unique_ptr<spider::core::DataStorage> const data_storage
+            = storage_factory->provide_data_storage();
+    std::unique_ptr<spider::core::MetadataStorage> const metadata_storage
+            = storage_factory->provide_metadata_storage();
+    std::unique_ptr<spider::core::StorageConnection> const conn = get_connection(*storage_factory);
+    REQUIRE(data_storage->add_client_kv_data(*conn, {"parent", "1", client_id}).success());
+
+    char const ready = 1;
+    REQUIRE(1 == ::write(parent_ready[1], &ready, 1));
+    int status = 0;
+    REQUIRE(pid == ::waitpid(pid, &status, 0));
+    ::close(parent_ready[0]);
+    ::close(parent_ready[1]);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(0 == WEXITSTATUS(status));
+
+    // Changes of the child are seen without reopening, including the ones after its snapshot
+    REQUIRE("2" == get_kv_value(*storage_factory, client_id, "child"));
+    REQUIRE("3" == get_kv_value(*storage_factory, client_id, "snapshot"));
+    std::vector<boost::uuids::uuid> timed_out_ids;
+    REQUIRE(metadata_storage->heartbeat_timeout(*conn, 0, &timed_out_ids).success());
+    REQUIRE(std::vector<boost::uuids::uuid>{driver_id} == timed_out_ids);
+
+    // Changes are appended after the ones of the child
+    REQUIRE(data_storage->add_client_kv_data(*conn, {"after", "4", client_id}).success());
+    REQUIRE("4" == get_kv_value(*storage_factory, client_id, "after"));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Durable storage ignores a torn log record", "[storage]") {
+    std::filesystem::path const directory = create_test_directory("durable_torn");
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const client_id = gen();
+
+    {
+        std::shared_ptr<spider::core::StorageFactory> const storage_factory
+                = spider::core::create_storage_factory(get_storage_url(directory));
+        std::unique_ptr<spider::core::DataStorage> const storage
+                = storage_factory->provide_data_storage();
+        std::unique_ptr<spider::core::StorageConnection> const conn
+                = get_connection(*storage_factory);
+        REQUIRE(storage->add_client_kv_data(*conn, {"key", "value", client_id}).success());
+    }
+
+    // Simulate a crash in the middle of appending a record
+    {
+        std::ofstream log{directory / "wal", std::ios::binary | std::ios::app};
+        log << "torn record";
+    }
+
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::core::create_storage_factory(get_storage_url(directory));
+    REQUIRE("value" == get_kv_value(*storage_factory, client_id, "key"));
+    std::unique_ptr<spider::core::DataStorage> const storage
+            = storage_factory->provide_data_storage();
+    std::unique_ptr<spider::core::StorageConnection> const conn = get_connection(*storage_factory);
+    REQUIRE(storage->add_client_kv_data(*conn, {"other", "value", client_id}).success());
+    REQUIRE("value" == get_kv_value(*storage_factory, client_id, "other"));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Durable storage commit benchmark", "[storage][.benchmark]") {
+    constexpr std::size_t cNumCommits = 1000;
+
+    std::filesystem::path const directory = create_test_directory("durable_benchmark");
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::core::create_storage_factory(get_storage_url(directory));
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const client_id = gen();
+
+    // Concurrent commits share log flushes, so more threads commit faster until the disk is busy
+    auto const commit = [&](std::size_t const num_threads) {
+        std::atomic<std::size_t> num_failures = 0;
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            threads.emplace_back([&, i] {
+                std::unique_ptr<spider::core::DataStorage> const storage
+                        = storage_factory->provide_data_storage();
+                std::variant<
+                        std::unique_ptr<spider::core::StorageConnection>,
+                        spider::core::StorageErr> const conn_result
+                        = storage_factory->provide_storage_connection();
+                if (std::holds_alternative<spider::core::StorageErr>(conn_result)) {
+                    ++num_failures;
+                    return;
+                }
+                auto const& conn
+                        = std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result);
+                for (std::size_t j = i; j < cNumCommits; j += num_threads) {
+                    spider::core::KeyValueData const data{fmt::format("key-{}", j), "", client_id};
+                    if (false == storage->add_client_kv_data(*conn, data).success()) {
+                        ++num_failures;
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(0 == num_failures);
+    };
+
+    BENCHMARK("1 thread") {
+        commit(1);
+    };
+
+    BENCHMARK("8 threads") {
+        commit(8);
+    };
+
+    BENCHMARK("64 threads") {
+        commit(64);
+    };
+
+    std::filesystem::remove_all(directory);
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
@@ -0,0 +1,73 @@
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <spider/core/Driver.hpp>
+#include <spider/core/Error.hpp>
+#include <spider/storage/memory/MemoryStorageFactory.hpp>
+#include <spider/storage/MetadataStorage.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageFactory.hpp>
+
+namespace {
+auto get_connection(spider::core::StorageFactory& storage_factory)
+        -> std::unique_ptr<spider::core::StorageConnection> {
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory.provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    return std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+}
+
+TEST_CASE("Memory storages with the same URL share the store", "[storage]") {
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::core::create_storage_factory("memory://shared");
+    REQUIRE(nullptr
+            != std::dynamic_pointer_cast<spider::core::MemoryStorageFactory>(storage_factory));
+    std::shared_ptr<spider::core::StorageFactory> const same_factory
+            = spider::core::create_storage_factory("memory://shared");
+    std::shared_ptr<spider::core::StorageFactory> const other_factory
+            = spider::core::create_storage_factory("memory://other");
+
+    std::unique_ptr<spider::core::MetadataStorage> const storage
+            = storage_factory->provide_metadata_storage();
+    std::unique_ptr<spider::core::StorageConnection> const conn = get_connection(*storage_factory);
+    std::unique_ptr<spider::core::StorageConnection> const same_conn
+            = get_connection(*same_factory);
+    std::unique_ptr<spider::core::StorageConnection> const other_conn
+            = get_connection(*other_factory);
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const scheduler_id = gen();
+    REQUIRE(storage->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", 3306})
+                    .success());
+
+    std::vector<spider::core::Scheduler> schedulers;
+    REQUIRE(storage->get_active_scheduler(*same_conn, &schedulers).success());
+    REQUIRE(1 == schedulers.size());
+    REQUIRE(scheduler_id == schedulers[0].get_id());
+
+    schedulers.clear();
+    REQUIRE(storage->get_active_scheduler(*other_conn, &schedulers).success());
+    REQUIRE(schedulers.empty());
+
+    REQUIRE(storage->remove_driver(*same_conn, scheduler_id).success());
+    REQUIRE(storage->get_active_scheduler(*conn, &schedulers).success());
+    REQUIRE(schedulers.empty());
+}
+
+TEST_CASE("Memory storage URLs are process-local", "[storage]") {
+    REQUIRE(spider::core::is_process_local_storage_url("memory://shared"));
+    REQUIRE_FALSE(spider::core::is_process_local_storage_url(
+            "jdbc:mariadb://localhost:3306/spider-storage?user=spider&password=password"
+    ));
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
@@ -1,8 +1,13 @@
 // NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
 
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
 #include <thread>
 #include <utility>
 #include <variant>
@@ -10,8 +15,10 @@
 
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
 
 #include <spider/core/Driver.hpp>
 #include <spider/core/Error.hpp>
@@ -26,7 +33,39 @@
 #include <tests/wolf/utils/CoreTaskUtils.hpp>
 
 namespace {
-TEMPLATE_LIST_TEST_CASE("Driver heartbeat", "[storage]", spider::test::StorageFactoryTypeList) {
+/**
+ * Creates a graph of tasks forming a binary tree, where each task takes the output of its parent.
+ *
+ * @param num_tasks
+ * @return The task graph, with the root as input task and the last task as output task.
+ */
+auto create_tree_graph(std::size_t const num_tasks) -> spider::core::TaskGraph {
+    spider::core::TaskGraph graph;
+    std::vector<boost::uuids::uuid> task_ids;
+    task_ids.reserve(num_tasks);
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        spider::core::Task task{"tree"};
+        if (0 == i) {
+            task.add_input(spider::core::TaskInput{"0", "int"});
+        } else {
+            boost::uuids::uuid const parent_id = task_ids[(i - 1) / 2];
+            task.add_input(spider::core::TaskInput{parent_id, 0, "int"});
+            graph.add_dependency(parent_id, task.get_id());
+        }
+        task.add_output(spider::core::TaskOutput{"int"});
+        task_ids.push_back(task.get_id());
+        graph.add_task(task);
+    }
+    graph.add_input_task(task_ids.front());
+    graph.add_output_task(task_ids.back());
+    return graph;
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Driver heartbeat",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
     std::unique_ptr<spider::core::MetadataStorage> storage
@@ -74,7 +113,11 @@ TEMPLATE_LIST_TEST_CASE("Driver heartbeat", "[storage]", spider::test::StorageFa
     REQUIRE(storage->remove_driver(*conn, driver_id).success());
 }
 
-TEMPLATE_LIST_TEST_CASE("Scheduler addr", "[storage]", spider::test::StorageFactoryTypeList) {
+TEMPLATE_LIST_TEST_CASE(
+        "Scheduler addr",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
     std::unique_ptr<spider::core::MetadataStorage> storage
@@ -111,7 +154,7 @@ TEMPLATE_LIST_TEST_CASE("Scheduler addr", "[storage]", spider::test::StorageFact
 TEMPLATE_LIST_TEST_CASE(
         "Job batch add, get and remove",
         "[storage]",
-        spider::test::StorageFactoryTypeList
+        spider::test::InProcessStorageFactoryTypeList
 ) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
@@ -247,7 +290,7 @@ TEMPLATE_LIST_TEST_CASE(
 TEMPLATE_LIST_TEST_CASE(
         "Job add, get and remove",
         "[storage]",
-        spider::test::StorageFactoryTypeList
+        spider::test::InProcessStorageFactoryTypeList
 ) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
@@ -374,7 +417,60 @@ TEMPLATE_LIST_TEST_CASE(
     REQUIRE(storage->remove_job(*conn, job_id).success());
 }
 
-TEMPLATE_LIST_TEST_CASE("Task finish", "[storage]", spider::test::StorageFactoryTypeList) {
+TEMPLATE_LIST_TEST_CASE(
+        "Large job add and remove",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    // Large enough for the MySQL storage to commit the job in chunks
+    constexpr std::size_t cNumTasks = 20'000;
+
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const job_id = gen();
+    spider::core::TaskGraph const graph = create_tree_graph(cNumTasks);
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph, 0).success());
+
+    spider::core::JobStatus status = spider::core::JobStatus::Failed;
+    REQUIRE(storage->get_job_status(*conn, job_id, &status).success());
+    REQUIRE(spider::core::JobStatus::Running == status);
+    std::vector<boost::uuids::uuid> output_task_ids;
+    REQUIRE(storage->get_job_output_tasks(*conn, job_id, &output_task_ids).success());
+    REQUIRE(graph.get_output_tasks() == output_task_ids);
+
+    // Only the root is ready
+    boost::uuids::uuid const root_id = graph.get_input_tasks().front();
+    spider::core::Task task{""};
+    REQUIRE(storage->get_task(*conn, root_id, &task).success());
+    REQUIRE(spider::core::TaskState::Ready == task.get_state());
+    std::vector<spider::core::Task> children;
+    REQUIRE(storage->get_child_tasks(*conn, root_id, &children).success());
+    REQUIRE(2 == children.size());
+    REQUIRE(spider::core::TaskState::Pending == children[0].get_state());
+    REQUIRE(storage->get_task(*conn, output_task_ids.front(), &task).success());
+    REQUIRE(1 == task.get_num_inputs());
+    REQUIRE(spider::core::TaskState::Pending == task.get_state());
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+    REQUIRE(spider::core::StorageErrType::KeyNotFoundErr
+            == storage->get_task(*conn, root_id, &task).type);
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Task finish",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
     std::unique_ptr<spider::core::MetadataStorage> storage
@@ -448,7 +544,11 @@ TEMPLATE_LIST_TEST_CASE("Task finish", "[storage]", spider::test::StorageFactory
     REQUIRE(storage->remove_job(*conn, job_id).success());
 }
 
-TEMPLATE_LIST_TEST_CASE("Job reset", "[storage]", spider::test::StorageFactoryTypeList) {
+TEMPLATE_LIST_TEST_CASE(
+        "Task finish keeps job creation time",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
     std::unique_ptr<spider::core::MetadataStorage> storage
@@ -462,94 +562,178 @@ TEMPLATE_LIST_TEST_CASE("Job reset", "[storage]", spider::test::StorageFactoryTy
     boost::uuids::random_generator gen;
     boost::uuids::uuid const job_id = gen();
 
-    // Create a complicated task graph
+    spider::core::Task task_1{"t1"};
+    spider::core::Task task_2{"t2"};
+    task_1.add_output(spider::core::TaskOutput{"int"});
+    task_2.add_output(spider::core::TaskOutput{"int"});
+    spider::core::TaskGraph graph;
+    graph.add_task(task_1);
+    graph.add_task(task_2);
+    graph.add_input_task(task_1.get_id());
+    graph.add_input_task(task_2.get_id());
+    graph.add_output_task(task_1.get_id());
+    graph.add_output_task(task_2.get_id());
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
+    spider::core::JobMetadata job_metadata{};
+    REQUIRE(storage->get_job_metadata(*conn, job_id, &job_metadata).success());
+    std::chrono::system_clock::time_point const creation_time = job_metadata.get_creation_time();
+
+    // Creation time is stored in seconds
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    // Finishing a task of the job does not change its creation time
+    spider::core::TaskInstance const instance_1{gen(), task_1.get_id()};
+    REQUIRE(storage->set_task_state(*conn, task_1.get_id(), spider::core::TaskState::Running)
+                    .success());
+    REQUIRE(storage->task_finish(*conn, instance_1, {spider::core::TaskOutput{"1", "int"}})
+                    .success());
+    REQUIRE(storage->get_job_metadata(*conn, job_id, &job_metadata).success());
+    REQUIRE(job_metadata.get_creation_time() == creation_time);
+
+    // Neither does finishing a task in a batch
+    spider::core::TaskInstance const instance_2{gen(), task_2.get_id()};
+    REQUIRE(storage->set_task_state(*conn, task_2.get_id(), spider::core::TaskState::Running)
+                    .success());
+    REQUIRE(storage->task_finish_batch(
+                           *conn,
+                           {instance_2},
+                           {{spider::core::TaskOutput{"2", "int"}}}
+    )
+                    .success());
+    REQUIRE(storage->get_job_metadata(*conn, job_id, &job_metadata).success());
+    REQUIRE(job_metadata.get_creation_time() == creation_time);
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Remove stale submitting jobs keeps submitted jobs",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const job_id = gen();
+
+    spider::core::Task task{"t1"};
+    task.add_output(spider::core::TaskOutput{"int"});
+    spider::core::TaskGraph graph;
+    graph.add_task(task);
+    graph.add_input_task(task.get_id());
+    graph.add_output_task(task.get_id());
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
+
+    // A fully submitted job is never removed, however old it is
+    REQUIRE(storage->remove_stale_submitting_jobs(*conn, 0).success());
+    spider::core::JobMetadata job_metadata{};
+    REQUIRE(storage->get_job_metadata(*conn, job_id, &job_metadata).success());
+    spider::core::Task res_task{""};
+    REQUIRE(storage->get_task(*conn, task.get_id(), &res_task).success());
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Task finish counts down remaining inputs and tasks",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const job_id = gen();
+
+    // Child consumes both outputs of parent 1 and the output of parent 2
     spider::core::Task child_task{"child"};
     spider::core::Task parent_1{"p1"};
     spider::core::Task parent_2{"p2"};
-    parent_1.add_input(spider::core::TaskInput{"1", "float"});
-    parent_1.add_input(spider::core::TaskInput{"2", "float"});
-    parent_2.add_input(spider::core::TaskInput{"3", "int"});
-    parent_2.add_input(spider::core::TaskInput{"4", "int"});
-    parent_1.add_output(spider::core::TaskOutput{"float"});
+    parent_1.add_input(spider::core::TaskInput{"1", "int"});
+    parent_2.add_input(spider::core::TaskInput{"2", "int"});
+    parent_1.add_output(spider::core::TaskOutput{"int"});
+    parent_1.add_output(spider::core::TaskOutput{"int"});
     parent_2.add_output(spider::core::TaskOutput{"int"});
-    child_task.add_input(spider::core::TaskInput{parent_1.get_id(), 0, "float"});
+    child_task.add_input(spider::core::TaskInput{parent_1.get_id(), 0, "int"});
+    child_task.add_input(spider::core::TaskInput{parent_1.get_id(), 1, "int"});
     child_task.add_input(spider::core::TaskInput{parent_2.get_id(), 0, "int"});
-    child_task.add_output(spider::core::TaskOutput{"float"});
-    parent_1.set_max_retries(1);
-    parent_2.set_max_retries(1);
-    child_task.set_max_retries(1);
+    child_task.add_output(spider::core::TaskOutput{"int"});
     spider::core::TaskGraph graph;
-    // Add task and dependencies to task graph in wrong order
     graph.add_task(child_task);
     graph.add_task(parent_1);
     graph.add_task(parent_2);
-    graph.add_dependency(parent_2.get_id(), child_task.get_id());
     graph.add_dependency(parent_1.get_id(), child_task.get_id());
+    graph.add_dependency(parent_2.get_id(), child_task.get_id());
     graph.add_input_task(parent_1.get_id());
     graph.add_input_task(parent_2.get_id());
     graph.add_output_task(child_task.get_id());
-    // Submit job should success
     REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
 
-    // Task finish for parent 1 should succeed
-    spider::core::TaskInstance const parent_1_instance{gen(), parent_1.get_id()};
+    // Both outputs of parent 1 are not enough for the child to be ready
     REQUIRE(storage->set_task_state(*conn, parent_1.get_id(), spider::core::TaskState::Running)
                     .success());
     REQUIRE(storage->task_finish(
                            *conn,
-                           parent_1_instance,
-                           {spider::core::TaskOutput{"1.1", "float"}}
+                           spider::core::TaskInstance{gen(), parent_1.get_id()},
+                           {spider::core::TaskOutput{"1", "int"},
+                            spider::core::TaskOutput{"2", "int"}}
     )
                     .success());
-    // Task finish for parent 2 should success
-    spider::core::TaskInstance const parent_2_instance{gen(), parent_2.get_id()};
+    spider::core::Task res_task{""};
+    REQUIRE(storage->get_task(*conn, child_task.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Pending);
+
     REQUIRE(storage->set_task_state(*conn, parent_2.get_id(), spider::core::TaskState::Running)
                     .success());
-    REQUIRE(storage->task_finish(*conn, parent_2_instance, {spider::core::TaskOutput{"2", "int"}})
+    REQUIRE(storage->task_finish(
+                           *conn,
+                           spider::core::TaskInstance{gen(), parent_2.get_id()},
+                           {spider::core::TaskOutput{"3", "int"}}
+    )
                     .success());
-    // Task finish for child should success
-    spider::core::TaskInstance const child_instance{gen(), child_task.get_id()};
+    REQUIRE(storage->get_task(*conn, child_task.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Ready);
+    bool complete = true;
+    REQUIRE(storage->get_job_complete(*conn, job_id, &complete).success());
+    REQUIRE_FALSE(complete);
+
+    // Job completes once the last task finishes
     REQUIRE(storage->set_task_state(*conn, child_task.get_id(), spider::core::TaskState::Running)
                     .success());
-    REQUIRE(storage->task_finish(*conn, child_instance, {spider::core::TaskOutput{"3.3", "float"}})
+    REQUIRE(storage->task_finish(
+                           *conn,
+                           spider::core::TaskInstance{gen(), child_task.get_id()},
+                           {spider::core::TaskOutput{"6", "int"}}
+    )
                     .success());
-
-    // Job reset
-    REQUIRE(storage->reset_job(*conn, job_id).success());
-    // Parent tasks states should be ready and child task state should be waiting
-    // Parent tasks inputs should be available and child task inputs should be empty
-    // All tasks output should be empty
-    spider::core::Task res_task{""};
-    REQUIRE(storage->get_task(*conn, parent_1.get_id(), &res_task).success());
-    REQUIRE(res_task.get_state() == spider::core::TaskState::Ready);
-    REQUIRE(res_task.get_num_inputs() == 2);
-    REQUIRE(res_task.get_input(0).get_value() == "1");
-    REQUIRE(res_task.get_input(1).get_value() == "2");
-    REQUIRE(res_task.get_num_outputs() == 1);
-    REQUIRE(!res_task.get_output(0).get_value().has_value());
-    REQUIRE(storage->get_task(*conn, parent_2.get_id(), &res_task).success());
-    REQUIRE(res_task.get_state() == spider::core::TaskState::Ready);
-    REQUIRE(res_task.get_num_inputs() == 2);
-    REQUIRE(res_task.get_input(0).get_value() == "3");
-    REQUIRE(res_task.get_input(1).get_value() == "4");
-    REQUIRE(res_task.get_num_outputs() == 1);
-    REQUIRE(!res_task.get_output(0).get_value().has_value());
-    REQUIRE(storage->get_task(*conn, child_task.get_id(), &res_task).success());
-    REQUIRE(res_task.get_state() == spider::core::TaskState::Pending);
-    REQUIRE(res_task.get_num_inputs() == 2);
-    REQUIRE(!res_task.get_input(0).get_value().has_value());
-    REQUIRE(!res_task.get_input(1).get_value().has_value());
-    REQUIRE(res_task.get_num_outputs() == 1);
-    REQUIRE(!res_task.get_output(0).get_value().has_value());
+    REQUIRE(storage->get_job_complete(*conn, job_id, &complete).success());
+    REQUIRE(complete);
 
     // Clean up
     REQUIRE(storage->remove_job(*conn, job_id).success());
 }
 
 TEMPLATE_LIST_TEST_CASE(
-        "Scheduler lease timeout",
+        "Task finish with oversized values",
         "[storage]",
-        spider::test::StorageFactoryTypeList
+        spider::test::InProcessStorageFactoryTypeList
 ) {
     std::unique_ptr<spider::core::StorageFactory> storage_factory
             = spider::test::create_storage_factory<TestType>();
@@ -562,44 +746,779 @@ TEMPLATE_LIST_TEST_CASE(
     auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
 
     boost::uuids::random_generator gen;
-
-    // Register scheduler
-    boost::uuids::uuid const scheduler_id = gen();
-    constexpr int cPort = 3306;
-    REQUIRE(storage->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", cPort})
-                    .success());
-
-    // Add simple job
     boost::uuids::uuid const job_id = gen();
-    spider::core::Task const task{"simple"};
+
+    // Values larger than the inline value columns
+    constexpr std::size_t cValueSize = 2048;
+    std::string const input_value(cValueSize, 'i');
+    std::string const output_value(cValueSize, 'o');
+    spider::core::Task parent{"parent"};
+    spider::core::Task child_task{"child"};
+    parent.add_input(spider::core::TaskInput{input_value, "std::string"});
+    parent.add_output(spider::core::TaskOutput{"std::string"});
+    child_task.add_input(spider::core::TaskInput{parent.get_id(), 0, "std::string"});
+    child_task.add_output(spider::core::TaskOutput{"std::string"});
     spider::core::TaskGraph graph;
-    graph.add_task(task);
-    graph.add_input_task(task.get_id());
-    graph.add_output_task(task.get_id());
+    graph.add_task(parent);
+    graph.add_task(child_task);
+    graph.add_dependency(parent.get_id(), child_task.get_id());
+    graph.add_input_task(parent.get_id());
+    graph.add_output_task(child_task.get_id());
     REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
 
-    // Get ready tasks should schedule the task
-    std::vector<spider::core::ScheduleTaskMetadata> tasks;
-    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, &tasks).success());
-    REQUIRE(1 == tasks.size());
-    REQUIRE(tasks[0].get_id() == task.get_id());
+    spider::core::Task res_task{""};
+    REQUIRE(storage->get_task(*conn, parent.get_id(), &res_task).success());
+    REQUIRE(res_task.get_input(0).get_value() == input_value);
 
-    // Get again should not schedule the task
-    tasks.clear();
-    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, &tasks).success());
-    REQUIRE(tasks.empty());
+    // Oversized output is passed to the child
+    REQUIRE(storage->set_task_state(*conn, parent.get_id(), spider::core::TaskState::Running)
+                    .success());
+    REQUIRE(storage->task_finish(
+                           *conn,
+                           spider::core::TaskInstance{gen(), parent.get_id()},
+                           {spider::core::TaskOutput{output_value, "std::string"}}
+    )
+                    .success());
+    REQUIRE(storage->get_task(*conn, child_task.get_id(), &res_task).success());
+    REQUIRE(res_task.get_input(0).get_value() == output_value);
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Ready);
 
-    // Wait for lease timeout
-    std::this_thread::sleep_for(std::chrono::seconds(2));
-    // Get ready tasks should schedule the task again
-    tasks.clear();
-    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, &tasks).success());
-    REQUIRE(1 == tasks.size());
-    REQUIRE(tasks[0].get_id() == task.get_id());
+    spider::core::TaskGraph res_graph;
+    REQUIRE(storage->get_task_graph(*conn, job_id, &res_graph).success());
+    std::optional<spider::core::Task*> const res_parent = res_graph.get_task(parent.get_id());
+    REQUIRE(res_parent.has_value());
+    if (res_parent.has_value()) {
+        REQUIRE(res_parent.value()->get_output(0).get_value() == output_value);
+    }
 
     // Clean up
     REQUIRE(storage->remove_job(*conn, job_id).success());
-    REQUIRE(storage->remove_driver(*conn, scheduler_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Task finish batch",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const job_id = gen();
+
+    spider::core::Task child_task{"child"};
+    spider::core::Task parent_1{"p1"};
+    spider::core::Task parent_2{"p2"};
+    parent_1.add_input(spider::core::TaskInput{"1", "float"});
+    parent_2.add_input(spider::core::TaskInput{"2", "int"});
+    parent_1.add_output(spider::core::TaskOutput{"float"});
+    parent_2.add_output(spider::core::TaskOutput{"int"});
+    child_task.add_input(spider::core::TaskInput{parent_1.get_id(), 0, "float"});
+    child_task.add_input(spider::core::TaskInput{parent_2.get_id(), 0, "int"});
+    child_task.add_output(spider::core::TaskOutput{"float"});
+    spider::core::TaskGraph graph;
+    graph.add_task(child_task);
+    graph.add_task(parent_1);
+    graph.add_task(parent_2);
+    graph.add_dependency(parent_1.get_id(), child_task.get_id());
+    graph.add_dependency(parent_2.get_id(), child_task.get_id());
+    graph.add_input_task(parent_1.get_id());
+    graph.add_input_task(parent_2.get_id());
+    graph.add_output_task(child_task.get_id());
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
+
+    // Finishing both parents in one batch should make the child ready
+    spider::core::TaskInstance const parent_1_instance{gen(), parent_1.get_id()};
+    spider::core::TaskInstance const parent_2_instance{gen(), parent_2.get_id()};
+    REQUIRE(storage->set_task_state(*conn, parent_1.get_id(), spider::core::TaskState::Running)
+                    .success());
+    REQUIRE(storage->set_task_state(*conn, parent_2.get_id(), spider::core::TaskState::Running)
+                    .success());
+    REQUIRE(storage->task_finish_batch(
+                           *conn,
+                           {parent_1_instance, parent_2_instance},
+                           {{spider::core::TaskOutput{"1.1", "float"}},
+                            {spider::core::TaskOutput{"2", "int"}}}
+    )
+                    .success());
+    spider::core::Task res_task{""};
+    REQUIRE(storage->get_task(*conn, parent_1.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Succeed);
+    REQUIRE(storage->get_task(*conn, child_task.get_id(), &res_task).success());
+    REQUIRE(res_task.get_input(0).get_value() == "1.1");
+    REQUIRE(res_task.get_input(1).get_value() == "2");
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Ready);
+
+    // A batch of already finished instances should not change the outputs
+    REQUIRE(storage->task_finish_batch(
+                           *conn,
+                           {spider::core::TaskInstance{gen(), parent_1.get_id()}},
+                           {{spider::core::TaskOutput{"3.3", "float"}}}
+    )
+                    .success());
+    REQUIRE(storage->get_task(*conn, child_task.get_id(), &res_task).success());
+    REQUIRE(res_task.get_input(0).get_value() == "1.1");
+
+    // Mismatched outputs should fail
+    REQUIRE_FALSE(storage->task_finish_batch(*conn, {parent_1_instance}, {}).success());
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Create task instances in batch",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const job_id = gen();
+
+    // Two ready tasks and one pending child
+    spider::core::Task const parent_1{"p1"};
+    spider::core::Task const parent_2{"p2"};
+    spider::core::Task const child_task{"child"};
+    spider::core::TaskGraph graph;
+    graph.add_task(parent_1);
+    graph.add_task(parent_2);
+    graph.add_task(child_task);
+    graph.add_dependency(parent_1.get_id(), child_task.get_id());
+    graph.add_dependency(parent_2.get_id(), child_task.get_id());
+    graph.add_input_task(parent_1.get_id());
+    graph.add_input_task(parent_2.get_id());
+    graph.add_output_task(child_task.get_id());
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
+
+    // Only instances of ready tasks should be created
+    std::vector<spider::core::TaskInstance> const instances{
+            spider::core::TaskInstance{parent_1.get_id()},
+            spider::core::TaskInstance{parent_2.get_id()},
+            spider::core::TaskInstance{child_task.get_id()}
+    };
+    std::vector<spider::core::TaskInstance> created;
+    REQUIRE(storage->create_task_instances(*conn, instances, &created).success());
+    REQUIRE(2 == created.size());
+    REQUIRE(created[0].id == instances[0].id);
+    REQUIRE(created[1].id == instances[1].id);
+
+    spider::core::Task res_task{""};
+    REQUIRE(storage->get_task(*conn, parent_1.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Running);
+    REQUIRE(storage->get_task(*conn, parent_2.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Running);
+    REQUIRE(storage->get_task(*conn, child_task.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Pending);
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Start task instances",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const job_id = gen();
+
+    spider::core::Task parent{"parent"};
+    parent.add_input(spider::core::TaskInput{"1", "int"});
+    parent.add_output(spider::core::TaskOutput{"int"});
+    spider::core::Task child_task{"child"};
+    child_task.add_input(spider::core::TaskInput{parent.get_id(), 0, "int"});
+    child_task.add_output(spider::core::TaskOutput{"int"});
+    spider::core::TaskGraph graph;
+    graph.add_task(parent);
+    graph.add_task(child_task);
+    graph.add_dependency(parent.get_id(), child_task.get_id());
+    graph.add_input_task(parent.get_id());
+    graph.add_output_task(child_task.get_id());
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
+
+    // Only the ready task is started and returned with its inputs and outputs
+    std::vector<spider::core::TaskInstance> const instances{
+            spider::core::TaskInstance{parent.get_id()},
+            spider::core::TaskInstance{child_task.get_id()}
+    };
+    std::vector<spider::core::TaskInstance> created;
+    std::vector<spider::core::Task> tasks;
+    REQUIRE(storage->start_task_instances(*conn, gen(), instances, &created, &tasks).success());
+    REQUIRE(1 == created.size());
+    REQUIRE(1 == tasks.size());
+    REQUIRE(created[0].id == instances[0].id);
+    REQUIRE(tasks[0].get_id() == parent.get_id());
+    REQUIRE(tasks[0].get_function_name() == "parent");
+    REQUIRE(tasks[0].get_state() == spider::core::TaskState::Running);
+    REQUIRE(1 == tasks[0].get_num_inputs());
+    REQUIRE(tasks[0].get_input(0).get_value() == std::optional<std::string>{"1"});
+    REQUIRE(1 == tasks[0].get_num_outputs());
+    REQUIRE(tasks[0].get_output(0).get_type() == "int");
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Recover tasks of dead workers",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    constexpr double cHeartbeatTimeout = 60'000;
+
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const job_id = gen();
+    boost::uuids::uuid const worker_id = gen();
+    REQUIRE(storage->add_driver(*conn, spider::core::Driver{worker_id}).success());
+
+    spider::core::Task const task{"task"};
+    spider::core::TaskGraph graph;
+    graph.add_task(task);
+    graph.add_input_task(task.get_id());
+    graph.add_output_task(task.get_id());
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
+
+    std::vector<spider::core::TaskInstance> created;
+    std::vector<spider::core::Task> tasks;
+    REQUIRE(storage->start_task_instances(
+                           *conn,
+                           worker_id,
+                           {spider::core::TaskInstance{task.get_id()}},
+                           &created,
+                           &tasks
+    )
+                    .success());
+    REQUIRE(1 == created.size());
+
+    // Task of a live worker is not recovered
+    std::vector<boost::uuids::uuid> task_ids;
+    REQUIRE(storage->recover_dead_worker_tasks(*conn, cHeartbeatTimeout, &task_ids).success());
+    REQUIRE(task_ids.empty());
+
+    // Task of a removed worker is ready again
+    REQUIRE(storage->remove_driver(*conn, worker_id).success());
+    REQUIRE(storage->recover_dead_worker_tasks(*conn, cHeartbeatTimeout, &task_ids).success());
+    REQUIRE(1 == task_ids.size());
+    REQUIRE(task_ids[0] == task.get_id());
+    spider::core::Task res_task{""};
+    REQUIRE(storage->get_task(*conn, task.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Ready);
+
+    // Recovered task is not recovered again
+    REQUIRE(storage->recover_dead_worker_tasks(*conn, cHeartbeatTimeout, &task_ids).success());
+    REQUIRE(task_ids.empty());
+
+    // Task already made ready by other means is not reported
+    REQUIRE(storage->add_driver(*conn, spider::core::Driver{worker_id}).success());
+    created.clear();
+    tasks.clear();
+    REQUIRE(storage->start_task_instances(
+                           *conn,
+                           worker_id,
+                           {spider::core::TaskInstance{task.get_id()}},
+                           &created,
+                           &tasks
+    )
+                    .success());
+    REQUIRE(1 == created.size());
+    REQUIRE(storage->set_task_state(*conn, task.get_id(), spider::core::TaskState::Ready)
+                    .success());
+    REQUIRE(storage->remove_driver(*conn, worker_id).success());
+    REQUIRE(storage->recover_dead_worker_tasks(*conn, cHeartbeatTimeout, &task_ids).success());
+    REQUIRE(task_ids.empty());
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Remove undelivered task instances",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const job_id = gen();
+    boost::uuids::uuid const worker_id = gen();
+    REQUIRE(storage->add_driver(*conn, spider::core::Driver{worker_id}).success());
+
+    spider::core::Task const task{"task"};
+    spider::core::TaskGraph graph;
+    graph.add_task(task);
+    graph.add_input_task(task.get_id());
+    graph.add_output_task(task.get_id());
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
+
+    std::vector<spider::core::TaskInstance> created;
+    std::vector<spider::core::Task> tasks;
+    REQUIRE(storage->start_task_instances(
+                           *conn,
+                           worker_id,
+                           {spider::core::TaskInstance{task.get_id()}},
+                           &created,
+                           &tasks
+    )
+                    .success());
+    REQUIRE(1 == created.size());
+
+    // Task of a live worker is ready again once its instance is removed
+    std::vector<boost::uuids::uuid> task_ids;
+    REQUIRE(storage->remove_task_instances(*conn, created, &task_ids).success());
+    REQUIRE(1 == task_ids.size());
+    REQUIRE(task_ids[0] == task.get_id());
+    spider::core::Task res_task{""};
+    REQUIRE(storage->get_task(*conn, task.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Ready);
+
+    // Removed instance is not removed again
+    REQUIRE(storage->remove_task_instances(*conn, created, &task_ids).success());
+    REQUIRE(task_ids.empty());
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+    REQUIRE(storage->remove_driver(*conn, worker_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Job reset",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const job_id = gen();
+
+    // Create a complicated task graph
+    spider::core::Task child_task{"child"};
+    spider::core::Task parent_1{"p1"};
+    spider::core::Task parent_2{"p2"};
+    parent_1.add_input(spider::core::TaskInput{"1", "float"});
+    parent_1.add_input(spider::core::TaskInput{"2", "float"});
+    parent_2.add_input(spider::core::TaskInput{"3", "int"});
+    parent_2.add_input(spider::core::TaskInput{"4", "int"});
+    parent_1.add_output(spider::core::TaskOutput{"float"});
+    parent_2.add_output(spider::core::TaskOutput{"int"});
+    child_task.add_input(spider::core::TaskInput{parent_1.get_id(), 0, "float"});
+    child_task.add_input(spider::core::TaskInput{parent_2.get_id(), 0, "int"});
+    child_task.add_output(spider::core::TaskOutput{"float"});
+    parent_1.set_max_retries(1);
+    parent_2.set_max_retries(1);
+    child_task.set_max_retries(1);
+    spider::core::TaskGraph graph;
+    // Add task and dependencies to task graph in wrong order
+    graph.add_task(child_task);
+    graph.add_task(parent_1);
+    graph.add_task(parent_2);
+    graph.add_dependency(parent_2.get_id(), child_task.get_id());
+    graph.add_dependency(parent_1.get_id(), child_task.get_id());
+    graph.add_input_task(parent_1.get_id());
+    graph.add_input_task(parent_2.get_id());
+    graph.add_output_task(child_task.get_id());
+    // Submit job should success
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
+
+    // Task finish for parent 1 should succeed
+    spider::core::TaskInstance const parent_1_instance{gen(), parent_1.get_id()};
+    REQUIRE(storage->set_task_state(*conn, parent_1.get_id(), spider::core::TaskState::Running)
+                    .success());
+    REQUIRE(storage->task_finish(
+                           *conn,
+                           parent_1_instance,
+                           {spider::core::TaskOutput{"1.1", "float"}}
+    )
+                    .success());
+    // Task finish for parent 2 should success
+    spider::core::TaskInstance const parent_2_instance{gen(), parent_2.get_id()};
+    REQUIRE(storage->set_task_state(*conn, parent_2.get_id(), spider::core::TaskState::Running)
+                    .success());
+    REQUIRE(storage->task_finish(*conn, parent_2_instance, {spider::core::TaskOutput{"2", "int"}})
+                    .success());
+    // Task finish for child should success
+    spider::core::TaskInstance const child_instance{gen(), child_task.get_id()};
+    REQUIRE(storage->set_task_state(*conn, child_task.get_id(), spider::core::TaskState::Running)
+                    .success());
+    REQUIRE(storage->task_finish(*conn, child_instance, {spider::core::TaskOutput{"3.3", "float"}})
+                    .success());
+
+    // Job reset
+    REQUIRE(storage->reset_job(*conn, job_id).success());
+    // Parent tasks states should be ready and child task state should be waiting
+    // Parent tasks inputs should be available and child task inputs should be empty
+    // All tasks output should be empty
+    spider::core::Task res_task{""};
+    REQUIRE(storage->get_task(*conn, parent_1.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Ready);
+    REQUIRE(res_task.get_num_inputs() == 2);
+    REQUIRE(res_task.get_input(0).get_value() == "1");
+    REQUIRE(res_task.get_input(1).get_value() == "2");
+    REQUIRE(res_task.get_num_outputs() == 1);
+    REQUIRE(!res_task.get_output(0).get_value().has_value());
+    REQUIRE(storage->get_task(*conn, parent_2.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Ready);
+    REQUIRE(res_task.get_num_inputs() == 2);
+    REQUIRE(res_task.get_input(0).get_value() == "3");
+    REQUIRE(res_task.get_input(1).get_value() == "4");
+    REQUIRE(res_task.get_num_outputs() == 1);
+    REQUIRE(!res_task.get_output(0).get_value().has_value());
+    REQUIRE(storage->get_task(*conn, child_task.get_id(), &res_task).success());
+    REQUIRE(res_task.get_state() == spider::core::TaskState::Pending);
+    REQUIRE(res_task.get_num_inputs() == 2);
+    REQUIRE(!res_task.get_input(0).get_value().has_value());
+    REQUIRE(!res_task.get_input(1).get_value().has_value());
+    REQUIRE(res_task.get_num_outputs() == 1);
+    REQUIRE(!res_task.get_output(0).get_value().has_value());
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Scheduler lease timeout",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+
+    // Register scheduler
+    boost::uuids::uuid const scheduler_id = gen();
+    constexpr int cPort = 3306;
+    REQUIRE(storage->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", cPort})
+                    .success());
+
+    // Add simple job
+    boost::uuids::uuid const job_id = gen();
+    spider::core::Task const task{"simple"};
+    spider::core::TaskGraph graph;
+    graph.add_task(task);
+    graph.add_input_task(task.get_id());
+    graph.add_output_task(task.get_id());
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph).success());
+
+    // Get ready tasks should schedule the task
+    std::vector<spider::core::ScheduleTaskMetadata> tasks;
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, &tasks).success());
+    REQUIRE(1 == tasks.size());
+    REQUIRE(tasks[0].get_id() == task.get_id());
+
+    // Get again should not schedule the task
+    tasks.clear();
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, &tasks).success());
+    REQUIRE(tasks.empty());
+
+    // Wait for lease timeout
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    // Get ready tasks should schedule the task again
+    tasks.clear();
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, &tasks).success());
+    REQUIRE(1 == tasks.size());
+    REQUIRE(tasks[0].get_id() == task.get_id());
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+    REQUIRE(storage->remove_driver(*conn, scheduler_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Job priority",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+
+    // Register scheduler
+    boost::uuids::uuid const scheduler_id = gen();
+    constexpr int cPort = 3306;
+    REQUIRE(storage->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", cPort})
+                    .success());
+
+    // Add job with priority
+    constexpr std::int32_t cPriority = 5;
+    boost::uuids::uuid const job_id = gen();
+    spider::core::Task const task{"simple"};
+    spider::core::TaskGraph graph;
+    graph.add_task(task);
+    graph.add_input_task(task.get_id());
+    graph.add_output_task(task.get_id());
+    REQUIRE(storage->add_job(*conn, job_id, gen(), graph, cPriority).success());
+
+    // Priority is persisted with the job
+    spider::core::JobMetadata job_metadata{};
+    REQUIRE(storage->get_job_metadata(*conn, job_id, &job_metadata).success());
+    REQUIRE(cPriority == job_metadata.get_priority());
+
+    // Priority is returned with ready tasks
+    std::vector<spider::core::ScheduleTaskMetadata> tasks;
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, &tasks).success());
+    REQUIRE(1 == tasks.size());
+    REQUIRE(tasks[0].get_id() == task.get_id());
+    REQUIRE(cPriority == tasks[0].get_job_priority());
+
+    // Clean up
+    REQUIRE(storage->remove_job(*conn, job_id).success());
+    REQUIRE(storage->remove_driver(*conn, scheduler_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Get ready tasks in pages",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+
+    // Register scheduler
+    boost::uuids::uuid const scheduler_id = gen();
+    constexpr int cPort = 3306;
+    REQUIRE(storage->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", cPort})
+                    .success());
+
+    // Add jobs with increasing priority
+    constexpr std::int32_t cNumJobs = 3;
+    std::vector<boost::uuids::uuid> job_ids;
+    std::vector<boost::uuids::uuid> task_ids;
+    for (std::int32_t priority = 0; priority < cNumJobs; ++priority) {
+        boost::uuids::uuid const job_id = gen();
+        spider::core::Task const task{"simple"};
+        spider::core::TaskGraph graph;
+        graph.add_task(task);
+        graph.add_input_task(task.get_id());
+        graph.add_output_task(task.get_id());
+        REQUIRE(storage->add_job(*conn, job_id, gen(), graph, priority).success());
+        job_ids.push_back(job_id);
+        task_ids.push_back(task.get_id());
+    }
+
+    // First page holds the two highest priority tasks
+    std::vector<spider::core::ScheduleTaskMetadata> tasks;
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, 2, &tasks).success());
+    REQUIRE(2 == tasks.size());
+    REQUIRE(tasks[0].get_id() == task_ids[2]);
+    REQUIRE(tasks[1].get_id() == task_ids[1]);
+
+    // Next page starts after the last task of the first page
+    tasks.clear();
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, task_ids[1], 2, &tasks).success());
+    REQUIRE(1 == tasks.size());
+    REQUIRE(tasks[0].get_id() == task_ids[0]);
+
+    // Nothing follows the last page
+    tasks.clear();
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, task_ids[0], 2, &tasks).success());
+    REQUIRE(tasks.empty());
+
+    // The cursor skips tasks before it even after their leases expire
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    tasks.clear();
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, task_ids[2], 2, &tasks).success());
+    REQUIRE(2 == tasks.size());
+    REQUIRE(tasks[0].get_id() == task_ids[1]);
+    REQUIRE(tasks[1].get_id() == task_ids[0]);
+
+    // Clean up
+    for (boost::uuids::uuid const& job_id : job_ids) {
+        REQUIRE(storage->remove_job(*conn, job_id).success());
+    }
+    REQUIRE(storage->remove_driver(*conn, scheduler_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Get ready tasks of a client",
+        "[storage]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+
+    // Register scheduler
+    boost::uuids::uuid const scheduler_id = gen();
+    constexpr int cPort = 3306;
+    REQUIRE(storage->add_scheduler(*conn, spider::core::Scheduler{scheduler_id, "127.0.0.1", cPort})
+                    .success());
+
+    // First client has a higher priority job than second client
+    std::array<boost::uuids::uuid, 2> const client_ids{gen(), gen()};
+    std::vector<boost::uuids::uuid> job_ids;
+    std::vector<boost::uuids::uuid> task_ids;
+    for (std::size_t i = 0; i < client_ids.size(); ++i) {
+        boost::uuids::uuid const job_id = gen();
+        spider::core::Task const task{"simple"};
+        spider::core::TaskGraph graph;
+        graph.add_task(task);
+        graph.add_input_task(task.get_id());
+        graph.add_output_task(task.get_id());
+        REQUIRE(storage->add_job(
+                               *conn,
+                               job_id,
+                               client_ids[i],
+                               graph,
+                               static_cast<std::int32_t>(client_ids.size() - i)
+                       )
+                        .success());
+        job_ids.push_back(job_id);
+        task_ids.push_back(task.get_id());
+    }
+
+    // Both clients have ready tasks
+    std::vector<boost::uuids::uuid> ready_client_ids;
+    REQUIRE(storage->get_ready_clients(*conn, &ready_client_ids).success());
+    REQUIRE(2 == ready_client_ids.size());
+    REQUIRE(std::ranges::is_permutation(ready_client_ids, client_ids));
+
+    // Second client's task is fetched even though first client's task has a higher priority
+    std::vector<spider::core::ScheduleTaskMetadata> tasks;
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, client_ids[1], std::nullopt, 1, &tasks)
+                    .success());
+    REQUIRE(1 == tasks.size());
+    REQUIRE(tasks[0].get_id() == task_ids[1]);
+
+    // A client without ready tasks is not returned
+    REQUIRE(storage->set_task_state(*conn, task_ids[0], spider::core::TaskState::Running)
+                    .success());
+    ready_client_ids.clear();
+    REQUIRE(storage->get_ready_clients(*conn, &ready_client_ids).success());
+    REQUIRE(1 == ready_client_ids.size());
+    REQUIRE(ready_client_ids[0] == client_ids[1]);
+    tasks.clear();
+    REQUIRE(storage->get_ready_tasks(*conn, scheduler_id, client_ids[0], std::nullopt, 1, &tasks)
+                    .success());
+    REQUIRE(tasks.empty());
+
+    // Clean up
+    for (boost::uuids::uuid const& job_id : job_ids) {
+        REQUIRE(storage->remove_job(*conn, job_id).success());
+    }
+    REQUIRE(storage->remove_driver(*conn, scheduler_id).success());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Job submission benchmark",
+        "[storage][.benchmark]",
+        spider::test::InProcessStorageFactoryTypeList
+) {
+    std::unique_ptr<spider::core::StorageFactory> storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    std::unique_ptr<spider::core::MetadataStorage> storage
+            = storage_factory->provide_metadata_storage();
+
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory->provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    auto conn = std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+
+    boost::uuids::random_generator gen;
+    boost::uuids::uuid const client_id = gen();
+
+    // The submission rate of each graph size is its number of tasks over the mean time
+    for (std::size_t const num_tasks : {100, 1000, 10'000, 100'000}) {
+        BENCHMARK_ADVANCED(fmt::format("Submit {} tasks", num_tasks))(
+                Catch::Benchmark::Chronometer meter
+        ) {
+            std::vector<spider::core::TaskGraph> graphs;
+            std::vector<boost::uuids::uuid> job_ids;
+            for (int i = 0; i < meter.runs(); ++i) {
+                graphs.push_back(create_tree_graph(num_tasks));
+                job_ids.push_back(gen());
+            }
+            meter.measure([&](int const i) {
+                return storage->add_job(*conn, job_ids[i], client_id, graphs[i], 0).success();
+            });
+            for (boost::uuids::uuid const& job_id : job_ids) {
+                REQUIRE(storage->remove_job(*conn, job_id).success());
+            }
+        };
+    }
 }
 }  // namespace
 
@@ -0,0 +1,87 @@
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <mariadb/conncpp/PreparedStatement.hpp>
+#include <mariadb/conncpp/ResultSet.hpp>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/mysql/MySqlConnection.hpp>
+#include <spider/storage/mysql/MySqlStorageFactory.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageFactory.hpp>
+#include <tests/wolf/storage/StorageTestHelper.hpp>
+
+namespace {
+constexpr char const* cSelectJobState = "SELECT `state` FROM `jobs` WHERE `id` = ?";
+
+auto get_connection(spider::core::StorageFactory& storage_factory)
+        -> std::unique_ptr<spider::core::StorageConnection> {
+    std::variant<std::unique_ptr<spider::core::StorageConnection>, spider::core::StorageErr>
+            conn_result = storage_factory.provide_storage_connection();
+    REQUIRE(std::holds_alternative<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+    return std::move(std::get<std::unique_ptr<spider::core::StorageConnection>>(conn_result));
+}
+
+TEST_CASE("MySQL connection reuses prepared statements", "[storage]") {
+    std::unique_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<spider::core::MySqlStorageFactory>();
+    std::unique_ptr<spider::core::StorageConnection> const conn
+            = get_connection(*storage_factory);
+    auto& mysql_conn = static_cast<spider::core::MySqlConnection&>(*conn);
+
+    sql::PreparedStatement const* first_statement = nullptr;
+    {
+        spider::core::MySqlConnection::CachedStatement const statement
+                = mysql_conn.prepare_statement(cSelectJobState);
+        first_statement = statement.get();
+
+        // Statement in use is not shared
+        spider::core::MySqlConnection::CachedStatement const other_statement
+                = mysql_conn.prepare_statement(cSelectJobState);
+        REQUIRE(first_statement != other_statement.get());
+    }
+
+    // Released statement is reused with its parameters cleared
+    spider::core::MySqlConnection::CachedStatement const statement
+            = mysql_conn.prepare_statement(cSelectJobState);
+    REQUIRE(first_statement == statement.get());
+    statement->setString(1, "missing");
+    std::unique_ptr<sql::ResultSet> const res{statement->executeQuery()};
+    REQUIRE(0 == res->rowsCount());
+    mysql_conn->commit();
+}
+
+TEST_CASE("MySQL prepared statement benchmark", "[storage][.benchmark]") {
+    std::unique_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<spider::core::MySqlStorageFactory>();
+    std::unique_ptr<spider::core::StorageConnection> const conn
+            = get_connection(*storage_factory);
+    auto& mysql_conn = static_cast<spider::core::MySqlConnection&>(*conn);
+
+    BENCHMARK("Prepare statement per query") {
+        std::unique_ptr<sql::PreparedStatement> const statement{
+                mysql_conn->prepareStatement(cSelectJobState)
+        };
+        statement->setString(1, "missing");
+        std::unique_ptr<sql::ResultSet> const res{statement->executeQuery()};
+        return res->rowsCount();
+    };
+
+    BENCHMARK("Cached prepared statement per query") {
+        spider::core::MySqlConnection::CachedStatement const statement
+                = mysql_conn.prepare_statement(cSelectJobState);
+        statement->setString(1, "missing");
+        std::unique_ptr<sql::ResultSet> const res{statement->executeQuery()};
+        return res->rowsCount();
+    };
+
+    mysql_conn->commit();
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
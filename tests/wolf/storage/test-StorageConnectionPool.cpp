@@ -0,0 +1,111 @@
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <variant>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <spider/core/Error.hpp>
+#include <spider/storage/StorageConnection.hpp>
+#include <spider/storage/StorageConnectionPool.hpp>
+#include <spider/storage/StorageFactory.hpp>
+#include <tests/wolf/storage/StorageTestHelper.hpp>
+
+namespace {
+TEMPLATE_LIST_TEST_CASE(
+        "Storage connection pool reuses and bounds connections",
+        "[storage]",
+        spider::test::StorageFactoryTypeList
+) {
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    spider::core::StorageConnectionPool pool{storage_factory, 2};
+
+    std::variant<spider::core::StorageConnectionPool::Lease, spider::core::StorageErr>
+            first_result = pool.acquire();
+    REQUIRE(std::holds_alternative<spider::core::StorageConnectionPool::Lease>(first_result));
+    std::variant<spider::core::StorageConnectionPool::Lease, spider::core::StorageErr>
+            second_result = pool.acquire();
+    REQUIRE(std::holds_alternative<spider::core::StorageConnectionPool::Lease>(second_result));
+    auto first = std::move(std::get<spider::core::StorageConnectionPool::Lease>(first_result));
+    spider::core::StorageConnection const* first_conn = &*first;
+
+    // Pool is full, so the next acquire blocks until a lease is released
+    std::future<spider::core::StorageConnection const*> third = std::async(
+            std::launch::async,
+            [&]() -> spider::core::StorageConnection const* {
+                std::variant<spider::core::StorageConnectionPool::Lease, spider::core::StorageErr>
+                        result = pool.acquire();
+                if (false
+                    == std::holds_alternative<spider::core::StorageConnectionPool::Lease>(result))
+                {
+                    return nullptr;
+                }
+                return &*std::get<spider::core::StorageConnectionPool::Lease>(result);
+            }
+    );
+    REQUIRE(std::future_status::timeout == third.wait_for(std::chrono::milliseconds(100)));
+
+    // Released connection is reused
+    {
+        auto const released = std::move(first);
+    }
+    REQUIRE(first_conn == third.get());
+}
+
+TEST_CASE("Storage connection pool evicts idle and broken connections", "[storage]") {
+    int num_created = 0;
+    constexpr std::chrono::milliseconds cMaxIdleTime{50};
+    spider::core::StorageConnectionPool pool{
+            [&]() -> std::variant<
+                          std::unique_ptr<spider::core::StorageConnection>,
+                          spider::core::StorageErr> {
+                ++num_created;
+                return std::make_unique<spider::core::StorageConnection>();
+            },
+            2,
+            cMaxIdleTime
+    };
+
+    {
+        std::variant<spider::core::StorageConnectionPool::Lease, spider::core::StorageErr> const
+                result = pool.acquire();
+        REQUIRE(std::holds_alternative<spider::core::StorageConnectionPool::Lease>(result));
+    }
+    REQUIRE(1 == pool.get_num_idle_connections());
+
+    // Released connection is reused
+    {
+        std::variant<spider::core::StorageConnectionPool::Lease, spider::core::StorageErr> const
+                result = pool.acquire();
+        REQUIRE(std::holds_alternative<spider::core::StorageConnectionPool::Lease>(result));
+    }
+    REQUIRE(1 == num_created);
+
+    // Connection idle for too long is closed instead of reused
+    std::this_thread::sleep_for(cMaxIdleTime * 2);
+    {
+        std::variant<spider::core::StorageConnectionPool::Lease, spider::core::StorageErr> const
+                result = pool.acquire();
+        REQUIRE(std::holds_alternative<spider::core::StorageConnectionPool::Lease>(result));
+        REQUIRE(1 == pool.get_num_connections());
+    }
+    REQUIRE(2 == num_created);
+
+    // Discarded connection is not returned to the pool
+    {
+        std::variant<spider::core::StorageConnectionPool::Lease, spider::core::StorageErr> result
+                = pool.acquire();
+        REQUIRE(std::holds_alternative<spider::core::StorageConnectionPool::Lease>(result));
+        std::get<spider::core::StorageConnectionPool::Lease>(result).discard();
+    }
+    REQUIRE(0 == pool.get_num_connections());
+    REQUIRE(0 == pool.get_num_idle_connections());
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
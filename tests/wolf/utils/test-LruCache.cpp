@@ -0,0 +1,90 @@
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <spider/core/Data.hpp>
+#include <spider/core/DataCache.hpp>
+#include <spider/utils/LruCache.hpp>
+
+namespace {
+struct StringWeigher {
+    auto operator()(std::string const& value) const -> std::size_t { return value.size(); }
+};
+
+TEST_CASE("LRU cache evicts least recently used", "[utils]") {
+    spider::core::LruCache<int, int> cache{2};
+    cache.put(1, 1);
+    cache.put(2, 2);
+
+    // Get marks the entry as the most recently used
+    REQUIRE(1 == cache.get(1).value_or(0));
+    cache.put(3, 3);
+    REQUIRE(cache.get(1).has_value());
+    REQUIRE_FALSE(cache.get(2).has_value());
+    REQUIRE(cache.get(3).has_value());
+
+    // Put replaces the value of an existing key
+    cache.put(3, 4);
+    REQUIRE(4 == cache.get(3).value_or(0));
+    REQUIRE(2 == cache.get_weight());
+}
+
+TEST_CASE("LRU cache evicts by weight", "[utils]") {
+    constexpr std::size_t cCapacity = 10;
+    spider::core::LruCache<int, std::string, StringWeigher> cache{cCapacity};
+    cache.put(1, "aaaa");
+    cache.put(2, "bbbb");
+    REQUIRE(8 == cache.get_weight());
+
+    // Evict until the new value fits
+    cache.put(3, "cccccc");
+    REQUIRE_FALSE(cache.get(1).has_value());
+    REQUIRE(cache.get(2).has_value());
+    REQUIRE(cache.get(3).has_value());
+    REQUIRE(cCapacity == cache.get_weight());
+
+    // Value heavier than the capacity is not cached
+    cache.put(4, std::string(cCapacity + 1, 'd'));
+    REQUIRE_FALSE(cache.get(4).has_value());
+    REQUIRE(cCapacity == cache.get_weight());
+
+    // Shrink the capacity
+    cache.set_size(cCapacity / 2);
+    REQUIRE_FALSE(cache.get(2).has_value());
+    REQUIRE_FALSE(cache.get(3).has_value());
+    REQUIRE(0 == cache.get_weight());
+}
+
+TEST_CASE("Data cache", "[core]") {
+    spider::core::DataCache& cache = spider::core::DataCache::get_instance();
+    spider::core::Data const data{"value"};
+
+    // Disabled cache does not keep data
+    cache.set_capacity(0);
+    cache.put(data);
+    REQUIRE_FALSE(cache.get(data.get_id()).has_value());
+
+    constexpr std::size_t cCapacity = 1024;
+    cache.set_capacity(cCapacity);
+    cache.put(data);
+    std::optional<spider::core::Data> const cached_data = cache.get(data.get_id());
+    REQUIRE(cached_data.has_value());
+    if (cached_data.has_value()) {
+        REQUIRE(data.get_value() == cached_data.value().get_value());
+    }
+    REQUIRE(cache.get_size() > 0);
+
+    // Oversized data is not cached
+    spider::core::Data const large_data{std::string(cCapacity, 'a')};
+    cache.put(large_data);
+    REQUIRE_FALSE(cache.get(large_data.get_id()).has_value());
+
+    cache.set_capacity(0);
+    REQUIRE(0 == cache.get_size());
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
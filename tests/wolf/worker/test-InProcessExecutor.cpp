@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/uuid/random_generator.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <spider/client/TaskContext.hpp>
+#include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
+#include <spider/io/MsgPack.hpp>  // IWYU pragma: keep
+#include <spider/storage/StorageFactory.hpp>
+#include <spider/worker/FunctionManager.hpp>
+#include <spider/worker/InProcessExecutor.hpp>
+#include <tests/wolf/storage/StorageTestHelper.hpp>
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+namespace {
+auto in_process_sum(spider::TaskContext& /*context*/, int const x, int const y) -> int {
+    return x + y;
+}
+
+auto in_process_throw(spider::TaskContext& /*context*/, int const /*x*/) -> int {
+    throw std::runtime_error("in process error");
+}
+
+SPIDER_WORKER_REGISTER_TASK(in_process_sum);
+SPIDER_WORKER_REGISTER_TASK(in_process_throw);
+
+auto pack_args(std::vector<int> const& args) -> std::vector<msgpack::sbuffer> {
+    std::vector<msgpack::sbuffer> buffers(args.size());
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        msgpack::pack(buffers[i], args[i]);
+    }
+    return buffers;
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "In process executor runs tasks",
+        "[worker][storage]",
+        spider::test::StorageFactoryTypeList
+) {
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    spider::worker::InProcessExecutor executor{
+            storage_factory,
+            storage_factory->provide_metadata_storage(),
+            storage_factory->provide_data_storage(),
+            2,
+            {}
+    };
+    REQUIRE(executor.runs_function("in_process_sum"));
+
+    boost::uuids::random_generator gen;
+
+    boost::asio::io_context context;
+    std::future<msgpack::sbuffer> sum_future = boost::asio::co_spawn(
+            context,
+            executor.run("in_process_sum", gen(), pack_args({2, 3})),
+            boost::asio::use_future
+    );
+    std::future<msgpack::sbuffer> throw_future = boost::asio::co_spawn(
+            context,
+            executor.run("in_process_throw", gen(), pack_args({1})),
+            boost::asio::use_future
+    );
+    std::future<msgpack::sbuffer> missing_future = boost::asio::co_spawn(
+            context,
+            executor.run("in_process_missing", gen(), pack_args({2, 3})),
+            boost::asio::use_future
+    );
+    context.run();
+    REQUIRE(sum_future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    REQUIRE(throw_future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    REQUIRE(missing_future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+
+    // Task result should be returned
+    constexpr int cExpected = 2 + 3;
+    REQUIRE(cExpected == spider::core::response_get_result<int>(sum_future.get()).value_or(0));
+
+    // Exception thrown by the task should be returned as an error
+    std::optional<std::tuple<spider::core::FunctionInvokeError, std::string>> const throw_error
+            = spider::core::response_get_error(throw_future.get());
+    REQUIRE(throw_error.has_value());
+
+    // Unknown function should be returned as an error
+    std::optional<std::tuple<spider::core::FunctionInvokeError, std::string>> const missing_error
+            = spider::core::response_get_error(missing_future.get());
+    REQUIRE(missing_error.has_value());
+    if (missing_error.has_value()) {
+        REQUIRE(spider::core::FunctionInvokeError::FunctionExecutionError
+                == std::get<0>(missing_error.value()));
+    }
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "In process executor selects functions",
+        "[worker][storage]",
+        spider::test::StorageFactoryTypeList
+) {
+    std::shared_ptr<spider::core::StorageFactory> const storage_factory
+            = spider::test::create_storage_factory<TestType>();
+    spider::worker::InProcessExecutor const executor{
+            storage_factory,
+            storage_factory->provide_metadata_storage(),
+            storage_factory->provide_data_storage(),
+            1,
+            {"in_process_sum"}
+    };
+    REQUIRE(executor.runs_function("in_process_sum"));
+    REQUIRE_FALSE(executor.runs_function("in_process_throw"));
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
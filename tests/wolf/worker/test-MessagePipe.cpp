@@ -1,8 +1,13 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <chrono>
 #include <future>
 #include <optional>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -52,6 +57,73 @@ TEST_CASE("pipe message response", "[worker]") {
         }
     }
 }
+
+TEST_CASE("pipe message response through shared memory", "[worker]") {
+    boost::asio::io_context context;
+    boost::asio::readable_pipe read_pipe(context);
+    boost::asio::writable_pipe write_pipe(context);
+    boost::asio::connect_pipe(read_pipe, write_pipe);
+
+    // Large enough to be sent through shared memory
+    std::string const large_value(spider::worker::cSharedMemoryThreshold * 2, 'a');
+    msgpack::sbuffer const buffer
+            = spider::core::create_result_response(std::make_tuple(large_value));
+    REQUIRE(buffer.size() >= spider::worker::cSharedMemoryThreshold);
+
+    std::future<std::optional<msgpack::sbuffer>> future = boost::asio::co_spawn(
+            context,
+            spider::worker::receive_message_async(read_pipe),
+            boost::asio::use_future
+    );
+
+    // Send message should succeed and record the shared memory object
+    std::vector<std::string> shared_memory_names;
+    REQUIRE(spider::worker::send_message(write_pipe, buffer, &shared_memory_names));
+    REQUIRE(1 == shared_memory_names.size());
+
+    context.run();
+
+    REQUIRE(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+
+    // Get value should succeed
+    std::optional<msgpack::sbuffer> const& response_option = future.get();
+    REQUIRE(response_option.has_value());
+    if (response_option.has_value()) {
+        std::optional<std::tuple<std::string>> const parse_response
+                = spider::core::response_get_result<std::string>(response_option.value());
+        REQUIRE(parse_response.has_value());
+        if (parse_response.has_value()) {
+            REQUIRE(large_value == std::get<0>(parse_response.value()));
+        }
+    }
+
+    // Removing the shared memory object after the receiver unlinked it should be harmless
+    spider::worker::remove_shared_memory(shared_memory_names[0]);
+}
+
+TEST_CASE("Unread shared memory of a process is removed", "[worker]") {
+    boost::asio::io_context context;
+    boost::asio::readable_pipe read_pipe(context);
+    boost::asio::writable_pipe write_pipe(context);
+    boost::asio::connect_pipe(read_pipe, write_pipe);
+
+    std::string const large_value(spider::worker::cSharedMemoryThreshold * 2, 'a');
+    msgpack::sbuffer const buffer
+            = spider::core::create_result_response(std::make_tuple(large_value));
+    std::vector<std::string> shared_memory_names;
+    REQUIRE(spider::worker::send_message(write_pipe, buffer, &shared_memory_names));
+    REQUIRE(1 == shared_memory_names.size());
+
+    // The object is named after the sending process, so it can be found from the pid alone
+    spider::worker::remove_process_shared_memory(getpid());
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+    int const fd = shm_open(shared_memory_names[0].c_str(), O_RDONLY, 0);
+    REQUIRE(fd < 0);
+    if (fd >= 0) {
+        close(fd);
+        spider::worker::remove_shared_memory(shared_memory_names[0]);
+    }
+}
 }  // namespace
 
 // NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
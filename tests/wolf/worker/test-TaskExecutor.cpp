@@ -242,6 +242,106 @@ TEMPLATE_LIST_TEST_CASE(
     REQUIRE(metadata_storage->remove_driver(*conn, driver_id).success());
 }
 
+TEMPLATE_LIST_TEST_CASE(
+        "Task execute concurrently on one context",
+        "[worker][storage]",
+        spider::test::StorageFactoryTypeList
+) {
+    absl::flat_hash_map<
+            boost::process::v2::environment::key,
+            boost::process::v2::environment::value
+    > const environment_variable
+            = get_environment_variable();
+
+    boost::asio::io_context context;
+
+    boost::uuids::random_generator gen;
+
+    auto error_executor = spider::worker::TaskExecutor::spawn_cpp_executor(
+            context,
+            "error_test",
+            gen(),
+            spider::test::get_storage_url<TestType>(),
+            get_libraries(),
+            environment_variable,
+            pack_args(2)
+    );
+    auto sum_executor = spider::worker::TaskExecutor::spawn_cpp_executor(
+            context,
+            "sum_test",
+            gen(),
+            spider::test::get_storage_url<TestType>(),
+            get_libraries(),
+            environment_variable,
+            pack_args(2, 3)
+    );
+
+    // Both executors report their outputs on the same context
+    bool outputs_done = false;
+    boost::asio::co_spawn(
+            context,
+            [&]() -> boost::asio::awaitable<void> {
+                co_await sum_executor->async_wait_output();
+                co_await error_executor->async_wait_output();
+                outputs_done = true;
+            },
+            boost::asio::detached
+    );
+    context.run();
+    REQUIRE(outputs_done);
+
+    sum_executor->wait();
+    REQUIRE(sum_executor->succeed());
+    std::optional<int> const result_option = sum_executor->template get_result<int>();
+    REQUIRE(result_option.has_value());
+    REQUIRE(5 == result_option.value_or(0));
+    error_executor->wait();
+    REQUIRE(error_executor->error());
+}
+
+TEMPLATE_LIST_TEST_CASE(
+        "Persistent task executor runs several tasks",
+        "[worker][storage]",
+        spider::test::StorageFactoryTypeList
+) {
+    absl::flat_hash_map<
+            boost::process::v2::environment::key,
+            boost::process::v2::environment::value
+    > const environment_variable
+            = get_environment_variable();
+
+    boost::asio::io_context context;
+
+    boost::uuids::random_generator gen;
+
+    auto executor = spider::worker::TaskExecutor::spawn_persistent_cpp_executor(
+            context,
+            spider::test::get_storage_url<TestType>(),
+            get_libraries(),
+            environment_variable
+    );
+    REQUIRE(nullptr != executor);
+
+    // A failed task does not stop the executor
+    REQUIRE(executor->run_task("error_test", gen(), pack_args(2)));
+    context.run();
+    executor->wait();
+    REQUIRE(executor->error());
+    REQUIRE(executor->reusable());
+
+    REQUIRE(executor->run_task("sum_test", gen(), pack_args(2, 3)));
+    context.restart();
+    context.run();
+    executor->wait();
+    REQUIRE(executor->succeed());
+    std::optional<int> const result_option = executor->template get_result<int>();
+    REQUIRE(result_option.has_value());
+    REQUIRE(5 == result_option.value_or(0));
+    REQUIRE(executor->reusable());
+
+    REQUIRE(0 == executor->stop());
+}
+
 constexpr int cLargeInputSize = 300;
 
 TEMPLATE_LIST_TEST_CASE(
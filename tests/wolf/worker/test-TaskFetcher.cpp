@@ -0,0 +1,122 @@
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <spider/core/Task.hpp>
+#include <spider/scheduler/SchedulerMessage.hpp>
+#include <spider/worker/TaskFetcher.hpp>
+#include <spider/worker/TaskSource.hpp>
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+namespace {
+/**
+ * A task source that replays scripted responses and records the requests it gets.
+ */
+class ScriptedTaskSource final : public spider::worker::TaskSource {
+public:
+    struct Response {
+        std::vector<spider::scheduler::ScheduledTask> tasks;
+        // Whether the session is still alive after the request
+        bool connected = true;
+    };
+
+    explicit ScriptedTaskSource(std::vector<Response> responses)
+            : m_responses{std::move(responses)} {}
+
+    auto get_next_tasks(
+            std::optional<boost::uuids::uuid> const& fail_task_id,
+            std::size_t const num_tasks
+    ) -> std::vector<spider::scheduler::ScheduledTask> override {
+        m_requests.emplace_back(fail_task_id, num_tasks);
+        Response& response = m_responses.at(m_requests.size() - 1);
+        m_connected = response.connected;
+        return std::move(response.tasks);
+    }
+
+    [[nodiscard]] auto is_connected() const -> bool override { return m_connected; }
+
+    [[nodiscard]] auto get_requests() const
+            -> std::vector<std::pair<std::optional<boost::uuids::uuid>, std::size_t>> const& {
+        return m_requests;
+    }
+
+private:
+    std::vector<Response> m_responses;
+    std::vector<std::pair<std::optional<boost::uuids::uuid>, std::size_t>> m_requests;
+    bool m_connected = true;
+};
+
+auto make_task(boost::uuids::random_generator& gen) -> spider::scheduler::ScheduledTask {
+    spider::core::Task const task{"task"};
+    return spider::scheduler::ScheduledTask{
+            spider::core::TaskInstance{gen(), task.get_id()},
+            task,
+            {}
+    };
+}
+
+TEST_CASE("Task fetcher reports a failed task once", "[worker]") {
+    boost::uuids::random_generator gen;
+    std::vector<ScriptedTaskSource::Response> responses;
+    responses.push_back({{}, true});
+    responses.push_back({{make_task(gen)}, true});
+    ScriptedTaskSource source{std::move(responses)};
+    spider::worker::TaskFetcher fetcher{source};
+
+    boost::uuids::uuid const failed_task_id = gen();
+    fetcher.add_failed_task(failed_task_id);
+    REQUIRE(fetcher.fetch().has_value());
+
+    // The scheduler received the failed task with the first request
+    auto const& requests = source.get_requests();
+    REQUIRE(2 == requests.size());
+    REQUIRE(requests[0].first == failed_task_id);
+    REQUIRE(false == requests[1].first.has_value());
+}
+
+TEST_CASE("Task fetcher reports a failed task again after the session fails", "[worker]") {
+    boost::uuids::random_generator gen;
+    std::vector<ScriptedTaskSource::Response> responses;
+    responses.push_back({{}, false});
+    responses.push_back({{make_task(gen)}, true});
+    ScriptedTaskSource source{std::move(responses)};
+    spider::worker::TaskFetcher fetcher{source};
+
+    boost::uuids::uuid const failed_task_id = gen();
+    fetcher.add_failed_task(failed_task_id);
+    REQUIRE(fetcher.fetch().has_value());
+
+    // The first request may not have reached the scheduler, so the next one reports it again
+    auto const& requests = source.get_requests();
+    REQUIRE(2 == requests.size());
+    REQUIRE(requests[0].first == failed_task_id);
+    REQUIRE(requests[1].first == failed_task_id);
+}
+
+TEST_CASE("Task fetcher keeps extra tasks for later fetches", "[worker]") {
+    boost::uuids::random_generator gen;
+    spider::scheduler::ScheduledTask const first_task = make_task(gen);
+    spider::scheduler::ScheduledTask const second_task = make_task(gen);
+    std::vector<ScriptedTaskSource::Response> responses;
+    responses.push_back({{first_task, second_task}, true});
+    ScriptedTaskSource source{std::move(responses)};
+    spider::worker::TaskFetcher fetcher{source};
+
+    std::optional<spider::scheduler::ScheduledTask> const task = fetcher.fetch();
+    REQUIRE(task.has_value());
+    REQUIRE(task->get_task_id() == first_task.get_task_id());
+
+    // The second task is served without another request
+    std::optional<spider::scheduler::ScheduledTask> const kept_task = fetcher.fetch();
+    REQUIRE(kept_task.has_value());
+    REQUIRE(kept_task->get_task_id() == second_task.get_task_id());
+    REQUIRE(1 == source.get_requests().size());
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity,cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <spider/io/BoostAsio.hpp>  // IWYU pragma: keep
+#include <spider/worker/TaskPipeline.hpp>
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity)
+namespace {
+constexpr int cNumTasks = 3;
+constexpr std::chrono::seconds cWaitTimeout{5};
+
+/**
+ * Records the events of a pipeline from the event loop and the thread pool.
+ */
+class EventLog {
+public:
+    auto add(std::string const& event) -> void {
+        std::lock_guard const lock{m_mutex};
+        m_events.push_back(event);
+    }
+
+    [[nodiscard]] auto index_of(std::string const& event) const -> std::optional<std::size_t> {
+        std::lock_guard const lock{m_mutex};
+        for (std::size_t i = 0; i < m_events.size(); ++i) {
+            if (m_events[i] == event) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<std::string> m_events;
+};
+
+TEST_CASE("Task pipeline fetches the next task after the current task returns", "[worker]") {
+    boost::asio::io_context context;
+    boost::asio::thread_pool pool{2};
+    EventLog log;
+    std::mutex mutex;
+    int next_task = 0;
+    bool stop = false;
+    std::vector<int> submitted;
+
+    std::future<void> done = boost::asio::co_spawn(
+            context,
+            spider::worker::run_task_pipeline<int, int>(
+                    context,
+                    pool,
+                    [&]() -> std::optional<int> {
+                        std::lock_guard const lock{mutex};
+                        if (next_task >= cNumTasks) {
+                            stop = true;
+                            return std::nullopt;
+                        }
+                        log.add("fetch " + std::to_string(next_task));
+                        return next_task++;
+                    },
+                    [&] {
+                        std::lock_guard const lock{mutex};
+                        return stop;
+                    },
+                    [&](int task) -> boost::asio::awaitable<std::optional<int>> {
+                        log.add("run " + std::to_string(task));
+                        boost::asio::steady_timer timer{context, std::chrono::milliseconds(10)};
+                        co_await timer.async_wait(boost::asio::use_awaitable);
+                        log.add("return " + std::to_string(task));
+                        // Task 1 has no result to submit
+                        if (1 == task) {
+                            co_return std::nullopt;
+                        }
+                        co_return task;
+                    },
+                    [&](int result) {
+                        std::lock_guard const lock{mutex};
+                        submitted.push_back(result);
+                        return true;
+                    }
+            ),
+            boost::asio::use_future
+    );
+    context.run();
+    pool.join();
+    REQUIRE(done.wait_for(cWaitTimeout) == std::future_status::ready);
+    done.get();
+
+    // No task is fetched while another task runs
+    for (int task = 0; task + 1 < cNumTasks; ++task) {
+        std::optional<std::size_t> const returned = log.index_of("return " + std::to_string(task));
+        std::optional<std::size_t> const next_fetched
+                = log.index_of("fetch " + std::to_string(task + 1));
+        REQUIRE(returned.has_value());
+        REQUIRE(next_fetched.has_value());
+        REQUIRE(returned.value_or(0) < next_fetched.value_or(0));
+    }
+    REQUIRE(std::vector<int>{0, 2} == submitted);
+}
+
+TEST_CASE("Task pipeline submits results in the background", "[worker]") {
+    boost::asio::io_context context;
+    boost::asio::thread_pool pool{2};
+    std::mutex mutex;
+    int next_task = 0;
+    bool stop = false;
+    std::vector<int> submitted;
+    // Set once the task after the first one starts
+    std::promise<void> second_task_started;
+    std::future<void> second_task_started_future = second_task_started.get_future();
+    bool submission_overlapped = false;
+
+    std::future<void> done = boost::asio::co_spawn(
+            context,
+            spider::worker::run_task_pipeline<int, int>(
+                    context,
+                    pool,
+                    [&]() -> std::optional<int> {
+                        std::lock_guard const lock{mutex};
+                        if (next_task >= cNumTasks) {
+                            stop = true;
+                            return std::nullopt;
+                        }
+                        return next_task++;
+                    },
+                    [&] {
+                        std::lock_guard const lock{mutex};
+                        return stop;
+                    },
+                    [&](int task) -> boost::asio::awaitable<std::optional<int>> {
+                        if (1 == task) {
+                            second_task_started.set_value();
+                        }
+                        co_return task;
+                    },
+                    [&](int result) {
+                        if (0 == result) {
+                            // Only returns in time if the next task runs during this submission
+                            submission_overlapped = second_task_started_future.wait_for(cWaitTimeout)
+                                                    == std::future_status::ready;
+                        }
+                        std::lock_guard const lock{mutex};
+                        submitted.push_back(result);
+                        return true;
+                    }
+            ),
+            boost::asio::use_future
+    );
+    context.run();
+    pool.join();
+    REQUIRE(done.wait_for(cWaitTimeout) == std::future_status::ready);
+    done.get();
+
+    REQUIRE(submission_overlapped);
+    // Results are submitted in order, and all of them before the pipeline returns
+    REQUIRE(std::vector<int>{0, 1, 2} == submitted);
+}
+}  // namespace
+
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-do-while,readability-function-cognitive-complexity)
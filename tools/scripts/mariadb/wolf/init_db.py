@@ -35,10 +35,13 @@ _TABLE_CREATORS = [
       `id` BINARY(16) NOT NULL,
       `client_id` BINARY(16) NOT NULL,
       `creation_time` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,
-      `state` ENUM ('running', 'success', 'fail', 'cancel') NOT NULL DEFAULT 'running',
+      `state` ENUM ('submitting', 'running', 'success', 'fail', 'cancel') NOT NULL DEFAULT 'running',
+      `priority` INT NOT NULL DEFAULT 0,
+      `remaining_tasks` INT UNSIGNED NOT NULL DEFAULT 0,
       KEY (`client_id`) USING BTREE,
       INDEX idx_jobs_creation_time (`creation_time`),
       INDEX idx_jobs_state (`state`),
+      INDEX idx_jobs_state_priority (`state`, `priority`, `creation_time`),
       PRIMARY KEY (`id`)
     );
     """,
@@ -53,6 +56,7 @@ _TABLE_CREATORS = [
       `max_retry` INT UNSIGNED DEFAULT 0,
       `retry` INT UNSIGNED DEFAULT 0,
       `instance_id` BINARY(16),
+      `remaining_inputs` INT UNSIGNED NOT NULL DEFAULT 0,
       CONSTRAINT `task_job_id` FOREIGN KEY (`job_id`) REFERENCES `jobs` (`id`)
       ON UPDATE NO ACTION ON DELETE CASCADE,
       PRIMARY KEY (`id`)
@@ -90,6 +94,8 @@ _TABLE_CREATORS = [
       `value` VARBINARY(999) NOT NULL,
       `hard_locality` BOOL DEFAULT FALSE,
       `persisted` BOOL DEFAULT FALSE,
+      `size` BIGINT UNSIGNED NOT NULL DEFAULT 0,
+      `num_chunks` INT UNSIGNED NOT NULL DEFAULT 0,
       PRIMARY KEY (`id`)
     );
     """,
@@ -100,10 +106,13 @@ _TABLE_CREATORS = [
       `type` VARCHAR(999) NOT NULL,
       `value` VARBINARY(999),
       `data_id` BINARY(16),
+      `value_data_id` BINARY(16),
       CONSTRAINT `output_task_id` FOREIGN KEY (`task_id`) REFERENCES `tasks` (`id`)
       ON UPDATE NO ACTION ON DELETE CASCADE,
       CONSTRAINT `output_data_id` FOREIGN KEY (`data_id`) REFERENCES `data` (`id`)
       ON UPDATE NO ACTION ON DELETE NO ACTION,
+      CONSTRAINT `output_value_data_id` FOREIGN KEY (`value_data_id`) REFERENCES `data` (`id`)
+      ON UPDATE NO ACTION ON DELETE NO ACTION,
       PRIMARY KEY (`task_id`, `position`)
     );
     """,
@@ -116,12 +125,16 @@ _TABLE_CREATORS = [
       `output_task_position` INT UNSIGNED,
       `value` VARBINARY(999),
       `data_id` BINARY(16),
+      `value_data_id` BINARY(16),
       CONSTRAINT `input_task_id` FOREIGN KEY (`task_id`) REFERENCES `tasks` (`id`)
       ON UPDATE NO ACTION ON DELETE CASCADE,
       CONSTRAINT `input_task_output_match` FOREIGN KEY (`output_task_id`, `output_task_position`)
       REFERENCES task_outputs (`task_id`, `position`) ON UPDATE NO ACTION ON DELETE SET NULL,
       CONSTRAINT `input_data_id` FOREIGN KEY (`data_id`) REFERENCES `data` (`id`)
       ON UPDATE NO ACTION ON DELETE NO ACTION,
+      CONSTRAINT `input_value_data_id` FOREIGN KEY (`value_data_id`) REFERENCES `data` (`id`)
+      ON UPDATE NO ACTION ON DELETE NO ACTION,
+      INDEX idx_task_inputs_output_task (`output_task_id`, `output_task_position`),
       PRIMARY KEY (`task_id`, `position`)
     );
     """,
@@ -141,9 +154,11 @@ _TABLE_CREATORS = [
     CREATE TABLE IF NOT EXISTS `task_instances` (
       `id` BINARY(16) NOT NULL,
       `task_id` BINARY(16) NOT NULL,
+      `worker_id` BINARY(16),
       `start_time` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,
       CONSTRAINT `instance_task_id` FOREIGN KEY (`task_id`) REFERENCES `tasks` (`id`)
       ON UPDATE NO ACTION ON DELETE CASCADE,
+      INDEX (`worker_id`),
       PRIMARY KEY (`id`)
     );
     """,
@@ -161,6 +176,16 @@ _TABLE_CREATORS = [
     );
     """,
     """
+    CREATE TABLE IF NOT EXISTS `data_chunks` (
+      `id` BINARY(16) NOT NULL,
+      `chunk_index` INT UNSIGNED NOT NULL,
+      `value` MEDIUMBLOB NOT NULL,
+      CONSTRAINT `chunk_data_id` FOREIGN KEY (`id`) REFERENCES `data` (`id`)
+      ON UPDATE NO ACTION ON DELETE CASCADE,
+      PRIMARY KEY (`id`, `chunk_index`)
+    );
+    """,
+    """
     CREATE TABLE IF NOT EXISTS `data_locality` (
       `id` BINARY(16) NOT NULL,
       `address` VARCHAR(40) NOT NULL,
@@ -213,6 +238,58 @@ _TABLE_CREATORS = [
     """,
 ]
 
+# Columns added to existing tables, as (table, column, definition, statements filling the column for
+# existing rows). `CREATE TABLE IF NOT EXISTS` does not alter tables created by an older version.
+_COLUMN_MIGRATIONS = [
+    (
+        "tasks",
+        "remaining_inputs",
+        "INT UNSIGNED NOT NULL DEFAULT 0",
+        [
+            """
+            UPDATE `tasks` SET `remaining_inputs` = (
+              SELECT COUNT(*) FROM `task_inputs`
+              WHERE `task_inputs`.`task_id` = `tasks`.`id`
+                AND `task_inputs`.`output_task_id` IS NOT NULL
+                AND `task_inputs`.`value` IS NULL
+                AND `task_inputs`.`data_id` IS NULL
+            )
+            WHERE `state` = 'pending';
+            """,
+        ],
+    ),
+    (
+        "jobs",
+        "remaining_tasks",
+        "INT UNSIGNED NOT NULL DEFAULT 0",
+        [
+            """
+            UPDATE `jobs` SET `remaining_tasks` = (
+              SELECT COUNT(*) FROM `tasks`
+              WHERE `tasks`.`job_id` = `jobs`.`id` AND `tasks`.`state` != 'success'
+            );
+            """,
+        ],
+    ),
+]
+
+# Idempotent changes to existing tables
+_TABLE_MIGRATIONS = [
+    """
+    CREATE INDEX IF NOT EXISTS idx_task_inputs_output_task
+    ON `task_inputs` (`output_task_id`, `output_task_position`);
+    """,
+    # Older versions updated `creation_time` on every update of the job
+    """
+    ALTER TABLE `jobs` MODIFY `creation_time` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP;
+    """,
+    # Older versions had no 'submitting' state for jobs submitted in chunks
+    """
+    ALTER TABLE `jobs` MODIFY `state`
+    ENUM ('submitting', 'running', 'success', 'fail', 'cancel') NOT NULL DEFAULT 'running';
+    """,
+]
+
 
 logging.basicConfig(
     level=logging.INFO,
@@ -222,6 +299,30 @@ logging.basicConfig(
 logger = logging.getLogger(__name__)
 
 
+def _column_exists(cursor: "mariadb.cursors.Cursor", table: str, column: str) -> bool:
+    """Returns whether the table in the current database has the column."""
+    cursor.execute(
+        "SELECT COUNT(*) FROM information_schema.COLUMNS"
+        " WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND COLUMN_NAME = ?",
+        (table, column),
+    )
+    (count,) = cursor.fetchone()
+    return count > 0
+
+
+def _migrate_tables(cursor: "mariadb.cursors.Cursor") -> None:
+    """Brings tables created by an older version up to date. Safe to run more than once."""
+    for table, column, definition, backfills in _COLUMN_MIGRATIONS:
+        if _column_exists(cursor, table, column):
+            continue
+        logger.info("Adding column `%s`.`%s`", table, column)
+        cursor.execute(f"ALTER TABLE `{table}` ADD COLUMN `{column}` {definition};")
+        for backfill in backfills:
+            cursor.execute(backfill)
+    for table_migration in _TABLE_MIGRATIONS:
+        cursor.execute(table_migration)
+
+
 def main() -> int:
     """Main."""
     parser = argparse.ArgumentParser(description="Initialize the database tables for Spider.")
@@ -263,6 +364,7 @@ def main() -> int:
     ):
         for table_creator in _TABLE_CREATORS:
             cursor.execute(table_creator)
+        _migrate_tables(cursor)
         conn.commit()
 
     return 0